@@ -0,0 +1,165 @@
+/*! 
+BufferPoolBenchmark for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/*
+Compares the receive buffers from the heap against the BufferPool with the
+normal pages and with the large pages.
+
+Each thread keeps a window of the buffers in flight as an IOCP worker does,
+and frees the oldest, allocates a new one and writes over it, so both the
+allocation and the TLB cost of touching the memory are measured.
+
+Built by the epBufferPoolBenchmark project in the EpServerEngine solution of each Visual
+Studio version, e.g. Benchmarks\epBufferPoolBenchmark100.vcxproj, which links the static
+library of the same configuration from the Bin directory.
+Run as the user holding "Lock pages in memory" for the large page result.
+
+Usage: epBufferPoolBenchmark [threadCount] [iterationCount]
+*/
+#include "epse.h"
+#include <process.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace epse;
+
+/// the number of the buffers in flight for each thread
+#define BENCHMARK_WINDOW_COUNT 256
+
+/// Benchmark Mode
+typedef enum _benchmarkMode{
+	/// the global heap
+	BENCHMARK_MODE_HEAP=0,
+	/// the pool on the normal pages
+	BENCHMARK_MODE_POOL,
+	/// the pool on the large pages
+	BENCHMARK_MODE_LARGE_PAGE_POOL,
+	/// the number of the modes
+	BENCHMARK_MODE_COUNT,
+}BenchmarkMode;
+
+static const char *s_modeNames[BENCHMARK_MODE_COUNT]={"heap","pool","large page pool"};
+
+/// the argument of a benchmark thread
+struct BenchmarkThreadArg{
+	/// the mode to run
+	BenchmarkMode m_mode;
+	/// the number of the allocations
+	unsigned int m_iterationCount;
+	/// flag whether the pool got the large pages
+	bool m_isLargePage;
+};
+
+static unsigned __stdcall benchmarkThread(void *param)
+{
+	BenchmarkThreadArg *arg=reinterpret_cast<BenchmarkThreadArg*>(param);
+	BufferPool *pool=NULL;
+	if(arg->m_mode==BENCHMARK_MODE_POOL)
+		pool=EP_NEW BufferPool(BUFFER_POOL_BUFFER_BYTE_SIZE,BUFFER_POOL_FLAG_POOLED);
+	else if(arg->m_mode==BENCHMARK_MODE_LARGE_PAGE_POOL)
+		pool=EP_NEW BufferPool(BUFFER_POOL_BUFFER_BYTE_SIZE,BUFFER_POOL_FLAG_POOLED|BUFFER_POOL_FLAG_LARGE_PAGE);
+
+	void *window[BENCHMARK_WINDOW_COUNT];
+	memset(window,0,sizeof(window));
+	for(unsigned int trav=0;trav<arg->m_iterationCount;trav++)
+	{
+		unsigned int slot=trav%BENCHMARK_WINDOW_COUNT;
+		if(window[slot])
+		{
+			if(pool)
+				pool->Free(window[slot]);
+			else
+				EP_DELETE[] reinterpret_cast<char*>(window[slot]);
+		}
+		if(pool)
+			window[slot]=pool->Allocate(BUFFER_POOL_BUFFER_BYTE_SIZE);
+		else
+			window[slot]=EP_NEW char[BUFFER_POOL_BUFFER_BYTE_SIZE];
+		if(window[slot])
+			memset(window[slot],static_cast<int>(trav),BUFFER_POOL_BUFFER_BYTE_SIZE);
+	}
+	for(unsigned int slot=0;slot<BENCHMARK_WINDOW_COUNT;slot++)
+	{
+		if(!window[slot])
+			continue;
+		if(pool)
+			pool->Free(window[slot]);
+		else
+			EP_DELETE[] reinterpret_cast<char*>(window[slot]);
+	}
+	if(pool)
+	{
+		arg->m_isLargePage=pool->IsLargePage();
+		pool->ReleaseObj();
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int threadCount=System::GetNumberOfCores();
+	unsigned int iterationCount=1000000;
+	if(argc>1)
+		threadCount=static_cast<unsigned int>(atoi(argv[1]));
+	if(argc>2)
+		iterationCount=static_cast<unsigned int>(atoi(argv[2]));
+	if(threadCount==0 || threadCount>MAXIMUM_WAIT_OBJECTS)
+		threadCount=1;
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	printf("%u threads, %u buffers of %u bytes each\n",threadCount,iterationCount,BUFFER_POOL_BUFFER_BYTE_SIZE);
+
+	for(int mode=0;mode<BENCHMARK_MODE_COUNT;mode++)
+	{
+		BenchmarkThreadArg *argList=EP_NEW BenchmarkThreadArg[threadCount];
+		HANDLE *threadList=EP_NEW HANDLE[threadCount];
+		LARGE_INTEGER startCount;
+		LARGE_INTEGER endCount;
+		QueryPerformanceCounter(&startCount);
+		for(unsigned int trav=0;trav<threadCount;trav++)
+		{
+			argList[trav].m_mode=static_cast<BenchmarkMode>(mode);
+			argList[trav].m_iterationCount=iterationCount;
+			argList[trav].m_isLargePage=false;
+			threadList[trav]=reinterpret_cast<HANDLE>(_beginthreadex(NULL,0,benchmarkThread,&argList[trav],0,NULL));
+		}
+		WaitForMultipleObjects(threadCount,threadList,TRUE,INFINITE);
+		QueryPerformanceCounter(&endCount);
+		for(unsigned int trav=0;trav<threadCount;trav++)
+			CloseHandle(threadList[trav]);
+
+		double seconds=static_cast<double>(endCount.QuadPart-startCount.QuadPart)/static_cast<double>(frequency.QuadPart);
+		double buffersPerSecond=static_cast<double>(iterationCount)*threadCount/seconds;
+		printf("%-16s %10.3f sec %14.0f buffers/sec",s_modeNames[mode],seconds,buffersPerSecond);
+		if(mode==BENCHMARK_MODE_LARGE_PAGE_POOL && !argList[0].m_isLargePage)
+			printf(" (large pages not available, fell back to normal pages)");
+		printf("\n");
+		EP_DELETE[] argList;
+		EP_DELETE[] threadList;
+	}
+	return 0;
+}
@@ -0,0 +1,201 @@
+/*! 
+LightLockBenchmark for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/*
+Compares the lock policies under contention, and LightEvent against
+epl::EventEx in a ping-pong between two threads.
+
+Every thread increments a shared counter under the lock, so the result is
+the lock handover cost as the thread count grows. The "epl CriticalSectionEx"
+row is the heap allocated, virtual epl::BaseLock the engine used before the
+lock policies.
+
+Built by the epLightLockBenchmark project in the EpServerEngine solution of each Visual
+Studio version, e.g. Benchmarks\epLightLockBenchmark100.vcxproj, which links the static
+library of the same configuration from the Bin directory.
+
+Usage: epLightLockBenchmark [threadCount] [iterationCount]
+*/
+#include "epse.h"
+#include <process.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace epse;
+
+/*!
+The lock policy over the epl::BaseLock on the heap, as the engine used before the lock policies
+*/
+class BaseLockPolicy{
+public:
+	BaseLockPolicy(){m_lock=EP_NEW epl::CriticalSectionEx();}
+	~BaseLockPolicy(){EP_DELETE m_lock;}
+	bool Lock(){return m_lock->Lock();}
+	void Unlock(){m_lock->Unlock();}
+private:
+	epl::BaseLock *m_lock;
+};
+
+/// the argument of a lock benchmark thread
+template<typename LockPolicyType>
+struct LockThreadArg{
+	/// the lock shared by the threads
+	LockPolicyType *m_lock;
+	/// the counter guarded by the lock
+	volatile unsigned int *m_counter;
+	/// the number of the increments
+	unsigned int m_iterationCount;
+};
+
+template<typename LockPolicyType>
+static unsigned __stdcall lockThread(void *param)
+{
+	LockThreadArg<LockPolicyType> *arg=reinterpret_cast<LockThreadArg<LockPolicyType>*>(param);
+	for(unsigned int trav=0;trav<arg->m_iterationCount;trav++)
+	{
+		ScopedLock<LockPolicyType> lock(*arg->m_lock);
+		(*arg->m_counter)++;
+	}
+	return 0;
+}
+
+template<typename LockPolicyType>
+static void runLockBenchmark(const char *name,LockPolicyType &lock,unsigned int threadCount,unsigned int iterationCount,const LARGE_INTEGER &frequency)
+{
+	volatile unsigned int counter=0;
+	LockThreadArg<LockPolicyType> arg;
+	arg.m_lock=&lock;
+	arg.m_counter=&counter;
+	arg.m_iterationCount=iterationCount;
+
+	HANDLE *threadList=EP_NEW HANDLE[threadCount];
+	LARGE_INTEGER startCount;
+	LARGE_INTEGER endCount;
+	QueryPerformanceCounter(&startCount);
+	for(unsigned int trav=0;trav<threadCount;trav++)
+		threadList[trav]=reinterpret_cast<HANDLE>(_beginthreadex(NULL,0,lockThread<LockPolicyType>,&arg,0,NULL));
+	WaitForMultipleObjects(threadCount,threadList,TRUE,INFINITE);
+	QueryPerformanceCounter(&endCount);
+	for(unsigned int trav=0;trav<threadCount;trav++)
+		CloseHandle(threadList[trav]);
+	EP_DELETE[] threadList;
+
+	double seconds=static_cast<double>(endCount.QuadPart-startCount.QuadPart)/static_cast<double>(frequency.QuadPart);
+	double locksPerSecond=static_cast<double>(iterationCount)*threadCount/seconds;
+	printf("%-24s %10.3f sec %14.0f locks/sec",name,seconds,locksPerSecond);
+	if(counter!=iterationCount*threadCount)
+		printf(" (counter mismatch %u)",counter);
+	printf("\n");
+}
+
+/// the argument of an event ping-pong thread
+template<typename EventType>
+struct EventThreadArg{
+	/// the event to wait on
+	EventType *m_waitEvent;
+	/// the event to raise
+	EventType *m_raiseEvent;
+	/// the number of the round trips
+	unsigned int m_iterationCount;
+};
+
+template<typename EventType>
+static unsigned __stdcall eventThread(void *param)
+{
+	EventThreadArg<EventType> *arg=reinterpret_cast<EventThreadArg<EventType>*>(param);
+	for(unsigned int trav=0;trav<arg->m_iterationCount;trav++)
+	{
+		arg->m_waitEvent->WaitForEvent();
+		arg->m_raiseEvent->SetEvent();
+	}
+	return 0;
+}
+
+template<typename EventType>
+static void runEventBenchmark(const char *name,EventType &pingEvent,EventType &pongEvent,unsigned int iterationCount,const LARGE_INTEGER &frequency)
+{
+	EventThreadArg<EventType> arg;
+	arg.m_waitEvent=&pingEvent;
+	arg.m_raiseEvent=&pongEvent;
+	arg.m_iterationCount=iterationCount;
+
+	LARGE_INTEGER startCount;
+	LARGE_INTEGER endCount;
+	QueryPerformanceCounter(&startCount);
+	HANDLE thread=reinterpret_cast<HANDLE>(_beginthreadex(NULL,0,eventThread<EventType>,&arg,0,NULL));
+	for(unsigned int trav=0;trav<iterationCount;trav++)
+	{
+		pingEvent.SetEvent();
+		pongEvent.WaitForEvent();
+	}
+	WaitForSingleObject(thread,INFINITE);
+	QueryPerformanceCounter(&endCount);
+	CloseHandle(thread);
+
+	double seconds=static_cast<double>(endCount.QuadPart-startCount.QuadPart)/static_cast<double>(frequency.QuadPart);
+	printf("%-24s %10.3f sec %14.0f round trips/sec\n",name,seconds,static_cast<double>(iterationCount)/seconds);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int threadCount=System::GetNumberOfCores();
+	unsigned int iterationCount=1000000;
+	if(argc>1)
+		threadCount=static_cast<unsigned int>(atoi(argv[1]));
+	if(argc>2)
+		iterationCount=static_cast<unsigned int>(atoi(argv[2]));
+	if(threadCount==0 || threadCount>MAXIMUM_WAIT_OBJECTS)
+		threadCount=1;
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+
+	for(unsigned int count=1;count<=threadCount;count*=2)
+	{
+		printf("%u threads, %u locks each\n",count,iterationCount);
+		BaseLockPolicy baseLock;
+		runLockBenchmark("epl CriticalSectionEx",baseLock,count,iterationCount,frequency);
+		CriticalSectionPolicy criticalSection;
+		runLockBenchmark("CriticalSectionPolicy",criticalSection,count,iterationCount,frequency);
+		MutexPolicy mutex;
+		runLockBenchmark("MutexPolicy",mutex,count,iterationCount/10,frequency);
+		LightMutexPolicy lightMutex;
+		runLockBenchmark("LightMutexPolicy",lightMutex,count,iterationCount,frequency);
+		RuntimeLightLockPolicy runtimeLightLock(epl::LOCK_POLICY_CRITICALSECTION);
+		runLockBenchmark("RuntimeLightLockPolicy",runtimeLightLock,count,iterationCount,frequency);
+		printf("\n");
+	}
+
+	unsigned int roundTripCount=iterationCount/10;
+	printf("event ping-pong, %u round trips\n",roundTripCount);
+	epl::EventEx eventExPing(false,false);
+	epl::EventEx eventExPong(false,false);
+	runEventBenchmark("epl EventEx",eventExPing,eventExPong,roundTripCount,frequency);
+	LightEvent lightEventPing(false,false);
+	LightEvent lightEventPong(false,false);
+	runEventBenchmark("LightEvent",lightEventPing,lightEventPong,roundTripCount,frequency);
+	return 0;
+}
@@ -0,0 +1,244 @@
+/*! 
+ProxyBenchmark for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/*
+Measures the loopback throughput of both directions through the TCP proxy.
+
+Each client keeps a window of packets in flight to an echo server, directly
+or through the ProxyTcpServer, and sends the next packet for each echo it
+gets, so the proxy forwards from the clients and from the forward server at
+the same time. The packets reaching the echo server are counted for the
+direction to the forward server, and the echoes reaching the clients for the
+direction back to the clients.
+
+Built by the epProxyBenchmark project in the EpServerEngine solution of each Visual
+Studio version, e.g. Benchmarks\epProxyBenchmark100.vcxproj, which links the static
+library of the same configuration from the Bin directory.
+
+Usage: epProxyBenchmark [clientCount] [windowCount] [packetByteSize] [seconds]
+*/
+#include "epse.h"
+#include <process.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace epse;
+
+/// the port of the echo server
+#define BENCHMARK_ECHO_PORT "19100"
+/// the port of the proxy server
+#define BENCHMARK_PROXY_PORT "19101"
+/// the time in millisecond to let the connections settle before and after measuring
+#define BENCHMARK_SETTLE_MILLISEC 500
+
+/// Benchmark Mode
+typedef enum _benchmarkMode{
+	/// the clients connect to the echo server
+	BENCHMARK_MODE_DIRECT=0,
+	/// the clients connect through the proxy
+	BENCHMARK_MODE_PROXY,
+	/// the clients connect through the proxy forwarding through the queues
+	BENCHMARK_MODE_PROXY_BACKPRESSURED,
+	/// the number of the modes
+	BENCHMARK_MODE_COUNT,
+}BenchmarkMode;
+
+static const char *s_modeNames[BENCHMARK_MODE_COUNT]={"direct","proxy","proxy backpressured"};
+
+/// flag whether the clients send the next packet for each echo
+static volatile LONG s_isRunning=0;
+/// the number of the packets reached the echo server
+static volatile LONG s_toServerCount=0;
+/// the number of the echoes reached the clients
+static volatile LONG s_toClientCount=0;
+
+/// the echo server sending back each packet it receives
+class EchoServerCallback:public ServerCallbackInterface{
+public:
+	virtual void OnReceived(SocketInterface *socket,const Packet*receivedPacket,ReceiveStatus status)
+	{
+		if(status!=RECEIVE_STATUS_SUCCESS || !receivedPacket)
+			return;
+		InterlockedIncrement(&s_toServerCount);
+		socket->Send(*receivedPacket);
+	}
+};
+
+/// the proxy forwarding every client to the echo server
+class ForwardCallback:public ProxyServerCallbackInterface{
+public:
+	virtual ForwardServerInfo GetForwardServerInfo(const sockaddr &socketAddr)
+	{
+		ForwardServerInfo info;
+		info.hostname=_T("127.0.0.1");
+		info.port=_T(BENCHMARK_ECHO_PORT);
+		return info;
+	}
+};
+
+/// the client sending the next packet for each echo
+class WindowClientCallback:public ClientCallbackInterface{
+public:
+	/*!
+	Default Constructor
+	@param[in] packet the packet to send
+	*/
+	WindowClientCallback(const Packet *packet)
+	{
+		m_packet=packet;
+	}
+	virtual void OnReceived(ClientInterface *client,const Packet*receivedPacket,ReceiveStatus status)
+	{
+		if(status!=RECEIVE_STATUS_SUCCESS || !receivedPacket)
+			return;
+		InterlockedIncrement(&s_toClientCount);
+		if(s_isRunning)
+			client->Send(*m_packet);
+	}
+private:
+	/// the packet to send
+	const Packet *m_packet;
+};
+
+int main(int argc, char *argv[])
+{
+	unsigned int clientCount=8;
+	unsigned int windowCount=16;
+	unsigned int packetByteSize=1024;
+	unsigned int seconds=5;
+	if(argc>1)
+		clientCount=static_cast<unsigned int>(atoi(argv[1]));
+	if(argc>2)
+		windowCount=static_cast<unsigned int>(atoi(argv[2]));
+	if(argc>3)
+		packetByteSize=static_cast<unsigned int>(atoi(argv[3]));
+	if(argc>4)
+		seconds=static_cast<unsigned int>(atoi(argv[4]));
+	if(clientCount==0)
+		clientCount=8;
+	if(windowCount==0)
+		windowCount=16;
+	if(packetByteSize==0)
+		packetByteSize=1024;
+	if(seconds==0)
+		seconds=5;
+
+	char *payload=EP_NEW char[packetByteSize];
+	memset(payload,0,packetByteSize);
+	Packet packet(payload,packetByteSize);
+	EP_DELETE[] payload;
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	printf("%u clients with %u packets of %u bytes in flight each for %u seconds over the loopback\n",clientCount,windowCount,packetByteSize,seconds);
+
+	EchoServerCallback echoCallback;
+	AsyncTcpServer echoServer;
+	ServerOps echoOps;
+	echoOps.callBackObj=&echoCallback;
+	echoOps.port=_T(BENCHMARK_ECHO_PORT);
+	if(!echoServer.StartServer(echoOps))
+	{
+		printf("failed to start the echo server\n");
+		return 1;
+	}
+
+	ForwardCallback forwardCallback;
+	WindowClientCallback clientCallback(&packet);
+	for(int mode=0;mode<BENCHMARK_MODE_COUNT;mode++)
+	{
+		ProxyTcpServer proxyServer;
+		const TCHAR *port=_T(BENCHMARK_ECHO_PORT);
+		if(mode!=BENCHMARK_MODE_DIRECT)
+		{
+			ProxyServerOps proxyOps;
+			proxyOps.callBackObj=&forwardCallback;
+			proxyOps.port=_T(BENCHMARK_PROXY_PORT);
+			proxyOps.isBackpressured=(mode==BENCHMARK_MODE_PROXY_BACKPRESSURED);
+			if(!proxyServer.StartServer(proxyOps))
+			{
+				printf("%-20s failed to start the proxy server\n",s_modeNames[mode]);
+				continue;
+			}
+			port=_T(BENCHMARK_PROXY_PORT);
+		}
+
+		AsyncTcpClient **clients=EP_NEW AsyncTcpClient*[clientCount];
+		unsigned int connectedCount=0;
+		for(unsigned int trav=0;trav<clientCount;trav++)
+		{
+			clients[trav]=EP_NEW AsyncTcpClient();
+			ClientOps clientOps;
+			clientOps.callBackObj=&clientCallback;
+			clientOps.hostName=_T("127.0.0.1");
+			clientOps.port=port;
+			if(clients[trav]->Connect(clientOps))
+				connectedCount++;
+		}
+
+		InterlockedExchange(&s_isRunning,1);
+		for(unsigned int trav=0;trav<clientCount;trav++)
+		{
+			if(!clients[trav]->IsConnectionAlive())
+				continue;
+			for(unsigned int windowTrav=0;windowTrav<windowCount;windowTrav++)
+				clients[trav]->Send(packet);
+		}
+		// measure after the windows are filled, so the rates are of the steady state
+		Sleep(BENCHMARK_SETTLE_MILLISEC);
+		LARGE_INTEGER startCount;
+		LARGE_INTEGER endCount;
+		LONG toServerStart=s_toServerCount;
+		LONG toClientStart=s_toClientCount;
+		QueryPerformanceCounter(&startCount);
+		Sleep(seconds*1000);
+		LONG toServerEnd=s_toServerCount;
+		LONG toClientEnd=s_toClientCount;
+		QueryPerformanceCounter(&endCount);
+		InterlockedExchange(&s_isRunning,0);
+		// let the packets in flight drain before disconnecting
+		Sleep(BENCHMARK_SETTLE_MILLISEC);
+
+		for(unsigned int trav=0;trav<clientCount;trav++)
+		{
+			clients[trav]->Disconnect();
+			EP_DELETE clients[trav];
+		}
+		EP_DELETE[] clients;
+		if(mode!=BENCHMARK_MODE_DIRECT)
+			proxyServer.StopServer();
+
+		double elapsedSeconds=static_cast<double>(endCount.QuadPart-startCount.QuadPart)/static_cast<double>(frequency.QuadPart);
+		double toServerPerSecond=elapsedSeconds>0.0?static_cast<double>(toServerEnd-toServerStart)/elapsedSeconds:0.0;
+		double toClientPerSecond=elapsedSeconds>0.0?static_cast<double>(toClientEnd-toClientStart)/elapsedSeconds:0.0;
+		printf("%-20s to server %10.0f packets/sec %8.1f MB/sec to client %10.0f packets/sec %8.1f MB/sec connected %u/%u\n",s_modeNames[mode],
+			toServerPerSecond,toServerPerSecond*packetByteSize/(1024.0*1024.0),
+			toClientPerSecond,toClientPerSecond*packetByteSize/(1024.0*1024.0),
+			connectedCount,clientCount);
+	}
+	echoServer.StopServer();
+	return 0;
+}
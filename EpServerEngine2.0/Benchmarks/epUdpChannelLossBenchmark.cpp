@@ -0,0 +1,295 @@
+/*! 
+UdpChannelLossBenchmark for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/*
+Runs the UdpChannelSession over a simulated link with the given loss,
+latency and jitter, and checks the reliable ordered channel still delivers
+every message in order.
+
+Two sessions are connected back to back through LossyLink, which drops
+the datagrams at random and delivers the rest after the latency plus a
+random jitter, so the datagrams also arrive out of order. The channel timer
+drives the retransmissions as in the servers. It reports the time to
+deliver all the messages, the datagrams sent and dropped on each side, and
+the final round trip time and congestion window of the sender.
+
+Built by the epUdpChannelLossBenchmark project in the EpServerEngine solution of each Visual
+Studio version, e.g. Benchmarks\epUdpChannelLossBenchmark100.vcxproj, which links the static
+library of the same configuration from the Bin directory.
+
+Usage: epUdpChannelLossBenchmark [messageCount] [lossPercent] [latencyMilliSec] [jitterMilliSec]
+*/
+#include "epse.h"
+#include <process.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <mmsystem.h>
+#include <map>
+
+using namespace epse;
+
+/// the maximum datagram byte size of the sessions
+#define BENCHMARK_MAX_PACKET_SIZE 1200
+/// the message byte size
+#define BENCHMARK_MESSAGE_BYTE_SIZE 256
+
+/*! 
+@class LossyLink
+@brief A one way link which drops and delays the datagrams.
+*/
+class LossyLink:public UdpChannelTransportInterface{
+public:
+	LossyLink(unsigned int lossPercent,unsigned int latencyMilliSec,unsigned int jitterMilliSec,unsigned int seed)
+	{
+		m_lossPercent=lossPercent;
+		m_latencyMilliSec=latencyMilliSec;
+		m_jitterMilliSec=jitterMilliSec;
+		m_random=seed;
+		m_peer=NULL;
+		m_sentCount=0;
+		m_droppedCount=0;
+	}
+
+	virtual ~LossyLink()
+	{
+		multimap<DWORD,Packet*>::iterator iter;
+		for(iter=m_flightMap.begin();iter!=m_flightMap.end();iter++)
+			iter->second->ReleaseObj();
+	}
+
+	void SetPeer(UdpChannelSession *peer)
+	{
+		m_peer=peer;
+	}
+
+	virtual int SendDatagram(const Packet &datagram,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_linkLock);
+		m_sentCount++;
+		if(nextRandom()%100<m_lossPercent)
+		{
+			m_droppedCount++;
+		}
+		else
+		{
+			DWORD delay=m_latencyMilliSec;
+			if(m_jitterMilliSec)
+				delay+=nextRandom()%(m_jitterMilliSec+1);
+			m_flightMap.insert(pair<DWORD,Packet*>(GetTickCount()+delay,EP_NEW Packet(datagram.GetPacket(),datagram.GetPacketByteSize())));
+		}
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_SUCCESS;
+		return static_cast<int>(datagram.GetPacketByteSize());
+	}
+
+	/*!
+	Deliver the datagrams due to the peer
+	@param[out] messageList the messages delivered by the peer, which must be released by the caller
+	*/
+	void Deliver(vector<Packet*> &messageList)
+	{
+		vector<Packet*> dueList;
+		DWORD currentTick=GetTickCount();
+		m_linkLock.Lock();
+		while(!m_flightMap.empty() && static_cast<int>(currentTick-m_flightMap.begin()->first)>=0)
+		{
+			dueList.push_back(m_flightMap.begin()->second);
+			m_flightMap.erase(m_flightMap.begin());
+		}
+		m_linkLock.Unlock();
+		for(size_t dueTrav=0;dueTrav<dueList.size();dueTrav++)
+		{
+			m_peer->Receive(dueList[dueTrav]->GetPacket(),static_cast<int>(dueList[dueTrav]->GetPacketByteSize()),messageList);
+			dueList[dueTrav]->ReleaseObj();
+		}
+	}
+
+	unsigned int GetSentCount() const
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_linkLock);
+		return m_sentCount;
+	}
+
+	unsigned int GetDroppedCount() const
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_linkLock);
+		return m_droppedCount;
+	}
+
+private:
+	unsigned int nextRandom()
+	{
+		m_random=m_random*1103515245+12345;
+		return (m_random>>16)&0x7fff;
+	}
+
+	/// the loss in percent
+	unsigned int m_lossPercent;
+	/// the latency in millisecond
+	unsigned int m_latencyMilliSec;
+	/// the maximum jitter in millisecond
+	unsigned int m_jitterMilliSec;
+	/// the random state
+	unsigned int m_random;
+	/// the session receiving the datagrams
+	UdpChannelSession *m_peer;
+	/// the datagrams in flight by the delivery tick
+	multimap<DWORD,Packet*> m_flightMap;
+	/// the number of the datagrams sent
+	unsigned int m_sentCount;
+	/// the number of the datagrams dropped
+	unsigned int m_droppedCount;
+	/// the link lock
+	mutable RuntimeLockPolicy m_linkLock;
+};
+
+/// the argument of the delivery thread
+struct DeliveryArg{
+	/// the link from the sender to the receiver
+	LossyLink *m_forwardLink;
+	/// the link from the receiver to the sender
+	LossyLink *m_backwardLink;
+	/// the number of the messages to receive
+	unsigned int m_messageCount;
+	/// the number of the messages received in order
+	volatile unsigned int m_receivedCount;
+	/// the number of the messages received out of order
+	unsigned int m_disorderCount;
+	/// flag whether to stop
+	volatile bool m_isStopped;
+};
+
+static unsigned __stdcall deliveryThread(void *param)
+{
+	DeliveryArg *arg=reinterpret_cast<DeliveryArg*>(param);
+	vector<Packet*> messageList;
+	while(!arg->m_isStopped && arg->m_receivedCount<arg->m_messageCount)
+	{
+		arg->m_forwardLink->Deliver(messageList);
+		for(size_t messageTrav=0;messageTrav<messageList.size();messageTrav++)
+		{
+			unsigned int messageIdx=*reinterpret_cast<const unsigned int*>(messageList[messageTrav]->GetPacket());
+			if(messageIdx==arg->m_receivedCount)
+				arg->m_receivedCount++;
+			else
+				arg->m_disorderCount++;
+			messageList[messageTrav]->ReleaseObj();
+		}
+		messageList.clear();
+
+		// the sender gets the acknowledgements only
+		arg->m_backwardLink->Deliver(messageList);
+		for(size_t messageTrav=0;messageTrav<messageList.size();messageTrav++)
+			messageList[messageTrav]->ReleaseObj();
+		messageList.clear();
+		Sleep(1);
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int messageCount=10000;
+	unsigned int lossPercent=5;
+	unsigned int latencyMilliSec=20;
+	unsigned int jitterMilliSec=10;
+	if(argc>1)
+		messageCount=static_cast<unsigned int>(atoi(argv[1]));
+	if(argc>2)
+		lossPercent=static_cast<unsigned int>(atoi(argv[2]));
+	if(argc>3)
+		latencyMilliSec=static_cast<unsigned int>(atoi(argv[3]));
+	if(argc>4)
+		jitterMilliSec=static_cast<unsigned int>(atoi(argv[4]));
+	if(lossPercent>=100)
+		lossPercent=99;
+
+	// the delivery thread sleeps for 1 ms
+	timeBeginPeriod(1);
+	printf("%u messages, %u%% loss, %u ms latency, %u ms jitter\n",messageCount,lossPercent,latencyMilliSec,jitterMilliSec);
+
+	LossyLink forwardLink(lossPercent,latencyMilliSec,jitterMilliSec,1);
+	LossyLink backwardLink(lossPercent,latencyMilliSec,jitterMilliSec,2);
+	UdpChannelType channelType=UDP_CHANNEL_TYPE_RELIABLE_ORDERED;
+	UdpChannelSession *sender=EP_NEW UdpChannelSession(&forwardLink,&channelType,1,BENCHMARK_MAX_PACKET_SIZE);
+	UdpChannelSession *receiver=EP_NEW UdpChannelSession(&backwardLink,&channelType,1,BENCHMARK_MAX_PACKET_SIZE);
+	forwardLink.SetPeer(receiver);
+	backwardLink.SetPeer(sender);
+
+	UdpChannelTimer timer;
+	timer.Register(sender);
+	timer.Register(receiver);
+	timer.StartTimer();
+
+	DeliveryArg deliveryArg;
+	deliveryArg.m_forwardLink=&forwardLink;
+	deliveryArg.m_backwardLink=&backwardLink;
+	deliveryArg.m_messageCount=messageCount;
+	deliveryArg.m_receivedCount=0;
+	deliveryArg.m_disorderCount=0;
+	deliveryArg.m_isStopped=false;
+
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER startCount;
+	LARGE_INTEGER endCount;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&startCount);
+	HANDLE deliveryHandle=reinterpret_cast<HANDLE>(_beginthreadex(NULL,0,deliveryThread,&deliveryArg,0,NULL));
+
+	Packet message(NULL,BENCHMARK_MESSAGE_BYTE_SIZE);
+	char *messageData=const_cast<char*>(message.GetPacket());
+	memset(messageData,0,BENCHMARK_MESSAGE_BYTE_SIZE);
+	for(unsigned int messageTrav=0;messageTrav<messageCount;messageTrav++)
+	{
+		*reinterpret_cast<unsigned int*>(messageData)=messageTrav;
+		sender->Send(0,message);
+	}
+
+	while(WaitForSingleObject(deliveryHandle,100)==WAIT_TIMEOUT)
+	{
+		if(sender->IsFailed())
+			deliveryArg.m_isStopped=true;
+	}
+	QueryPerformanceCounter(&endCount);
+	CloseHandle(deliveryHandle);
+	timer.StopTimer();
+
+	double seconds=static_cast<double>(endCount.QuadPart-startCount.QuadPart)/static_cast<double>(frequency.QuadPart);
+	unsigned int forwardSentCount=forwardLink.GetSentCount();
+	printf("received %u of %u in order in %.3f sec (%.0f messages/sec)\n",deliveryArg.m_receivedCount,messageCount,seconds,seconds>0.0?deliveryArg.m_receivedCount/seconds:0.0);
+	printf("sender   sent %u datagrams, %u dropped, %.2f datagrams per message\n",forwardSentCount,forwardLink.GetDroppedCount(),messageCount?static_cast<double>(forwardSentCount)/messageCount:0.0);
+	printf("receiver sent %u datagrams, %u dropped\n",backwardLink.GetSentCount(),backwardLink.GetDroppedCount());
+	printf("round trip time %u ms, congestion window %u\n",sender->GetRoundTripTime(),sender->GetCongestionWindow());
+	if(deliveryArg.m_disorderCount)
+		printf("%u messages delivered out of order\n",deliveryArg.m_disorderCount);
+	if(sender->IsFailed())
+		printf("the session failed after %u transmissions of a message\n",UDP_CHANNEL_MAX_SEND_COUNT);
+
+	EP_DELETE sender;
+	EP_DELETE receiver;
+	timeEndPeriod(1);
+	return (deliveryArg.m_receivedCount==messageCount && deliveryArg.m_disorderCount==0)?0:1;
+}
@@ -0,0 +1,295 @@
+/*! 
+UdpOffloadBenchmark for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+/*
+Compares the loopback UDP throughput of the separate datagrams against the
+UdpOffload segmented send and coalesced receive.
+
+The sender thread sends the datagrams as fast as it can, one sendto for
+each or one SendSegmented for each train of UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE
+bytes at most, while the receiver thread counts the datagrams it gets, so
+both the send and the receive rate are reported with the datagrams lost on
+the way. The offload rows fall back to the separate datagrams where the
+network stack does not support it, and say so.
+
+Built by the epUdpOffloadBenchmark project in the EpServerEngine solution of each Visual
+Studio version, e.g. Benchmarks\epUdpOffloadBenchmark100.vcxproj, which links the static
+library of the same configuration from the Bin directory.
+
+Usage: epUdpOffloadBenchmark [datagramCount] [datagramByteSize]
+*/
+#include "epse.h"
+#include <process.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace epse;
+
+/// the receive timeout which ends the receiver after the sender is done
+#define BENCHMARK_RECEIVE_TIMEOUT 500
+/// the socket buffer byte size of both sides
+#define BENCHMARK_SOCKET_BUFFER_BYTE_SIZE (8*1024*1024)
+
+/// Benchmark Mode
+typedef enum _benchmarkMode{
+	/// one sendto and one recvfrom for each datagram
+	BENCHMARK_MODE_PLAIN=0,
+	/// the segmented send with the separate receive
+	BENCHMARK_MODE_SEND_OFFLOAD,
+	/// the segmented send with the coalesced receive
+	BENCHMARK_MODE_SEND_RECEIVE_OFFLOAD,
+	/// the number of the modes
+	BENCHMARK_MODE_COUNT,
+}BenchmarkMode;
+
+static const char *s_modeNames[BENCHMARK_MODE_COUNT]={"plain","send offload","send+recv offload"};
+
+/// the argument of the receiver thread
+struct ReceiverArg{
+	/// the receive socket
+	SOCKET m_socket;
+	/// the offload of the receive socket
+	UdpOffload *m_offload;
+	/// the byte size of the receive buffer
+	unsigned int m_bufferByteSize;
+	/// the number of the received datagrams
+	unsigned int m_receivedCount;
+	/// the counter of the first receive
+	LARGE_INTEGER m_firstCount;
+	/// the counter of the last receive
+	LARGE_INTEGER m_lastCount;
+};
+
+/// the argument of the sender thread
+struct SenderArg{
+	/// the send socket
+	SOCKET m_socket;
+	/// the offload of the send socket, NULL for the separate datagrams
+	UdpOffload *m_offload;
+	/// the receiver address
+	sockaddr_in m_address;
+	/// the number of the datagrams to send
+	unsigned int m_datagramCount;
+	/// the byte size of each datagram
+	unsigned int m_datagramByteSize;
+	/// the number of the sent datagrams
+	unsigned int m_sentCount;
+	/// the number of the datagrams failed to send
+	unsigned int m_failedCount;
+	/// flag whether the segmented send fell back to the separate datagrams
+	bool m_isFallBack;
+	/// the counter of the send start
+	LARGE_INTEGER m_startCount;
+	/// the counter of the send end
+	LARGE_INTEGER m_endCount;
+};
+
+static unsigned __stdcall receiverThread(void *param)
+{
+	ReceiverArg *arg=reinterpret_cast<ReceiverArg*>(param);
+	char *buffer=EP_NEW char[arg->m_bufferByteSize];
+	arg->m_receivedCount=0;
+	while(true)
+	{
+		sockaddr_in fromAddress;
+		int fromAddressSize=sizeof(fromAddress);
+		unsigned int segmentByteSize=0;
+		int recvLength;
+		if(arg->m_offload)
+			recvLength=arg->m_offload->ReceiveFrom(arg->m_socket,buffer,static_cast<int>(arg->m_bufferByteSize),reinterpret_cast<sockaddr*>(&fromAddress),&fromAddressSize,&segmentByteSize);
+		else
+			recvLength=recvfrom(arg->m_socket,buffer,static_cast<int>(arg->m_bufferByteSize),0,reinterpret_cast<sockaddr*>(&fromAddress),&fromAddressSize);
+		if(recvLength<=0)
+			break;
+		if(arg->m_receivedCount==0)
+			QueryPerformanceCounter(&arg->m_firstCount);
+		QueryPerformanceCounter(&arg->m_lastCount);
+		if(segmentByteSize)
+			arg->m_receivedCount+=(static_cast<unsigned int>(recvLength)+segmentByteSize-1)/segmentByteSize;
+		else
+			arg->m_receivedCount++;
+	}
+	EP_DELETE[] buffer;
+	return 0;
+}
+
+static unsigned __stdcall senderThread(void *param)
+{
+	SenderArg *arg=reinterpret_cast<SenderArg*>(param);
+	unsigned int trainCount=1;
+	if(arg->m_offload)
+		trainCount=UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE/arg->m_datagramByteSize;
+	if(trainCount==0)
+		trainCount=1;
+	char *train=EP_NEW char[trainCount*arg->m_datagramByteSize];
+	memset(train,0,trainCount*arg->m_datagramByteSize);
+	const sockaddr *address=reinterpret_cast<const sockaddr*>(&arg->m_address);
+	arg->m_sentCount=0;
+	arg->m_failedCount=0;
+	arg->m_isFallBack=false;
+	QueryPerformanceCounter(&arg->m_startCount);
+	unsigned int remainCount=arg->m_datagramCount;
+	while(remainCount>0)
+	{
+		unsigned int sendCount=remainCount;
+		if(sendCount>trainCount)
+			sendCount=trainCount;
+		remainCount-=sendCount;
+		if(arg->m_offload && arg->m_offload->IsSendOffloadSupported() && sendCount>1)
+		{
+			int sendLength=static_cast<int>(sendCount*arg->m_datagramByteSize);
+			if(arg->m_offload->SendSegmented(arg->m_socket,train,sendLength,arg->m_datagramByteSize,address,sizeof(arg->m_address))==sendLength)
+			{
+				arg->m_sentCount+=sendCount;
+				continue;
+			}
+			if(!arg->m_offload->IsSendOffloadSupported())
+				arg->m_isFallBack=true;
+		}
+		// the separate datagrams, also for the train the segmented send failed
+		for(unsigned int trav=0;trav<sendCount;trav++)
+		{
+			if(sendto(arg->m_socket,train+trav*arg->m_datagramByteSize,static_cast<int>(arg->m_datagramByteSize),0,address,sizeof(arg->m_address))==SOCKET_ERROR)
+				arg->m_failedCount++;
+			else
+				arg->m_sentCount++;
+		}
+	}
+	QueryPerformanceCounter(&arg->m_endCount);
+	EP_DELETE[] train;
+	return 0;
+}
+
+static SOCKET createSocket(sockaddr_in &retAddress)
+{
+	SOCKET udpSocket=socket(AF_INET,SOCK_DGRAM,IPPROTO_UDP);
+	if(udpSocket==INVALID_SOCKET)
+		return INVALID_SOCKET;
+	int bufferByteSize=BENCHMARK_SOCKET_BUFFER_BYTE_SIZE;
+	setsockopt(udpSocket,SOL_SOCKET,SO_RCVBUF,reinterpret_cast<const char*>(&bufferByteSize),sizeof(bufferByteSize));
+	setsockopt(udpSocket,SOL_SOCKET,SO_SNDBUF,reinterpret_cast<const char*>(&bufferByteSize),sizeof(bufferByteSize));
+	DWORD timeout=BENCHMARK_RECEIVE_TIMEOUT;
+	setsockopt(udpSocket,SOL_SOCKET,SO_RCVTIMEO,reinterpret_cast<const char*>(&timeout),sizeof(timeout));
+
+	memset(&retAddress,0,sizeof(retAddress));
+	retAddress.sin_family=AF_INET;
+	retAddress.sin_addr.s_addr=htonl(INADDR_LOOPBACK);
+	retAddress.sin_port=0;
+	int addressSize=sizeof(retAddress);
+	if(bind(udpSocket,reinterpret_cast<sockaddr*>(&retAddress),sizeof(retAddress))==SOCKET_ERROR
+		|| getsockname(udpSocket,reinterpret_cast<sockaddr*>(&retAddress),&addressSize)==SOCKET_ERROR)
+	{
+		closesocket(udpSocket);
+		return INVALID_SOCKET;
+	}
+	return udpSocket;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int datagramCount=1000000;
+	unsigned int datagramByteSize=1200;
+	if(argc>1)
+		datagramCount=static_cast<unsigned int>(atoi(argv[1]));
+	if(argc>2)
+		datagramByteSize=static_cast<unsigned int>(atoi(argv[2]));
+	if(datagramByteSize==0 || datagramByteSize>UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE)
+		datagramByteSize=1200;
+
+	WSADATA wsaData;
+	if(WSAStartup(MAKEWORD(2,2),&wsaData)!=0)
+	{
+		printf("WSAStartup failed\n");
+		return 1;
+	}
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	printf("%u datagrams of %u bytes each over the loopback\n",datagramCount,datagramByteSize);
+
+	for(int mode=0;mode<BENCHMARK_MODE_COUNT;mode++)
+	{
+		sockaddr_in receiveAddress;
+		sockaddr_in sendAddress;
+		SOCKET receiveSocket=createSocket(receiveAddress);
+		SOCKET sendSocket=createSocket(sendAddress);
+		if(receiveSocket==INVALID_SOCKET || sendSocket==INVALID_SOCKET)
+		{
+			printf("%-18s failed to create the sockets\n",s_modeNames[mode]);
+			if(receiveSocket!=INVALID_SOCKET)
+				closesocket(receiveSocket);
+			if(sendSocket!=INVALID_SOCKET)
+				closesocket(sendSocket);
+			continue;
+		}
+
+		UdpOffload sendOffload;
+		UdpOffload receiveOffload;
+		bool isSendOffload=false;
+		bool isReceiveOffload=false;
+		if(mode!=BENCHMARK_MODE_PLAIN)
+			isSendOffload=sendOffload.Initialize(sendSocket);
+		if(mode==BENCHMARK_MODE_SEND_RECEIVE_OFFLOAD && receiveOffload.Initialize(receiveSocket))
+			isReceiveOffload=receiveOffload.EnableReceiveCoalescing(receiveSocket,UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE);
+
+		ReceiverArg receiverArg;
+		receiverArg.m_socket=receiveSocket;
+		receiverArg.m_offload=isReceiveOffload?&receiveOffload:NULL;
+		receiverArg.m_bufferByteSize=UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE;
+		receiverArg.m_receivedCount=0;
+
+		SenderArg senderArg;
+		senderArg.m_socket=sendSocket;
+		senderArg.m_offload=(mode!=BENCHMARK_MODE_PLAIN)?&sendOffload:NULL;
+		senderArg.m_address=receiveAddress;
+		senderArg.m_datagramCount=datagramCount;
+		senderArg.m_datagramByteSize=datagramByteSize;
+
+		HANDLE receiverHandle=reinterpret_cast<HANDLE>(_beginthreadex(NULL,0,receiverThread,&receiverArg,0,NULL));
+		HANDLE senderHandle=reinterpret_cast<HANDLE>(_beginthreadex(NULL,0,senderThread,&senderArg,0,NULL));
+		WaitForSingleObject(senderHandle,INFINITE);
+		// the receiver ends on the receive timeout once the sender is done
+		WaitForSingleObject(receiverHandle,INFINITE);
+		CloseHandle(senderHandle);
+		CloseHandle(receiverHandle);
+		closesocket(sendSocket);
+		closesocket(receiveSocket);
+
+		double sendSeconds=static_cast<double>(senderArg.m_endCount.QuadPart-senderArg.m_startCount.QuadPart)/static_cast<double>(frequency.QuadPart);
+		double receiveSeconds=static_cast<double>(receiverArg.m_lastCount.QuadPart-receiverArg.m_firstCount.QuadPart)/static_cast<double>(frequency.QuadPart);
+		double sentPerSecond=sendSeconds>0.0?static_cast<double>(senderArg.m_sentCount)/sendSeconds:0.0;
+		double receivedPerSecond=(receiverArg.m_receivedCount>1 && receiveSeconds>0.0)?static_cast<double>(receiverArg.m_receivedCount)/receiveSeconds:0.0;
+		unsigned int lostCount=senderArg.m_sentCount>receiverArg.m_receivedCount?senderArg.m_sentCount-receiverArg.m_receivedCount:0;
+		printf("%-18s sent %12.0f datagrams/sec received %12.0f datagrams/sec lost %u failed %u",s_modeNames[mode],sentPerSecond,receivedPerSecond,lostCount,senderArg.m_failedCount);
+		if(mode!=BENCHMARK_MODE_PLAIN && (!isSendOffload || senderArg.m_isFallBack))
+			printf(" (send offload not available, fell back to separate datagrams)");
+		if(mode==BENCHMARK_MODE_SEND_RECEIVE_OFFLOAD && !isReceiveOffload)
+			printf(" (receive coalescing not available)");
+		printf("\n");
+	}
+	WSACleanup();
+	return 0;
+}
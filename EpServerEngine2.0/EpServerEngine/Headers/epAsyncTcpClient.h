@@ -109,6 +109,8 @@ namespace epse{
 		@param[in] ops the client options
 		@return true if successfully connected otherwise false
 		@remark if argument is NULL then previously setting value is used
+		@remark if ops.isAsynchronousConnect is true, returns once the connect is started,<br/>
+		        and the result is given to OnConnected of the callback object.
 		*/
 		bool Connect(const ClientOps &ops=ClientOps::defaultClientOps);
 
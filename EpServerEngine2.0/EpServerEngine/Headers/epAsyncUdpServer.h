@@ -101,16 +101,37 @@ namespace epse{
 		@remark if argument is NULL then previously setting value is used
 		*/
 		bool StartServer(const ServerOps &ops=ServerOps::defaultServerOps);
+
+		/*!
+		Get the number of the threads running the sessions
+		@return the number of the dispatch threads, 0 if each session runs on its own thread
+		*/
+		unsigned int GetUdpDispatchThreadCount() const;
 	
+	protected:
+		/*!
+		Clean up the server initialization.
+		*/
+		virtual void cleanUpServer();
+
 	private:
 	
 		/*!
-		Listening Loop Function
+		Handle the datagram received from the client
+		@param[in] packetData the datagram
+		@param[in] recvLength the result of the receive
+		@param[in] clientAddress the client address
+		@param[in] segmentByteSize the segment byte size of the coalesced datagrams, 0 if not coalesced
 		*/
-		virtual void execute();
+		virtual void handleDatagram(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize);
 	
 		/// Flag for Asynchronous Receive
 		bool m_isAsynchronousReceive;
+
+		/// number of the threads running the sessions
+		unsigned int m_udpDispatchThreadCount;
+		/// dispatcher of the sessions
+		UdpSessionDispatcher m_dispatcher;
 	
 	};
 }
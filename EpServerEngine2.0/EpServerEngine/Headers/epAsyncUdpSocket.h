@@ -39,7 +39,9 @@ An Interface for Asynchronous UDP Socket.
 #define __EP_ASYNC_UDP_SOCKET_H__
 
 #include "epServerEngine.h"
+#include "epLightLock.h"
 #include "epBaseUdpSocket.h"
+#include "epUdpSessionDispatcher.h"
 
 namespace epse
 {
@@ -74,8 +76,15 @@ namespace epse
 			
 		/*!
 		Kill the connection
+		@remark when dispatched on the thread pool, the connection is killed on the dispatch thread after the packets queued before.
 		*/
 		void KillConnection();
+
+		/*!
+		Check if the connection is alive
+		@return true if the connection is alive otherwise false
+		*/
+		virtual bool IsConnectionAlive() const;
 	
 
 		/*!
@@ -130,6 +139,30 @@ namespace epse
 		*/
 		virtual void addPacket(Packet *packet);
 
+		/*!
+		Process the packets queued on the dispatch thread
+		*/
+		virtual void dispatchPackets();
+
+		/*!
+		Set the dispatcher to run this session instead of the own thread
+		@param[in] dispatcher the dispatcher of the server
+		@remark must be set before the first packet is added, and the thread is not started then.
+		*/
+		void setDispatcher(UdpSessionDispatcher *dispatcher);
+
+		/*!
+		Schedule this session to the dispatcher unless already scheduled
+		*/
+		void schedule();
+
+		/*!
+		Process the packets popped from the queue
+		@param[in] packetList the packets popped, released by this function
+		@return true if the close signal is found, otherwise false
+		*/
+		bool processPackets(const vector<Packet*> &packetList);
+
 	private:
 		/*!
 		Default Copy Constructor
@@ -151,7 +184,11 @@ namespace epse
 
 		/// Thread Stop Event
 		/// @remark if this is raised, the thread should quickly stop.
-		epl::EventEx m_threadStopEvent;
+		LightEvent m_threadStopEvent;
+
+		/// Packet Received Event
+		/// @remark raised only when the packet queue turns non-empty.
+		LightEvent m_packetReceivedEvent;
 
 		/// processor thread list
 		ServerObjectList m_processorList;
@@ -162,6 +199,15 @@ namespace epse
 		/// Flag for Asynchronous Receive
 		bool m_isAsynchronousReceive;
 
+		/// dispatcher, NULL if this session runs on its own thread
+		UdpSessionDispatcher *m_dispatcher;
+		/// flag whether this session is scheduled to the dispatcher
+		volatile LONG m_isScheduled;
+		/// flag whether OnNewConnection is called on the dispatch thread
+		bool m_isNewConnectionNotified;
+		/// connection status when dispatched on the thread pool
+		bool m_isConnected;
+
 	};
 
 }
@@ -48,6 +48,7 @@ An Interface for Base Client.
 #include "epBaseServerObject.h"
 #include "epServerConf.h"
 #include "epClientInterfaces.h"
+#include "epResolverCache.h"
 
 #include <windows.h>
 #include <winsock2.h>
@@ -70,6 +71,7 @@ namespace epse{
 	@brief A class for Base Client.
 	*/
 	class EP_SERVER_ENGINE BaseClient:public BaseServerObject,public ClientInterface{
+		friend class ProxyTcpHandler;
 
 	public:
 		/*!
@@ -130,6 +132,7 @@ namespace epse{
 		/*!
 		Set the Callback Object for the server.
 		@param[in] callBackObj The Callback Object to set.
+		@remark waits for the OnReceived or the OnDisconnect in progress on the receiving thread, if synchronous.
 		*/
 		void SetCallbackObject(ClientCallbackInterface *callBackObj);
 
@@ -225,6 +228,8 @@ namespace epse{
 		epl::BaseLock *m_sendLock;
 		/// general lock
 		epl::BaseLock *m_generalLock;
+		/// lock held across the synchronous callbacks, so the Callback Object is not changed in the middle of them
+		epl::BaseLock *m_callBackLock;
 
 		/// Lock Policy
 		epl::LockPolicy m_lockPolicy;
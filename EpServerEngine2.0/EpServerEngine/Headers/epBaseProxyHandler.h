@@ -41,6 +41,9 @@ An Interface for Proxy Base Handler.
 #include "epServerEngine.h"
 #include "epProxyServerInterfaces.h"
 #include "epBaseClient.h"
+#include "epProxyUpstreamGroup.h"
+#include "epProxyForwardQueue.h"
+#include "epLockPolicy.h"
 
 namespace epse{
 
@@ -52,6 +55,7 @@ namespace epse{
 	class BaseProxyHandler:public ServerCallbackInterface, public ClientCallbackInterface{
 
 		friend class BaseProxyServer;
+		friend class ProxyForwardQueue;
 	protected:
 		/*!
 		Default Constructor
@@ -126,18 +130,111 @@ namespace epse{
 		*/
 		sockaddr GetSockAddr() const;
 
+		/*!
+		Get the full socket address of client
+		@return the socket address of client
+		*/
+		SOCKADDR_STORAGE GetSockAddrStorage() const;
+
+		/*!
+		Get the byte size of the socket address of client
+		@return the byte size of the socket address
+		*/
+		int GetSockAddrSize() const;
+
+		/*!
+		Release the client connected to forward server, when the client socket is disconnected.
+		@remark The default is just disconnecting the forward server client.
+		*/
+		virtual void releaseForwardClient();
+
+		/*!
+		Check if connected to forward server
+		@return true if connected, otherwise false
+		*/
+		virtual bool isForwardConnected() const;
+
+		/*!
+		Set the upstream group which the forward server is chosen from, and report the connect to it
+		@param[in] upstreamGroup the upstream group
+		@param[in] upstreamIdx the index of the upstream chosen
+		@param[in] connectTick the tick when started to connect
+		*/
+		void setUpstreamGroup(ProxyUpstreamGroup *upstreamGroup,unsigned int upstreamIdx,unsigned int connectTick);
+
+		/*!
+		Release the upstream chosen from the upstream group
+		*/
+		void releaseUpstreamGroup();
+
+		/*!
+		Forward each direction through a queue, which stops reading the sender over the high watermark
+		@param[in] forwardWorker the worker to forward the queues on
+		@param[in] highWatermarkByteSize the queued byte size to stop reading the sender at
+		@param[in] lowWatermarkByteSize the queued byte size to resume reading the sender at
+		@remark must be called before the forward server client is connected.
+		*/
+		void openForwardQueues(ProxyForwardWorker *forwardWorker,unsigned int highWatermarkByteSize,unsigned int lowWatermarkByteSize);
+
+		/*!
+		Close the queues of both directions
+		*/
+		void closeForwardQueues();
+
+		/*!
+		Forward the packet received from the client through the callback object
+		@param[in] receivedPacket the received packet
+		*/
+		void forwardFromClient(const Packet *receivedPacket);
+
+		/*!
+		Forward the packet received from the forward server through the callback object
+		@param[in] client the forward server client, or NULL for the one currently connected
+		@param[in] receivedPacket the received packet
+		@remark dropped once the forward server client is released.
+		*/
+		void forwardFromForwardServer(ClientInterface *client,const Packet *receivedPacket);
+
+		/*!
+		Check if the peer of the direction takes the data without blocking
+		@param[in] isFromClient flag whether the direction is from the client, otherwise from the forward server
+		@return true if writable, otherwise false
+		@remark The default is always writable.
+		*/
+		virtual bool isWritable(bool isFromClient);
+
+		/*!
+		Abort the session whose peer does not take the queued data in time
+		@remark The default is killing the client connection, so must not be called on its receiving thread.
+		*/
+		virtual void abortClient();
+
 	protected:
 		/// client socket
 		SocketInterface *m_client;
-		/// the client connected to forward server
-		BaseClient *m_forwardClient;
-		/// callback object
-		ProxyServerCallbackInterface *m_callBack;
+		/// the client connected to forward server, exchanged with InterlockedExchangePointer once the handler is built
+		BaseClient * volatile m_forwardClient;
+		/// callback object, read without the lock by both directions
+		ProxyServerCallbackInterface * volatile m_callBack;
+		/// upstream group which the forward server is chosen from
+		ProxyUpstreamGroup *m_upstreamGroup;
+		/// index of the upstream chosen
+		unsigned int m_upstreamGroupIdx;
+		/// queue from the client to the forward server, NULL if not backpressured
+		ProxyForwardQueue *m_fromClientQueue;
+		/// queue from the forward server to the client, NULL if not backpressured
+		ProxyForwardQueue *m_fromForwardServerQueue;
 
 
 		/// general lock 
 		epl::BaseLock *m_baseProxyHandlerLock;
 
+		/// lock of the direction from the client to the forward server, also held to take m_forwardClient away
+		RuntimeLockPolicy m_clientToForwardLock;
+
+		/// lock of the direction from the forward server to the client, also held to take m_forwardClient away
+		RuntimeLockPolicy m_forwardToClientLock;
+
 		/// Lock Policy
 		epl::LockPolicy m_lockPolicy;
 	};
@@ -153,10 +153,11 @@ namespace epse{
 	protected:
 		/*!
 		When new client tries to connect.
-		@param[in] sockAddr the client's socket address which tries to connect
+		@param[in] sockAddr the client's full socket address which tries to connect
+		@param[in] sockAddrSize the byte size of the socket address
 		@return true to accept the connection otherwise false.		
 		*/
-		bool OnAccept(sockaddr sockAddr);
+		bool OnAccept(const sockaddr *sockAddr,int sockAddrSize);
 
 		/*!
 		When accepted client tries to make connection.
@@ -166,6 +167,23 @@ namespace epse{
 		*/
 		virtual void OnNewConnection(SocketInterface *socket)=0;
 
+		/*!
+		Choose the forward server for the client from the upstream group, or get it from the callback object
+		@param[in] socket the client socket
+		@param[out] retForwardServerInfo the forward server info
+		@param[out] retUpstreamIdx the index of the upstream chosen
+		@return the upstream group chosen from, or NULL if got from the callback object
+		@remark m_baseProxyServerLock must be held.
+		*/
+		ProxyUpstreamGroup *selectForwardServer(SocketInterface *socket,ForwardServerInfo &retForwardServerInfo,unsigned int &retUpstreamIdx);
+
+		/*!
+		Add the handler built without the lock to the handler list
+		@param[in] handler the handler built
+		@param[in] callBack the callback object the handler was built with
+		@remark the handler gets the current callback object, if it was changed meanwhile.
+		*/
+		void addHandler(BaseProxyHandler *handler,ProxyServerCallbackInterface *callBack);
 	
 
 	protected:
@@ -178,6 +196,9 @@ namespace epse{
 		/// Callback Object
 		ProxyServerCallbackInterface *m_callBack;
 
+		/// Upstream group to choose the forward server from
+		ProxyUpstreamGroup *m_upstreamGroup;
+
 		/// general lock 
 		epl::BaseLock *m_baseProxyServerLock;
 
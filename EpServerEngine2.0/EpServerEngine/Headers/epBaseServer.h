@@ -176,6 +176,26 @@ namespace epse{
 		*/
 		void ShutdownAllClient();
 
+		/*!
+		Get the server-wide memory budget
+		@return the server-wide memory budget
+		*/
+		MemoryBudget *GetMemoryBudget();
+
+		/*!
+		Set the memory budget for each connection.
+		@param[in] budgetByteSize The memory budget in byte to set.
+		@remark 0 means there is no limit
+		*/
+		void SetConnectionMemoryBudgetByteSize(size_t budgetByteSize);
+
+		/*!
+		Get the memory budget for each connection.
+		@return the memory budget in byte
+		@remark 0 means there is no limit
+		*/
+		size_t GetConnectionMemoryBudgetByteSize() const;
+
 	protected:
 		/*!
 		Actually set the port for the server.
@@ -241,6 +261,12 @@ namespace epse{
 	
 		/// Callback Object
 		ServerCallbackInterface *m_callBackObj;
+
+		/// server-wide memory budget
+		MemoryBudget *m_memoryBudget;
+
+		/// memory budget for each connection
+		size_t m_connectionMemoryBudget;
 	};
 }
 #endif //__EP_BASE_SERVER_H__
\ No newline at end of file
@@ -43,6 +43,32 @@ An Interface for Base Server Object.
 
 namespace epse{
 
+	class BaseServerObject;
+
+	/*! 
+	@class ServerObjectContainer epBaseServerObject.h
+	@brief An Interface for the container of Base Server Objects.
+	*/
+	class EP_SERVER_ENGINE ServerObjectContainer{
+	public:
+		/*!
+		Default Destructor
+
+		Destroy the Container
+		*/
+		virtual ~ServerObjectContainer(){}
+
+	protected:
+		friend class BaseServerObject;
+
+		/*!
+		Remove the given object from the container
+		@param[in] serverObj the server object to remove
+		@return true if successfully removed otherwise false
+		*/
+		virtual bool Remove(const BaseServerObject* serverObj)=0;
+	};
+
 	/*! 
 	@class BaseServerObject epBaseServerObject.h
 	@brief A class for Base Server Object.
@@ -97,7 +123,7 @@ namespace epse{
 
 		
 	protected:
-		friend class ServerObjectList;
+		template<typename LockPolicyType> friend class BasicServerObjectList;
 
 
 
@@ -105,7 +131,7 @@ namespace epse{
 		Set Container
 		@param[in] container the new container for this object
 		*/
-		void setContainer(ServerObjectList *container);
+		void setContainer(ServerObjectContainer *container);
 
 		/*!
 		Remove self from the container
@@ -120,7 +146,9 @@ namespace epse{
 		unsigned int m_waitTime;
 
 		/// Container
-		ServerObjectList *m_container;
+		ServerObjectContainer *m_container;
+		/// index in the container list (guarded by the container)
+		size_t m_containerIndex;
 
 		/// container lock
 		epl::BaseLock *m_containerLock;
@@ -43,6 +43,7 @@ An Interface for Base Socket.
 #include "epServerPacketProcessor.h"
 #include "epServerConf.h"
 #include "epServerObjectList.h"
+#include "epMessageArena.h"
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -112,6 +113,18 @@ namespace epse
 		*/
 		sockaddr GetSockAddr() const;
 
+		/*!
+		Get the full socket address of this socket object.
+		@return the socket address of this socket object.
+		*/
+		virtual SOCKADDR_STORAGE GetSockAddrStorage() const;
+
+		/*!
+		Get the byte size of the socket address of this socket object.
+		@return the byte size of the socket address.
+		*/
+		virtual int GetSockAddrSize() const;
+
 		/*!
 		Get the IP of client
 		@return the IP of client in string
@@ -125,6 +138,14 @@ namespace epse
 		*/
 		static epl::EpTString GetIP(sockaddr socketAddr);
 
+		/*!
+		Get the IP of client
+		@param[in] socketAddr the socket address info
+		@param[in] sockAddrSize the byte size of the socket address
+		@return the IP of client in string
+		*/
+		static epl::EpTString GetIP(const sockaddr *socketAddr,int sockAddrSize);
+
 		
 		/*!
 		Get the owner object of this socket object.
@@ -157,6 +178,19 @@ namespace epse
 		*/
 		ServerCallbackInterface *GetCallbackObject();
 
+		/*!
+		Get the arena for the transient allocations of the message currently dispatched
+		@return the arena of the current dispatch, NULL if not available
+		@remark the arena is reset after OnReceived returns.
+		*/
+		virtual MessageArena *GetArena();
+
+		/*!
+		Get the memory budget of this connection
+		@return the memory budget of this connection
+		*/
+		virtual MemoryBudget *GetMemoryBudget();
+
 
 	protected:	
 		friend class IocpServerProcessor;
@@ -186,8 +220,16 @@ namespace epse
 		/*!
 		Set the Sock Address for this socket.
 		@param[in] sockAddr The Sock Address for this socket.
+		@param[in] sockAddrSize the byte size of the Sock Address
 		*/
-		virtual void setSockAddr(sockaddr sockAddr);
+		virtual void setSockAddr(const sockaddr *sockAddr,int sockAddrSize);
+
+		/*!
+		Set the memory budget for this socket.
+		@param[in] serverBudget the server-wide memory budget to be charged together
+		@param[in] budgetByteSize the memory budget in byte for this socket
+		*/
+		void setMemoryBudget(MemoryBudget *serverBudget,size_t budgetByteSize);
 
 
 	protected:
@@ -224,7 +266,16 @@ namespace epse
 		ServerCallbackInterface *m_callBackObj;
 
 		///Sock Address
-		sockaddr m_sockAddr;
+		SOCKADDR_STORAGE m_sockAddr;
+
+		/// byte size of the Sock Address
+		int m_sockAddrSize;
+
+		/// Arena for the messages dispatched by the socket thread
+		MessageArena m_arena;
+
+		/// memory budget of this connection
+		MemoryBudget *m_memoryBudget;
 	};
 
 }
@@ -114,6 +114,22 @@ namespace epse{
 		*/
 		int receive(Packet &packet);
 
+		/*!
+		Resolve the server, and connect to the first of its addresses to accept the connection
+		@param[out] retStatus the status of Connect
+		@return true if connected, otherwise false
+		@remark the addresses of the different families are raced, each started after the attempt delay<br/>
+		        or as soon as the previous one failed, until m_connectTimeOutMilliSec passed.
+		*/
+		bool connectToServer(ConnectStatus &retStatus);
+
+		/*!
+		Cancel the connect left to the thread of the client, and wait until OnConnected returned
+		@return true if a connect was pending, and the thread of the client is ending, otherwise false
+		@remark returns false without waiting when called from OnConnected.
+		*/
+		bool cancelConnect();
+
 		/*!
 		Actually processing the client thread
 		*/
@@ -130,6 +146,15 @@ namespace epse{
 		/// Temp Packet;
 		Packet m_recvSizePacket;
 
+		/// time to give up connecting
+		unsigned int m_connectTimeOutMilliSec;
+
+		/// flag whether the connect is left to the thread of the client, cleared after OnConnected returned
+		volatile bool m_isConnectPending;
+
+		/// flag whether the connect in progress is canceled
+		volatile bool m_isConnectCanceled;
+
 
 	};
 }
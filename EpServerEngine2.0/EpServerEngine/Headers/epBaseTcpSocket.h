@@ -88,6 +88,9 @@ namespace epse
 	protected:	
 		friend class SyncTcpServer;
 		friend class AsyncTcpServer;
+		friend class ProxyTcpRelay;
+		friend class ProxyMuxHandler;
+		friend class ProxyTcpHandler;
 		/*!
 		Actually Kill the connection
 		*/
@@ -105,6 +108,13 @@ namespace epse
 		@return received byte size
 		*/
 		int receive(Packet &packet);
+
+		/*!
+		Peek the byte size of the next packet without consuming it
+		@param[out] byteSize the byte size of the next packet
+		@return true if the byte size is available, otherwise false
+		*/
+		bool peekPacketByteSize(unsigned int &byteSize);
 	
 		/*!
 		Set the argument for the base server worker thread.
@@ -112,6 +122,25 @@ namespace epse
 		*/
 		void setClientSocket(const SOCKET& clientSocket );
 
+		/*!
+		Send the next part of the packet framed as Send does, only if the socket is writable now
+		@param[in] packet the packet to be sent
+		@param[in,out] offset the byte offset into the frame sent so far
+		@param[in] maxByteSize the maximum byte size to write with this call
+		@param[in] sendStatus the status of the send, SEND_STATUS_FAIL_TIME_OUT if not writable
+		@return sent byte size
+		@remark return -1 if error occurred
+		@remark no other send may be made on the socket until the whole frame is sent.
+		*/
+		int sendPart(const Packet &packet,unsigned int &offset,unsigned int maxByteSize,SendStatus *sendStatus);
+
+		/*!
+		Get the byte size of the packet framed as Send does
+		@param[in] packet the packet
+		@return the byte size of the length header and the packet, 0 for the empty packet
+		*/
+		static unsigned int getFrameByteSize(const Packet &packet);
+
 
 
 	protected:
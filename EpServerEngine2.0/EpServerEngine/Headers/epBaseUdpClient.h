@@ -42,6 +42,13 @@ An Interface for Base UDP Client.
 #include "epBaseClient.h"
 #include "epServerObjectList.h"
 #include "epClientPacketProcessor.h"
+#include "epUdpChannel.h"
+#include "epUdpFragment.h"
+#include "epUdpCoalescer.h"
+#include "epUdpSessionTable.h"
+#include <queue>
+#include <vector>
+using namespace std;
 
 
 namespace epse{
@@ -50,7 +57,7 @@ namespace epse{
 	@class BaseUdpClient epBaseUdpClient.h
 	@brief A class for Base UDP Client.
 	*/
-	class EP_SERVER_ENGINE BaseUdpClient:public BaseClient{
+	class EP_SERVER_ENGINE BaseUdpClient:public BaseClient,public UdpChannelTransportInterface,public UdpFragmentTransportInterface,public UdpCoalescerTransportInterface{
 
 	public:
 		/*!
@@ -110,8 +117,45 @@ namespace epse{
 		@param[in] sendStatus the status of Send
 		@return sent byte size
 		@remark return -1 if error occurred
+		@remark sent on the channel 0 if the channel layer is used.
+		@remark buffered until the datagram is full or the flush delay has passed if the coalescing is used.
 		*/
 		virtual int Send(const Packet &packet, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the packets buffered for the coalescing now
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of Flush
+		@return sent byte size
+		@remark return -1 if error occurred
+		@remark does nothing if the coalescing is not used.
+		*/
+		int Flush(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the packet to the server on the channel
+		@param[in] channelId the channel id
+		@param[in] packet the packet to be sent
+		@param[in] waitTimeInMilliSec wait time for sending the packet in millisecond
+		@param[in] sendStatus the status of SendOnChannel
+		@return sent byte size, or queued byte size when the congestion window is full
+		@remark return -1 if error occurred
+		@remark the packet must be UDP_CHANNEL_HEADER_BYTE_SIZE shorter than the maximum packet byte size.
+		@remark the packet is received with the channel id by OnReceived of the server.
+		*/
+		int SendOnChannel(unsigned int channelId,const Packet &packet, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Get the number of the channels
+		@return the number of the channels, 0 if the channel layer is not used
+		*/
+		unsigned int GetChannelCount() const;
+
+		/*!
+		Get the smoothed round trip time measured by the channel layer
+		@return the round trip time in millisecond, 0 if not measured
+		*/
+		unsigned int GetRoundTripTime() const;
 	
 	protected:
 		/*!
@@ -123,9 +167,106 @@ namespace epse{
 		/*!
 		Receive the packet from the server
 		@param[out] packet the packet received
+		@param[out] isMoveNotice set to true if the move notice of the server is received, which is answered and not delivered
 		@return received byte size
 		*/
-		int receive(Packet &packet);
+		int receive(Packet &packet,bool &isMoveNotice);
+
+		/*!
+		Move the datagrams sent to the port of the server the move notice came from, and answer it from there
+		@param[in] sourceSockAddr the source address of the empty datagram received
+		@param[in] sourceSockAddrSize the byte size of the source address
+		@return true if it was the move notice, otherwise false
+		@remark the move notice is an empty datagram from the same host as the server, on another port.
+		*/
+		bool answerMoveNotice(const sockaddr *sourceSockAddr,int sourceSockAddrSize);
+
+		/*!
+		Send the packet to the server as it is
+		@param[in] packet the packet to be sent
+		@param[in] waitTimeInMilliSec wait time for sending the packet in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		*/
+		int sendTo(const Packet &packet, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the buffers gathered as one datagram to the server
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		*/
+		int sendBuffers(const WSABUF *buffers,unsigned int bufferCount, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Set up the coalescing, the fragmentation and the channel layer with the options given
+		@param[in] ops the client options
+		@return true if set up or not used, otherwise false
+		*/
+		bool setUpSession(const ClientOps &ops);
+
+		/*!
+		Convert the datagram received to the packets to deliver
+		@param[in] packetData the datagram received
+		@param[in] recvLength the byte size of the datagram
+		@param[out] packetList the packets to deliver, which must be released by the caller
+		@remark none for the datagram carrying the acknowledgement only.
+		*/
+		void unpackDatagram(const char *packetData,int recvLength,vector<Packet*> &packetList);
+
+		/*!
+		Convert the message unpacked from a datagram to the packets to deliver
+		@param[in] messageData the message
+		@param[in] messageLength the byte size of the message
+		@param[out] packetList the packets to deliver, which must be released by the caller
+		*/
+		void unpackMessage(const char *messageData,int messageLength,vector<Packet*> &packetList);
+
+		/*!
+		Keep the packets for the following Receive calls
+		@param[in] packetList the packets to keep
+		@param[in] startIndex the index of the first packet to keep
+		*/
+		void pushChannelPackets(const vector<Packet*> &packetList,size_t startIndex);
+
+		/*!
+		Take the packet kept for Receive
+		@return the packet kept, NULL if none
+		*/
+		Packet *popChannelPacket();
+
+		/*!
+		Send the datagram built by the channel session
+		@param[in] datagram the datagram to send
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		*/
+		virtual int SendDatagram(const Packet &datagram,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
+		/*!
+		Send the buffers gathered as one datagram built by the fragmenter
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		*/
+		virtual int SendBuffers(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
+		/*!
+		Send the buffers gathered as one datagram built by the coalescer
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		*/
+		virtual int SendCoalesced(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
 
 		/*!
 		Actually processing the client thread
@@ -152,6 +293,39 @@ namespace epse{
 		/// internal variable2
 		struct addrinfo *m_ptr;
 
+		/// server address connected to
+		UdpSessionAddress m_serverAddress;
+		/// address the datagrams are sent to, moved to another port of the server by the move notice
+		UdpSessionAddress m_sendAddress;
+		/// flag whether the server may move the session to another port
+		bool m_isUdpSessionMovable;
+
+		/// channel types, empty if the channel layer is not used
+		vector<UdpChannelType> m_channelTypeList;
+		/// channel session, NULL if the channel layer is not used
+		UdpChannelSession *m_channelSession;
+		/// timer of the channel session and the coalescer
+		UdpChannelTimer m_channelTimer;
+		/// packets delivered by the channel session, kept for Receive
+		queue<Packet*> m_channelPacketList;
+		/// channel packet list lock
+		RuntimeLockPolicy m_channelListLock;
+
+		/// fragmenter, NULL if the fragmentation is not used
+		UdpFragmenter *m_fragmenter;
+
+		/// coalescer, NULL if the coalescing is not used
+		UdpCoalescer *m_coalescer;
+
+	private:
+		/*!
+		Wait for the connect socket to be writable
+		@param[in] waitTimeInMilliSec wait time in millisecond
+		@param[in] sendStatus the status of the wait
+		@return positive if writable, otherwise 0 for time-out or SOCKET_ERROR
+		*/
+		int waitForWritable(unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
 	};
 }
 
@@ -41,8 +41,15 @@ An Interface for Base UDP Server.
 
 #include "epServerEngine.h"
 #include "epBaseServer.h"
+#include "epUdpSessionTable.h"
+#include "epUdpReceiveThread.h"
+#include "epUdpOffload.h"
+#include "epUdpChannel.h"
+#include "epUdpFragment.h"
+#include "epUdpConnectedReceiver.h"
 
 namespace epse{
+	class BaseUdpSocket;
 
 	/*! 
 	@class BaseUdpServer epBaseUdpServer.h
@@ -53,6 +60,9 @@ namespace epse{
 		friend class AsyncUdpSocket;
 		friend class SyncUdpSocket;
 		friend class BaseUdpSocket;
+		friend class UdpReceiveShard;
+		friend class UdpReceiveThread;
+		friend class UdpConnectedReceiver;
 	public:
 		
 		/*!
@@ -103,12 +113,73 @@ namespace epse{
 		*/
 		unsigned int GetMaxPacketByteSize() const;
 
+		/*!
+		Send all the datagrams queued by SendBatch of the sockets
+		@param[in] waitTimeInMilliSec wait time for sending the datagrams in millisecond
+		@param[in] sendStatus the status of the flush
+		@param[out] retFailedCount the number of the datagrams failed to send
+		@return sent byte size of the datagrams sent
+		@remark return -1 if the wait failed or no datagram was sent
+		@remark sendStatus is SEND_STATUS_FAIL_SEND_FAILED if any datagram failed, and the failed datagrams are dropped.
+		@remark the queue is sent with one send lock and one select, then one sendto per datagram.
+		*/
+		int FlushSendQueue(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL,unsigned int *retFailedCount=NULL);
+
+		/*!
+		Get the maximum number of the datagrams queued before flushed
+		@return the maximum number of the datagrams queued before flushed
+		*/
+		unsigned int GetUdpSendQueueCount() const;
+
+		/*!
+		Get the combination of UdpOffloadFlag requested
+		@return the combination of UdpOffloadFlag
+		*/
+		unsigned int GetUdpOffloadFlags() const;
+
+		/*!
+		Get the flag whether the packets larger than the path MTU are fragmented
+		@return true if the fragmentation is used, otherwise false
+		*/
+		bool GetIsUdpFragmentation() const;
+
+		/*!
+		Get the time in millisecond a small packet may wait to share a datagram with the others
+		@return the flush delay in millisecond, 0 if the coalescing is not used
+		*/
+		unsigned int GetUdpCoalesceDelayMilliSec() const;
+
+		/*!
+		Get the number of the packets received in a second, at which a session is moved to its own connected socket
+		@return the packet rate, 0 if the sessions are not moved
+		*/
+		unsigned int GetUdpConnectPacketRate() const;
+
 	protected:
 	
 		/*!
 		Listening Loop Function
+
+		Runs the receive loop with the receive threads.
+		*/
+		virtual void execute();
+
+		/*!
+		Receiving Loop Function
+		@remark run by the server thread and each receive thread on the listen socket.
+		@remark handles each datagram in the shard chosen by the seeded hash of the client address, if any.
 		*/
-		virtual void execute()=0;
+		void receiveLoop();
+
+		/*!
+		Handle the datagram received from the client
+		@param[in] packetData the datagram
+		@param[in] recvLength the result of the receive
+		@param[in] clientAddress the client address
+		@param[in] segmentByteSize the segment byte size of the coalesced datagrams, 0 if not coalesced
+		@remark the datagrams of a client are never handled concurrently.
+		*/
+		virtual void handleDatagram(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize)=0;
 	
 		/*!
 		Clean up the server initialization.
@@ -133,6 +204,102 @@ namespace epse{
 		*/
 		int send(const Packet &packet,const sockaddr &clientSockAddr, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
 
+		/*!
+		Send the packet to the client
+		@param[in] packet the packet to be sent
+		@param[in] clientSockAddr the client socket address, which the packet will be delivered
+		@param[in] sockAddrSize the byte size of the client socket address
+		@param[in] waitTimeInMilliSec wait time for sending the packet in millisecond
+		@param[in] sendStatus the status of Send
+		@return sent byte size
+		@remark return -1 if error occurred
+		*/
+		int send(const Packet &packet,const sockaddr *clientSockAddr,int sockAddrSize, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the packets to the client in a batch
+		@param[in] packets the packets to be sent
+		@param[in] packetCount the number of the packets
+		@param[in] clientAddress the client address, which the packets will be delivered
+		@param[in] waitTimeInMilliSec wait time for sending the packets in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size, or queued byte size when the send queue is on
+		@remark return -1 if error occurred
+		*/
+		int sendBatch(const Packet *const *packets,unsigned int packetCount,const UdpSessionAddress &clientAddress, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the packet to the client as a train of datagrams
+		@param[in] packet the packet to be sent
+		@param[in] segmentByteSize the byte size of each datagram
+		@param[in] clientAddress the client address, which the datagrams will be delivered
+		@param[in] isOffload flag whether to use the segmentation offload
+		@param[in] waitTimeInMilliSec wait time for sending the datagrams in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		*/
+		int sendSegmented(const Packet &packet,unsigned int segmentByteSize,const UdpSessionAddress &clientAddress,bool isOffload, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the buffers gathered as one datagram to the client
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] clientAddress the client address, which the datagram will be delivered
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		*/
+		int sendBuffers(const WSABUF *buffers,unsigned int bufferCount,const UdpSessionAddress &clientAddress, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the buffers gathered as one datagram on the connected socket of a session
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] connectedSocket the connected socket of the session
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		@remark sent without the send lock, since the socket is not shared with the other sessions.
+		*/
+		int sendConnected(const WSABUF *buffers,unsigned int bufferCount,SOCKET connectedSocket, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Receive the datagram, or the coalesced datagrams on the listen socket
+		@param[out] packetData the buffer to receive
+		@param[in] length the byte size of the buffer
+		@param[out] clientSockAddr the client socket address
+		@param[in,out] sockAddrSize the byte size of the client socket address
+		@param[out] segmentByteSize the byte size of each coalesced datagram, 0 if not coalesced
+		@return received byte size
+		*/
+		int receiveFrom(char *packetData,int length,sockaddr *clientSockAddr,int *sockAddrSize,unsigned int *segmentByteSize);
+
+		/*!
+		Deliver the received data to the socket as the original datagrams
+		@param[in] socket the socket to deliver
+		@param[in] packetData the received data
+		@param[in] recvLength the received byte size
+		@param[in] segmentByteSize the byte size of each coalesced datagram, 0 if not coalesced
+		*/
+		void deliverPacket(BaseUdpSocket *socket,const char *packetData,int recvLength,unsigned int segmentByteSize);
+
+		/*!
+		Set up the new session socket, and add it to the socket list and the session table
+		@param[in] socket the new session socket
+		@param[in] clientAddress the client address of the session
+		*/
+		void addSession(BaseUdpSocket *socket,const UdpSessionAddress &clientAddress);
+
+		/*!
+		Create the socket for the session on its own port, connected to the client
+		@param[in] socket the session socket
+		@return the connected socket, INVALID_SOCKET if failed
+		*/
+		SOCKET createConnectedSocket(const BaseUdpSocket *socket);
+
 
 		/*!
 		Compare given clientSocket with BaseServerObject's socket
@@ -151,6 +318,100 @@ namespace epse{
 		/// send lock
 		epl::BaseLock *m_sendLock;
 
+		/// session table by the client address
+		UdpSessionTable m_sessionTable;
+
+		/// session creation lock
+		RuntimeLockPolicy m_acceptLock;
+
+	private:
+		/// datagram queued for the send
+		struct QueuedDatagram{
+			/// packet to send
+			Packet *m_packet;
+			/// client address
+			UdpSessionAddress m_address;
+		};
+
+		/*!
+		Wait for the socket to be writable
+		@param[in] sendSocket the listen socket or the connected socket of a session
+		@param[in] waitTimeInMilliSec wait time in millisecond
+		@param[in] sendStatus the status of the wait
+		@return positive if writable, otherwise 0 for time-out or SOCKET_ERROR
+		*/
+		int waitForWritable(SOCKET sendSocket,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
+		/*!
+		Send the datagrams with one wait under the send lock
+		@param[in] datagrams the datagrams to send
+		@param[in] datagramCount the number of the datagrams
+		@param[in] waitTimeInMilliSec wait time in millisecond
+		@param[in] sendStatus the status of the send
+		@param[out] retFailedCount the number of the datagrams failed to send
+		@return sent byte size of the datagrams sent
+		@remark return -1 if the wait failed or no datagram was sent
+		@remark a failed datagram does not stop the rest.
+		*/
+		int sendDatagrams(const QueuedDatagram *datagrams,size_t datagramCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus,unsigned int *retFailedCount=NULL);
+
+		/*!
+		Release the queued datagrams
+		*/
+		void clearSendQueue();
+
+		/*!
+		Deliver a datagram to the socket through the coalescing, the fragmentation and the channel layer of the socket if any
+		@param[in] socket the socket to deliver
+		@param[in] packetData the datagram
+		@param[in] datagramLength the byte size of the datagram
+		*/
+		void deliverDatagram(BaseUdpSocket *socket,const char *packetData,int datagramLength);
+
+		/*!
+		Deliver a message unpacked from a datagram to the socket through the fragmentation and the channel layer of the socket if any
+		@param[in] socket the socket to deliver
+		@param[in] messageData the message
+		@param[in] messageLength the byte size of the message
+		*/
+		void deliverMessage(BaseUdpSocket *socket,const char *messageData,int messageLength);
+
+	private:
+		/// maximum number of the datagrams queued before flushed
+		unsigned int m_udpSendQueueCount;
+		/// send queue lock
+		RuntimeLockPolicy m_sendQueueLock;
+		/// queued datagrams
+		vector<QueuedDatagram> m_sendQueue;
+
+		/// number of the threads receiving on the listen socket
+		unsigned int m_udpReceiveThreadCount;
+		/// threads receiving with the server thread, used by the server thread only
+		vector<UdpReceiveThread*> m_receiveThreadList;
+		/// shards of the received datagrams by the client address, empty if received on the server thread only
+		vector<UdpReceiveShard*> m_receiveShardList;
+
+		/// combination of UdpOffloadFlag requested
+		unsigned int m_udpOffloadFlags;
+		/// offload of the listen socket
+		UdpOffload m_offload;
+
+		/// channel types of each session, empty if the channel layer is not used
+		vector<UdpChannelType> m_channelTypeList;
+		/// timer of the channel sessions
+		UdpChannelTimer m_channelTimer;
+
+		/// flag whether the packets larger than the path MTU are fragmented
+		bool m_isUdpFragmentation;
+
+		/// time in millisecond a small packet may wait to share a datagram, 0 if the coalescing is not used
+		unsigned int m_udpCoalesceDelayMilliSec;
+
+		/// number of the packets received in a second, at which a session is moved to its own connected socket
+		unsigned int m_udpConnectPacketRate;
+		/// receiver of the sessions moved to their own connected sockets
+		UdpConnectedReceiver m_connectedReceiver;
+
 	};
 }
 #endif //__EP_BASE_UDP_SERVER_H__
\ No newline at end of file
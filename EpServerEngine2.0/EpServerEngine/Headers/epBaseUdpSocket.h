@@ -40,7 +40,12 @@ An Interface for Base UDP Socket.
 
 #include "epServerEngine.h"
 #include "epBaseSocket.h"
-#include <queue>
+#include "epLockPolicy.h"
+#include "epUdpSessionTable.h"
+#include "epUdpChannel.h"
+#include "epUdpFragment.h"
+#include "epUdpCoalescer.h"
+#include "epUdpPacketQueue.h"
 using namespace std;
 
 namespace epse
@@ -50,10 +55,15 @@ namespace epse
 	@class BaseUdpSocket epBaseUdpSocket.h
 	@brief A class for Base UDP Socket.
 	*/
-	class EP_SERVER_ENGINE BaseUdpSocket:public BaseSocket
+	class EP_SERVER_ENGINE BaseUdpSocket:public BaseSocket,public UdpChannelTransportInterface,public UdpFragmentTransportInterface,public UdpCoalescerTransportInterface
 	{
 		friend class SyncUdpServer;
 		friend class AsyncUdpServer;
+		friend class IocpUdpServer;
+		friend class BaseUdpServer;
+		friend class UdpDispatchThread;
+		friend class UdpSessionDispatcher;
+		friend class UdpConnectedReceiver;
 	public:
 		/*!
 		Default Constructor
@@ -80,9 +90,86 @@ namespace epse
 		@param[in] sendStatus the status of Send
 		@return sent byte size
 		@remark return -1 if error occurred
+		@remark sent on the channel 0 if the channel layer is used.
+		@remark sent in the fragments if the fragmentation is used.
+		@remark buffered until the datagram is full or the flush delay has passed if the coalescing is used.
 		*/
 		int Send(const Packet &packet, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
 
+		/*!
+		Send the packets buffered for the coalescing now
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of Flush
+		@return sent byte size
+		@remark return -1 if error occurred
+		@remark does nothing if the coalescing is not used.
+		*/
+		int Flush(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the packet to the client on the channel
+		@param[in] channelId the channel id
+		@param[in] packet the packet to be sent
+		@param[in] waitTimeInMilliSec wait time for sending the packet in millisecond
+		@param[in] sendStatus the status of SendOnChannel
+		@return sent byte size, or queued byte size when the congestion window is full
+		@remark return -1 if error occurred
+		@remark the packet must be UDP_CHANNEL_HEADER_BYTE_SIZE shorter than the maximum packet byte size.
+		@remark the packet is received with the channel id by OnReceived of the peer.
+		*/
+		int SendOnChannel(unsigned int channelId,const Packet &packet, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Get the number of the channels
+		@return the number of the channels, 0 if the channel layer is not used
+		*/
+		unsigned int GetChannelCount() const;
+
+		/*!
+		Get the smoothed round trip time measured by the channel layer
+		@return the round trip time in millisecond, 0 if not measured
+		*/
+		unsigned int GetRoundTripTime() const;
+
+		/*!
+		Send the packets to the client in a batch
+		@param[in] packets the packets to be sent
+		@param[in] packetCount the number of the packets
+		@param[in] waitTimeInMilliSec wait time for sending the packets in millisecond
+		@param[in] sendStatus the status of SendBatch
+		@return sent byte size, or queued byte size when the send queue of the server is on
+		@remark return -1 if error occurred
+		@remark the queued packets are sent by FlushSendQueue of the server.
+		@remark bypasses the channel layer, the fragmentation and the coalescing.
+		*/
+		virtual int SendBatch(const Packet *const *packets,unsigned int packetCount, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the packet to the client as a train of datagrams
+		@param[in] packet the packet to be sent
+		@param[in] segmentByteSize the byte size of each datagram
+		@param[in] waitTimeInMilliSec wait time for sending the datagrams in millisecond
+		@param[in] sendStatus the status of SendSegmented
+		@return sent byte size
+		@remark return -1 if error occurred
+		@remark the packet is split into segmentByteSize datagrams, where only the last one can be short.
+		@remark uses the segmentation offload if enabled and supported, otherwise sends the datagrams separately.
+		@remark bypasses the channel layer, the fragmentation and the coalescing.
+		*/
+		int SendSegmented(const Packet &packet,unsigned int segmentByteSize, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Set whether to use the segmentation offload for SendSegmented
+		@param[in] isSegmentOffload flag whether to use the segmentation offload
+		*/
+		void SetSegmentOffload(bool isSegmentOffload);
+
+		/*!
+		Get whether to use the segmentation offload for SendSegmented
+		@return true if the segmentation offload is used, otherwise false
+		*/
+		bool GetSegmentOffload() const;
+
 		
 		/*!
 		Kill the connection
@@ -116,12 +203,115 @@ namespace epse
 		@param[in] packet the new packet received from client
 		*/
 		virtual void addPacket(Packet *packet)=0;
+
+		/*!
+		Process the packets queued on the dispatch thread
+		@remark called only for the sessions scheduled to the UdpSessionDispatcher.
+		*/
+		virtual void dispatchPackets(){}
 	
 		/*!
 		Set the maximum packet byte size
 		@param[in] maxPacketSize the maximum packet byte size to set
 		*/
 		void setMaxPacketByteSize(unsigned int maxPacketSize);
+
+		/*!
+		Set the client address of the session
+		@param[in] sessionAddress the client address
+		*/
+		void setSessionAddress(const UdpSessionAddress &sessionAddress);
+
+		/*!
+		Remove self from the session table and the channel timer of the owner server
+		*/
+		void removeSelfFromSessionTable();
+
+		/*!
+		Set the channel session
+		@param[in] channelSession the channel session, which is deleted by this socket
+		*/
+		void setChannelSession(UdpChannelSession *channelSession);
+
+		/*!
+		Set the fragmenter
+		@param[in] fragmenter the fragmenter, which is deleted by this socket
+		*/
+		void setFragmenter(UdpFragmenter *fragmenter);
+
+		/*!
+		Set the coalescer
+		@param[in] coalescer the coalescer, which is deleted by this socket
+		*/
+		void setCoalescer(UdpCoalescer *coalescer);
+
+		/*!
+		Count the packet received on the listen socket, and move the session to its own connected socket at the packet rate
+		@param[in] packetRate the number of the packets received in a second, at which the session is moved
+		@remark the move notice is sent again each second until the client answers on the new port.
+		*/
+		void updateReceiveRate(unsigned int packetRate);
+
+		/*!
+		Send the move notice on the connected socket
+		@remark called with the connected socket lock held.
+		*/
+		void sendConnectNotice();
+
+		/*!
+		Mark that the client answered on the connected socket, so the datagrams are sent from it
+		*/
+		void setConnected();
+
+		/*!
+		Stop using the connected socket, before it is closed by the connected session receiver
+		*/
+		void clearConnectedSocket();
+
+		/*!
+		Send the buffers gathered as one datagram to the client as it is
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark sent on the connected socket once the client moved to it, otherwise on the listen socket.
+		*/
+		int sendBuffers(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
+		/*!
+		Send the datagram built by the channel session
+		@param[in] datagram the datagram to send
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		*/
+		virtual int SendDatagram(const Packet &datagram,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
+		/*!
+		Close the session as the reliable message is not acknowledged
+		*/
+		virtual void OnChannelFailed();
+
+		/*!
+		Send the buffers gathered as one datagram built by the fragmenter
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		*/
+		virtual int SendBuffers(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
+		/*!
+		Send the buffers gathered as one datagram built by the coalescer
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		*/
+		virtual int SendCoalesced(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
 	protected:
 		/*!
 		Default Copy Constructor
@@ -144,11 +334,48 @@ namespace epse
 		/// Maximum UDP Datagram byte size
 		unsigned int m_maxPacketSize;
 
-		/// list lock 
-		epl::BaseLock *m_listLock;
+		/// client address of the session
+		UdpSessionAddress m_sessionAddress;
+
+		/// flag whether to use the segmentation offload
+		bool m_isSegmentOffload;
+
+		/// channel session, NULL if the channel layer is not used
+		UdpChannelSession *m_channelSession;
+
+		/// fragmenter, NULL if the fragmentation is not used
+		UdpFragmenter *m_fragmenter;
+
+		/// coalescer, NULL if the coalescing is not used
+		UdpCoalescer *m_coalescer;
+
+		/// state of the move to the connected socket
+		typedef enum _connectState{
+			/// on the listen socket
+			CONNECT_STATE_NONE=0,
+			/// move notice sent, and the client not answered yet
+			CONNECT_STATE_PENDING,
+			/// the client answered, so sent on the connected socket
+			CONNECT_STATE_CONNECTED,
+			/// failed or closed, and not tried again
+			CONNECT_STATE_CLOSED,
+		}ConnectState;
+
+		/// socket connected to the client, INVALID_SOCKET if none
+		SOCKET m_connectedSocket;
+		/// ConnectState of the session
+		volatile LONG m_connectState;
+		/// number of the move notices sent
+		unsigned int m_connectNoticeCount;
+		/// number of the packets received since m_receiveTick
+		unsigned int m_receiveCount;
+		/// tick count when the packet rate measurement started
+		DWORD m_receiveTick;
+		/// connected socket lock, held while sending on it
+		RuntimeLightLockPolicy m_connectLock;
 
-		/// Packet List
-		queue<Packet*> m_packetList;
+		/// Packet Queue
+		UdpPacketQueue m_packetQueue;
 	};
 
 }
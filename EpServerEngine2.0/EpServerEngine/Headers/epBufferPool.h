@@ -0,0 +1,196 @@
+/*! 
+@file epBufferPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Buffer Pool Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Buffer Pool.
+
+*/
+#ifndef __EP_BUFFER_POOL_H__
+#define __EP_BUFFER_POOL_H__
+
+#include "epServerEngine.h"
+#include "epLockPolicy.h"
+#include "epServerConf.h"
+#include <vector>
+
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class BufferPool epBufferPool.h
+	@brief A class for fixed-size I/O Buffer Pool.
+
+	The pool can be backed by the large pages, and allocated on the NUMA node of the thread creating it.
+	*/
+	class EP_SERVER_ENGINE BufferPool:public epl::SmartObject{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Buffer Pool
+		@param[in] bufferByteSize the byte size of each buffer
+		@param[in] poolFlags the combination of BufferPoolFlag
+		@param[in] lockPolicyType The lock policy
+		@remark with BUFFER_POOL_FLAG_NUMA_LOCAL, the pool is allocated on the NUMA node of the calling thread.
+		*/
+		BufferPool(unsigned int bufferByteSize=BUFFER_POOL_BUFFER_BYTE_SIZE,unsigned int poolFlags=BUFFER_POOL_FLAG_POOLED,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the Buffer Pool
+		*/
+		virtual ~BufferPool();
+
+		/*!
+		Allocate the buffer from the pool
+		@param[in] byteSize the byte size required
+		@return the buffer allocated, NULL if byteSize is larger than the buffer byte size or failed
+		*/
+		void *Allocate(unsigned int byteSize);
+
+		/*!
+		Return the buffer to the pool
+		@param[in] buffer the buffer allocated from this pool
+		*/
+		void Free(void *buffer);
+
+		/*!
+		Get the byte size of each buffer
+		@return the buffer byte size
+		*/
+		unsigned int GetBufferByteSize() const;
+
+		/*!
+		Get the flags of the pool
+		@return the combination of BufferPoolFlag
+		*/
+		unsigned int GetPoolFlags() const;
+
+		/*!
+		Check if the pool is actually backed by the large pages
+		@return true if backed by the large pages, otherwise false
+		@remark falls back to the normal pages if the large pages are not available.
+		*/
+		bool IsLargePage() const;
+
+		/*!
+		Get the NUMA node of the pool
+		@return the NUMA node number
+		*/
+		unsigned int GetNumaNode() const;
+
+		/*!
+		Get the number of the buffers currently allocated
+		@return the number of the buffers in use
+		*/
+		unsigned int GetUsedBufferCount() const;
+
+		/*!
+		Get the total byte size reserved for the pool
+		@return the total byte size of the slabs
+		*/
+		size_t GetReservedByteSize() const;
+
+		/*!
+		Get the buffer pool bound to the calling thread
+		@return the buffer pool of the calling thread, NULL if not bound
+		*/
+		static BufferPool *GetCurrentPool();
+
+		/*!
+		Bind the buffer pool to the calling thread
+		@param[in] bufferPool the buffer pool to bind
+		@remark the caller must keep the pool alive while bound.
+		*/
+		static void SetCurrentPool(BufferPool *bufferPool);
+
+	private:
+		/*!
+		Allocate new slab and add the buffers to the free list
+		@return true if successfully allocated otherwise false
+		*/
+		bool addSlab();
+
+		/*!
+		Allocate the memory for the slab
+		@param[in] byteSize the byte size of the slab
+		@param[in] allocationType the allocation type for VirtualAlloc
+		@return the memory allocated, NULL if failed
+		*/
+		void *allocSlab(size_t byteSize,DWORD allocationType);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the Buffer Pool
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		BufferPool(const BufferPool& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		BufferPool & operator=(const BufferPool&b){return *this;}
+
+	private:
+		/// buffer byte size
+		unsigned int m_bufferByteSize;
+		/// pool flags
+		unsigned int m_poolFlags;
+		/// flag whether backed by the large pages
+		bool m_isLargePage;
+		/// NUMA node
+		unsigned int m_numaNode;
+		/// free buffer list
+		void *m_freeList;
+		/// slab list
+		vector<void*> m_slabList;
+		/// total byte size of the slabs
+		size_t m_reservedByteSize;
+		/// number of the buffers in use
+		unsigned int m_usedBufferCount;
+		/// pool lock
+		mutable RuntimeLightLockPolicy m_poolLock;
+		/// Lock Policy
+		epl::LockPolicy m_lockPolicy;
+	};
+
+}
+
+#endif //__EP_BUFFER_POOL_H__
@@ -45,6 +45,7 @@ An Interface for Client Interfaces.
 
 namespace epse{
 	class ClientCallbackInterface;
+	class IocpClientRuntime;
 
 	
 	/*! 
@@ -78,6 +79,66 @@ namespace epse{
 		*/
 		unsigned int workerThreadCount;
 
+		/*!
+		The runtime shared with the other clients to run the jobs on.
+		@remark NULL runs the jobs on the worker threads of the client
+		@remark started with workerThreadCount if not started yet
+		@remark IOCP_CLIENT_RUNTIME_INSTANCE is the process-wide runtime
+		@remark For IOCP Use Only!
+		*/
+		IocpClientRuntime *iocpClientRuntime;
+
+		/*!
+		The types of the UDP channels, indexed by the channel id.
+		@remark NULL disables the channel layer, and the datagrams are sent as they are
+		@remark must match the channels of the server
+		@remark For UDP Use Only!
+		*/
+		const UdpChannelType *udpChannelTypes;
+
+		/*!
+		The number of the UDP channels in udpChannelTypes.
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpChannelCount;
+
+		/*!
+		Flag whether to fragment the packets larger than the path MTU.
+		@remark the path MTU is probed with the datagrams not fragmented by IP
+		@remark must match the server
+		@remark For UDP Use Only!
+		*/
+		bool isUdpFragmentation;
+
+		/*!
+		The time in millisecond a small UDP packet may wait to share a datagram with the others.
+		@remark 0 disables the coalescing, and each packet is sent in its own datagram
+		@remark must match the server
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpCoalesceDelayMilliSec;
+
+		/*!
+		Flag whether the server may move the session to another port, as ServerOps::udpConnectPacketRate.
+		@remark an empty datagram from another port of the server is then taken as the move notice, and answered from the new port
+		@remark must be set when the server moves the sessions
+		@remark For UDP Use Only!
+		*/
+		bool isUdpSessionMovable;
+
+		/*!
+		Flag whether Connect returns before connected, and the result is delivered to OnConnected.
+		@remark For Asynchronous and IOCP TCP Client Use Only!
+		*/
+		bool isAsynchronousConnect;
+
+		/*!
+		The time in millisecond to give up connecting to all the addresses of the server.
+		@remark WAITTIME_INIFINITE waits until every address failed
+		@remark For TCP Use Only!
+		*/
+		unsigned int connectTimeOutMilliSec;
+
 		/*!
 		Default Constructor
 
@@ -92,6 +153,14 @@ namespace epse{
 			waitTimeMilliSec=WAITTIME_INIFINITE;
 			maximumProcessorCount=PROCESSOR_LIMIT_INFINITE;
 			workerThreadCount=0;
+			iocpClientRuntime=NULL;
+			udpChannelTypes=NULL;
+			udpChannelCount=0;
+			isUdpFragmentation=false;
+			udpCoalesceDelayMilliSec=0;
+			isUdpSessionMovable=false;
+			isAsynchronousConnect=false;
+			connectTimeOutMilliSec=WAITTIME_INIFINITE;
 		}
 
 		static ClientOps defaultClientOps;
@@ -272,6 +341,14 @@ namespace epse{
 		*/
 		virtual void OnSent(ClientInterface *client,SendStatus status){}
 
+		/*!
+		The client is connected, or failed to connect.
+		@param[in] client the client which tried to connect
+		@param[in] status the status of Connect
+		@remark for Asynchronous Connect Use Only!
+		*/
+		virtual void OnConnected(ClientInterface *client,ConnectStatus status){}
+
 		/*!
 		The client is disconnected.
 		@param[in] client the client, disconnected.
@@ -0,0 +1,148 @@
+/*! 
+@file epIocpClientRuntime.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief IOCP Client Runtime Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the IOCP Client Runtime.
+
+Runs the jobs of many IOCP clients on one worker pool, so the number of the
+threads does not grow with the number of the clients.
+
+*/
+#ifndef __EP_IOCP_CLIENT_RUNTIME_H__
+#define __EP_IOCP_CLIENT_RUNTIME_H__
+
+#include "epServerEngine.h"
+#include "epLockPolicy.h"
+#include <vector>
+#include <queue>
+using namespace std;
+
+/*!
+@def IOCP_CLIENT_RUNTIME_INSTANCE
+@brief Macro for the process-wide IOCP client runtime
+
+Macro for the process-wide IOCP client runtime.
+*/
+#define IOCP_CLIENT_RUNTIME_INSTANCE epl::SingletonHolder<epse::IocpClientRuntime>::Instance()
+
+namespace epse{
+
+	/*! 
+	@class IocpClientRuntime epIocpClientRuntime.h
+	@brief A class for the worker pool shared by the IOCP clients.
+	*/
+	class EP_SERVER_ENGINE IocpClientRuntime:public WorkerThreadDelegate{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the runtime
+		@param[in] lockPolicyType The lock policy
+		*/
+		IocpClientRuntime(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the runtime
+		*/
+		virtual ~IocpClientRuntime();
+
+		/*!
+		Start the worker threads
+		@param[in] workerThreadCount the number of the worker threads, 0 for twice the number of the cores
+		@return true if started, otherwise false
+		@remark does nothing if already started, so the first start decides the number of the threads.
+		*/
+		bool StartRuntime(unsigned int workerThreadCount=0);
+
+		/*!
+		Stop the worker threads
+		@param[in] waitTimeInMilliSec wait time for each worker thread to terminate
+		@remark the jobs not processed yet are dropped.
+		*/
+		void StopRuntime(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Check if the worker threads are started
+		@return true if started, otherwise false
+		*/
+		bool IsRuntimeStarted() const;
+
+		/*!
+		Get the number of the worker threads
+		@return the number of the worker threads
+		*/
+		unsigned int GetWorkerThreadCount() const;
+
+		/*!
+		Add new job to the idle worker thread, or the least loaded one
+		@param[in] job the job to push to the worker thread.
+		*/
+		void PushJob(BaseJob *job);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the runtime
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		IocpClientRuntime(const IocpClientRuntime& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		IocpClientRuntime & operator=(const IocpClientRuntime&b){return *this;}
+
+		/*!
+		Call Back Function.
+		@param[in] p the argument for call back function.
+		*/
+		virtual void CallBackFunc(BaseWorkerThread *p);
+
+	private:
+		/// Worker thread list
+		vector<BaseWorkerThread*> m_workerList;
+		/// worker thread list with no job
+		queue<BaseWorkerThread*> m_emptyWorkerList;
+		/// worker lock
+		mutable RuntimeLockPolicy m_workerLock;
+	};
+}
+
+#endif //__EP_IOCP_CLIENT_RUNTIME_H__
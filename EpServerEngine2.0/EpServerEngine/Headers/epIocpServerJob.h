@@ -59,6 +59,8 @@ namespace epse{
 			IOCP_SERVER_JOB_TYPE_RECEIVE,
 			/// disconnect job
 			IOCP_SERVER_JOB_TYPE_DISCONNECT,
+			/// new connection notification job
+			IOCP_SERVER_JOB_TYPE_CONNECT,
 		}IocpServerJobType;
 
 		/*!
@@ -123,6 +125,13 @@ namespace epse{
 		*/
 		ServerCallbackInterface *GetCallBackObject();
 
+		/*!
+		Charge the byte size of the packet to the given budget until the job is destroyed
+		@param[in] budget the memory budget to charge
+		@return true if charged, false if the budget is exceeded
+		*/
+		bool ChargeMemoryBudget(MemoryBudget *budget);
+
 
 	protected:
 		/// pointer to the packet
@@ -139,6 +148,10 @@ namespace epse{
 
 		/// callback object for job completion
 		ServerCallbackInterface *m_callBackObj;
+		/// memory budget charged
+		MemoryBudget *m_memoryBudget;
+		/// byte size charged to the memory budget
+		unsigned int m_chargedByteSize;
 
 	};
 }
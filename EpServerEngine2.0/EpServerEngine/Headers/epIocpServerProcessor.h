@@ -39,6 +39,8 @@ An Interface for IOCP Server Processor.
 #define __EP_IOCP_SERVER_PROCESSOR_H__
 
 #include "epServerEngine.h"
+#include "epMessageArena.h"
+#include "epBufferPool.h"
 namespace epse{
 		/*! 
 	@class IocpServerProcessor epIocpServerProcessor.h
@@ -47,6 +49,21 @@ namespace epse{
 	class EP_SERVER_ENGINE IocpServerProcessor:public BaseJobProcessor{
 
 	public:
+		/*!
+		Default Constructor
+
+		Initializes the Processor
+		@param[in] bufferPoolFlags the combination of BufferPoolFlag for the buffer pool of the worker thread
+		*/
+		IocpServerProcessor(unsigned int bufferPoolFlags=BUFFER_POOL_FLAG_NONE);
+
+		/*!
+		Default Destructor
+
+		Destroy the Processor
+		*/
+		virtual ~IocpServerProcessor();
+
 		/*!
 		Process the job given, subclasses must implement this function.
 		@param[in] workerThread The worker thread which called the DoJob.
@@ -62,6 +79,16 @@ namespace epse{
 		@param[in] status The Status of the Job
 		*/
 		virtual void handleReport(const JobProcessorStatus status);
+
+	private:
+		/// Arena for the messages dispatched by the worker thread of this processor
+		MessageArena m_arena;
+
+		/// Buffer pool flags
+		unsigned int m_bufferPoolFlags;
+
+		/// Buffer pool bound to the worker thread of this processor
+		BufferPool *m_bufferPool;
 	};
 }
 
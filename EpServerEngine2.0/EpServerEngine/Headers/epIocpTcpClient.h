@@ -89,6 +89,8 @@ namespace epse{
 		@param[in] ops the client options
 		@return true if successfully connected otherwise false
 		@remark if argument is NULL then previously setting value is used
+		@remark if ops.isAsynchronousConnect is true, returns once the connect is started,<br/>
+		        and the result is given to OnConnected of the callback object.
 		*/
 		bool Connect(const ClientOps &ops=ClientOps::defaultClientOps);
 
@@ -179,6 +181,8 @@ namespace epse{
 		vector<BaseWorkerThread*> m_workerList;
 		/// worker thread list with no job
 		queue<BaseWorkerThread*> m_emptyWorkerList;
+		/// runtime shared with the other clients, NULL if the worker threads of this client are used
+		IocpClientRuntime *m_runtime;
 
 	};
 }
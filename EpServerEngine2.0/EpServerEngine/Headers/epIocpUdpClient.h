@@ -181,6 +181,8 @@ namespace epse{
 		vector<BaseWorkerThread*> m_workerList;
 		/// worker thread list with no job
 		queue<BaseWorkerThread*> m_emptyWorkerList;
+		/// runtime shared with the other clients, NULL if the worker threads of this client are used
+		IocpClientRuntime *m_runtime;
 	};
 }
 
@@ -41,6 +41,8 @@ An Interface for IOCP UDP Server.
 
 #include "epServerEngine.h"
 #include "epBaseUdpServer.h"
+#include <queue>
+using namespace std;
 
 namespace epse{
 		/*! 
@@ -109,9 +111,13 @@ namespace epse{
 		void pushJob(BaseJob * job);
 
 		/*!
-		Listening Loop Function
+		Handle the datagram received from the client
+		@param[in] packetData the datagram
+		@param[in] recvLength the result of the receive
+		@param[in] clientAddress the client address
+		@param[in] segmentByteSize the segment byte size of the coalesced datagrams, 0 if not coalesced
 		*/
-		virtual void execute() ;
+		virtual void handleDatagram(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize);
 
 		/// general lock 
 		epl::BaseLock *m_workerLock;
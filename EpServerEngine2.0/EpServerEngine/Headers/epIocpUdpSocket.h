@@ -39,6 +39,7 @@ An Interface for IOCP UDP Socket.
 #define __EP_IOCP_UDP_SOCKET_H__
 
 #include "epServerEngine.h"
+#include "epLightLock.h"
 #include "epBaseUdpSocket.h"
 
 namespace epse
@@ -173,7 +174,7 @@ namespace epse
 	
 	private:
 		/// Packet Received Event
-		epl::EventEx m_packetReceivedEvent;
+		LightEvent m_packetReceivedEvent;
 
 		/// Connection status
 		bool m_isConnected;
@@ -0,0 +1,394 @@
+/*! 
+@file epLightLock.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Light Lock Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for User-space-first Lock Primitives.
+
+*/
+#ifndef __EP_LIGHT_LOCK_H__
+#define __EP_LIGHT_LOCK_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+
+namespace epse{
+
+	/*! 
+	@class LightParker epLightLock.h
+	@brief A class that parks and unparks the threads waiting on the address.
+
+	Uses WaitOnAddress where available, otherwise falls back to a semaphore.
+	*/
+	class EP_SERVER_ENGINE LightParker{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Parker
+		*/
+		LightParker();
+
+		/*!
+		Default Destructor
+
+		Destroys the Parker
+		*/
+		~LightParker();
+
+		/*!
+		Park the current thread while the value at the address equals the compare value
+		@param[in] address the address to wait on
+		@param[in] compareValue the value to keep waiting on
+		@param[in] waitTimeMilliSec the wait time
+		@return false if timed out, otherwise true
+		@remark may return spuriously, so the caller must re-check its condition.
+		*/
+		bool Park(volatile LONG *address,LONG compareValue,unsigned int waitTimeMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Unpark the threads parked on the address
+		@param[in] address the address parked on
+		@param[in] shouldWakeAll flag whether to wake all the parked threads
+		@remark the caller must change the value at the address with the interlocked operation before calling.
+		*/
+		void Unpark(volatile LONG *address,bool shouldWakeAll);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the Parker
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		LightParker(const LightParker& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		LightParker & operator=(const LightParker&b){return *this;}
+
+	private:
+		/// parked thread count
+		volatile LONG m_waiterCount;
+		/// semaphore used when WaitOnAddress is not available
+		HANDLE m_semaphore;
+	};
+
+	/*! 
+	@class LightMutex epLightLock.h
+	@brief A class for the recursive lock which spins before parking.
+
+	The uncontended Lock and Unlock do not enter the kernel.
+	*/
+	class EP_SERVER_ENGINE LightMutex:public epl::BaseLock{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock
+		*/
+		LightMutex();
+
+		/*!
+		Default Copy Constructor
+
+		Initializes new lock
+		@param[in] b the second object
+		@remark the lock state is not copied.
+		*/
+		LightMutex(const LightMutex& b);
+
+		/*!
+		Default Destructor
+
+		Destroys the lock
+		*/
+		virtual ~LightMutex();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return this object
+		@remark the lock state is not copied.
+		*/
+		LightMutex & operator=(const LightMutex&b){return *this;}
+
+		/*!
+		Lock
+		@return true if locked, false otherwise
+		*/
+		virtual bool Lock();
+
+		/*!
+		Try to Lock without waiting
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLock();
+
+		/*!
+		Try to Lock for given time
+		@param[in] dwMilliSecond the wait time.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLockFor(const unsigned int dwMilliSecond);
+
+		/*!
+		Unlock
+
+		The Lock and Unlock has to be matched.
+		*/
+		virtual void Unlock();
+
+	private:
+		/// lock state (0: unlocked, 1: locked, 2: locked with waiters)
+		volatile LONG m_state;
+		/// thread ID owning the lock
+		volatile DWORD m_ownerThreadID;
+		/// recursion count of the owner thread
+		unsigned int m_recursionCount;
+		/// parker
+		LightParker m_parker;
+	};
+
+	/*! 
+	@class LightEvent epLightLock.h
+	@brief A class for the event which spins before parking.
+
+	Raising the event without the waiter does not enter the kernel.
+	*/
+	class EP_SERVER_ENGINE LightEvent:public epl::BaseLock{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the event
+		@param[in] isInitialRaised flag to raise the event on creation
+		@param[in] isManualReset flag to whether event is reset manually
+		*/
+		LightEvent(bool isInitialRaised=false,bool isManualReset=false);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the event with the same flags and state
+		@param[in] b the second object
+		*/
+		LightEvent(const LightEvent& b);
+
+		/*!
+		Default Destructor
+
+		Destroys the event
+		*/
+		virtual ~LightEvent();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return this object
+		@remark the waiters of this object are not affected.
+		*/
+		LightEvent & operator=(const LightEvent&b);
+
+		/*!
+		Wait for the event raised
+		@return true if raised, false otherwise
+		*/
+		virtual bool Lock();
+
+		/*!
+		Check the event raised without waiting
+		@return true if raised, otherwise false.
+		*/
+		virtual long TryLock();
+
+		/*!
+		Wait for the event raised for given time
+		@param[in] dwMilliSecond the wait time.
+		@return true if raised, otherwise false.
+		*/
+		virtual long TryLockFor(const unsigned int dwMilliSecond);
+
+		/*!
+		Raise the event
+		@remark this function is same as SetEvent
+		*/
+		virtual void Unlock();
+
+		/*!
+		Reset the event raised
+		@return true if succeeded otherwise false
+		@remark if event is not raised then no effect
+		*/
+		bool ResetEvent();
+
+		/*!
+		Set the event to be raised
+		@return true if succeeded otherwise false
+		@remark if event is already raised then no effect
+		*/
+		bool SetEvent();
+
+		/*!
+		Returns the flag whether this event is resetting manually.
+		@return true if the event is resetting manually, otherwise false.
+		*/
+		bool IsManualReset() const;
+
+		/*!
+		Wait for the event raised for given time
+		@param[in] dwMilliSecond the wait time.
+		@return true if the wait is succeeded, otherwise false.
+		*/
+		bool WaitForEvent(const unsigned int dwMilliSecond=WAITTIME_INIFINITE);
+
+	private:
+		/*!
+		Try to consume the raised event
+		@return true if the event was raised, otherwise false
+		*/
+		bool tryConsume();
+
+	private:
+		/// event state (0: not raised, 1: raised)
+		volatile LONG m_state;
+		/// Flag for whether the event is resetting manually.
+		bool m_isManualReset;
+		/// parker
+		LightParker m_parker;
+	};
+
+	/*! 
+	@class LightSemaphore epLightLock.h
+	@brief A class for the semaphore which spins before parking.
+
+	Acquiring the available count and releasing without the waiter do not enter the kernel.
+	*/
+	class EP_SERVER_ENGINE LightSemaphore:public epl::BaseLock{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the semaphore
+		@param[in] count maximum count
+		*/
+		LightSemaphore(long count=1);
+
+		/*!
+		Default Constructor
+
+		Initializes the semaphore
+		@param[in] count maximum count
+		@param[in] initialCount the initial count
+		@remark initialCount must be greater than or equal to zero and less than or equal to count.
+		*/
+		LightSemaphore(long count,long initialCount);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the semaphore with the same counts
+		@param[in] b the second object
+		*/
+		LightSemaphore(const LightSemaphore& b);
+
+		/*!
+		Default Destructor
+
+		Destroys the semaphore
+		*/
+		virtual ~LightSemaphore();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return this object
+		@remark the waiters of this object are not affected.
+		*/
+		LightSemaphore & operator=(const LightSemaphore&b);
+
+		/*!
+		Acquire the semaphore
+		@return true if acquired, false otherwise
+		*/
+		virtual bool Lock();
+
+		/*!
+		Try to acquire the semaphore without waiting
+		@return true if acquired, otherwise false.
+		*/
+		virtual long TryLock();
+
+		/*!
+		Try to acquire the semaphore for given time
+		@param[in] dwMilliSecond the wait time.
+		@return true if acquired, otherwise false.
+		*/
+		virtual long TryLockFor(const unsigned int dwMilliSecond);
+
+		/*!
+		Release the semaphore by one
+		*/
+		virtual void Unlock();
+
+		/*!
+		Release the semaphore with given count
+		@param[in] releaseCount the count of the semaphore to release
+		@param[out] retPreviousCount the count of the semaphore before the release
+		@return nonzero if successful otherwise 0
+		@remark fails if the count exceeds the maximum count.
+		*/
+		long Release(long releaseCount, long * retPreviousCount=NULL);
+
+	private:
+		/*!
+		Try to decrease the count by one
+		@return true if decreased, otherwise false
+		*/
+		bool tryAcquire();
+
+	private:
+		/// current count
+		volatile LONG m_count;
+		/// maximum count
+		long m_maxCount;
+		/// parker
+		LightParker m_parker;
+	};
+}
+
+#endif //__EP_LIGHT_LOCK_H__
@@ -0,0 +1,677 @@
+/*! 
+@file epLockPolicy.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Lock Policy Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for compile-time Lock Policies.
+
+*/
+#ifndef __EP_LOCK_POLICY_H__
+#define __EP_LOCK_POLICY_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epLightLock.h"
+#include <new>
+
+namespace epse{
+
+	/*! 
+	@class NoLockPolicy epLockPolicy.h
+	@brief A class for the lock policy without locking.
+
+	All the operations are inlined no-ops, so the locking compiles away.
+	*/
+	class NoLockPolicy{
+	public:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType The lock policy (ignored)
+		@remark takes the lock policy, so the templates construct the same as RuntimeLockPolicy.
+		*/
+		NoLockPolicy(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY){}
+
+		/*!
+		Set the lock policy (does nothing)
+		@param[in] lockPolicyType The lock policy
+		@remark the lock policy is fixed at compile time.
+		*/
+		void SetLockPolicy(epl::LockPolicy lockPolicyType){}
+
+		/*!
+		Get the lock policy
+		@return LOCK_POLICY_NONE
+		*/
+		epl::LockPolicy GetLockPolicy() const
+		{
+			return epl::LOCK_POLICY_NONE;
+		}
+
+		/*!
+		Lock (does nothing)
+		@return always true
+		*/
+		bool Lock(){return true;}
+
+		/*!
+		Try to Lock (does nothing)
+		@return always true
+		*/
+		bool TryLock(){return true;}
+
+		/*!
+		Unlock (does nothing)
+		*/
+		void Unlock(){}
+	};
+
+	/*! 
+	@class CriticalSectionPolicy epLockPolicy.h
+	@brief A class for the lock policy with the inline Critical Section.
+	*/
+	class CriticalSectionPolicy{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Critical Section
+		@param[in] lockPolicyType The lock policy (ignored)
+		*/
+		CriticalSectionPolicy(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY)
+		{
+			InitializeCriticalSectionAndSpinCount(&m_criticalSection,LOCK_POLICY_SPIN_COUNT);
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes new Critical Section
+		@param[in] b the second object
+		@remark the lock state is not copied.
+		*/
+		CriticalSectionPolicy(const CriticalSectionPolicy& b)
+		{
+			InitializeCriticalSectionAndSpinCount(&m_criticalSection,LOCK_POLICY_SPIN_COUNT);
+		}
+
+		/*!
+		Default Destructor
+
+		Deletes the Critical Section
+		*/
+		~CriticalSectionPolicy()
+		{
+			DeleteCriticalSection(&m_criticalSection);
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return this object
+		@remark the lock state is not copied.
+		*/
+		CriticalSectionPolicy & operator=(const CriticalSectionPolicy&b){return *this;}
+
+		/*!
+		Set the lock policy (does nothing)
+		@param[in] lockPolicyType The lock policy
+		@remark the lock policy is fixed at compile time.
+		*/
+		void SetLockPolicy(epl::LockPolicy lockPolicyType){}
+
+		/*!
+		Get the lock policy
+		@return LOCK_POLICY_CRITICALSECTION
+		*/
+		epl::LockPolicy GetLockPolicy() const
+		{
+			return epl::LOCK_POLICY_CRITICALSECTION;
+		}
+
+		/*!
+		Lock the Critical Section
+		@return always true
+		*/
+		bool Lock()
+		{
+			EnterCriticalSection(&m_criticalSection);
+			return true;
+		}
+
+		/*!
+		Try to Lock the Critical Section
+		@return true if locked, otherwise false
+		*/
+		bool TryLock()
+		{
+			return (TryEnterCriticalSection(&m_criticalSection)!=FALSE);
+		}
+
+		/*!
+		Unlock the Critical Section
+		*/
+		void Unlock()
+		{
+			LeaveCriticalSection(&m_criticalSection);
+		}
+
+	private:
+		/// Critical Section
+		CRITICAL_SECTION m_criticalSection;
+	};
+
+	/*! 
+	@class MutexPolicy epLockPolicy.h
+	@brief A class for the lock policy with the Mutex kernel object.
+	*/
+	class MutexPolicy{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Mutex
+		@param[in] lockPolicyType The lock policy (ignored)
+		*/
+		MutexPolicy(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY)
+		{
+			m_mutex=CreateMutex(NULL,FALSE,NULL);
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes new Mutex
+		@param[in] b the second object
+		@remark the lock state is not copied.
+		*/
+		MutexPolicy(const MutexPolicy& b)
+		{
+			m_mutex=CreateMutex(NULL,FALSE,NULL);
+		}
+
+		/*!
+		Default Destructor
+
+		Deletes the Mutex
+		*/
+		~MutexPolicy()
+		{
+			if(m_mutex)
+				CloseHandle(m_mutex);
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return this object
+		@remark the lock state is not copied.
+		*/
+		MutexPolicy & operator=(const MutexPolicy&b){return *this;}
+
+		/*!
+		Set the lock policy (does nothing)
+		@param[in] lockPolicyType The lock policy
+		@remark the lock policy is fixed at compile time.
+		*/
+		void SetLockPolicy(epl::LockPolicy lockPolicyType){}
+
+		/*!
+		Get the lock policy
+		@return LOCK_POLICY_MUTEX
+		*/
+		epl::LockPolicy GetLockPolicy() const
+		{
+			return epl::LOCK_POLICY_MUTEX;
+		}
+
+		/*!
+		Lock the Mutex
+		@return true if locked, otherwise false
+		*/
+		bool Lock()
+		{
+			DWORD waitResult=WaitForSingleObject(m_mutex,INFINITE);
+			return (waitResult==WAIT_OBJECT_0 || waitResult==WAIT_ABANDONED);
+		}
+
+		/*!
+		Try to Lock the Mutex
+		@return true if locked, otherwise false
+		*/
+		bool TryLock()
+		{
+			DWORD waitResult=WaitForSingleObject(m_mutex,0);
+			return (waitResult==WAIT_OBJECT_0 || waitResult==WAIT_ABANDONED);
+		}
+
+		/*!
+		Unlock the Mutex
+		*/
+		void Unlock()
+		{
+			ReleaseMutex(m_mutex);
+		}
+
+	private:
+		/// Mutex handle
+		HANDLE m_mutex;
+	};
+
+	/*! 
+	@class LightMutexPolicy epLockPolicy.h
+	@brief A class for the lock policy with the inline LightMutex.
+
+	The uncontended Lock and Unlock do not enter the kernel.
+	*/
+	class LightMutexPolicy{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the LightMutex
+		@param[in] lockPolicyType The lock policy (ignored)
+		*/
+		LightMutexPolicy(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY){}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes new LightMutex
+		@param[in] b the second object
+		@remark the lock state is not copied.
+		*/
+		LightMutexPolicy(const LightMutexPolicy& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return this object
+		@remark the lock state is not copied.
+		*/
+		LightMutexPolicy & operator=(const LightMutexPolicy&b){return *this;}
+
+		/*!
+		Set the lock policy (does nothing)
+		@param[in] lockPolicyType The lock policy
+		@remark the lock policy is fixed at compile time.
+		*/
+		void SetLockPolicy(epl::LockPolicy lockPolicyType){}
+
+		/*!
+		Get the lock policy
+		@return LOCK_POLICY_CRITICALSECTION
+		*/
+		epl::LockPolicy GetLockPolicy() const
+		{
+			return epl::LOCK_POLICY_CRITICALSECTION;
+		}
+
+		/*!
+		Lock the LightMutex
+		@return true if locked, otherwise false
+		*/
+		bool Lock()
+		{
+			return m_mutex.Lock();
+		}
+
+		/*!
+		Try to Lock the LightMutex
+		@return true if locked, otherwise false
+		*/
+		bool TryLock()
+		{
+			return (m_mutex.TryLock()!=0);
+		}
+
+		/*!
+		Unlock the LightMutex
+		*/
+		void Unlock()
+		{
+			m_mutex.Unlock();
+		}
+
+	private:
+		/// LightMutex
+		LightMutex m_mutex;
+	};
+
+	/*! 
+	@class RuntimeLockPolicy epLockPolicy.h
+	@brief A class for the lock policy chosen by epl::LockPolicy at runtime.
+
+	Compatibility shim for the runtime LockPolicy constructors.
+	The lock is stored inline and called without the virtual dispatch,
+	so LOCK_POLICY_NONE costs only a predictable branch.
+	*/
+	class RuntimeLockPolicy{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock
+		@param[in] lockPolicyType The lock policy
+		@param[in] isLightLock flag whether to use LightMutex for LOCK_POLICY_CRITICALSECTION
+		*/
+		RuntimeLockPolicy(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY,bool isLightLock=false)
+		{
+			m_isLightLock=isLightLock;
+			initialize(lockPolicyType);
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes new lock with the same lock policy
+		@param[in] b the second object
+		@remark the lock state is not copied.
+		*/
+		RuntimeLockPolicy(const RuntimeLockPolicy& b)
+		{
+			m_isLightLock=b.m_isLightLock;
+			initialize(b.m_lockPolicy);
+		}
+
+		/*!
+		Default Destructor
+
+		Deletes the lock
+		*/
+		~RuntimeLockPolicy()
+		{
+			release();
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return this object
+		@remark the lock state is not copied, and the lock policy is kept.
+		*/
+		RuntimeLockPolicy & operator=(const RuntimeLockPolicy&b){return *this;}
+
+		/*!
+		Reset the lock with the given lock policy
+		@param[in] lockPolicyType The lock policy
+		@remark must not be called while locked.
+		*/
+		void SetLockPolicy(epl::LockPolicy lockPolicyType)
+		{
+			release();
+			initialize(lockPolicyType);
+		}
+
+		/*!
+		Get the lock policy
+		@return the lock policy
+		*/
+		epl::LockPolicy GetLockPolicy() const
+		{
+			return m_lockPolicy;
+		}
+
+		/*!
+		Lock
+		@return true if locked, otherwise false
+		*/
+		bool Lock()
+		{
+			switch(m_lockType)
+			{
+			case LOCK_TYPE_CRITICALSECTION:
+				EnterCriticalSection(&m_lock.m_criticalSection);
+				return true;
+			case LOCK_TYPE_LIGHT_MUTEX:
+				return lightMutex()->Lock();
+			case LOCK_TYPE_MUTEX:
+				{
+					DWORD waitResult=WaitForSingleObject(m_mutex,INFINITE);
+					return (waitResult==WAIT_OBJECT_0 || waitResult==WAIT_ABANDONED);
+				}
+			default:
+				return true;
+			}
+		}
+
+		/*!
+		Try to Lock
+		@return true if locked, otherwise false
+		*/
+		bool TryLock()
+		{
+			switch(m_lockType)
+			{
+			case LOCK_TYPE_CRITICALSECTION:
+				return (TryEnterCriticalSection(&m_lock.m_criticalSection)!=FALSE);
+			case LOCK_TYPE_LIGHT_MUTEX:
+				return (lightMutex()->TryLock()!=0);
+			case LOCK_TYPE_MUTEX:
+				{
+					DWORD waitResult=WaitForSingleObject(m_mutex,0);
+					return (waitResult==WAIT_OBJECT_0 || waitResult==WAIT_ABANDONED);
+				}
+			default:
+				return true;
+			}
+		}
+
+		/*!
+		Unlock
+		*/
+		void Unlock()
+		{
+			switch(m_lockType)
+			{
+			case LOCK_TYPE_CRITICALSECTION:
+				LeaveCriticalSection(&m_lock.m_criticalSection);
+				break;
+			case LOCK_TYPE_LIGHT_MUTEX:
+				lightMutex()->Unlock();
+				break;
+			case LOCK_TYPE_MUTEX:
+				ReleaseMutex(m_mutex);
+				break;
+			default:
+				break;
+			}
+		}
+
+	private:
+		/// Enumerator for the lock stored
+		typedef enum _lockType{
+			/// no lock
+			LOCK_TYPE_NONE=0,
+			/// Critical Section
+			LOCK_TYPE_CRITICALSECTION,
+			/// LightMutex
+			LOCK_TYPE_LIGHT_MUTEX,
+			/// Mutex
+			LOCK_TYPE_MUTEX,
+		}LockType;
+
+		/*!
+		Initialize the lock for the given lock policy
+		@param[in] lockPolicyType The lock policy
+		*/
+		void initialize(epl::LockPolicy lockPolicyType)
+		{
+			m_lockPolicy=lockPolicyType;
+			m_mutex=NULL;
+			switch(m_lockPolicy)
+			{
+			case epl::LOCK_POLICY_CRITICALSECTION:
+				if(m_isLightLock)
+				{
+					m_lockType=LOCK_TYPE_LIGHT_MUTEX;
+					new(m_lock.m_lightMutex) LightMutex();
+				}
+				else
+				{
+					m_lockType=LOCK_TYPE_CRITICALSECTION;
+					InitializeCriticalSectionAndSpinCount(&m_lock.m_criticalSection,LOCK_POLICY_SPIN_COUNT);
+				}
+				break;
+			case epl::LOCK_POLICY_MUTEX:
+				m_lockType=LOCK_TYPE_MUTEX;
+				m_mutex=CreateMutex(NULL,FALSE,NULL);
+				break;
+			default:
+				m_lockType=LOCK_TYPE_NONE;
+				break;
+			}
+		}
+
+		/*!
+		Release the lock
+		*/
+		void release()
+		{
+			switch(m_lockType)
+			{
+			case LOCK_TYPE_CRITICALSECTION:
+				DeleteCriticalSection(&m_lock.m_criticalSection);
+				break;
+			case LOCK_TYPE_LIGHT_MUTEX:
+				lightMutex()->~LightMutex();
+				break;
+			case LOCK_TYPE_MUTEX:
+				if(m_mutex)
+					CloseHandle(m_mutex);
+				m_mutex=NULL;
+				break;
+			default:
+				break;
+			}
+			m_lockType=LOCK_TYPE_NONE;
+		}
+
+		/*!
+		Get the LightMutex constructed in the lock storage
+		@return the LightMutex
+		*/
+		LightMutex *lightMutex()
+		{
+			return reinterpret_cast<LightMutex*>(m_lock.m_lightMutex);
+		}
+
+		/// Lock Policy
+		epl::LockPolicy m_lockPolicy;
+		/// lock stored
+		LockType m_lockType;
+		/// flag whether to use LightMutex for LOCK_POLICY_CRITICALSECTION
+		bool m_isLightLock;
+		/// storage for the Critical Section or the LightMutex
+		/// @remark the LightMutex is constructed only when selected, since its parker may own a semaphore.
+		union{
+			/// Critical Section (for LOCK_TYPE_CRITICALSECTION)
+			CRITICAL_SECTION m_criticalSection;
+			/// LightMutex (for LOCK_TYPE_LIGHT_MUTEX)
+			char m_lightMutex[sizeof(LightMutex)];
+		}m_lock;
+		/// Mutex handle (for LOCK_POLICY_MUTEX)
+		HANDLE m_mutex;
+	};
+
+	/*! 
+	@class RuntimeLightLockPolicy epLockPolicy.h
+	@brief A class for the runtime lock policy which uses LightMutex for LOCK_POLICY_CRITICALSECTION.
+
+	For the hot lists and queues, where the lock is mostly uncontended.
+	*/
+	class RuntimeLightLockPolicy:public RuntimeLockPolicy{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock
+		@param[in] lockPolicyType The lock policy
+		*/
+		RuntimeLightLockPolicy(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY):RuntimeLockPolicy(lockPolicyType,true)
+		{
+		}
+	};
+
+	/*! 
+	@class ScopedLock epLockPolicy.h
+	@brief A class for locking the lock policy object within the scope.
+	*/
+	template<typename LockPolicyType>
+	class ScopedLock{
+	public:
+		/*!
+		Default Constructor
+
+		Locks the given lock
+		@param[in] lock the lock to lock
+		*/
+		ScopedLock(LockPolicyType &lock):m_lock(lock)
+		{
+			m_lock.Lock();
+		}
+
+		/*!
+		Default Destructor
+
+		Unlocks the lock
+		*/
+		~ScopedLock()
+		{
+			m_lock.Unlock();
+		}
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the ScopedLock
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ScopedLock(const ScopedLock& b):m_lock(b.m_lock){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ScopedLock & operator=(const ScopedLock&b){return *this;}
+
+	private:
+		/// lock
+		LockPolicyType &m_lock;
+	};
+
+}
+
+#endif //__EP_LOCK_POLICY_H__
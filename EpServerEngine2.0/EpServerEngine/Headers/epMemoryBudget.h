@@ -0,0 +1,184 @@
+/*! 
+@file epMemoryBudget.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Memory Budget Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Memory Budget.
+
+*/
+#ifndef __EP_MEMORY_BUDGET_H__
+#define __EP_MEMORY_BUDGET_H__
+
+#include "epServerEngine.h"
+#include "epLockPolicy.h"
+#include "epServerConf.h"
+
+namespace epse{
+
+	/*! 
+	@class MemoryBudget epMemoryBudget.h
+	@brief A class for Memory Budget accounting.
+
+	The budget of the connection is chained to the budget of the server,
+	so acquiring from the connection also acquires from the server.
+	*/
+	class EP_SERVER_ENGINE MemoryBudget:public epl::SmartObject{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Memory Budget
+		@param[in] budgetByteSize the budget in byte
+		@param[in] parent the parent budget to be charged together
+		@param[in] lockPolicyType The lock policy
+		@remark 0 means there is no limit
+		*/
+		MemoryBudget(size_t budgetByteSize=MEMORY_BUDGET_INFINITE,MemoryBudget *parent=NULL,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the Memory Budget
+		*/
+		virtual ~MemoryBudget();
+
+		/*!
+		Acquire the given byte size from the budget
+		@param[in] byteSize the byte size to acquire
+		@return true if acquired, false if the budget (or the parent budget) is exceeded
+		*/
+		bool Acquire(size_t byteSize);
+
+		/*!
+		Release the given byte size to the budget
+		@param[in] byteSize the byte size to release
+		@remark must be paired with the successful Acquire
+		*/
+		void Release(size_t byteSize);
+
+		/*!
+		Check if the given byte size can be acquired
+		@param[in] byteSize the byte size to check
+		@return true if it can be acquired, otherwise false
+		*/
+		bool CanAcquire(size_t byteSize) const;
+
+		/*!
+		Check if the given byte size can be ever acquired from the empty budget
+		@param[in] byteSize the byte size to check
+		@return true if it fits in the budget (and the parent budget), otherwise false
+		*/
+		bool IsInBudget(size_t byteSize) const;
+
+		/*!
+		Set the budget in byte
+		@param[in] budgetByteSize the budget in byte
+		@remark 0 means there is no limit
+		*/
+		void SetBudgetByteSize(size_t budgetByteSize);
+
+		/*!
+		Get the budget in byte
+		@return the budget in byte
+		@remark 0 means there is no limit
+		*/
+		size_t GetBudgetByteSize() const;
+
+		/*!
+		Get the byte size currently acquired
+		@return the used byte size
+		*/
+		size_t GetUsedByteSize() const;
+
+		/*!
+		Get the maximum byte size acquired at once so far
+		@return the peak byte size
+		*/
+		size_t GetPeakByteSize() const;
+
+		/*!
+		Get the number of the rejected Acquire
+		@return the rejected count
+		*/
+		unsigned int GetRejectedCount() const;
+
+		/*!
+		Set the parent budget
+		@param[in] parent the parent budget to be charged together
+		@remark must be set while nothing is acquired
+		*/
+		void SetParent(MemoryBudget *parent);
+
+		/*!
+		Get the parent budget
+		@return the parent budget
+		*/
+		MemoryBudget *GetParent() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the Memory Budget
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		MemoryBudget(const MemoryBudget& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		MemoryBudget & operator=(const MemoryBudget&b){return *this;}
+
+	private:
+		/// budget in byte
+		size_t m_budgetByteSize;
+		/// used byte size
+		size_t m_usedByteSize;
+		/// peak byte size
+		size_t m_peakByteSize;
+		/// rejected count
+		unsigned int m_rejectedCount;
+		/// parent budget
+		MemoryBudget *m_parent;
+		/// budget lock
+		mutable RuntimeLightLockPolicy m_budgetLock;
+		/// Lock Policy
+		epl::LockPolicy m_lockPolicy;
+	};
+
+}
+
+#endif //__EP_MEMORY_BUDGET_H__
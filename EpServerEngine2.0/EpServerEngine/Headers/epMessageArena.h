@@ -0,0 +1,343 @@
+/*! 
+@file epMessageArena.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Message Arena Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Message Arena.
+
+The arena serves the transient allocations of the OnReceived handlers. The
+packets, the packet processors and the jobs of the engine are reference
+counted, and may be retained past OnReceived, so they stay on the heap.
+
+*/
+#ifndef __EP_MESSAGE_ARENA_H__
+#define __EP_MESSAGE_ARENA_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include <new>
+#include <cstddef>
+#include <climits>
+
+namespace epse{
+
+	/*! 
+	@class MessageArena epMessageArena.h
+	@brief A class for bump-pointer arena for the transient per-message allocations.
+	*/
+	class EP_SERVER_ENGINE MessageArena{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Arena
+		@param[in] blockByteSize the byte size of each arena block
+		@remark no memory is allocated until the first Allocate call.
+		*/
+		MessageArena(unsigned int blockByteSize=MESSAGE_ARENA_BLOCK_BYTE_SIZE);
+
+		/*!
+		Default Destructor
+
+		Destroy the Arena
+		*/
+		virtual ~MessageArena();
+
+		/*!
+		Allocate the memory of given size from the arena
+		@param[in] byteSize the byte size to allocate
+		@param[in] alignment the alignment of the memory (must be power of 2)
+		@return the pointer to the allocated memory, NULL if failed
+		@remark the memory is valid until Reset is called, and must not be freed individually.
+		*/
+		void *Allocate(unsigned int byteSize,unsigned int alignment=MESSAGE_ARENA_ALIGNMENT);
+
+		/*!
+		Release all the memory allocated from the arena at once
+		@remark the first block is kept for the next message.
+		*/
+		void Reset();
+
+		/*!
+		Get the byte size allocated from the arena since the last Reset
+		@return the used byte size
+		*/
+		unsigned int GetUsedByteSize() const;
+
+		/*!
+		Get the byte size of each arena block
+		@return the block byte size
+		*/
+		unsigned int GetBlockByteSize() const;
+
+		/*!
+		Get the arena of the message currently dispatched by the calling thread
+		@return the arena of the current dispatch, NULL if not dispatching
+		*/
+		static MessageArena *GetCurrentArena();
+
+	private:
+		friend class MessageArenaScope;
+
+		/*!
+		Set the arena of the message currently dispatched by the calling thread
+		@param[in] arena the arena to set
+		*/
+		static void setCurrentArena(MessageArena *arena);
+
+		/*!
+		Allocate new block which can hold at least given byte size
+		@param[in] byteSize the byte size the block must hold
+		@return true if successfully allocated otherwise false
+		*/
+		bool addBlock(unsigned int byteSize);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the Arena
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		MessageArena(const MessageArena& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		MessageArena & operator=(const MessageArena&b){return *this;}
+
+	private:
+		/*! 
+		@struct ArenaBlock epMessageArena.h
+		@brief A header of each arena block.
+		*/
+		struct ArenaBlock{
+			/// next block
+			ArenaBlock *m_next;
+			/// byte size of the block excluding the header
+			unsigned int m_byteSize;
+		};
+
+		/// first block (kept across Reset)
+		ArenaBlock *m_firstBlock;
+		/// block currently allocating from
+		ArenaBlock *m_currentBlock;
+		/// current position in the current block
+		char *m_cursor;
+		/// end of the current block
+		char *m_end;
+		/// block byte size
+		unsigned int m_blockByteSize;
+		/// used byte size since the last Reset
+		unsigned int m_usedByteSize;
+	};
+
+	/*! 
+	@class MessageArenaScope epMessageArena.h
+	@brief A class for binding the arena to the message dispatch of the calling thread.
+
+	The arena is reset when the scope ends (i.e. after OnReceived returns).
+	*/
+	class EP_SERVER_ENGINE MessageArenaScope{
+	public:
+		/*!
+		Default Constructor
+
+		Bind the given arena as the current arena of the calling thread
+		@param[in] arena the arena to bind (NULL for no arena)
+		*/
+		MessageArenaScope(MessageArena *arena);
+
+		/*!
+		Default Destructor
+
+		Reset the arena and restore the previous arena of the calling thread
+		*/
+		virtual ~MessageArenaScope();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the Scope
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		MessageArenaScope(const MessageArenaScope& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		MessageArenaScope & operator=(const MessageArenaScope&b){return *this;}
+
+	private:
+		/// arena bound
+		MessageArena *m_arena;
+		/// arena bound before this scope
+		MessageArena *m_prevArena;
+	};
+
+	/*! 
+	@class ArenaAllocator epMessageArena.h
+	@brief A STL-compatible allocator allocating from the MessageArena.
+
+	Containers using this allocator must not outlive the dispatch of the message.
+	If no arena is given and no message is dispatched, the global heap is used.
+	*/
+	template<typename T>
+	class ArenaAllocator{
+	public:
+		typedef T value_type;
+		typedef T* pointer;
+		typedef const T* const_pointer;
+		typedef T& reference;
+		typedef const T& const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		template<typename U>
+		struct rebind{
+			typedef ArenaAllocator<U> other;
+		};
+
+		/*!
+		Default Constructor
+
+		Initializes the Allocator
+		@param[in] arena the arena to allocate from (NULL for the arena of the current dispatch)
+		*/
+		ArenaAllocator(MessageArena *arena=NULL)
+		{
+			m_arena=arena?arena:MessageArena::GetCurrentArena();
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the Allocator
+		@param[in] b the second object
+		*/
+		ArenaAllocator(const ArenaAllocator& b)
+		{
+			m_arena=b.m_arena;
+		}
+
+		/*!
+		Rebinding Copy Constructor
+
+		Initializes the Allocator
+		@param[in] b the second object
+		*/
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& b)
+		{
+			m_arena=b.GetArena();
+		}
+
+		/*!
+		Get the arena of this allocator
+		@return the arena, NULL if the global heap is used
+		*/
+		MessageArena *GetArena() const
+		{
+			return m_arena;
+		}
+
+		pointer address(reference x) const
+		{
+			return &x;
+		}
+
+		const_pointer address(const_reference x) const
+		{
+			return &x;
+		}
+
+		pointer allocate(size_type n,const void *hint=0)
+		{
+			if(n>max_size())
+				throw std::bad_alloc();
+			if(!m_arena)
+				return reinterpret_cast<pointer>(::operator new(n*sizeof(T)));
+			void *retMem=m_arena->Allocate(static_cast<unsigned int>(n*sizeof(T)),__alignof(T));
+			if(!retMem)
+				throw std::bad_alloc();
+			return reinterpret_cast<pointer>(retMem);
+		}
+
+		void deallocate(pointer p,size_type n)
+		{
+			// arena memory is released at once on Reset
+			if(!m_arena)
+				::operator delete(p);
+		}
+
+		size_type max_size() const
+		{
+			return static_cast<size_type>(UINT_MAX)/sizeof(T);
+		}
+
+		void construct(pointer p,const_reference val)
+		{
+			new(reinterpret_cast<void*>(p)) T(val);
+		}
+
+		void destroy(pointer p)
+		{
+			p->~T();
+		}
+
+	private:
+		/// arena to allocate from
+		MessageArena *m_arena;
+	};
+
+	template<typename T,typename U>
+	inline bool operator==(const ArenaAllocator<T>& a,const ArenaAllocator<U>& b)
+	{
+		return a.GetArena()==b.GetArena();
+	}
+
+	template<typename T,typename U>
+	inline bool operator!=(const ArenaAllocator<T>& a,const ArenaAllocator<U>& b)
+	{
+		return a.GetArena()!=b.GetArena();
+	}
+}
+
+#endif //__EP_MESSAGE_ARENA_H__
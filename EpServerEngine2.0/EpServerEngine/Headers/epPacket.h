@@ -39,14 +39,21 @@ An Interface for Packet.
 #define __EP_PACKET_H__
 
 #include "epServerEngine.h"
+#include "epLockPolicy.h"
+#include "epMemoryBudget.h"
+#include "epBufferPool.h"
 
 namespace epse{
 
 	/*! 
-	@class Packet epPacket.h
-	@brief A class for Packet.
+	@class BasicPacket epPacket.h
+	@brief A class template for Packet on the given lock policy.
+
+	Packet is BasicPacket on RuntimeLockPolicy, which keeps the epl::LockPolicy constructor.
+	The packets owned by a single thread can use BasicPacket<NoLockPolicy>.
 	*/
-	class EP_SERVER_ENGINE Packet:public epl::SmartObject{
+	template<typename LockPolicyType>
+	class BasicPacket:public epl::SmartObject{
 
 	public:
 		/*!
@@ -58,7 +65,7 @@ namespace epse{
 		@param[in] shouldAllocate flag for the allocation of memory for itself
 		@param[in] lockPolicyType The lock policy
 		*/
-		Packet(const void *packet=NULL, unsigned int byteSize=0, bool shouldAllocate=true, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+		BasicPacket(const void *packet=NULL, unsigned int byteSize=0, bool shouldAllocate=true, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
 
 		/*!
 		Default Copy Constructor
@@ -66,7 +73,7 @@ namespace epse{
 		Initializes the Packet
 		@param[in] b the original Packet object
 		*/
-		Packet(const Packet& b);
+		BasicPacket(const BasicPacket& b);
 
 		/*!
 		Assignment Operator Overloading
@@ -75,20 +82,20 @@ namespace epse{
 		@param[in] b right side of packet
 		@return this object
 		*/
-		Packet & operator=(const Packet&b);
+		BasicPacket & operator=(const BasicPacket&b);
 
 		/*!
 		Default Destructor
 
 		Destroy the Packet
 		*/
-		virtual ~Packet();
+		virtual ~BasicPacket();
 
 		/*!
 		Return the currently stored packet byte size
 		@return byte size of the holding packet
 		*/
-		 unsigned int GetPacketByteSize() const;
+		unsigned int GetPacketByteSize() const;
 
 		/*!
 		Get the flag whether memory is allocated or not
@@ -112,12 +119,52 @@ namespace epse{
 		*/
 		void SetPacket(const void* packet, unsigned int packetByteSize);
 
+		/*!
+		Charge the byte size of the packet to the given budget until the packet is destroyed
+		@param[in] budget the memory budget to charge
+		@return true if charged, false if the budget is exceeded
+		@remark the packet can be charged to only one budget.
+		*/
+		bool ChargeMemoryBudget(MemoryBudget *budget);
+
+		/*!
+		Allocate the packet memory from the given buffer pool
+		@param[in] bufferPool the buffer pool to allocate from
+		@param[in] packetByteSize the byte size of the packet
+		@return true if allocated from the pool, otherwise false and the packet is unchanged
+		@remark the memory is not initialized, and returned to the pool when the packet is destroyed.
+		*/
+		bool AllocateFromPool(BufferPool *bufferPool,unsigned int packetByteSize);
+
+		/*!
+		Get the UDP channel id the packet is received on
+		@return the channel id
+		@remark 0 if the channel layer is not used.
+		*/
+		unsigned int GetChannelId() const;
+
+		/*!
+		Set the UDP channel id the packet is received on
+		@param[in] channelId the channel id
+		*/
+		void SetChannelId(unsigned int channelId);
+
 	private:
 
 		/*!
 		Reset Packet
 		*/
 		void resetPacket();
+
+		/*!
+		Release the charge to the memory budget
+		*/
+		void releaseMemoryBudget();
+
+		/*!
+		Free the allocated packet memory
+		*/
+		void freePacket();
 		/// packet
 		char *m_packet;
 		/// packet Byte Size
@@ -125,10 +172,245 @@ namespace epse{
 		/// flag whether memory is allocated in this object or now
 		bool m_isAllocated;
 		/// lock
-		epl::BaseLock *m_packetLock;
+		mutable LockPolicyType m_packetLock;
 		/// Lock Policy
 		epl::LockPolicy m_lockPolicy;
+
+		/// memory budget charged
+		MemoryBudget *m_memoryBudget;
+
+		/// byte size charged to the memory budget
+		unsigned int m_chargedByteSize;
+
+		/// buffer pool the packet memory is allocated from
+		BufferPool *m_bufferPool;
+
+		/// UDP channel id
+		unsigned int m_channelId;
 	};
+
+	/// Packet on the lock policy chosen by epl::LockPolicy at runtime
+	typedef BasicPacket<RuntimeLockPolicy> Packet;
+
+	template<typename LockPolicyType>
+	BasicPacket<LockPolicyType>::BasicPacket(const void *packet, unsigned int byteSize, bool shouldAllocate, epl::LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_packetLock(lockPolicyType)
+	{
+		m_packet=NULL;
+		m_packetSize=0;
+		m_isAllocated=shouldAllocate;
+		m_memoryBudget=NULL;
+		m_chargedByteSize=0;
+		m_bufferPool=NULL;
+		m_channelId=0;
+		if(shouldAllocate)
+		{
+			if(byteSize>0)
+			{
+				m_packet=EP_NEW char[byteSize];
+				if(packet)
+					epl::System::Memcpy(m_packet,packet,byteSize);
+				else
+					epl::System::Memset(m_packet,0,byteSize);
+				m_packetSize=byteSize;
+			}
+		}
+		else
+		{
+			m_packet=reinterpret_cast<char*>(const_cast<void*>(packet));
+			m_packetSize=byteSize;
+		}
+		m_lockPolicy=lockPolicyType;
+	}
+
+	template<typename LockPolicyType>
+	BasicPacket<LockPolicyType>::BasicPacket(const BasicPacket<LockPolicyType>& b):SmartObject(b),m_packetLock(b.m_packetLock)
+	{
+		m_memoryBudget=NULL;
+		m_chargedByteSize=0;
+		m_bufferPool=NULL;
+		m_lockPolicy=b.m_lockPolicy;
+
+		ScopedLock<LockPolicyType> lock(b.m_packetLock);
+		m_channelId=b.m_channelId;
+		m_packet=NULL;
+		if(b.m_isAllocated)
+		{
+			if(b.m_packetSize>0)
+			{
+				m_packet=EP_NEW char[b.m_packetSize];
+				epl::System::Memcpy(m_packet,b.m_packet,b.m_packetSize);
+			}
+			m_packetSize=b.m_packetSize;
+		}
+		else
+		{
+			m_packet=b.m_packet;
+			m_packetSize=b.m_packetSize;
+		}
+		m_isAllocated=b.m_isAllocated;
+
+	}
+
+	template<typename LockPolicyType>
+	BasicPacket<LockPolicyType> & BasicPacket<LockPolicyType>::operator=(const BasicPacket<LockPolicyType>&b)
+	{
+		if(this!=&b)
+		{
+			resetPacket();
+			releaseMemoryBudget();
+
+			SmartObject::operator =(b);
+
+			m_lockPolicy=b.m_lockPolicy;
+			m_packetLock.SetLockPolicy(m_lockPolicy);
+
+			ScopedLock<LockPolicyType> lock(b.m_packetLock);
+			m_channelId=b.m_channelId;
+			m_packet=NULL;
+			if(b.m_isAllocated)
+			{
+				if(b.m_packetSize>0)
+				{
+					m_packet=EP_NEW char[b.m_packetSize];
+					epl::System::Memcpy(m_packet,b.m_packet,b.m_packetSize);
+				}
+				m_packetSize=b.m_packetSize;
+			}
+			else
+			{
+				m_packet=b.m_packet;
+				m_packetSize=b.m_packetSize;
+			}
+			m_isAllocated=b.m_isAllocated;
+
+		}
+		return *this;
+	}
+
+	template<typename LockPolicyType>
+	void BasicPacket<LockPolicyType>::resetPacket()
+	{
+		m_packetLock.Lock();
+		freePacket();
+		m_packetLock.Unlock();
+	}
+
+	template<typename LockPolicyType>
+	BasicPacket<LockPolicyType>::~BasicPacket()
+	{
+		resetPacket();
+		releaseMemoryBudget();
+	}
+
+	template<typename LockPolicyType>
+	void BasicPacket<LockPolicyType>::freePacket()
+	{
+		if(m_isAllocated && m_packet)
+		{
+			if(m_bufferPool)
+				m_bufferPool->Free(m_packet);
+			else
+				EP_DELETE[] m_packet;
+		}
+		m_packet=NULL;
+		if(m_bufferPool)
+			m_bufferPool->ReleaseObj();
+		m_bufferPool=NULL;
+	}
+
+	template<typename LockPolicyType>
+	bool BasicPacket<LockPolicyType>::AllocateFromPool(BufferPool *bufferPool,unsigned int packetByteSize)
+	{
+		EP_ASSERT(bufferPool);
+		ScopedLock<LockPolicyType> lock(m_packetLock);
+		if(!m_isAllocated)
+			return false;
+		void *buffer=bufferPool->Allocate(packetByteSize);
+		if(!buffer)
+			return false;
+		freePacket();
+		bufferPool->RetainObj();
+		m_bufferPool=bufferPool;
+		m_packet=reinterpret_cast<char*>(buffer);
+		m_packetSize=packetByteSize;
+		return true;
+	}
+
+	template<typename LockPolicyType>
+	void BasicPacket<LockPolicyType>::releaseMemoryBudget()
+	{
+		if(m_memoryBudget)
+		{
+			m_memoryBudget->Release(m_chargedByteSize);
+			m_memoryBudget->ReleaseObj();
+		}
+		m_memoryBudget=NULL;
+		m_chargedByteSize=0;
+	}
+
+	template<typename LockPolicyType>
+	bool BasicPacket<LockPolicyType>::ChargeMemoryBudget(MemoryBudget *budget)
+	{
+		EP_ASSERT(budget);
+		ScopedLock<LockPolicyType> lock(m_packetLock);
+		EP_ASSERT(!m_memoryBudget);
+		if(!budget->Acquire(m_packetSize))
+			return false;
+		budget->RetainObj();
+		m_memoryBudget=budget;
+		m_chargedByteSize=m_packetSize;
+		return true;
+	}
+
+	template<typename LockPolicyType>
+	unsigned int BasicPacket<LockPolicyType>::GetPacketByteSize() const
+	{
+		return m_packetSize;
+	}
+
+	template<typename LockPolicyType>
+	const char *BasicPacket<LockPolicyType>::GetPacket() const
+	{
+		return m_packet;	
+	}
+
+	template<typename LockPolicyType>
+	void BasicPacket<LockPolicyType>::SetPacket(const void* packet, unsigned int packetByteSize)
+	{
+		ScopedLock<LockPolicyType> lock(m_packetLock);
+		if(m_isAllocated)
+		{
+			freePacket();
+			if(packetByteSize>0)
+			{
+				m_packet=EP_NEW char[packetByteSize];
+				EP_ASSERT(m_packet);
+			}
+			if(packet)
+				epl::System::Memcpy(m_packet,packet,packetByteSize);
+			else
+				epl::System::Memset(m_packet,0,packetByteSize);
+			m_packetSize=packetByteSize;
+
+		}
+		else
+		{
+			m_packet=reinterpret_cast<char*>(const_cast<void*>(packet));
+			m_packetSize=packetByteSize;
+		}
+	}
+
+	template<typename LockPolicyType>
+	unsigned int BasicPacket<LockPolicyType>::GetChannelId() const
+	{
+		return m_channelId;
+	}
+
+	template<typename LockPolicyType>
+	void BasicPacket<LockPolicyType>::SetChannelId(unsigned int channelId)
+	{
+		m_channelId=channelId;
+	}
 }
 
 
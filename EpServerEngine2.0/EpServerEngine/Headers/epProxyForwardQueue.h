@@ -0,0 +1,202 @@
+/*! 
+@file epProxyForwardQueue.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy Forward Queue Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Proxy Forward Queue.
+
+Decouples receiving from forwarding for one direction of a proxied session.
+The receiving thread only queues the packet, and the shared forward worker
+forwards it while the peer is writable. When the queued byte size reaches the
+high watermark, the receiving thread waits until the queue is drained to the
+low watermark, so it stops reading from its peer and the memory held for a
+slow peer is bounded.
+
+*/
+#ifndef __EP_PROXY_FORWARD_QUEUE_H__
+#define __EP_PROXY_FORWARD_QUEUE_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epPacket.h"
+#include "epProxyForwardWorker.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <deque>
+using namespace std;
+
+namespace epse{
+
+	class BaseProxyHandler;
+
+	/*! 
+	@class ProxyForwardQueue epProxyForwardQueue.h
+	@brief A class for the queue forwarding one direction of a proxied session.
+	*/
+	class EP_SERVER_ENGINE ProxyForwardQueue{
+		friend class ProxyForwardWorker;
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the queue
+		@param[in] handler the handler to forward the packets with
+		@param[in] isFromClient flag whether the packets are from the client, otherwise from the forward server
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyForwardQueue(BaseProxyHandler *handler,bool isFromClient,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the queue
+		*/
+		virtual ~ProxyForwardQueue();
+
+		/*!
+		Open the queue, and start forwarding
+		@param[in] worker the worker to forward the queue on
+		@param[in] highWatermarkByteSize the queued byte size to stop receiving at
+		@param[in] lowWatermarkByteSize the queued byte size to resume receiving at
+		@return true if opened, otherwise false
+		@remark a queue closed is not opened again.
+		*/
+		bool Open(ProxyForwardWorker *worker,unsigned int highWatermarkByteSize,unsigned int lowWatermarkByteSize);
+
+		/*!
+		Close the queue, and release the packets left
+		@param[in] waitTimeInMilliSec wait time for the worker to finish the packet being forwarded
+		@return true if no packet is being forwarded, otherwise false
+		@remark wakes the threads waiting in Push or Flush.
+		*/
+		bool Close(unsigned int waitTimeInMilliSec=PROXY_FORWARD_CLOSE_WAITTIME_MILLISEC);
+
+		/*!
+		Queue the packet to forward
+		@param[in] packet the packet to forward
+		@param[in] waitTimeInMilliSec wait time for the queue over the high watermark to drain
+		@return true if queued, false if the queue is closed, or not drained in time
+		@remark the packet is retained until forwarded.
+		@remark waits on the calling thread while the queue is over the high watermark.
+		*/
+		bool Push(const Packet *packet,unsigned int waitTimeInMilliSec=PROXY_FORWARD_DRAIN_WAITTIME_MILLISEC);
+
+		/*!
+		Wait until all the packets queued are forwarded
+		@param[in] waitTimeInMilliSec wait time for the packets to be forwarded
+		@return true if all forwarded, otherwise false
+		@remark returns when the queue is closed.
+		*/
+		bool Flush(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Get the byte size of the packets queued and being forwarded
+		@return the byte size queued
+		*/
+		unsigned int GetQueuedByteSize() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the queue
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyForwardQueue(const ProxyForwardQueue& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyForwardQueue & operator=(const ProxyForwardQueue&b){return *this;}
+
+		/// the result of forwarding a batch of the queue
+		typedef enum _forwardStatus{
+			/// nothing left to forward, or closed
+			FORWARD_STATUS_EMPTY=0,
+			/// more left to forward after the batch
+			FORWARD_STATUS_MORE,
+			/// the peer is not writable
+			FORWARD_STATUS_BLOCKED,
+		}ForwardStatus;
+
+		/*!
+		Forward the packets queued while the peer is writable, up to a batch
+		@return the result of forwarding
+		@remark called by the worker only.
+		*/
+		ForwardStatus forward();
+
+		/*!
+		Release the packets queued
+		*/
+		void clear();
+
+	private:
+		/// the handler to forward the packets with
+		BaseProxyHandler *m_handler;
+		/// flag whether the packets are from the client
+		bool m_isFromClient;
+		/// the worker forwarding the queue
+		ProxyForwardWorker *m_worker;
+		/// packets to forward
+		deque<Packet*> m_queue;
+		/// byte size of the packets queued and being forwarded
+		unsigned int m_queuedByteSize;
+		/// the queued byte size to stop receiving at
+		unsigned int m_highWatermarkByteSize;
+		/// the queued byte size to resume receiving at
+		unsigned int m_lowWatermarkByteSize;
+		/// flag whether the queue is opened
+		bool m_isOpened;
+		/// queue lock
+		mutable RuntimeLightLockPolicy m_queueLock;
+		/// event raised while under the low watermark, or closed
+		LightEvent m_drainEvent;
+		/// event raised while nothing is queued, or closed
+		LightEvent m_emptyEvent;
+
+		/// flag whether listed on the worker, or to be listed once forwarded, guarded by the worker lock
+		bool m_isScheduled;
+		/// flag whether being forwarded by the worker, guarded by the worker lock
+		bool m_isForwarding;
+		/// flag whether unscheduled for good, guarded by the worker lock
+		bool m_isUnscheduled;
+		/// event raised while not being forwarded by the worker
+		LightEvent m_idleEvent;
+	};
+}
+
+#endif //__EP_PROXY_FORWARD_QUEUE_H__
@@ -0,0 +1,186 @@
+/*! 
+@file epProxyForwardWorker.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy Forward Worker Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Proxy Forward Worker.
+
+Forwards the packets queued for all the proxied sessions on a fixed set of
+threads. A queue with the packets to forward is scheduled on the worker, which
+forwards a batch of it while its peer is writable, and checks it again later
+otherwise, so a slow peer never holds a thread.
+
+*/
+#ifndef __EP_PROXY_FORWARD_WORKER_H__
+#define __EP_PROXY_FORWARD_WORKER_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <vector>
+#include <deque>
+using namespace std;
+
+namespace epse{
+
+	class ProxyForwardQueue;
+
+	/*! 
+	@class ProxyForwardWorker epProxyForwardWorker.h
+	@brief A class for the threads forwarding the queues of the proxied sessions.
+	*/
+	class EP_SERVER_ENGINE ProxyForwardWorker{
+		friend class ProxyForwardQueue;
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the worker
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyForwardWorker(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the worker
+		*/
+		virtual ~ProxyForwardWorker();
+
+		/*!
+		Start the threads forwarding
+		@param[in] workerCount the number of the threads, 0 for the number of the cores
+		@return true if started, otherwise false
+		*/
+		bool StartWorker(unsigned int workerCount=0);
+
+		/*!
+		Stop the threads forwarding
+		@param[in] waitTimeInMilliSec wait time for each thread to terminate
+		@remark the queues scheduled are left unforwarded.
+		*/
+		void StopWorker(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Check if the threads are started
+		@return true if started, otherwise false
+		*/
+		bool IsWorkerStarted() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the worker
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyForwardWorker(const ProxyForwardWorker& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyForwardWorker & operator=(const ProxyForwardWorker&b){return *this;}
+
+		/*! 
+		@class ForwardThread epProxyForwardWorker.h
+		@brief A class for a thread of the worker.
+		*/
+		class ForwardThread:public epl::Thread{
+		public:
+			/*!
+			Default Constructor
+
+			Initializes the thread
+			@param[in] worker the worker
+			@param[in] lockPolicyType The lock policy
+			*/
+			ForwardThread(ProxyForwardWorker *worker,epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+			{
+				m_worker=worker;
+			}
+		protected:
+			/*!
+			Forwarding Loop Function
+			*/
+			virtual void execute()
+			{
+				m_worker->forwardQueues();
+			}
+		private:
+			/// the worker
+			ProxyForwardWorker *m_worker;
+		};
+
+		/*!
+		Forward the queues scheduled until stopped
+		*/
+		void forwardQueues();
+
+		/*!
+		Schedule the queue to forward
+		@param[in] queue the queue with the packets to forward
+		*/
+		void schedule(ProxyForwardQueue *queue);
+
+		/*!
+		Unschedule the queue closed
+		@param[in] queue the queue closed
+		@return true if not being forwarded, otherwise false, and its idle event is raised when done
+		*/
+		bool unschedule(ProxyForwardQueue *queue);
+
+	private:
+		/// the threads forwarding
+		vector<ForwardThread*> m_threadList;
+		/// the queues ready to forward
+		deque<ProxyForwardQueue*> m_readyList;
+		/// the queues whose peer was not writable
+		vector<ProxyForwardQueue*> m_blockedList;
+		/// the tick when the queues blocked are checked again
+		unsigned int m_retryTick;
+		/// flag whether the threads are started
+		bool m_isStarted;
+		/// worker lock, also guarding the scheduled state of the queues
+		mutable RuntimeLightLockPolicy m_workerLock;
+		/// auto-reset event to wake a thread to forward or to stop
+		LightEvent m_wakeEvent;
+		/// Lock Policy
+		epl::LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_PROXY_FORWARD_WORKER_H__
@@ -0,0 +1,178 @@
+/*! 
+@file epProxyMuxHandler.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy Multiplexing Handler Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Proxy Multiplexing Handler.
+
+Handles a proxied client as a session multiplexed over the shared connections
+of ProxyMuxPool.
+
+*/
+#ifndef __EP_PROXY_MUX_HANDLE_H__
+#define __EP_PROXY_MUX_HANDLE_H__
+#include "epServerEngine.h"
+#include "epBaseProxyHandler.h"
+#include "epBaseTcpSocket.h"
+#include "epProxyMuxPool.h"
+#include <deque>
+using namespace std;
+
+
+namespace epse{
+
+
+	/*! 
+	@class ProxyMuxHandler epProxyMuxHandler.h
+	@brief A class for Proxy Multiplexing Handler.
+	*/
+	class ProxyMuxHandler:public BaseProxyHandler{
+
+		friend class ProxyTcpServer;
+		friend class ProxyMuxConnection;
+		friend class ProxyMuxPool;
+	private:
+		/*!
+		Default Constructor
+
+		Initializes the Handler
+		@param[in] callBack the callback object
+		@param[in] forwardServerInfo the forward server info
+		@param[in] socket the client socket
+		@param[in] muxPool the pool to open the session on
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyMuxHandler(ProxyServerCallbackInterface *callBack,const ForwardServerInfo& forwardServerInfo, SocketInterface *socket, ProxyMuxPool *muxPool, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+
+		/*!
+		Default Destructor
+
+		Destroy the Handler
+		*/
+		virtual ~ProxyMuxHandler();
+
+		/*!
+		Received the packet from the client, and send it on the session.
+		@param[in] socket the client socket which received the packet
+		@param[in] receivedPacket the received packet
+		@param[in] status the status of Receive
+		@remark waits on the thread of the client while the session has not the credit for the packet.
+		@remark the packet over the whole window is sent once all the credit is back.
+		*/
+		void OnReceived(SocketInterface *socket,const Packet *receivedPacket,ReceiveStatus status);
+
+		/*!
+		Close the session, when the client socket is disconnected.
+		*/
+		virtual void releaseForwardClient();
+
+		/*!
+		Check if the session is open
+		@return true if open, otherwise false
+		*/
+		virtual bool isForwardConnected() const;
+
+		/*!
+		Queue the data received on the session to deliver to the client
+		@param[in] data the data
+		@param[in] dataByteSize the byte size of the data
+		@return false if the session is reset as the data is over the window, otherwise true
+		@remark the client of the session reset is disconnected by the delivering thread.
+		*/
+		bool queueFromForwardServer(const char *data,unsigned int dataByteSize);
+
+		/*!
+		Add the credit to send on the session
+		@param[in] credit the credit in byte
+		*/
+		void addSendCredit(unsigned int credit);
+
+		/*!
+		Close the session, when the forward server closed it
+		*/
+		void closeByForwardServer();
+
+		/*!
+		Deliver the data queued to the client, and grant the window consumed, without waiting for the client or the forward server
+		@return true if the data is left to deliver or the window is left to grant, otherwise false
+		@remark called on the delivering thread of the pool.
+		*/
+		bool deliver();
+
+		/*!
+		Check if the client should be disconnected, once the data queued is delivered
+		@return true if the session is closed by the forward server, otherwise false
+		*/
+		bool isClosing() const;
+
+		/*!
+		Disconnect the client
+		*/
+		void killClient();
+
+		/*!
+		Release the data queued
+		*/
+		void clearQueue();
+
+	private:
+		/// the pool the session is opened on
+		ProxyMuxPool *m_muxPool;
+		/// the connection the session is opened on
+		ProxyMuxConnection *m_muxConnection;
+		/// session ID
+		unsigned int m_sessionId;
+		/// credit in byte to send on the session
+		int m_sendCredit;
+		/// event raised when the credit is added or the session is closed
+		LightEvent m_creditEvent;
+		/// data received on the session to deliver to the client
+		deque<Packet*> m_deliverQueue;
+		/// byte size of the data queued
+		unsigned int m_queuedByteSize;
+		/// byte offset sent of the frame at the front of the deliver queue, accessed by the delivering thread only
+		unsigned int m_deliverOffset;
+		/// byte size delivered and not granted yet by a window frame, accessed by the delivering thread only
+		unsigned int m_grantByteSize;
+		/// flag whether the session is closed
+		bool m_isClosed;
+		/// flag whether the session is closed by the forward server
+		bool m_isClosedByForwardServer;
+		/// flag whether in the ready list of the pool, guarded by the pool
+		bool m_isReady;
+		/// session lock
+		mutable RuntimeLockPolicy m_muxLock;
+	};
+}
+
+#endif //__EP_PROXY_MUX_HANDLE_H__
@@ -0,0 +1,336 @@
+/*! 
+@file epProxyMuxPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy Multiplexing Pool Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Proxy Multiplexing Pool.
+
+Carries the sessions of many proxied clients over a few persistent connections
+to each forward server. Each packet on the connection is a frame tagged with
+the session ID, and the frames received are demultiplexed back to the client
+of the session. Each side of a session may send PROXY_MUX_SESSION_WINDOW_BYTE_SIZE
+bytes ahead, and grants more by a window frame once the bytes are consumed, so
+a slow client holds back only its own session instead of the shared connection.
+
+The frame is the 8 byte header of the session ID and the frame type, each as
+4 byte unsigned integer, followed by the data of the frame type. The forward
+server may use ProxyMuxFrame to make and to parse the frames.
+
+*/
+#ifndef __EP_PROXY_MUX_POOL_H__
+#define __EP_PROXY_MUX_POOL_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epPacket.h"
+#include "epProxyServerInterfaces.h"
+#include "epBaseClient.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <vector>
+#include <map>
+using namespace std;
+
+namespace epse{
+
+	class ProxyMuxHandler;
+
+	/*! 
+	@struct ProxyMuxFrameHeader epProxyMuxPool.h
+	@brief A class for the header of a multiplexing frame.
+	*/
+	struct ProxyMuxFrameHeader{
+		/// session ID
+		unsigned int sessionId;
+		/// frame type
+		unsigned int frameType;
+	};
+
+	/*! 
+	@class ProxyMuxFrame epProxyMuxPool.h
+	@brief A class for making and parsing the multiplexing frames.
+	*/
+	class EP_SERVER_ENGINE ProxyMuxFrame{
+	public:
+		/*!
+		Make the frame
+		@param[in] sessionId the session ID
+		@param[in] frameType the frame type
+		@param[in] data the data of the frame
+		@param[in] dataByteSize the byte size of the data
+		@return the new packet of the frame
+		@remark the packet must be released by ReleaseObj.
+		*/
+		static Packet *MakeFrame(unsigned int sessionId,ProxyMuxFrameType frameType,const void *data=NULL,unsigned int dataByteSize=0);
+
+		/*!
+		Parse the frame
+		@param[in] packet the packet of the frame
+		@param[out] retHeader the header of the frame
+		@param[out] retData the data of the frame, within the packet
+		@param[out] retDataByteSize the byte size of the data
+		@return true if the packet is a frame, otherwise false
+		*/
+		static bool ParseFrame(const Packet &packet,ProxyMuxFrameHeader &retHeader,const char *&retData,unsigned int &retDataByteSize);
+	};
+
+	/*! 
+	@class ProxyMuxConnection epProxyMuxPool.h
+	@brief A class for a connection to the forward server carrying the multiplexed sessions.
+	*/
+	class EP_SERVER_ENGINE ProxyMuxConnection:public ClientCallbackInterface{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the connection
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyMuxConnection(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the connection
+		*/
+		virtual ~ProxyMuxConnection();
+
+		/*!
+		Connect to the forward server
+		@param[in] hostName the hostname of the forward server
+		@param[in] port the port of the forward server
+		@return true if connected, otherwise false
+		*/
+		bool Connect(const TCHAR *hostName,const TCHAR *port);
+
+		/*!
+		Disconnect, and close all the sessions on the connection
+		*/
+		void Disconnect();
+
+		/*!
+		Check if connected to the forward server
+		@return true if connected, otherwise false
+		*/
+		bool IsConnected() const;
+
+		/*!
+		Get the number of the sessions on the connection
+		@return the number of the sessions
+		*/
+		unsigned int GetSessionCount() const;
+
+		/*!
+		Open the session of the handler on the connection
+		@param[in] handler the handler of the session
+		@return true if opened, otherwise false
+		*/
+		bool Attach(ProxyMuxHandler *handler);
+
+		/*!
+		Close the session of the handler on the connection
+		@param[in] handler the handler of the session
+		@remark the handler is not called back after this returns.
+		*/
+		void Detach(ProxyMuxHandler *handler);
+
+		/*!
+		Send the frame to the forward server
+		@param[in] sessionId the session ID
+		@param[in] frameType the frame type
+		@param[in] data the data of the frame
+		@param[in] dataByteSize the byte size of the data
+		@param[in] waitTimeInMilliSec wait time for the connection to be writable in millisecond
+		@param[out] sendStatus the status of the send
+		@return true if sent, otherwise false
+		*/
+		bool SendFrame(unsigned int sessionId,ProxyMuxFrameType frameType,const void *data=NULL,unsigned int dataByteSize=0,unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+	protected:
+		/*!
+		Received the frame from the forward server.
+		@param[in] client the client which received the packet
+		@param[in] receivedPacket the received packet
+		@param[in] status the status of Receive
+		*/
+		virtual void OnReceived(ClientInterface *client,const Packet*receivedPacket,ReceiveStatus status);
+
+		/*!
+		The connection is disconnected.
+		@param[in] client the client, disconnected.
+		*/
+		virtual void OnDisconnect(ClientInterface *client);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the connection
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyMuxConnection(const ProxyMuxConnection& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyMuxConnection & operator=(const ProxyMuxConnection&b){return *this;}
+
+		/// the client connected to forward server
+		BaseClient *m_client;
+		/// sessions on the connection by the session ID
+		map<unsigned int,ProxyMuxHandler*> m_sessionMap;
+		/// session lock
+		mutable RuntimeLockPolicy m_sessionLock;
+	};
+
+	/*! 
+	@class ProxyMuxPool epProxyMuxPool.h
+	@brief A class for the connections multiplexing the sessions to the forward servers, and the thread delivering to the clients.
+	*/
+	class EP_SERVER_ENGINE ProxyMuxPool:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the pool
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyMuxPool(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the pool
+		*/
+		virtual ~ProxyMuxPool();
+
+		/*!
+		Start the pool
+		@param[in] connectionCount the number of the connections to each forward server
+		@return true if started, otherwise false
+		*/
+		bool StartPool(unsigned int connectionCount);
+
+		/*!
+		Stop the pool, and disconnect all the connections
+		@param[in] waitTimeInMilliSec wait time for the thread to terminate
+		*/
+		void StopPool(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Check if the pool is started
+		@return true if the pool is started otherwise false
+		*/
+		bool IsPoolStarted() const;
+
+		/*!
+		Open the session of the handler on the least loaded connection to the forward server
+		@param[in] forwardServerInfo the forward server info
+		@param[in] handler the handler of the session
+		@return the connection opened on, or NULL if failed to connect
+		*/
+		ProxyMuxConnection *Attach(const ForwardServerInfo &forwardServerInfo,ProxyMuxHandler *handler);
+
+		/*!
+		Close the session of the handler
+		@param[in] connection the connection opened on, or NULL if closed already
+		@param[in] handler the handler of the session
+		@remark the handler is not delivered after this returns.
+		*/
+		void Detach(ProxyMuxConnection *connection,ProxyMuxHandler *handler);
+
+		/*!
+		Mark the handler to deliver to its client, or to close its client
+		@param[in] handler the handler of the session
+		*/
+		void MarkReady(ProxyMuxHandler *handler);
+
+	protected:
+		/*!
+		Delivering Loop Function
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the pool
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyMuxPool(const ProxyMuxPool& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyMuxPool & operator=(const ProxyMuxPool&b){return *this;}
+
+		/// connections to a forward server
+		struct Upstream{
+			/// hostname of the forward server
+			epl::EpTString m_hostName;
+			/// port of the forward server
+			epl::EpTString m_port;
+			/// connections
+			vector<ProxyMuxConnection*> m_connectionList;
+		};
+
+		/// forward servers
+		vector<Upstream*> m_upstreamList;
+		/// handlers to deliver or to close
+		vector<ProxyMuxHandler*> m_readyList;
+		/// the number of the connections to each forward server
+		unsigned int m_connectionCount;
+		/// the next session ID
+		unsigned int m_nextSessionId;
+		/// flag whether the pool is started
+		bool m_isStarted;
+		/// pool lock
+		mutable RuntimeLockPolicy m_poolLock;
+		/// lock held while delivering
+		RuntimeLightLockPolicy m_deliverLock;
+		/// event to wake the delivering thread
+		LightEvent m_wakeEvent;
+		/// Lock Policy
+		epl::LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_PROXY_MUX_POOL_H__
@@ -43,6 +43,7 @@ An Interface for Proxy Server Interfaces.
 namespace epse{
 
 	class ProxyServerCallbackInterface;
+	class ProxyUpstreamGroup;
 
 	/*! 
 	@class ForwardServerInfo epProxyServerInterfaces.h
@@ -80,6 +81,36 @@ namespace epse{
 		const TCHAR *port;
 		///The maximum possible number of client connection
 		unsigned int maximumConnectionCount;
+		/// Flag whether the connections to the forward servers are pooled (TCP only)
+		bool isUpstreamPooled;
+		/// The number of the idle connections kept for each forward server
+		unsigned int upstreamPoolMinimumCount;
+		/// The maximum number of the pooled connections for each forward server (0 means there is no limit)
+		unsigned int upstreamPoolMaximumCount;
+		/// The period in millisecond to reap the closed connections and to refill
+		unsigned int upstreamHealthCheckMilliSec;
+		/// Flag whether the forward servers speak a stateless request/response protocol, so the connection is returned to the pool when its client disconnects
+		bool isUpstreamStateless;
+		/// Flag whether the raw bytes, or the datagrams for UDP, are relayed without the packets and the callbacks
+		bool isPassthrough;
+		/// Upstream group to choose the forward server from, or NULL to get it from the callback object
+		ProxyUpstreamGroup *upstreamGroup;
+		/// Number of the upstream connections to multiplex the clients of each forward server over, or 0 not to multiplex (TCP only)
+		unsigned int muxConnectionCount;
+		/// Flag whether each direction is forwarded through a queue, which stops reading the sender over the high watermark (TCP only)
+		bool isBackpressured;
+		/// The queued byte size of a direction to stop reading its sender at
+		unsigned int highWatermarkByteSize;
+		/// The queued byte size of a direction to resume reading its sender at
+		unsigned int lowWatermarkByteSize;
+		/// The number of the threads forwarding the queues of all the sessions, 0 for the number of the cores (TCP backpressured only)
+		unsigned int forwardWorkerCount;
+		/// The number of the threads relaying the datagrams from the forward servers, 0 for the number of the cores (UDP passthrough only)
+		unsigned int udpRelayWorkerCount;
+		/// The idle time in millisecond until the binding of a client to its forward server expires (UDP passthrough only)
+		unsigned int udpBindingExpiryMilliSec;
+		/// The maximum number of the clients bound at once, and the datagrams from a new client are dropped at it (UDP passthrough only)
+		unsigned int udpBindingLimit;
 
 		/*!
 		Default Constructor
@@ -91,6 +122,21 @@ namespace epse{
 			callBackObj=NULL;
 			port=_T(DEFAULT_PORT);
 			maximumConnectionCount=CONNECTION_LIMIT_INFINITE;
+			isUpstreamPooled=false;
+			upstreamPoolMinimumCount=PROXY_UPSTREAM_POOL_MIN_COUNT;
+			upstreamPoolMaximumCount=CONNECTION_LIMIT_INFINITE;
+			upstreamHealthCheckMilliSec=PROXY_UPSTREAM_HEALTH_CHECK_MILLISEC;
+			isUpstreamStateless=false;
+			isPassthrough=false;
+			upstreamGroup=NULL;
+			muxConnectionCount=0;
+			isBackpressured=false;
+			highWatermarkByteSize=PROXY_FORWARD_HIGH_WATERMARK_BYTE_SIZE;
+			lowWatermarkByteSize=PROXY_FORWARD_LOW_WATERMARK_BYTE_SIZE;
+			forwardWorkerCount=0;
+			udpRelayWorkerCount=0;
+			udpBindingExpiryMilliSec=PROXY_UDP_BINDING_EXPIRY_MILLISEC;
+			udpBindingLimit=PROXY_UDP_RELAY_BINDING_LIMIT;
 		}
 
 		/// Default Proxy Server Options
@@ -184,6 +230,18 @@ namespace epse{
 			return true;
 		}
 
+		/*!
+		When new client tries to connect.
+		@param[in] sockAddr the client's full socket address which tries to connect
+		@param[in] sockAddrSize the byte size of the socket address
+		@return true to accept the connection otherwise false.
+		@remark The default calls OnAccept(sockaddr), which only holds the IPv4 address.
+		*/
+		virtual bool OnAccept(const sockaddr *sockAddr,int sockAddrSize)
+		{
+			return OnAccept(*sockAddr);
+		}
+
 		/*!
 		Received the packet from the client.
 		@param[in] clientSocket the client socket which the packet is received from
@@ -220,9 +278,12 @@ namespace epse{
 		Get the forward server info
 		@param[in] socketAddr the sockaddr of the client which tries to connect
 		@return the forward server info
-		@remark the subclass must specify the forward server info!
+		@remark the subclass must specify the forward server info, unless the upstream group is given!
 		*/
-		virtual ForwardServerInfo GetForwardServerInfo(const sockaddr &socketAddr)=0;
+		virtual ForwardServerInfo GetForwardServerInfo(const sockaddr &socketAddr)
+		{
+			return ForwardServerInfo::defaultForwardServerInfo;
+		}
 
 
 
@@ -40,6 +40,8 @@ An Interface for Proxy TCP Handler.
 #define __EP_PROXY_TCP_HANDLE_H__
 #include "epServerEngine.h"
 #include "epBaseProxyHandler.h"
+#include "epProxyUpstreamPool.h"
+#include "epProxyTcpRelay.h"
 
 
 namespace epse{
@@ -60,9 +62,14 @@ namespace epse{
 		@param[in] callBack the callback object
 		@param[in] forwardServerInfo the forward server info
 		@param[in] socket the client socket
+		@param[in] upstreamPool the pool to check out the connection to forward server, or NULL to connect
+		@param[in] isPassthrough flag whether the raw bytes are relayed instead of the packets
+		@param[in] forwardWorker the worker to forward the queues on, or NULL not to queue
+		@param[in] highWatermarkByteSize the queued byte size of a direction to stop reading its sender at, or 0 not to queue
+		@param[in] lowWatermarkByteSize the queued byte size of a direction to resume reading its sender at
 		@param[in] lockPolicyType The lock policy
 		*/
-		ProxyTcpHandler(ProxyServerCallbackInterface *callBack,const ForwardServerInfo& forwardServerInfo, SocketInterface *socket, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+		ProxyTcpHandler(ProxyServerCallbackInterface *callBack,const ForwardServerInfo& forwardServerInfo, SocketInterface *socket, ProxyUpstreamPool *upstreamPool=NULL, bool isPassthrough=false, ProxyForwardWorker *forwardWorker=NULL, unsigned int highWatermarkByteSize=0, unsigned int lowWatermarkByteSize=0, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
 
 
 		/*!
@@ -72,6 +79,49 @@ namespace epse{
 		*/
 		virtual ~ProxyTcpHandler();
 
+		/*!
+		Release the client connected to forward server to the pool, when the client socket is disconnected.
+		*/
+		virtual void releaseForwardClient();
+
+		/*!
+		Check if connected to forward server
+		@return true if connected, otherwise false
+		*/
+		virtual bool isForwardConnected() const;
+
+		/*!
+		Check if the peer of the direction takes the data without blocking
+		@param[in] isFromClient flag whether the direction is from the client, otherwise from the forward server
+		@return true if writable, otherwise false
+		*/
+		virtual bool isWritable(bool isFromClient);
+
+		/*!
+		Abort the session whose peer does not take the queued data in time
+		@remark shuts the client socket down, so its receiving thread ends the session.
+		*/
+		virtual void abortClient();
+
+		/*!
+		Check if the socket is writable at the moment
+		@param[in] socket the socket to check
+		@return true if writable, or in error, otherwise false
+		*/
+		static bool isSocketWritable(SOCKET socket);
+
+		/*!
+		Relay the raw bytes from the client until it stops sending, if passthrough
+		@remark called on the thread of the client socket, right after the handler is made.
+		*/
+		void relayFromClient();
+
+		/// the passthrough relay, or NULL if the packets are forwarded
+		ProxyTcpRelay *m_relay;
+		/// the pool which the connection to forward server is checked out from
+		ProxyUpstreamPool *m_upstreamPool;
+		/// the index of the forward server in the pool
+		unsigned int m_upstreamIdx;
 
 	};
 }
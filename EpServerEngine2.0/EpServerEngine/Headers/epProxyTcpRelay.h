@@ -0,0 +1,138 @@
+/*! 
+@file epProxyTcpRelay.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy TCP Passthrough Relay Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Proxy TCP Passthrough Relay.
+
+Shuttles the raw bytes between the client socket and the connection to the
+forward server, without receiving them into the packets or framing them again.
+The bytes from the client are relayed on the thread of the client socket, and
+the bytes from the forward server on the thread of the relay.
+
+*/
+#ifndef __EP_PROXY_TCP_RELAY_H__
+#define __EP_PROXY_TCP_RELAY_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epProxyServerInterfaces.h"
+#include "epBaseTcpSocket.h"
+
+namespace epse{
+
+	/*! 
+	@class ProxyTcpRelay epProxyTcpRelay.h
+	@brief A class for relaying the raw bytes between the client socket and the forward server.
+	*/
+	class EP_SERVER_ENGINE ProxyTcpRelay:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the relay
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyTcpRelay(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the relay
+		*/
+		virtual ~ProxyTcpRelay();
+
+		/*!
+		Connect to the forward server, and start relaying from it to the client
+		@param[in] forwardServerInfo the forward server info
+		@param[in] clientSocket the client socket
+		@return true if connected, otherwise false
+		*/
+		bool Connect(const ForwardServerInfo &forwardServerInfo,BaseTcpSocket *clientSocket);
+
+		/*!
+		Relay from the client to the forward server until the client stops sending
+		@remark must be called on the thread of the client socket, before it receives.
+		*/
+		void RelayFromClient();
+
+		/*!
+		Check if connected to the forward server
+		@return true if connected, otherwise false
+		*/
+		bool IsConnected() const;
+
+		/*!
+		Close the connection to the forward server
+		@param[in] waitTimeInMilliSec wait time for the thread to terminate
+		*/
+		void Close(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+	protected:
+		/*!
+		Relaying Loop Function from the forward server to the client
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the relay
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyTcpRelay(const ProxyTcpRelay& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyTcpRelay & operator=(const ProxyTcpRelay&b){return *this;}
+
+		/*!
+		Relay the bytes until the source stops sending, then shut down sending to the destination
+		@param[in] fromSocket the source socket
+		@param[in] toSocket the destination socket
+		*/
+		static void relay(SOCKET fromSocket,SOCKET toSocket);
+
+		/// the client socket
+		SOCKET m_clientSocket;
+		/// the connection to the forward server
+		SOCKET m_forwardSocket;
+	};
+}
+
+#endif //__EP_PROXY_TCP_RELAY_H__
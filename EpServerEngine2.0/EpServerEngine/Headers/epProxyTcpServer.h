@@ -42,6 +42,9 @@ An Interface for Proxy TCP Server.
 #include "epServerEngine.h"
 #include "epBaseProxyServer.h"
 #include "epAsyncTcpServer.h"
+#include "epProxyUpstreamPool.h"
+#include "epProxyMuxPool.h"
+#include "epProxyForwardWorker.h"
 
 
 namespace epse{
@@ -84,6 +87,27 @@ namespace epse{
 		*/
 		ProxyTcpServer & operator=(const ProxyTcpServer&b);
 
+		/*!
+		Start the server
+		@param[in] ops the proxy server options
+		@return true if successfully started otherwise false
+		@remark the clients are multiplexed when ops.muxConnectionCount is not 0, otherwise<br/>
+		        the upstream pool is started when ops.isUpstreamPooled is true,<br/>
+		        unless ops.isPassthrough is true, where each client relays on its own connection.
+		*/
+		bool StartServer(const ProxyServerOps &ops=ProxyServerOps::defaultProxyServerOps);
+
+		/*!
+		Stop the server, and disconnect the pooled upstream connections
+		*/
+		void StopServer();
+
+		/*!
+		Connect to the forward server in advance, before any client is accepted for it
+		@param[in] forwardServerInfo the forward server info
+		@remark only valid while the server is started with the upstream pool.
+		*/
+		void WarmUpstream(const ForwardServerInfo &forwardServerInfo);
 	
 	private:
 		/*!
@@ -94,6 +118,19 @@ namespace epse{
 		*/
 		virtual void OnNewConnection(SocketInterface *socket);
 
+	private:
+		/// pool of the connections to the forward servers
+		ProxyUpstreamPool *m_upstreamPool;
+		/// pool of the connections multiplexing the clients
+		ProxyMuxPool *m_muxPool;
+		/// threads forwarding the queues of the sessions, if backpressured
+		ProxyForwardWorker *m_forwardWorker;
+		/// flag whether the raw bytes are relayed
+		bool m_isPassthrough;
+		/// the queued byte size of a direction to stop reading its sender at, 0 if not backpressured
+		unsigned int m_highWatermarkByteSize;
+		/// the queued byte size of a direction to resume reading its sender at
+		unsigned int m_lowWatermarkByteSize;
 	};
 }
 
@@ -0,0 +1,353 @@
+/*! 
+@file epProxyUdpRelay.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy UDP Relay Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Proxy UDP Relay.
+
+Relays the datagrams between the clients and the forward servers without the
+sessions, the packets and the callbacks. Each client address is bound to its
+own connected socket to the forward server in a hashed table, up to a limit,
+and the binding expires when idle. The forward server of a new client is
+resolved and connected on the workers, while its datagrams are held. The datagrams from the clients are received coalesced and
+sent on segmented where the network stack supports it, and the datagrams from
+the forward servers are completed in batches on a completion port. The
+datagrams are relayed from the fixed buffers without allocating.
+
+*/
+#ifndef __EP_PROXY_UDP_RELAY_H__
+#define __EP_PROXY_UDP_RELAY_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epProxyServerInterfaces.h"
+#include "epProxyUpstreamGroup.h"
+#include "epUdpSessionTable.h"
+#include "epUdpOffload.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class ProxyUdpRelay epProxyUdpRelay.h
+	@brief A class for relaying the datagrams between the clients and the forward servers.
+	*/
+	class EP_SERVER_ENGINE ProxyUdpRelay:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the relay
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyUdpRelay(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the relay
+		*/
+		virtual ~ProxyUdpRelay();
+
+		/*!
+		Start the relay
+		@param[in] port the port to receive the datagrams from the clients on
+		@param[in] callBackObj the callback object to get the forward server info from
+		@param[in] upstreamGroup the upstream group to choose the forward server from, or NULL
+		@param[in] workerCount the number of the threads relaying from the forward servers, 0 for the number of the cores
+		@param[in] expiryMilliSec the idle time in millisecond until the binding of a client expires
+		@param[in] bindingLimit the maximum number of the clients bound at once
+		@return true if started, otherwise false
+		*/
+		bool StartRelay(const TCHAR *port,ProxyServerCallbackInterface *callBackObj,ProxyUpstreamGroup *upstreamGroup,unsigned int workerCount,unsigned int expiryMilliSec,unsigned int bindingLimit=PROXY_UDP_RELAY_BINDING_LIMIT);
+
+		/*!
+		Stop the relay, and close all the bindings
+		@param[in] waitTimeInMilliSec wait time for the threads to terminate
+		*/
+		void StopRelay(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Check if the relay is started
+		@return true if the relay is started otherwise false
+		*/
+		bool IsRelayStarted() const;
+
+		/*!
+		Get the number of the bindings alive
+		@return the number of the bindings
+		*/
+		unsigned int GetBindingCount() const;
+
+	protected:
+		/*!
+		Relaying Loop Function from the clients, which also expires the idle bindings
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the relay
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyUdpRelay(const ProxyUdpRelay& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyUdpRelay & operator=(const ProxyUdpRelay&b){return *this;}
+
+		/// binding of a client to its connection to the forward server
+		struct Binding{
+			/// overlapped of the set-up posted, and then of the receive from the forward server, which must be the first
+			OVERLAPPED m_overlapped;
+			/// buffer of the receive from the forward server
+			WSABUF m_wsaBuffer;
+			/// flags of the receive from the forward server
+			DWORD m_flags;
+			/// address of the client
+			UdpSessionAddress m_clientAddress;
+			/// connected socket to the forward server, INVALID_SOCKET until set up
+			SOCKET m_forwardSocket;
+			/// flag whether set up, so the datagrams are sent without the lock
+			volatile bool m_isReady;
+			/// flag whether failed to set up, guarded by m_bindingLock
+			bool m_isFailed;
+			/// flag whether the socket is closed, guarded by m_bindingLock
+			bool m_isClosed;
+			/// datagrams from the client held until set up, guarded by m_bindingLock
+			vector<char> m_pendingBuffer;
+			/// byte size of each datagram held, guarded by m_bindingLock
+			vector<int> m_pendingLengthList;
+			/// reference count of the table, and the set-up or the receive posted
+			volatile LONG m_refCount;
+			/// tick when relayed last in either direction
+			volatile DWORD m_lastActiveTick;
+			/// upstream group which the forward server is chosen from
+			ProxyUpstreamGroup *m_upstreamGroup;
+			/// index of the upstream chosen
+			unsigned int m_upstreamIdx;
+			/// next binding in the same bucket
+			Binding *m_next;
+			/// binding lock, to set up, to close the socket and to post the receive on it
+			RuntimeLockPolicy m_bindingLock;
+			/// datagram received from the forward server
+			char m_buffer[PROXY_UDP_RELAY_DATAGRAM_BYTE_SIZE];
+
+			/*!
+			Default Constructor
+
+			Initializes the binding
+			@param[in] lockPolicyType The lock policy
+			*/
+			Binding(epl::LockPolicy lockPolicyType):m_bindingLock(lockPolicyType)
+			{
+				m_flags=0;
+				m_forwardSocket=INVALID_SOCKET;
+				m_isReady=false;
+				m_isFailed=false;
+				m_isClosed=false;
+				m_refCount=0;
+				m_lastActiveTick=0;
+				m_upstreamGroup=NULL;
+				m_upstreamIdx=0;
+				m_next=NULL;
+			}
+		};
+
+		/// thread relaying the datagrams completed from the forward servers, and setting up the bindings
+		class Worker:public epl::Thread{
+		public:
+			/*!
+			Default Constructor
+
+			Initializes the worker
+			@param[in] relay the relay
+			@param[in] lockPolicyType The lock policy
+			*/
+			Worker(ProxyUdpRelay *relay,epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+			{
+				m_relay=relay;
+			}
+		protected:
+			/*!
+			Relaying Loop Function from the forward servers
+			*/
+			virtual void execute()
+			{
+				m_relay->relayFromForwardServers();
+			}
+		private:
+			/// the relay
+			ProxyUdpRelay *m_relay;
+		};
+
+		/*!
+		Relay the datagrams completed on the completion port, and set up the bindings posted, until woken to stop
+		*/
+		void relayFromForwardServers();
+
+		/*!
+		Relay the datagrams received from a client to its forward server, binding the client if new
+		@param[in] clientAddress the address of the client
+		@param[in] length the byte size received
+		@param[in] segmentByteSize the byte size of each coalesced datagram, 0 if not coalesced
+		*/
+		void relayFromClient(const UdpSessionAddress &clientAddress,int length,unsigned int segmentByteSize);
+
+		/*!
+		Find the binding of the client
+		@param[in] clientAddress the address of the client
+		@return the binding, or NULL if not bound
+		@remark called on the relay thread only.
+		*/
+		Binding *findBinding(const UdpSessionAddress &clientAddress) const;
+
+		/*!
+		Add the binding of the client to the table, and post it to the workers to set up
+		@param[in] clientAddress the address of the client
+		@return the binding, not set up yet
+		@remark called on the relay thread only.
+		*/
+		Binding *createBinding(const UdpSessionAddress &clientAddress);
+
+		/*!
+		Connect the binding to the forward server chosen for its client, and send the datagrams held
+		@param[in] binding the binding posted
+		@remark called on the workers, as resolving the forward server may block.
+		*/
+		void setUpBinding(Binding *binding);
+
+		/*!
+		Hold the datagrams received for the binding not set up yet
+		@param[in] binding the binding
+		@param[in] length the byte size received
+		@param[in] segmentByteSize the byte size of each coalesced datagram, 0 if not coalesced
+		@return true if held or dropped, false if set up meanwhile
+		*/
+		bool holdDatagrams(Binding *binding,int length,unsigned int segmentByteSize);
+
+		/*!
+		Connect a datagram socket to the forward server
+		@param[in] forwardServerInfo the forward server info
+		@return the socket connected, or INVALID_SOCKET if failed
+		*/
+		SOCKET connectForwardServer(const ForwardServerInfo &forwardServerInfo);
+
+		/*!
+		Post the receive from the forward server of the binding
+		@param[in] binding the binding
+		@return true if posted, otherwise false
+		@remark m_bindingLock of the binding must be held.
+		*/
+		static bool postReceive(Binding *binding);
+
+		/*!
+		Close the connection of the binding removed from the table, and release the reference of the table
+		@param[in] binding the binding
+		*/
+		void closeBinding(Binding *binding);
+
+		/*!
+		Release the reference of the binding, and delete it if the last
+		@param[in] binding the binding
+		*/
+		void releaseBinding(Binding *binding);
+
+		/*!
+		Close the bindings idle for the expiry time
+		@param[in] tick the current tick
+		*/
+		void expireBindings(unsigned int tick);
+
+		/*!
+		Double the buckets of the table
+		*/
+		void growTable();
+
+		/*!
+		Close the sockets and the completion port
+		*/
+		void cleanUpRelay();
+
+	private:
+		/// socket receiving from the clients
+		SOCKET m_listenSocket;
+		/// completion port of the connections to the forward servers
+		HANDLE m_completionPort;
+		/// threads relaying from the forward servers
+		vector<Worker*> m_workerList;
+		/// buckets of the bindings hashed by the client address, owned by the relay thread
+		vector<Binding*> m_bucketList;
+		/// number of the bindings in the table
+		size_t m_tableCount;
+		/// hash seed of the table
+		unsigned __int64 m_hashSeed;
+		/// number of the bindings not deleted yet
+		volatile LONG m_bindingCount;
+		/// event raised while no binding is left
+		LightEvent m_idleEvent;
+		/// offload of the socket receiving from the clients
+		UdpOffload m_offload;
+		/// offload of the connections to the forward servers
+		UdpOffload m_forwardOffload;
+		/// flag whether m_forwardOffload is initialized, by the relay thread
+		bool m_isForwardOffloadInitialized;
+		/// the callback object to get the forward server info from
+		ProxyServerCallbackInterface *m_callBack;
+		/// the upstream group to choose the forward server from
+		ProxyUpstreamGroup *m_upstreamGroup;
+		/// the idle time until the binding expires
+		unsigned int m_expiryMilliSec;
+		/// the maximum number of the bindings in the table
+		unsigned int m_bindingLimit;
+		/// flag whether the relay is started
+		volatile bool m_isStarted;
+		/// relay lock
+		mutable RuntimeLockPolicy m_relayLock;
+		/// Lock Policy
+		epl::LockPolicy m_lockPolicy;
+		/// datagrams received from the clients, which can be coalesced
+		char m_receiveBuffer[PROXY_UDP_RELAY_RECEIVE_BUFFER_BYTE_SIZE];
+	};
+}
+
+#endif //__EP_PROXY_UDP_RELAY_H__
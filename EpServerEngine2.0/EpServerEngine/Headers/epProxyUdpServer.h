@@ -41,6 +41,7 @@ An Interface for Proxy UDP Server.
 
 #include "epServerEngine.h"
 #include "epBaseProxyServer.h"
+#include "epProxyUdpRelay.h"
 
 
 namespace epse{
@@ -83,6 +84,25 @@ namespace epse{
 		*/
 		ProxyUdpServer & operator=(const ProxyUdpServer&b);
 
+		/*!
+		Start the server
+		@param[in] ops the proxy server options
+		@return true if successfully started otherwise false
+		@remark the datagrams are relayed without the sessions and the callbacks, when ops.isPassthrough is true.
+		*/
+		bool StartServer(const ProxyServerOps &ops=ProxyServerOps::defaultProxyServerOps);
+
+		/*!
+		Stop the server, and close the bindings of the relay
+		*/
+		void StopServer();
+
+		/*!
+		Check if the server is started
+		@return true if the server is started otherwise false
+		*/
+		bool IsServerStarted() const;
+
 	private:
 		/*!
 		When accepted client tries to make connection.
@@ -92,6 +112,9 @@ namespace epse{
 		*/
 		virtual void OnNewConnection(SocketInterface *socket);
 
+	private:
+		/// relay of the datagrams for the passthrough
+		ProxyUdpRelay *m_relay;
 	};
 }
 
@@ -0,0 +1,279 @@
+/*! 
+@file epProxyUpstreamGroup.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy Upstream Group Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Proxy Upstream Group.
+
+Chooses the forward server for each accepted client among a group of upstreams,
+by round-robin, least outstanding connections, power of two choices, or the
+consistent hash of the client IP. The upstreams failing to connect are ejected
+from the choice for a while, and a thread checks the health of each upstream
+by connecting to it periodically. The connect latency and the failures of each
+upstream feed the choice.
+
+*/
+#ifndef __EP_PROXY_UPSTREAM_GROUP_H__
+#define __EP_PROXY_UPSTREAM_GROUP_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epProxyServerInterfaces.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@struct ProxyUpstreamStats epProxyUpstreamGroup.h
+	@brief A class for the statistics of an upstream.
+	*/
+	struct EP_SERVER_ENGINE ProxyUpstreamStats{
+		/// number of the clients connected through the upstream
+		unsigned int outstandingCount;
+		/// moving average of the connect latency in millisecond
+		unsigned int latencyMilliSec;
+		/// number of the clients given the upstream
+		unsigned __int64 requestCount;
+		/// number of the failed connects
+		unsigned __int64 failureCount;
+		/// flag whether the last health check passed
+		bool isHealthy;
+		/// flag whether ejected by the consecutive failures
+		bool isEjected;
+	};
+
+	/*! 
+	@class ProxyUpstreamGroup epProxyUpstreamGroup.h
+	@brief A class for choosing the forward server among a group of upstreams.
+	*/
+	class EP_SERVER_ENGINE ProxyUpstreamGroup:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the group
+		@param[in] policy the balance policy
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyUpstreamGroup(UpstreamBalancePolicy policy=UPSTREAM_BALANCE_POLICY_ROUND_ROBIN,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the group
+		*/
+		virtual ~ProxyUpstreamGroup();
+
+		/*!
+		Add the upstream
+		@param[in] forwardServerInfo the forward server info of the upstream
+		@return the index of the upstream
+		*/
+		unsigned int AddUpstream(const ForwardServerInfo &forwardServerInfo);
+
+		/*!
+		Get the number of the upstreams
+		@return the number of the upstreams
+		*/
+		unsigned int GetUpstreamCount() const;
+
+		/*!
+		Set the balance policy
+		@param[in] policy the balance policy
+		*/
+		void SetBalancePolicy(UpstreamBalancePolicy policy);
+
+		/*!
+		Get the balance policy
+		@return the balance policy
+		*/
+		UpstreamBalancePolicy GetBalancePolicy() const;
+
+		/*!
+		Start checking the health of the upstreams
+		@param[in] periodMilliSec the period of the health checks
+		@return true if started, otherwise false
+		*/
+		bool StartHealthCheck(unsigned int periodMilliSec=PROXY_UPSTREAM_HEALTH_CHECK_MILLISEC);
+
+		/*!
+		Stop checking the health of the upstreams
+		@param[in] waitTimeInMilliSec wait time for the thread to terminate
+		*/
+		void StopHealthCheck(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Choose the upstream for the client, and count it as outstanding
+		@param[in] sockAddr the sockaddr of the client
+		@param[in] sockAddrSize the byte size of the sockaddr
+		@param[out] retUpstreamIdx the index of the upstream chosen
+		@return true if chosen, otherwise false when there is no upstream
+		@remark chooses among all the upstreams when none is healthy.
+		*/
+		bool Select(const sockaddr *sockAddr,int sockAddrSize,unsigned int &retUpstreamIdx);
+
+		/*!
+		Get the forward server info of the upstream
+		@param[in] upstreamIdx the index of the upstream
+		@return the forward server info
+		*/
+		ForwardServerInfo GetForwardServerInfo(unsigned int upstreamIdx) const;
+
+		/*!
+		Report the connect to the upstream chosen
+		@param[in] upstreamIdx the index of the upstream
+		@param[in] latencyMilliSec the time taken to connect
+		@param[in] isSucceeded flag whether connected
+		*/
+		void ReportConnect(unsigned int upstreamIdx,unsigned int latencyMilliSec,bool isSucceeded);
+
+		/*!
+		Release the upstream chosen, when its client disconnects
+		@param[in] upstreamIdx the index of the upstream
+		*/
+		void Release(unsigned int upstreamIdx);
+
+		/*!
+		Get the statistics of the upstream
+		@param[in] upstreamIdx the index of the upstream
+		@param[out] retStats the statistics
+		@return true if the upstream exists, otherwise false
+		*/
+		bool GetUpstreamStats(unsigned int upstreamIdx,ProxyUpstreamStats &retStats) const;
+
+		/*!
+		Connect to the upstream to check its health
+		@param[in] hostName the hostname of the upstream
+		@param[in] port the port of the upstream
+		@param[out] retLatencyMilliSec the time taken to connect
+		@return true if connected within PROXY_UPSTREAM_PROBE_TIMEOUT_MILLISEC, otherwise false
+		*/
+		static bool Probe(const TCHAR *hostName,const TCHAR *port,unsigned int &retLatencyMilliSec);
+
+	protected:
+		/*!
+		Health Check Loop Function
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the group
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyUpstreamGroup(const ProxyUpstreamGroup& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyUpstreamGroup & operator=(const ProxyUpstreamGroup&b){return *this;}
+
+		/// upstream
+		struct Upstream{
+			/// hostname of the forward server
+			epl::EpTString m_hostName;
+			/// port of the forward server
+			epl::EpTString m_port;
+			/// statistics
+			ProxyUpstreamStats m_stats;
+			/// number of the consecutive connect failures
+			unsigned int m_failureStreak;
+			/// tick when ejected
+			unsigned int m_ejectTick;
+		};
+
+		/*!
+		Check if the upstream can be chosen
+		@param[in] upstream the upstream
+		@param[in] tick the current tick
+		@return true if the upstream can be chosen, otherwise false
+		@remark the upstream ejected long enough is let back in.
+		*/
+		static bool isAvailable(Upstream *upstream,unsigned int tick);
+
+		/*!
+		Get the load score of the upstream, the lower the better
+		@param[in] upstream the upstream
+		@return the load score
+		*/
+		static unsigned __int64 getScore(const Upstream *upstream);
+
+		/*!
+		Get the index of the next available upstream from the index given
+		@param[in] upstreamIdx the index to search from
+		@param[in] tick the current tick
+		@return the index of the available upstream, or the number of the upstreams if none
+		*/
+		unsigned int findAvailable(unsigned int upstreamIdx,unsigned int tick);
+
+		/*!
+		Get the next pseudo random number
+		@return the pseudo random number
+		*/
+		unsigned int nextRandom();
+
+		/*!
+		Add the moving average of the connect latency
+		@param[in] upstream the upstream
+		@param[in] latencyMilliSec the time taken to connect
+		*/
+		static void addLatency(Upstream *upstream,unsigned int latencyMilliSec);
+
+		/// upstreams
+		vector<Upstream*> m_upstreamList;
+		/// points of the upstreams on the consistent hash ring, sorted by the hash
+		vector<pair<unsigned __int64,unsigned int> > m_hashRing;
+		/// balance policy
+		UpstreamBalancePolicy m_policy;
+		/// next index for round-robin
+		unsigned int m_nextIdx;
+		/// state of the pseudo random numbers
+		unsigned int m_randomState;
+		/// period of the health checks
+		unsigned int m_healthCheckMilliSec;
+		/// group lock
+		mutable RuntimeLockPolicy m_groupLock;
+		/// thread stop event
+		LightEvent m_threadStopEvent;
+	};
+}
+
+#endif //__EP_PROXY_UPSTREAM_GROUP_H__
@@ -0,0 +1,263 @@
+/*! 
+@file epProxyUpstreamPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Proxy Upstream Connection Pool Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Proxy Upstream Connection Pool.
+
+Keeps the connections to each forward server connected in advance, so the
+accepted clients are handed a connected upstream instead of resolving and
+connecting on the accept path. A thread keeps each forward server warm to the
+minimum count, probes each forward server, and reaps the connections which are
+closed.
+
+The released connections are reused only for the stateless request/response
+forward servers, and only after they stayed quiet, so a late reply to one
+client is never handed to the next. A connection receiving anything while not
+checked out is reaped.
+
+*/
+#ifndef __EP_PROXY_UPSTREAM_POOL_H__
+#define __EP_PROXY_UPSTREAM_POOL_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epProxyServerInterfaces.h"
+#include "epBaseClient.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class ProxyUpstreamPool epProxyUpstreamPool.h
+	@brief A class for the pool of the TCP connections to the forward servers.
+	*/
+	class EP_SERVER_ENGINE ProxyUpstreamPool:public epl::Thread, public ClientCallbackInterface{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the pool
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProxyUpstreamPool(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the pool
+		*/
+		virtual ~ProxyUpstreamPool();
+
+		/*!
+		Start the pool
+		@param[in] minimumCount the number of the idle connections kept for each forward server
+		@param[in] maximumCount the maximum number of the pooled connections for each forward server
+		@param[in] healthCheckMilliSec the period to reap the closed connections and to refill
+		@param[in] isStateless flag whether the forward servers are stateless request/response, so the released connection is reused
+		@return true if started, otherwise false
+		*/
+		bool StartPool(unsigned int minimumCount,unsigned int maximumCount,unsigned int healthCheckMilliSec,bool isStateless);
+
+		/*!
+		Stop the pool, and disconnect all the pooled connections
+		@param[in] waitTimeInMilliSec wait time for the thread to terminate
+		*/
+		void StopPool(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Check if the pool is started
+		@return true if the pool is started otherwise false
+		*/
+		bool IsPoolStarted() const;
+
+		/*!
+		Add the forward server to keep warm
+		@param[in] forwardServerInfo the forward server info
+		@return the index of the forward server
+		@remark the connections are made by the pool thread.
+		*/
+		unsigned int AddUpstream(const ForwardServerInfo &forwardServerInfo);
+
+		/*!
+		Check out a connection to the forward server
+		@param[in] forwardServerInfo the forward server info
+		@param[in] callBackObj the callback object for the connection
+		@param[out] retUpstreamIdx the index of the forward server, to release the connection with
+		@return the connection, or NULL if failed to connect
+		@remark connects on the calling thread only when no idle connection is left.
+		@remark the idle connection which received anything while handed over is reaped instead.
+		*/
+		BaseClient *Checkout(const ForwardServerInfo &forwardServerInfo,ClientCallbackInterface *callBackObj,unsigned int &retUpstreamIdx);
+
+		/*!
+		Release the connection checked out
+		@param[in] client the connection
+		@param[in] upstreamIdx the index of the forward server given by Checkout
+		@remark the connection is returned to the idle connections after staying quiet for PROXY_UPSTREAM_QUIET_MILLISEC,<br/>
+		        if stateless and still connected, otherwise disconnected and deleted by the pool thread.
+		@remark waits for the callback of the connection in progress, so the callback object may be deleted once this returns.
+		*/
+		void Release(BaseClient *client,unsigned int upstreamIdx);
+
+	protected:
+		/*!
+		Health Check Loop Function
+		*/
+		virtual void execute();
+
+		/*!
+		Received the packet on a connection not checked out, which is discarded and reaps the connection.
+		@param[in] client the client which received the packet
+		@param[in] receivedPacket the received packet
+		@param[in] status the status of Receive
+		*/
+		virtual void OnReceived(ClientInterface *client,const Packet*receivedPacket,ReceiveStatus status);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the pool
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProxyUpstreamPool(const ProxyUpstreamPool& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProxyUpstreamPool & operator=(const ProxyUpstreamPool&b){return *this;}
+
+		/// connection released, waiting to stay quiet
+		struct QuietClient{
+			/// connection
+			BaseClient *m_client;
+			/// tick when released
+			unsigned int m_releaseTick;
+		};
+
+		/// connections to a forward server
+		struct Upstream{
+			/// hostname of the forward server
+			epl::EpTString m_hostName;
+			/// port of the forward server
+			epl::EpTString m_port;
+			/// idle connections
+			vector<BaseClient*> m_idleList;
+			/// connections released, not reused until quiet
+			vector<QuietClient> m_quietList;
+			/// number of the idle, the quiet and the checked out connections
+			unsigned int m_connectionCount;
+			/// flag whether the last active health check passed
+			bool m_isHealthy;
+		};
+
+		/*!
+		Find the forward server
+		@param[in] forwardServerInfo the forward server info
+		@return the index of the forward server, or the number of the forward servers if not found
+		@remark m_poolLock must be held.
+		*/
+		unsigned int findUpstream(const ForwardServerInfo &forwardServerInfo) const;
+
+		/*!
+		Connect to the forward server
+		@param[in] hostName the hostname of the forward server
+		@param[in] port the port of the forward server
+		@param[in] callBackObj the callback object for the connection
+		@return the connection, or NULL if failed to connect
+		*/
+		BaseClient *connect(const TCHAR *hostName,const TCHAR *port,ClientCallbackInterface *callBackObj);
+
+		/*!
+		Disconnect and delete the connections
+		@param[in] clientList the connections
+		*/
+		void deleteClients(vector<BaseClient*> &clientList);
+
+		/*!
+		Take the connection out of the forward server, to be deleted by the pool thread
+		@param[in] upstream the forward server
+		@param[in] client the connection
+		@remark m_poolLock must be held.
+		*/
+		void reapClient(Upstream *upstream,BaseClient *client);
+
+		/*!
+		Check if the connection received anything while not checked out
+		@param[in] client the connection
+		@return true if received, otherwise false
+		@remark m_poolLock must be held.
+		*/
+		bool isTainted(const BaseClient *client) const;
+
+		/*!
+		Reap the idle and the quiet connections closed, tainted or of the unhealthy forward servers, and reuse the ones quiet long enough
+		@param[in] upstream the forward server
+		@param[in] tick the current tick
+		@remark m_poolLock must be held.
+		*/
+		void checkClients(Upstream *upstream,unsigned int tick);
+
+		/// forward servers
+		vector<Upstream*> m_upstreamList;
+		/// connections to delete by the pool thread
+		vector<BaseClient*> m_reapList;
+		/// connections received on while handed over, reaped by whom holds them
+		vector<BaseClient*> m_taintedList;
+		/// the number of the idle connections kept for each forward server
+		unsigned int m_minimumCount;
+		/// the maximum number of the pooled connections for each forward server
+		unsigned int m_maximumCount;
+		/// the period to reap and to refill
+		unsigned int m_healthCheckMilliSec;
+		/// flag whether the forward servers are stateless request/response, so the released connection is reused
+		bool m_isStateless;
+		/// flag whether the pool is started
+		bool m_isStarted;
+		/// pool lock
+		mutable RuntimeLockPolicy m_poolLock;
+		/// event to wake the pool thread to stop or to refill
+		LightEvent m_wakeEvent;
+		/// Lock Policy
+		epl::LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_PROXY_UPSTREAM_POOL_H__
@@ -0,0 +1,264 @@
+/*! 
+@file epResolverCache.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief Resolver Cache Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Resolver Cache.
+
+Caches the results of getaddrinfo for the clients and the proxy forward targets
+of the process, so the connects do not wait on the resolver each time. The hits
+after the refresh age are served while the addresses are resolved again in the
+background, and the failures are cached for a shorter time.
+
+*/
+#ifndef __EP_RESOLVER_CACHE_H__
+#define __EP_RESOLVER_CACHE_H__
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif //WIN32_LEAN_AND_MEAN
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <map>
+#include <deque>
+#include <string>
+using namespace std;
+
+/*!
+@def RESOLVER_CACHE_INSTANCE
+@brief Macro for the process-wide resolver cache
+
+Macro for the process-wide resolver cache.
+*/
+#define RESOLVER_CACHE_INSTANCE epl::SingletonHolder<epse::ResolverCache>::Instance()
+
+namespace epse{
+
+	/*! 
+	@class ResolverCache epResolverCache.h
+	@brief A class for the cache of the resolved addresses shared by the process.
+	*/
+	class EP_SERVER_ENGINE ResolverCache:protected epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the cache
+		@param[in] lockPolicyType The lock policy
+		*/
+		ResolverCache(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the cache
+		*/
+		virtual ~ResolverCache();
+
+		/*!
+		Resolve the host and the port as getaddrinfo, from the cache if not expired
+		@param[in] hostName the host name, NULL for the local address
+		@param[in] port the port
+		@param[in] hints the hints for getaddrinfo
+		@param[out] retResult the copy of the resolved addresses
+		@return 0 if resolved, otherwise the error of getaddrinfo
+		@remark retResult must be freed with FreeAddrInfo, not with freeaddrinfo.
+		*/
+		int GetAddrInfo(const char *hostName,const char *port,const struct addrinfo *hints,struct addrinfo **retResult);
+
+		/*!
+		Free the addresses returned by GetAddrInfo
+		@param[in] result the addresses to free
+		*/
+		static void FreeAddrInfo(struct addrinfo *result);
+
+		/*!
+		Drop the cached resolutions of the host
+		@param[in] hostName the host name, NULL to drop all the resolutions
+		@param[in] port the port, NULL for all the ports of the host
+		*/
+		void Invalidate(const char *hostName=NULL,const char *port=NULL);
+
+		/*!
+		Set the time to live of the resolutions
+		@param[in] timeToLiveMilliSec the time in millisecond the resolved addresses are reused, 0 to disable the cache
+		@param[in] negativeTimeToLiveMilliSec the time in millisecond the failure to resolve is reused, 0 not to cache the failures
+		@remark the resolutions already cached follow the new time to live.
+		*/
+		void SetTimeToLive(unsigned int timeToLiveMilliSec,unsigned int negativeTimeToLiveMilliSec=RESOLVER_CACHE_NEGATIVE_TIME_TO_LIVE_MILLISEC);
+
+		/*!
+		Get the time to live of the resolved addresses
+		@return the time in millisecond the resolved addresses are reused
+		*/
+		unsigned int GetTimeToLive() const;
+
+		/*!
+		Get the time to live of the failed resolutions
+		@return the time in millisecond the failure to resolve is reused
+		*/
+		unsigned int GetNegativeTimeToLive() const;
+
+		/*!
+		Get the number of the resolutions served from the cache
+		@return the number of the cache hits
+		*/
+		unsigned int GetHitCount() const;
+
+		/*!
+		Get the number of the resolutions which waited on the resolver
+		@return the number of the cache misses
+		*/
+		unsigned int GetMissCount() const;
+
+		/*!
+		Reset the numbers of the cache hits and misses
+		*/
+		void ResetStatistics();
+
+	protected:
+		/*!
+		Actually refresh the resolutions in the background
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the cache
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ResolverCache(const ResolverCache& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ResolverCache & operator=(const ResolverCache&b){return *this;}
+
+		/// A resolution of a host and a port
+		struct Entry{
+			/// the host name
+			string m_hostName;
+			/// the port
+			string m_port;
+			/// the hints the addresses are resolved with
+			struct addrinfo m_hints;
+			/// the resolved addresses from getaddrinfo, NULL if failed
+			struct addrinfo *m_result;
+			/// the error of getaddrinfo
+			int m_error;
+			/// the tick when resolved
+			unsigned int m_resolvedTick;
+			/// flag whether the refresh is queued
+			bool m_isRefreshing;
+		};
+
+		/*!
+		Make the key of the resolution
+		@param[in] hostName the host name
+		@param[in] port the port
+		@param[in] hints the hints for getaddrinfo
+		@return the key of the resolution
+		*/
+		static string makeKey(const char *hostName,const char *port,const struct addrinfo &hints);
+
+		/*!
+		Copy the addresses into one block for the caller
+		@param[in] result the addresses to copy
+		@return the copied addresses
+		*/
+		static struct addrinfo *copyAddrInfo(const struct addrinfo *result);
+
+		/*!
+		Resolve the entry with getaddrinfo
+		@param[in] entry the entry to resolve
+		@param[out] retResult the resolved addresses
+		@return 0 if resolved, otherwise the error of getaddrinfo
+		*/
+		static int resolve(const Entry &entry,struct addrinfo **retResult);
+
+		/*!
+		Store the resolution to the cache
+		@param[in] key the key of the resolution
+		@param[in] entry the entry holding the host, the port and the hints
+		@param[in] result the resolved addresses, owned by the cache from now
+		@param[in] error the error of getaddrinfo
+		@remark must be called with m_cacheLock held.
+		*/
+		void store(const string &key,const Entry &entry,struct addrinfo *result,int error);
+
+		/*!
+		Drop the expired resolutions to make room for a new one
+		@remark must be called with m_cacheLock held.
+		*/
+		void evict();
+
+		/*!
+		Get the time to live of the entry
+		@param[in] entry the entry
+		@return the time to live of the entry in millisecond
+		*/
+		unsigned int getTimeToLive(const Entry &entry) const;
+
+	private:
+		/// the cached resolutions
+		map<string,Entry> m_cache;
+		/// the keys of the resolutions to refresh
+		deque<string> m_refreshQueue;
+		/// cache lock
+		mutable RuntimeLockPolicy m_cacheLock;
+		/// the event raised when a refresh is queued
+		LightEvent m_refreshEvent;
+		/// flag whether the refresh thread is stopping
+		bool m_isStopping;
+		/// time to live of the resolved addresses
+		unsigned int m_timeToLiveMilliSec;
+		/// time to live of the failed resolutions
+		unsigned int m_negativeTimeToLiveMilliSec;
+		/// the number of the cache hits
+		unsigned int m_hitCount;
+		/// the number of the cache misses
+		unsigned int m_missCount;
+	};
+}
+
+#endif //__EP_RESOLVER_CACHE_H__
@@ -74,6 +74,575 @@ namespace epse{
 	*/
 	#define PROCESSOR_LIMIT_INFINITE 0
 
+	/*!
+	@def MESSAGE_ARENA_BLOCK_BYTE_SIZE
+	@brief default block byte size of the message arena
+
+	Macro for the default block byte size of the message arena.
+	*/
+	#define MESSAGE_ARENA_BLOCK_BYTE_SIZE 8192
+
+	/*!
+	@def MESSAGE_ARENA_ALIGNMENT
+	@brief default alignment of the message arena allocation
+
+	Macro for the default alignment of the message arena allocation.
+	*/
+	#define MESSAGE_ARENA_ALIGNMENT MEMORY_ALLOCATION_ALIGNMENT
+
+	/*!
+	@def MEMORY_BUDGET_INFINITE
+	@brief No limit for the memory budget
+
+	Macro for No limit for the memory budget.
+	*/
+	#define MEMORY_BUDGET_INFINITE 0
+
+	/*!
+	@def BUFFER_POOL_BUFFER_BYTE_SIZE
+	@brief default buffer byte size of the buffer pool
+
+	Macro for the default buffer byte size of the buffer pool.
+	*/
+	#define BUFFER_POOL_BUFFER_BYTE_SIZE 16384
+
+	/*!
+	@def BUFFER_POOL_SLAB_BYTE_SIZE
+	@brief default slab byte size of the buffer pool
+
+	Macro for the default slab byte size of the buffer pool.
+	@remark rounded up to the large page size when backed by the large pages.
+	*/
+	#define BUFFER_POOL_SLAB_BYTE_SIZE (2*1024*1024)
+
+	/*!
+	@def LOCK_POLICY_SPIN_COUNT
+	@brief spin count of the Critical Section lock policy
+
+	Macro for the spin count of the Critical Section lock policy.
+	*/
+	#define LOCK_POLICY_SPIN_COUNT 4000
+
+	/*!
+	@def LIGHT_LOCK_SPIN_COUNT
+	@brief spin count of the light lock primitives
+
+	Macro for the spin count of the light lock primitives before parking the thread.
+	*/
+	#define LIGHT_LOCK_SPIN_COUNT 1000
+
+	/*!
+	@def UDP_SESSION_TABLE_STRIPE_COUNT
+	@brief number of the lock stripes of the UDP session table
+
+	Macro for the number of the lock stripes of the UDP session table.
+	@remark must be the power of 2.
+	*/
+	#define UDP_SESSION_TABLE_STRIPE_COUNT 16
+
+	/*!
+	@def UDP_SESSION_TABLE_BUCKET_COUNT
+	@brief initial number of the buckets per stripe of the UDP session table
+
+	Macro for the initial number of the buckets per stripe of the UDP session table.
+	@remark must be the power of 2.
+	*/
+	#define UDP_SESSION_TABLE_BUCKET_COUNT 64
+
+	/*!
+	@def UDP_PACKET_QUEUE_FREE_NODE_COUNT
+	@brief maximum number of the free nodes kept by each UDP packet queue
+
+	Macro for the maximum number of the free nodes kept by each UDP packet queue.
+	*/
+	#define UDP_PACKET_QUEUE_FREE_NODE_COUNT 256
+
+	/*!
+	@def UDP_RECEIVE_SHARD_QUEUE_MAX_COUNT
+	@brief maximum number of the datagrams queued by each UDP receive shard
+
+	Macro for the maximum number of the datagrams queued for a UDP receive shard while another thread handles it, beyond which the datagrams are dropped.
+	*/
+	#define UDP_RECEIVE_SHARD_QUEUE_MAX_COUNT 1024
+
+	/*!
+	@def UDP_SEND_QUEUE_COUNT_DISABLED
+	@brief UDP send queue count which sends the packets immediately
+
+	Macro for the UDP send queue count which sends the packets immediately.
+	*/
+	#define UDP_SEND_QUEUE_COUNT_DISABLED 0
+
+	/*!
+	@def UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE
+	@brief Maximum byte size of the datagram train sent with one segmented send
+
+	Macro for the maximum byte size of the datagram train sent with one segmented send.
+	*/
+	#define UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE 65535
+
+	/*!
+	@def UDP_CHANNEL_HEADER_BYTE_SIZE
+	@brief Byte size of the header prepended to each datagram by the UDP channel layer
+
+	Macro for the byte size of the header prepended to each datagram by the UDP channel layer.
+	*/
+	#define UDP_CHANNEL_HEADER_BYTE_SIZE 12
+
+	/*!
+	@def UDP_CHANNEL_MAX_COUNT
+	@brief Maximum number of the UDP channels of a session
+
+	Macro for the maximum number of the UDP channels of a session.
+	*/
+	#define UDP_CHANNEL_MAX_COUNT 255
+
+	/*!
+	@def UDP_CHANNEL_TICK_MILLISEC
+	@brief Interval in millisecond of the retransmission and acknowledgement timer of the UDP channels
+
+	Macro for the interval in millisecond of the retransmission and acknowledgement timer of the UDP channels.
+	*/
+	#define UDP_CHANNEL_TICK_MILLISEC 10
+
+	/*!
+	@def UDP_CHANNEL_ACK_DELAY_MILLISEC
+	@brief Time in millisecond to wait for the outgoing datagram to piggyback the acknowledgement
+
+	Macro for the time in millisecond to wait for the outgoing datagram to piggyback the acknowledgement.
+	*/
+	#define UDP_CHANNEL_ACK_DELAY_MILLISEC 20
+
+	/*!
+	@def UDP_CHANNEL_INITIAL_RETRANSMIT_MILLISEC
+	@brief Retransmission time-out in millisecond before the round trip time is measured
+
+	Macro for the retransmission time-out in millisecond before the round trip time is measured.
+	*/
+	#define UDP_CHANNEL_INITIAL_RETRANSMIT_MILLISEC 500
+
+	/*!
+	@def UDP_CHANNEL_MIN_RETRANSMIT_MILLISEC
+	@brief Minimum retransmission time-out in millisecond
+
+	Macro for the minimum retransmission time-out in millisecond.
+	*/
+	#define UDP_CHANNEL_MIN_RETRANSMIT_MILLISEC 50
+
+	/*!
+	@def UDP_CHANNEL_MAX_RETRANSMIT_MILLISEC
+	@brief Maximum retransmission time-out in millisecond
+
+	Macro for the maximum retransmission time-out in millisecond.
+	*/
+	#define UDP_CHANNEL_MAX_RETRANSMIT_MILLISEC 4000
+
+	/*!
+	@def UDP_CHANNEL_MAX_SEND_COUNT
+	@brief Maximum number of the transmissions of a reliable message before the session fails
+
+	Macro for the maximum number of the transmissions of a reliable message before the session fails.
+	*/
+	#define UDP_CHANNEL_MAX_SEND_COUNT 10
+
+	/*!
+	@def UDP_CHANNEL_INITIAL_WINDOW
+	@brief Initial congestion window in the number of the reliable messages
+
+	Macro for the initial congestion window in the number of the reliable messages.
+	*/
+	#define UDP_CHANNEL_INITIAL_WINDOW 4
+
+	/*!
+	@def UDP_CHANNEL_RECEIVE_WINDOW
+	@brief Number of the out-of-order reliable messages buffered for each channel
+
+	Macro for the number of the out-of-order reliable messages buffered for each channel.
+	*/
+	#define UDP_CHANNEL_RECEIVE_WINDOW 256
+
+	/*!
+	@def UDP_FRAGMENT_HEADER_BYTE_SIZE
+	@brief Byte size of the header prepended to each fragment by the UDP fragmentation
+
+	Macro for the byte size of the header prepended to each fragment by the UDP fragmentation.
+	*/
+	#define UDP_FRAGMENT_HEADER_BYTE_SIZE 14
+
+	/*!
+	@def UDP_FRAGMENT_BASE_DATAGRAM_BYTE_SIZE
+	@brief Datagram byte size used before the path MTU is probed
+
+	Macro for the datagram byte size used before the path MTU is probed.
+	*/
+	#define UDP_FRAGMENT_BASE_DATAGRAM_BYTE_SIZE 1200
+
+	/*!
+	@def UDP_FRAGMENT_MAX_DATAGRAM_BYTE_SIZE
+	@brief Largest datagram byte size probed, the Ethernet MTU without the IPv4 and UDP headers
+
+	Macro for the largest datagram byte size probed.
+	*/
+	#define UDP_FRAGMENT_MAX_DATAGRAM_BYTE_SIZE 1472
+
+	/*!
+	@def UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE
+	@brief Maximum byte size of the packet sent in the fragments
+
+	Macro for the maximum byte size of the packet sent in the fragments.
+	*/
+	#define UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE (1024*1024)
+
+	/*!
+	@def UDP_FRAGMENT_REASSEMBLY_BYTE_SIZE
+	@brief Maximum byte size of the packets being reassembled for each session
+
+	Macro for the maximum byte size of the packets being reassembled for each session.
+	*/
+	#define UDP_FRAGMENT_REASSEMBLY_BYTE_SIZE (4*1024*1024)
+
+	/*!
+	@def UDP_FRAGMENT_REASSEMBLY_MESSAGE_COUNT
+	@brief Maximum number of the packets being reassembled for each session
+
+	Macro for the maximum number of the packets being reassembled for each session.
+	*/
+	#define UDP_FRAGMENT_REASSEMBLY_MESSAGE_COUNT 64
+
+	/*!
+	@def UDP_FRAGMENT_REASSEMBLY_TIMEOUT_MILLISEC
+	@brief Time in millisecond to wait for all the fragments of a packet
+
+	Macro for the time in millisecond to wait for all the fragments of a packet.
+	*/
+	#define UDP_FRAGMENT_REASSEMBLY_TIMEOUT_MILLISEC 3000
+
+	/*!
+	@def UDP_FRAGMENT_PROBE_TIMEOUT_MILLISEC
+	@brief Time in millisecond to wait for the acknowledgement of the path MTU probe
+
+	Macro for the time in millisecond to wait for the acknowledgement of the path MTU probe.
+	*/
+	#define UDP_FRAGMENT_PROBE_TIMEOUT_MILLISEC 1000
+
+	/*!
+	@def UDP_FRAGMENT_PROBE_COUNT
+	@brief Number of the path MTU probes of a byte size sent before it is considered too large
+
+	Macro for the number of the path MTU probes of a byte size sent before it is considered too large.
+	*/
+	#define UDP_FRAGMENT_PROBE_COUNT 3
+
+	/*!
+	@def UDP_FRAGMENT_PROBE_PRECISION
+	@brief Byte size precision, where the path MTU probing stops
+
+	Macro for the byte size precision, where the path MTU probing stops.
+	*/
+	#define UDP_FRAGMENT_PROBE_PRECISION 8
+
+	/*!
+	@def UDP_COALESCE_HEADER_BYTE_SIZE
+	@brief Byte size of the length header of each message in a coalesced datagram
+
+	Macro for the byte size of the length header of each message in a coalesced datagram.
+	*/
+	#define UDP_COALESCE_HEADER_BYTE_SIZE 2
+
+	/*!
+	@def UDP_COALESCE_DATAGRAM_BYTE_SIZE
+	@brief Maximum byte size of a coalesced datagram
+
+	Macro for the maximum byte size of a coalesced datagram.
+	@remark kept under the path MTU of the most paths, so the coalesced datagram is not fragmented by IP.
+	*/
+	#define UDP_COALESCE_DATAGRAM_BYTE_SIZE 1200
+
+	/*!
+	@def UDP_CONNECTED_SESSION_MAX_COUNT
+	@brief Maximum number of the UDP sessions moved to their own connected sockets
+
+	Macro for the maximum number of the UDP sessions moved to their own connected sockets.
+	@remark one less than WSA_MAXIMUM_WAIT_EVENTS, since the receiver waits on one more event.
+	*/
+	#define UDP_CONNECTED_SESSION_MAX_COUNT 63
+
+	/*!
+	@def UDP_CONNECT_NOTICE_MAX_COUNT
+	@brief Maximum number of the move notices sent to a UDP client
+
+	Macro for the maximum number of the move notices sent to a UDP client, one a second until the client answers on the new port.
+	*/
+	#define UDP_CONNECT_NOTICE_MAX_COUNT 5
+
+	/*!
+	@def PROXY_UPSTREAM_POOL_MIN_COUNT
+	@brief Default number of the idle connections kept for each forward server
+
+	Macro for the default number of the idle connections kept for each forward server.
+	*/
+	#define PROXY_UPSTREAM_POOL_MIN_COUNT 4
+
+	/*!
+	@def PROXY_UPSTREAM_REAP_RESERVE_COUNT
+	@brief Number of the connections to delete reserved by the upstream pool
+
+	Macro for the number of the dead or released upstream connections the pool reserves room for, so reaping them does not reallocate under the pool lock.
+	*/
+	#define PROXY_UPSTREAM_REAP_RESERVE_COUNT 64
+
+	/*!
+	@def PROXY_UPSTREAM_HEALTH_CHECK_MILLISEC
+	@brief Default period to reap and to refill the pooled upstream connections
+
+	Macro for the default period in millisecond to reap and to refill the pooled upstream connections.
+	*/
+	#define PROXY_UPSTREAM_HEALTH_CHECK_MILLISEC 1000
+
+	/*!
+	@def PROXY_UPSTREAM_QUIET_MILLISEC
+	@brief Time a released upstream connection must stay quiet before reused
+
+	Macro for the time in millisecond a released upstream connection must receive nothing before handed to the next client.
+	*/
+	#define PROXY_UPSTREAM_QUIET_MILLISEC 1000
+
+	/*!
+	@def PROXY_PASSTHROUGH_BUFFER_BYTE_SIZE
+	@brief Byte size of the buffer relaying each direction of a passthrough proxy connection
+
+	Macro for the byte size of the buffer relaying each direction of a passthrough proxy connection.
+	*/
+	#define PROXY_PASSTHROUGH_BUFFER_BYTE_SIZE (16*1024)
+
+	/*!
+	@def PROXY_UPSTREAM_EJECT_FAILURE_COUNT
+	@brief Number of the consecutive connect failures to eject an upstream
+
+	Macro for the number of the consecutive connect failures to eject an upstream from the selection.
+	*/
+	#define PROXY_UPSTREAM_EJECT_FAILURE_COUNT 3
+
+	/*!
+	@def PROXY_UPSTREAM_EJECT_MILLISEC
+	@brief Time an ejected upstream is left out of the selection
+
+	Macro for the time in millisecond an ejected upstream is left out of the selection, unless the health check passes.
+	*/
+	#define PROXY_UPSTREAM_EJECT_MILLISEC 10000
+
+	/*!
+	@def PROXY_UPSTREAM_PROBE_TIMEOUT_MILLISEC
+	@brief Time to wait for the connect of an active health check
+
+	Macro for the time in millisecond to wait for the connect of an active health check.
+	*/
+	#define PROXY_UPSTREAM_PROBE_TIMEOUT_MILLISEC 1000
+
+	/*!
+	@def PROXY_UPSTREAM_HASH_VIRTUAL_NODE_COUNT
+	@brief Number of the points of each upstream on the consistent hash ring
+
+	Macro for the number of the points of each upstream on the consistent hash ring.
+	*/
+	#define PROXY_UPSTREAM_HASH_VIRTUAL_NODE_COUNT 64
+
+	/*!
+	@def PROXY_MUX_SESSION_WINDOW_BYTE_SIZE
+	@brief Byte size each side of a multiplexed session may send ahead of the credit
+
+	Macro for the byte size each side of a multiplexed proxy session may send before the other side grants more.
+	*/
+	#define PROXY_MUX_SESSION_WINDOW_BYTE_SIZE (256*1024)
+
+	/*!
+	@def PROXY_MUX_DELIVER_WRITE_BYTE_SIZE
+	@brief Maximum byte size written to a client with one send by the multiplexed delivery
+
+	Macro for the maximum byte size written to a client with one send by the multiplexed delivery.
+	@remark kept within the send buffer, so a slow client does not stall the delivery to the others.
+	*/
+	#define PROXY_MUX_DELIVER_WRITE_BYTE_SIZE (8*1024)
+
+	/*!
+	@def PROXY_MUX_DELIVER_RETRY_MILLISEC
+	@brief Period to retry delivering to the clients not ready to receive
+
+	Macro for the period in millisecond to retry delivering the multiplexed data to the clients not ready to receive.
+	*/
+	#define PROXY_MUX_DELIVER_RETRY_MILLISEC 10
+
+	/*!
+	@def PROXY_MUX_FRAME_SEND_WAITTIME_MILLISEC
+	@brief Time to wait for a multiplexed connection to be writable in each attempt to send a frame
+
+	Macro for the time in millisecond to wait for a multiplexed connection to the forward server to be writable in each attempt to send a frame.
+	@remark the send lock of the connection is released between the attempts, so the other sessions are not held back.
+	*/
+	#define PROXY_MUX_FRAME_SEND_WAITTIME_MILLISEC 10
+
+	/*!
+	@def PROXY_FORWARD_HIGH_WATERMARK_BYTE_SIZE
+	@brief Default queued byte size to stop receiving at
+
+	Macro for the default byte size queued for one direction of a proxied session, at which its sender stops being read.
+	*/
+	#define PROXY_FORWARD_HIGH_WATERMARK_BYTE_SIZE (256*1024)
+
+	/*!
+	@def PROXY_FORWARD_LOW_WATERMARK_BYTE_SIZE
+	@brief Default queued byte size to resume receiving at
+
+	Macro for the default byte size queued for one direction of a proxied session, at which its sender is read again.
+	*/
+	#define PROXY_FORWARD_LOW_WATERMARK_BYTE_SIZE (64*1024)
+
+	/*!
+	@def PROXY_FORWARD_FLUSH_WAITTIME_MILLISEC
+	@brief Maximum time to deliver the queued data on disconnect
+
+	Macro for the maximum time in millisecond to deliver the data queued from a disconnected forward server before its client is disconnected.
+	*/
+	#define PROXY_FORWARD_FLUSH_WAITTIME_MILLISEC 5000
+
+	/*!
+	@def PROXY_FORWARD_DRAIN_WAITTIME_MILLISEC
+	@brief Maximum time to wait for the queue to drain
+
+	Macro for the maximum time in millisecond for the receiving thread to wait for the queue over the high watermark to drain to the low watermark.
+	@remark the session is killed when its peer does not take the data in time.
+	*/
+	#define PROXY_FORWARD_DRAIN_WAITTIME_MILLISEC 30000
+
+	/*!
+	@def PROXY_FORWARD_CLOSE_WAITTIME_MILLISEC
+	@brief Maximum time to wait for the forward in progress on close
+
+	Macro for the maximum time in millisecond to wait for the forward worker to finish the packet in progress of a closed queue.
+	*/
+	#define PROXY_FORWARD_CLOSE_WAITTIME_MILLISEC 5000
+
+	/*!
+	@def PROXY_FORWARD_BATCH_COUNT
+	@brief Maximum packets forwarded from a queue at a time
+
+	Macro for the maximum number of the packets the forward worker forwards from a queue before it moves on to the next ready queue.
+	*/
+	#define PROXY_FORWARD_BATCH_COUNT 16
+
+	/*!
+	@def PROXY_FORWARD_RETRY_MILLISEC
+	@brief Time to retry the queues blocked
+
+	Macro for the time in millisecond after which the forward worker checks again the queues whose peer was not writable.
+	*/
+	#define PROXY_FORWARD_RETRY_MILLISEC 10
+
+	/*!
+	@def PROXY_UDP_BINDING_EXPIRY_MILLISEC
+	@brief Default idle time until the binding of a UDP client expires
+
+	Macro for the default idle time in millisecond until the binding of a client to its forward server expires in the UDP relay.
+	*/
+	#define PROXY_UDP_BINDING_EXPIRY_MILLISEC 60000
+
+	/*!
+	@def PROXY_UDP_RELAY_SWEEP_MILLISEC
+	@brief Period to expire the idle bindings of the UDP relay
+
+	Macro for the period in millisecond to expire the idle bindings of the UDP relay.
+	*/
+	#define PROXY_UDP_RELAY_SWEEP_MILLISEC 1000
+
+	/*!
+	@def PROXY_UDP_RELAY_DATAGRAM_BYTE_SIZE
+	@brief Byte size of the datagram relayed from the forward server
+
+	Macro for the maximum byte size of the datagram relayed from the forward server by the UDP relay, and the larger datagram is dropped.
+	*/
+	#define PROXY_UDP_RELAY_DATAGRAM_BYTE_SIZE 2048
+
+	/*!
+	@def PROXY_UDP_RELAY_RECEIVE_BUFFER_BYTE_SIZE
+	@brief Byte size of the receive buffer for the clients of the UDP relay
+
+	Macro for the byte size of the buffer receiving the datagrams, which can be coalesced, from the clients of the UDP relay.
+	*/
+	#define PROXY_UDP_RELAY_RECEIVE_BUFFER_BYTE_SIZE (64*1024)
+
+	/*!
+	@def PROXY_UDP_RELAY_COMPLETION_BATCH_COUNT
+	@brief Number of the completions dequeued at once by the UDP relay
+
+	Macro for the maximum number of the receive completions from the forward servers dequeued with one call by the UDP relay.
+	*/
+	#define PROXY_UDP_RELAY_COMPLETION_BATCH_COUNT 64
+
+	/*!
+	@def PROXY_UDP_RELAY_BUCKET_COUNT
+	@brief Initial number of the buckets of the binding table
+
+	Macro for the initial number of the buckets of the binding table of the UDP relay, which must be the power of two.
+	*/
+	#define PROXY_UDP_RELAY_BUCKET_COUNT 1024
+
+	/*!
+	@def PROXY_UDP_RELAY_BINDING_LIMIT
+	@brief Default maximum number of the bindings of the UDP relay
+
+	Macro for the default maximum number of the clients bound to their forward servers at once in the UDP relay.
+	@remark the datagrams from a new client are dropped while the limit is reached, until the idle bindings expire.
+	*/
+	#define PROXY_UDP_RELAY_BINDING_LIMIT 65536
+
+	/*!
+	@def PROXY_UDP_RELAY_PENDING_BYTE_SIZE
+	@brief Maximum byte size held for a binding being set up
+
+	Macro for the maximum byte size of the datagrams from a client held while its binding is set up, and the more are dropped.
+	*/
+	#define PROXY_UDP_RELAY_PENDING_BYTE_SIZE (64*1024)
+
+	/*!
+	@def TCP_CONNECT_ATTEMPT_DELAY_MILLISEC
+	@brief Delay to start connecting to the next address of the server
+
+	Macro for the time in millisecond a TCP connect attempt is given before the next address of the server is raced against it.
+	*/
+	#define TCP_CONNECT_ATTEMPT_DELAY_MILLISEC 250
+
+	/*!
+	@def RESOLVER_CACHE_TIME_TO_LIVE_MILLISEC
+	@brief Default time to live of the resolved addresses
+
+	Macro for the default time in millisecond the resolved addresses of a host are reused.
+	*/
+	#define RESOLVER_CACHE_TIME_TO_LIVE_MILLISEC 60000
+
+	/*!
+	@def RESOLVER_CACHE_NEGATIVE_TIME_TO_LIVE_MILLISEC
+	@brief Default time to live of the failed resolution
+
+	Macro for the default time in millisecond the failure to resolve a host is reused.
+	*/
+	#define RESOLVER_CACHE_NEGATIVE_TIME_TO_LIVE_MILLISEC 5000
+
+	/*!
+	@def RESOLVER_CACHE_REFRESH_PERCENTAGE
+	@brief Age to refresh the resolved addresses
+
+	Macro for the age in percentage of the time to live, after which a hit refreshes the addresses in the background.
+	*/
+	#define RESOLVER_CACHE_REFRESH_PERCENTAGE 75
+
+	/*!
+	@def RESOLVER_CACHE_ENTRY_LIMIT
+	@brief Maximum number of the cached resolutions
+
+	Macro for the maximum number of the host and port pairs the resolver cache holds.
+	*/
+	#define RESOLVER_CACHE_ENTRY_LIMIT 1024
+
 	/// Receive Status
 	typedef enum _receiveStatus{
 		/// Success
@@ -90,6 +659,8 @@ namespace epse{
 		RECEIVE_STATUS_FAIL_RECEIVE_FAILED,
 		/// Not supported
 		RECEIVE_STATUS_FAIL_NOT_SUPPORTED,
+		/// Memory budget exceeded
+		RECEIVE_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED,
 		
 	}ReceiveStatus;
 
@@ -105,8 +676,81 @@ namespace epse{
 		SEND_STATUS_FAIL_SEND_FAILED,
 		/// Not connected
 		SEND_STATUS_FAIL_NOT_CONNECTED,
+		/// Memory budget exceeded
+		SEND_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED,
 
 	}SendStatus;
+
+	/// Connect Status
+	typedef enum _connectStatus{
+		/// Success
+		CONNECT_STATUS_SUCCESS=0,
+		/// Failed to resolve the server address
+		CONNECT_STATUS_FAIL_RESOLVE_FAILED,
+		/// Time-out
+		CONNECT_STATUS_FAIL_TIME_OUT,
+		/// No address of the server accepted the connection
+		CONNECT_STATUS_FAIL_CONNECT_FAILED,
+		/// Canceled by Disconnect
+		CONNECT_STATUS_FAIL_CANCELED,
+
+	}ConnectStatus;
+
+	/// Buffer Pool Flag
+	typedef enum _bufferPoolFlag{
+		/// No pooling (global heap)
+		BUFFER_POOL_FLAG_NONE=0x00,
+		/// Pooled for each worker thread
+		BUFFER_POOL_FLAG_POOLED=0x01,
+		/// Pool backed by the large pages
+		BUFFER_POOL_FLAG_LARGE_PAGE=0x02,
+		/// Pool allocated on the NUMA node of the worker thread
+		BUFFER_POOL_FLAG_NUMA_LOCAL=0x04,
+	}BufferPoolFlag;
+
+	/// UDP Offload Flag
+	typedef enum _udpOffloadFlag{
+		/// No offload
+		UDP_OFFLOAD_FLAG_NONE=0x00,
+		/// Segmentation offload for SendSegmented of the new sessions
+		UDP_OFFLOAD_FLAG_SEND=0x01,
+		/// Receive coalescing on the listen socket
+		UDP_OFFLOAD_FLAG_RECEIVE=0x02,
+	}UdpOffloadFlag;
+
+	/// UDP Channel Type
+	typedef enum _udpChannelType{
+		/// Unreliable and unordered, as the plain datagram
+		UDP_CHANNEL_TYPE_UNRELIABLE=0,
+		/// Unreliable, where the messages older than the last received are dropped
+		UDP_CHANNEL_TYPE_UNRELIABLE_SEQUENCED,
+		/// Reliable and ordered
+		UDP_CHANNEL_TYPE_RELIABLE_ORDERED,
+	}UdpChannelType;
+
+	/// Upstream Balance Policy
+	typedef enum _upstreamBalancePolicy{
+		/// Each upstream in turn
+		UPSTREAM_BALANCE_POLICY_ROUND_ROBIN=0,
+		/// The upstream with the least outstanding connections
+		UPSTREAM_BALANCE_POLICY_LEAST_OUTSTANDING,
+		/// The less loaded of two upstreams chosen at random
+		UPSTREAM_BALANCE_POLICY_POWER_OF_TWO_CHOICES,
+		/// The upstream by the consistent hash of the client IP, for sticky sessions
+		UPSTREAM_BALANCE_POLICY_CONSISTENT_HASH,
+	}UpstreamBalancePolicy;
+
+	/// Proxy Multiplexing Frame Type
+	typedef enum _proxyMuxFrameType{
+		/// New session, with the socket address of the client in its own byte size (proxy to forward server)
+		PROXY_MUX_FRAME_TYPE_OPEN=0,
+		/// Data of the session
+		PROXY_MUX_FRAME_TYPE_DATA,
+		/// More credit in byte for the session, as 4 byte unsigned integer
+		PROXY_MUX_FRAME_TYPE_WINDOW,
+		/// End of the session
+		PROXY_MUX_FRAME_TYPE_CLOSE,
+	}ProxyMuxFrameType;
 	
 }
 #endif //__EP_SERVER_CONF_H__
\ No newline at end of file
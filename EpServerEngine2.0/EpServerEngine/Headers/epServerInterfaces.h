@@ -42,6 +42,8 @@ An Interface for Server Interfaces.
 #include <winsock2.h>
 #include "epPacket.h"
 #include "epBaseServerObject.h"
+#include "epMessageArena.h"
+#include "epMemoryBudget.h"
 namespace epse{
 	class ServerCallbackInterface;
 
@@ -70,6 +72,93 @@ namespace epse{
 		*/
 		unsigned int workerThreadCount;
 
+		/*!
+		The server-wide memory budget in byte.
+		@remark 0 means there is no limit
+		*/
+		size_t memoryBudgetByteSize;
+
+		/*!
+		The memory budget in byte for each connection.
+		@remark 0 means there is no limit
+		*/
+		size_t connectionMemoryBudgetByteSize;
+
+		/*!
+		The combination of BufferPoolFlag for the receive buffers of each worker thread.
+		@remark For IOCP Use Only!
+		*/
+		unsigned int bufferPoolFlags;
+
+		/*!
+		The maximum number of the datagrams queued by SendBatch before flushed.
+		@remark 0 or 1 sends the packets immediately
+		@remark the queue saves the lock and the select per datagram, and still calls sendto per datagram.
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpSendQueueCount;
+
+		/*!
+		The number of the threads receiving on the UDP listen socket, including the server thread.
+		@remark 0 or 1 receives on the server thread only
+		@remark each datagram is handled in the shard chosen by the client address, so the datagrams of a client are never handled concurrently
+		@remark the datagrams received at once by two threads may be handled in either order, as UDP may reorder them anyway
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpReceiveThreadCount;
+
+		/*!
+		The combination of UdpOffloadFlag for the segmentation and receive coalescing offload.
+		@remark falls back to the separate datagrams where not supported
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpOffloadFlags;
+
+		/*!
+		The types of the UDP channels of each session, indexed by the channel id.
+		@remark NULL disables the channel layer, and the datagrams are sent as they are
+		@remark For UDP Use Only!
+		*/
+		const UdpChannelType *udpChannelTypes;
+
+		/*!
+		The number of the UDP channels in udpChannelTypes.
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpChannelCount;
+
+		/*!
+		Flag whether to fragment the packets larger than the path MTU.
+		@remark the path MTU is probed with the datagrams not fragmented by IP
+		@remark must match the clients
+		@remark For UDP Use Only!
+		*/
+		bool isUdpFragmentation;
+
+		/*!
+		The number of the threads running the UDP sessions.
+		@remark 0 runs each session on its own thread
+		@remark For AsyncUdpServer Use Only!
+		*/
+		unsigned int udpDispatchThreadCount;
+
+		/*!
+		The time in millisecond a small UDP packet may wait to share a datagram with the others.
+		@remark 0 disables the coalescing, and each packet is sent in its own datagram
+		@remark must match the clients
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpCoalesceDelayMilliSec;
+
+		/*!
+		The number of the packets received in a second, at which a UDP session is moved to its own connected socket.
+		@remark 0 keeps all the sessions on the listen socket
+		@remark the session is moved only when the client answers on the new port, which requires ClientOps::isUdpSessionMovable
+		@remark at most UDP_CONNECTED_SESSION_MAX_COUNT sessions are moved
+		@remark For UDP Use Only!
+		*/
+		unsigned int udpConnectPacketRate;
+
 		/*!
 		Default Constructor
 
@@ -83,7 +172,18 @@ namespace epse{
 			waitTimeMilliSec=WAITTIME_INIFINITE;
 			maximumConnectionCount=CONNECTION_LIMIT_INFINITE;
 			workerThreadCount=0;
-
+			memoryBudgetByteSize=MEMORY_BUDGET_INFINITE;
+			connectionMemoryBudgetByteSize=MEMORY_BUDGET_INFINITE;
+			bufferPoolFlags=BUFFER_POOL_FLAG_NONE;
+			udpSendQueueCount=UDP_SEND_QUEUE_COUNT_DISABLED;
+			udpReceiveThreadCount=1;
+			udpOffloadFlags=UDP_OFFLOAD_FLAG_NONE;
+			udpChannelTypes=NULL;
+			udpChannelCount=0;
+			isUdpFragmentation=false;
+			udpDispatchThreadCount=0;
+			udpCoalesceDelayMilliSec=0;
+			udpConnectPacketRate=0;
 		}
 
 		static ServerOps defaultServerOps;
@@ -156,6 +256,28 @@ namespace epse{
 		*/
 		virtual void ShutdownAllClient()=0;
 
+		/*!
+		Get the server-wide memory budget
+		@return the server-wide memory budget
+		@remark covers the receive buffers, outbound queues and pending packets of all connections.
+		*/
+		virtual MemoryBudget *GetMemoryBudget()=0;
+
+		/*!
+		Set the memory budget for each connection.
+		@param[in] budgetByteSize The memory budget in byte to set.
+		@remark 0 means there is no limit
+		@remark applied to the connections made afterwards.
+		*/
+		virtual void SetConnectionMemoryBudgetByteSize(size_t budgetByteSize)=0;
+
+		/*!
+		Get the memory budget for each connection.
+		@return the memory budget in byte
+		@remark 0 means there is no limit
+		*/
+		virtual size_t GetConnectionMemoryBudgetByteSize() const=0;
+
 		/*!
 		Get the maximum packet byte size
 		@return the maximum packet byte size
@@ -205,6 +327,29 @@ namespace epse{
 		*/
 		virtual int Send(const Packet &packet, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL)=0;
 
+		/*!
+		Send the packets to the client in a batch
+		@param[in] packets the packets to be sent
+		@param[in] packetCount the number of the packets
+		@param[in] waitTimeInMilliSec wait time for sending the packets in millisecond
+		@param[in] sendStatus the status of SendBatch
+		@return sent byte size
+		@remark return -1 if error occurred
+		@remark For UDP Socket, the packets are retained and queued until flushed when the send queue of the server is on.
+		*/
+		virtual int SendBatch(const Packet *const *packets,unsigned int packetCount, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL)
+		{
+			int writeLength=0;
+			for(unsigned int packetTrav=0;packetTrav<packetCount;packetTrav++)
+			{
+				int sentLength=Send(*packets[packetTrav],waitTimeInMilliSec,sendStatus);
+				if(sentLength<0)
+					return sentLength;
+				writeLength+=sentLength;
+			}
+			return writeLength;
+		}
+
 		/*!
 		Receive the packet from the client
 		@param[in] waitTimeInMilliSec wait time for receiving the packet in millisecond
@@ -237,6 +382,19 @@ namespace epse{
 		*/
 		virtual sockaddr GetSockAddr() const=0;
 
+		/*!
+		Get the full socket address of this socket object.
+		@return the socket address of this socket object.
+		@remark unlike GetSockAddr, holds the IPv6 address as well.
+		*/
+		virtual SOCKADDR_STORAGE GetSockAddrStorage() const=0;
+
+		/*!
+		Get the byte size of the socket address of this socket object.
+		@return the byte size of the socket address.
+		*/
+		virtual int GetSockAddrSize() const=0;
+
 		/*!
 		Get the IP of client
 		@return the IP of client in string
@@ -316,7 +474,19 @@ namespace epse{
 		*/
 		virtual unsigned int GetMaxPacketByteSize() const{return 0;}
 
-		
+		/*!
+		Get the arena for the transient allocations of the message currently dispatched
+		@return the arena of the current dispatch, NULL if not available
+		@remark the arena is reset after OnReceived returns.
+		*/
+		virtual MessageArena *GetArena(){return NULL;}
+
+		/*!
+		Get the memory budget of this connection
+		@return the memory budget of this connection, NULL if not available
+		@remark covers the receive buffers, outbound queues and pending packets of the connection.
+		*/
+		virtual MemoryBudget *GetMemoryBudget(){return NULL;}
 
 	};
 
@@ -333,6 +503,15 @@ namespace epse{
 		*/
 		virtual bool OnAccept(sockaddr sockAddr){return true;}
 
+		/*!
+		When new client tries to connect.
+		@param[in] sockAddr the client's full socket address which tries to connect
+		@param[in] sockAddrSize the byte size of the socket address
+		@return true to accept the connection otherwise false.
+		@remark The default calls OnAccept(sockaddr), which only holds the IPv4 address.
+		*/
+		virtual bool OnAccept(const sockaddr *sockAddr,int sockAddrSize){return OnAccept(*sockAddr);}
+
 		/*!
 		When accepted client tries to make connection.
 		@param[in] socket the client socket
@@ -39,6 +39,8 @@ An Interface for Server Object List.
 #define __EP_SERVER_OBJECT_LIST_H__
 
 #include "epServerEngine.h"
+#include "epLightLock.h"
+#include "epLockPolicy.h"
 #include "epBaseServerObject.h"
 #include "epServerObjectRemover.h"
 #include <vector>
@@ -50,10 +52,13 @@ using namespace std;
 namespace epse{
 
 	/*! 
-	@class ServerObjectList epServerObjectList.h
-	@brief A class for Server Object List.
+	@class BasicServerObjectList epServerObjectList.h
+	@brief A class template for Server Object List on the given lock policy.
+
+	ServerObjectList is BasicServerObjectList on RuntimeLightLockPolicy, which keeps the epl::LockPolicy constructor.
 	*/
-	class EP_SERVER_ENGINE ServerObjectList{
+	template<typename LockPolicyType>
+	class BasicServerObjectList:public ServerObjectContainer{
 
 	protected:
 		friend class BaseClient;
@@ -84,7 +89,7 @@ namespace epse{
 		@param[in] waitTimeMilliSec the wait time in millisecond for terminating
 		@param[in] lockPolicyType The lock policy
 		*/
-		ServerObjectList(unsigned int waitTimeMilliSec=WAITTIME_INIFINITE, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+		BasicServerObjectList(unsigned int waitTimeMilliSec=WAITTIME_INIFINITE, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
 
 		/*!
 		Default Copy Constructor
@@ -92,20 +97,20 @@ namespace epse{
 		Initializes the List
 		@param[in] b the second object
 		*/
-		ServerObjectList(const ServerObjectList& b);
+		BasicServerObjectList(const BasicServerObjectList& b);
 		/*!
 		Default Destructor
 
 		Destroy the List
 		*/
-		virtual ~ServerObjectList();
+		virtual ~BasicServerObjectList();
 
 		/*!
 		Assignment operator overloading
 		@param[in] b the second object
 		@return the new copied object
 		*/
-		ServerObjectList & operator=(const ServerObjectList&b);
+		BasicServerObjectList & operator=(const BasicServerObjectList&b);
 
 		/*!
 		Set the wait time for the thread termination
@@ -177,7 +182,7 @@ namespace epse{
 		template <typename T>
 		BaseServerObject  *Find(T const & key, bool (__cdecl *EqualFunc)(T const &, const BaseServerObject *))
 		{
-			epl::LockObj lock(m_listLock);
+			ScopedLock<LockPolicyType> lock(m_listLock);
 			vector<BaseServerObject*>::iterator iter;
 			for(iter=m_objectList.begin();iter!=m_objectList.end();iter++)
 			{
@@ -201,7 +206,7 @@ namespace epse{
 		void resetList();
 	
 		/// list lock
-		epl::BaseLock *m_listLock;
+		mutable LockPolicyType m_listLock;
 
 		/// parser thread list
 		vector<BaseServerObject*> m_objectList;
@@ -216,9 +221,217 @@ namespace epse{
 		/// Object Remover
 		ServerObjectRemover m_serverObjRemover;
 
-		epl::EventEx m_sizeEvent;
+		LightEvent m_sizeEvent;
 
 	};
+
+	/// Server Object List on the runtime lock policy, with LightMutex for LOCK_POLICY_CRITICALSECTION
+	typedef BasicServerObjectList<RuntimeLightLockPolicy> ServerObjectList;
+
+	template<typename LockPolicyType>
+	BasicServerObjectList<LockPolicyType>::BasicServerObjectList(unsigned int waitTimeMilliSec, epl::LockPolicy lockPolicyType):m_listLock(lockPolicyType)
+	{
+		m_waitTime=waitTimeMilliSec;
+		m_lockPolicy=lockPolicyType;
+		m_serverObjRemover=ServerObjectRemover(waitTimeMilliSec,lockPolicyType);
+		m_sizeEvent=LightEvent(false,false);
+	}
+
+	template<typename LockPolicyType>
+	BasicServerObjectList<LockPolicyType>::BasicServerObjectList(const BasicServerObjectList<LockPolicyType>& b):m_listLock(b.m_listLock)
+	{
+		m_sizeEvent=b.m_sizeEvent;
+		m_lockPolicy=b.m_lockPolicy;
+		m_waitTime=b.m_waitTime;
+
+		BasicServerObjectList<LockPolicyType>&unSafeB=const_cast<BasicServerObjectList<LockPolicyType>&>(b);
+		unSafeB.m_listLock.Lock();
+		m_objectList=b.m_objectList;
+		vector<BaseServerObject*>::iterator iter;
+		for(iter=m_objectList.begin();iter!=m_objectList.end();iter++)
+		{
+			(*iter)->RetainObj();
+			(*iter)->setContainer(this);
+			(*iter)->m_containerIndex=iter-m_objectList.begin();
+
+		}
+		unSafeB.m_listLock.Unlock();
+
+		m_serverObjRemover=b.m_serverObjRemover;
+
+
+	}
+
+	template<typename LockPolicyType>
+	BasicServerObjectList<LockPolicyType>::~BasicServerObjectList()
+	{
+		resetList();
+	}
+
+	template<typename LockPolicyType>
+	void BasicServerObjectList<LockPolicyType>::resetList()
+	{
+		Clear();
+	}
+
+	template<typename LockPolicyType>
+	BasicServerObjectList<LockPolicyType> & BasicServerObjectList<LockPolicyType>::operator=(const BasicServerObjectList<LockPolicyType>&b)
+	{
+		if(this!=&b)
+		{
+			resetList();
+
+			m_sizeEvent=b.m_sizeEvent;
+			m_lockPolicy=b.m_lockPolicy;
+			m_listLock.SetLockPolicy(m_lockPolicy);
+			m_waitTime=b.m_waitTime;
+			BasicServerObjectList<LockPolicyType>&unSafeB=const_cast<BasicServerObjectList<LockPolicyType>&>(b);
+			unSafeB.m_listLock.Lock();
+			m_objectList=b.m_objectList;
+			vector<BaseServerObject*>::iterator iter;
+			for(iter=m_objectList.begin();iter!=m_objectList.end();iter++)
+			{
+				(*iter)->RetainObj();
+				(*iter)->setContainer(this);
+				(*iter)->m_containerIndex=iter-m_objectList.begin();
+
+			}
+			unSafeB.m_listLock.Unlock();
+
+			m_serverObjRemover=b.m_serverObjRemover;
+
+		}
+		return *this;
+	}
+
+	template<typename LockPolicyType>
+	void BasicServerObjectList<LockPolicyType>::SetWaitTime(unsigned int milliSec)
+	{
+		ScopedLock<LockPolicyType> lock(m_listLock);
+		m_waitTime=milliSec;
+	}
+
+	template<typename LockPolicyType>
+	unsigned int BasicServerObjectList<LockPolicyType>::GetWaitTime()
+	{
+		ScopedLock<LockPolicyType> lock(m_listLock);
+		return m_waitTime;
+	}
+
+
+	template<typename LockPolicyType>
+	bool BasicServerObjectList<LockPolicyType>::Remove(const BaseServerObject* serverObj)
+	{
+		ScopedLock<LockPolicyType> lock(m_listLock);
+		if(!serverObj)
+			return false;
+		size_t removeIdx=serverObj->m_containerIndex;
+		if(removeIdx<m_objectList.size() && m_objectList.at(removeIdx)==serverObj)
+		{
+			// move the last object into the hole, so the removal is O(1)
+			m_serverObjRemover.Push(m_objectList.at(removeIdx));
+			m_objectList.at(removeIdx)=m_objectList.back();
+			m_objectList.at(removeIdx)->m_containerIndex=removeIdx;
+			m_objectList.pop_back();
+			m_sizeEvent.SetEvent();
+			return true;
+		}
+		for(ssize_t idx=static_cast<ssize_t>(m_objectList.size())-1;idx>=0;idx--)
+		{
+			if((m_objectList.at(idx))==serverObj)
+			{
+				m_serverObjRemover.Push(m_objectList.at(idx));
+				m_objectList.erase(m_objectList.begin()+idx);
+				m_sizeEvent.SetEvent();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template<typename LockPolicyType>
+	void BasicServerObjectList<LockPolicyType>::Clear()
+	{
+		ScopedLock<LockPolicyType> lock(m_listLock);
+		vector<BaseServerObject*>::iterator iter;
+		for(iter=m_objectList.begin();iter!=m_objectList.end();iter++)
+		{
+			if(*iter)
+			{
+				(*iter)->setContainer(NULL);
+				m_serverObjRemover.Push(*iter);
+
+			}
+		}
+		m_objectList.clear();
+		m_sizeEvent.SetEvent();
+	}
+
+	template<typename LockPolicyType>
+	void BasicServerObjectList<LockPolicyType>::Push(BaseServerObject* obj)
+	{
+		ScopedLock<LockPolicyType> lock(m_listLock);
+		if(obj)
+		{
+			obj->RetainObj();
+			obj->m_containerIndex=m_objectList.size();
+			m_objectList.push_back(obj);
+			obj->setContainer(this);
+		}
+
+	}
+
+	template<typename LockPolicyType>
+	vector<BaseServerObject*> BasicServerObjectList<LockPolicyType>::GetList() const
+	{
+		ScopedLock<LockPolicyType> lock(m_listLock);
+		return m_objectList;
+	}
+
+	template<typename LockPolicyType>
+	size_t BasicServerObjectList<LockPolicyType>::Count() const
+	{
+		ScopedLock<LockPolicyType> lock(m_listLock);
+		return m_objectList.size();
+	}
+
+	template<typename LockPolicyType>
+	void BasicServerObjectList<LockPolicyType>::Do(void (__cdecl *DoFunc)(BaseServerObject*,unsigned int,va_list),unsigned int argCount,...)
+	{
+		m_listLock.Lock();
+		vector<BaseServerObject*> objList=m_objectList;
+		m_listLock.Unlock();
+
+		void *argPtr=NULL;
+		va_list ap=NULL;
+		va_start (ap , argCount);         /* Initialize the argument list. */
+		for(ssize_t idx=static_cast<ssize_t>(objList.size())-1;idx>=0;idx--)
+		{
+			DoFunc(objList.at(idx),argCount,ap);
+		}
+
+		va_end (ap);                  /* Clean up. */
+	}
+
+	template<typename LockPolicyType>
+	void BasicServerObjectList<LockPolicyType>::Do(void (__cdecl *DoFunc)(BaseServerObject*,unsigned int,va_list),unsigned int argCount,va_list args)
+	{
+		m_listLock.Lock();
+		vector<BaseServerObject*> objList=m_objectList;
+		m_listLock.Unlock();
+
+		for(ssize_t idx=static_cast<ssize_t>(objList.size())-1;idx>=0;idx--)
+		{
+			DoFunc(objList.at(idx),argCount,args);
+		}
+	}
+
+
+	template<typename LockPolicyType>
+	void BasicServerObjectList<LockPolicyType>::WaitForListSizeDecrease()
+	{
+		m_sizeEvent.WaitForEvent();
+	}
 	
 }
 
@@ -39,6 +39,7 @@ An Interface for Server Object Remover.
 #define __EP_SERVER_OBJECT_REMOVER_H__
 
 #include "epServerEngine.h"
+#include "epLightLock.h"
 #include "epBaseServerObject.h"
 #include <queue>
 
@@ -55,7 +56,7 @@ namespace epse{
 	class EP_SERVER_ENGINE ServerObjectRemover:protected epl::Thread, protected SmartObject{
 
 	private:
-		friend class ServerObjectList;
+		template<typename LockPolicyType> friend class BasicServerObjectList;
 		friend class ParserList;
 		/*!
 		Default Constructor
@@ -133,7 +134,7 @@ namespace epse{
 
 		/// Thread Stop Event
 		/// @remark if this is raised, the thread should quickly stop.
-		epl::EventEx m_threadStopEvent;
+		LightEvent m_threadStopEvent;
 
 	};
 	
@@ -41,6 +41,7 @@ An Interface for Server Packet Processor.
 #include "epServerEngine.h"
 #include "epServerInterfaces.h"
 #include "epBasePacketProcessor.h"
+#include "epMessageArena.h"
 
 namespace epse
 {
@@ -105,6 +106,9 @@ namespace epse
 		/// Callback Object
 		ServerCallbackInterface *m_callBackObj;
 
+		/// Arena for the message dispatched by this processor
+		MessageArena m_arena;
+
 
 	};
 
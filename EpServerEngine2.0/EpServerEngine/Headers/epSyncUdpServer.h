@@ -85,9 +85,13 @@ namespace epse{
 	private:
 
 		/*!
-		Listening Loop Function
+		Handle the datagram received from the client
+		@param[in] packetData the datagram
+		@param[in] recvLength the result of the receive
+		@param[in] clientAddress the client address
+		@param[in] segmentByteSize the segment byte size of the coalesced datagrams, 0 if not coalesced
 		*/
-		virtual void execute() ;
+		virtual void handleDatagram(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize);
 		
 	};
 }
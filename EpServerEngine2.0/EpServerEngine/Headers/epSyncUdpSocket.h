@@ -39,6 +39,7 @@ An Interface for Synchronous UDP Socket.
 #define __EP_SYNC_UDP_SOCKET_H__
 
 #include "epServerEngine.h"
+#include "epLightLock.h"
 #include "epBaseUdpSocket.h"
 
 namespace epse
@@ -144,7 +145,7 @@ namespace epse
 
 	private:
 		/// Packet Received Event
-		epl::EventEx m_packetReceivedEvent;
+		LightEvent m_packetReceivedEvent;
 
 		/// Connection status
 		bool m_isConnected;
@@ -0,0 +1,415 @@
+/*! 
+@file epUdpChannel.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Channel Layer Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for UDP Channel Layer.
+
+Multiplexes the unreliable, unreliable-sequenced and reliable-ordered
+channels over the datagrams of a session. Each datagram carries a packet
+sequence number with the acknowledgement of the last 33 datagrams received,
+and the reliable messages are retransmitted by the round trip time within
+the congestion window.
+
+*/
+#ifndef __EP_UDP_CHANNEL_H__
+#define __EP_UDP_CHANNEL_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epPacket.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include <vector>
+#include <list>
+#include <deque>
+#include <map>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class UdpChannelTransportInterface epUdpChannel.h
+	@brief A class for the transport of the UDP channel session.
+	*/
+	class EP_SERVER_ENGINE UdpChannelTransportInterface{
+	public:
+		/*!
+		Send the datagram built by the channel session as it is
+		@param[in] datagram the datagram to send
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		@remark called after the lock of the channel session is released.
+		*/
+		virtual int SendDatagram(const Packet &datagram,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)=0;
+
+		/*!
+		Called when the reliable message is not acknowledged after UDP_CHANNEL_MAX_SEND_COUNT transmissions
+		@remark called from the channel timer thread.
+		*/
+		virtual void OnChannelFailed(){}
+	};
+
+	/*! 
+	@class UdpTimerTaskInterface epUdpChannel.h
+	@brief A class for the task updated by the UdpChannelTimer.
+	*/
+	class EP_SERVER_ENGINE UdpTimerTaskInterface{
+	public:
+		/*!
+		Called from the timer every UDP_CHANNEL_TICK_MILLISEC
+		*/
+		virtual void Update()=0;
+	};
+
+	/*! 
+	@class UdpChannelSession epUdpChannel.h
+	@brief A class for the channel layer of a UDP session.
+	*/
+	class EP_SERVER_ENGINE UdpChannelSession:public UdpTimerTaskInterface{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the channel session
+		@param[in] transport the transport to send the datagrams
+		@param[in] channelTypes the types of the channels, indexed by the channel id
+		@param[in] channelCount the number of the channels
+		@param[in] maxPacketSize the maximum datagram byte size
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpChannelSession(UdpChannelTransportInterface *transport,const UdpChannelType *channelTypes,unsigned int channelCount,unsigned int maxPacketSize,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the channel session
+		*/
+		virtual ~UdpChannelSession();
+
+		/*!
+		Send the message on the channel
+		@param[in] channelId the channel id
+		@param[in] packet the message to send
+		@param[in] waitTimeInMilliSec wait time for sending the message in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size of the message, or queued byte size when the congestion window is full
+		@remark return -1 if error occurred
+		@remark the message must fit in a datagram with UDP_CHANNEL_HEADER_BYTE_SIZE header.
+		*/
+		int Send(unsigned int channelId,const Packet &packet,unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Process the datagram received
+		@param[in] packetData the datagram received
+		@param[in] packetByteSize the byte size of the datagram
+		@param[out] packetList the messages ready to deliver, which must be released by the caller
+		@return false if the datagram is malformed, otherwise true
+		*/
+		bool Receive(const char *packetData,int packetByteSize,vector<Packet*> &packetList);
+
+		/*!
+		Retransmit the messages timed out, and send the acknowledgement not piggybacked
+		@remark called from the channel timer every UDP_CHANNEL_TICK_MILLISEC.
+		*/
+		virtual void Update();
+
+		/*!
+		Check if the session failed
+		@return true if a reliable message was not acknowledged, otherwise false
+		*/
+		bool IsFailed() const;
+
+		/*!
+		Get the number of the channels
+		@return the number of the channels
+		*/
+		unsigned int GetChannelCount() const;
+
+		/*!
+		Get the smoothed round trip time
+		@return the smoothed round trip time in millisecond
+		*/
+		unsigned int GetRoundTripTime() const;
+
+		/*!
+		Get the congestion window
+		@return the congestion window in the number of the reliable messages
+		*/
+		unsigned int GetCongestionWindow() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the channel session
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpChannelSession(const UdpChannelSession& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpChannelSession & operator=(const UdpChannelSession&b){return *this;}
+
+		/// reliable message
+		struct ReliableMessage{
+			/// sequence of the datagram, which carried the message last
+			unsigned short m_packetSequence;
+			/// channel id
+			unsigned char m_channelId;
+			/// sequence of the message in the channel
+			unsigned short m_messageSequence;
+			/// message
+			Packet *m_packet;
+			/// tick count of the last transmission
+			DWORD m_sentTick;
+			/// number of the transmissions
+			unsigned int m_sendCount;
+		};
+
+		/// state of a channel
+		struct ChannelState{
+			/// channel type
+			UdpChannelType m_type;
+			/// sequence of the next message to send
+			unsigned short m_sendSequence;
+			/// sequence of the next message to deliver, or of the last delivered for the sequenced channel
+			unsigned short m_receiveSequence;
+			/// flag whether a sequenced message is delivered
+			bool m_hasReceived;
+			/// out-of-order reliable messages by the message sequence
+			map<unsigned short,Packet*> m_orderedBuffer;
+		};
+
+		/*!
+		Build the datagram with the header
+		@param[in] channelId the channel id, or the acknowledgement only id
+		@param[in] messageSequence the message sequence in the channel
+		@param[in] packet the message, NULL for the acknowledgement only
+		@param[out] retPacketSequence the packet sequence of the datagram built
+		@return the datagram, which must be released by the caller
+		@remark called with the session lock held, and sent after it is released.
+		*/
+		Packet *buildDatagram(unsigned char channelId,unsigned short messageSequence,const Packet *packet,unsigned short *retPacketSequence=NULL);
+
+		/*!
+		Send the datagrams built, and release them
+		@param[in] datagramList the datagrams to send
+		@param[in] waitTimeInMilliSec wait time for sending each datagram in millisecond
+		@remark called without the session lock held.
+		*/
+		void sendDatagrams(vector<Packet*> &datagramList,unsigned int waitTimeInMilliSec);
+
+		/*!
+		Process the datagram received with the session lock held
+		@param[in] packetData the datagram received
+		@param[in] packetByteSize the byte size of the datagram
+		@param[out] packetList the messages ready to deliver
+		@param[out] datagramList the datagrams to send after the lock is released
+		@return false if the datagram is malformed, otherwise true
+		*/
+		bool receive(const char *packetData,int packetByteSize,vector<Packet*> &packetList,vector<Packet*> &datagramList);
+
+		/*!
+		Process the acknowledgement received
+		@param[in] ack the latest packet sequence received by the peer
+		@param[in] ackBits the bitfield of the 32 packet sequences before ack
+		@param[out] datagramList the datagrams to send after the lock is released
+		*/
+		void processAck(unsigned short ack,unsigned int ackBits,vector<Packet*> &datagramList);
+
+		/*!
+		Record the packet sequence received for the acknowledgement
+		@param[in] packetSequence the packet sequence received
+		*/
+		void recordReceived(unsigned short packetSequence);
+
+		/*!
+		Update the round trip time with the sample
+		@param[in] sampleMilliSec the round trip time sample in millisecond
+		*/
+		void updateRoundTripTime(unsigned int sampleMilliSec);
+
+		/*!
+		Send the pending reliable messages within the congestion window
+		@param[out] datagramList the datagrams to send after the lock is released
+		*/
+		void sendPending(vector<Packet*> &datagramList);
+
+		/*!
+		Check if the sequence is newer than the other with the wrap-around
+		@param[in] sequence the sequence to check
+		@param[in] otherSequence the sequence to compare
+		@return true if sequence is newer than otherSequence
+		*/
+		static bool isSequenceNewer(unsigned short sequence,unsigned short otherSequence);
+
+	private:
+		/// transport
+		UdpChannelTransportInterface *m_transport;
+		/// maximum datagram byte size
+		unsigned int m_maxPacketSize;
+		/// channel states
+		vector<ChannelState> m_channelList;
+
+		/// sequence of the next datagram to send
+		unsigned short m_localSequence;
+		/// latest sequence of the datagram received
+		unsigned short m_remoteSequence;
+		/// bitfield of the 32 sequences received before m_remoteSequence
+		unsigned int m_remoteAckBits;
+		/// flag whether any datagram is received
+		bool m_hasRemoteSequence;
+		/// flag whether the acknowledgement is not sent yet
+		bool m_isAckPending;
+		/// tick count when the acknowledgement became pending
+		DWORD m_ackPendingTick;
+
+		/// reliable messages sent and not acknowledged
+		list<ReliableMessage> m_inFlightList;
+		/// reliable messages waiting for the congestion window
+		deque<ReliableMessage> m_pendingList;
+
+		/// smoothed round trip time in millisecond
+		unsigned int m_smoothedRtt;
+		/// round trip time variance in millisecond
+		unsigned int m_rttVariance;
+		/// retransmission time-out in millisecond
+		unsigned int m_retransmitTimeout;
+		/// flag whether the round trip time is measured
+		bool m_hasRttSample;
+
+		/// congestion window in the number of the reliable messages
+		double m_congestionWindow;
+		/// slow start threshold
+		double m_slowStartThreshold;
+		/// tick count of the last window reduction
+		DWORD m_reductionTick;
+
+		/// flag whether the session failed
+		volatile bool m_isFailed;
+		/// session lock
+		mutable RuntimeLockPolicy m_sessionLock;
+	};
+
+	/*! 
+	@class UdpChannelTimer epUdpChannel.h
+	@brief A class for the thread updating the UDP channel sessions and the other timer tasks every UDP_CHANNEL_TICK_MILLISEC.
+	*/
+	class EP_SERVER_ENGINE UdpChannelTimer:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the timer
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpChannelTimer(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the timer
+		*/
+		virtual ~UdpChannelTimer();
+
+		/*!
+		Start the timer
+		@return true if started, otherwise false
+		*/
+		bool StartTimer();
+
+		/*!
+		Stop the timer
+		@param[in] waitTimeInMilliSec wait time for the thread to terminate
+		*/
+		void StopTimer(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Register the task to update
+		@param[in] task the channel session or the other timer task
+		*/
+		void Register(UdpTimerTaskInterface *task);
+
+		/*!
+		Unregister the task
+		@param[in] task the channel session or the other timer task
+		@remark the task is not updated after this returns, so it waits for the update in progress unless called from the timer.
+		*/
+		void Unregister(UdpTimerTaskInterface *task);
+
+	protected:
+		/*!
+		Timer Loop Function
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the timer
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpChannelTimer(const UdpChannelTimer& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpChannelTimer & operator=(const UdpChannelTimer&b){return *this;}
+
+	private:
+		/// tasks to update
+		vector<UdpTimerTaskInterface*> m_taskList;
+		/// task list lock
+		RuntimeLockPolicy m_listLock;
+		/// copy of the task list being updated, accessed by the timer thread only
+		vector<UdpTimerTaskInterface*> m_updateList;
+		/// lock held while the tasks are updated
+		RuntimeLockPolicy m_updateLock;
+		/// thread stop event
+		LightEvent m_threadStopEvent;
+	};
+}
+
+#endif //__EP_UDP_CHANNEL_H__
@@ -0,0 +1,187 @@
+/*! 
+@file epUdpCoalescer.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Coalescing Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for UDP Coalescing.
+
+Packs the small messages of a session into the shared datagrams up to the
+datagram byte size, each prefixed by its length, and sends the datagram when it
+is full, when the flush delay has passed since the first message buffered, or
+when flushed explicitly. The receiver slices the datagram back into the messages
+without copying.
+
+*/
+#ifndef __EP_UDP_COALESCER_H__
+#define __EP_UDP_COALESCER_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epUdpChannel.h"
+#include "epLockPolicy.h"
+#include <winsock2.h>
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class UdpCoalescerTransportInterface epUdpCoalescer.h
+	@brief A class for the transport of the UDP coalescer.
+	*/
+	class EP_SERVER_ENGINE UdpCoalescerTransportInterface{
+	public:
+		/*!
+		Send the buffers gathered as one datagram without coalescing
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		*/
+		virtual int SendCoalesced(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)=0;
+	};
+
+	/*! 
+	@class UdpCoalescer epUdpCoalescer.h
+	@brief A class for coalescing the small messages of a UDP session into the shared datagrams.
+	*/
+	class EP_SERVER_ENGINE UdpCoalescer:public UdpTimerTaskInterface{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the coalescer
+		@param[in] transport the transport to send the datagrams
+		@param[in] maxPacketSize the maximum datagram byte size of the socket
+		@param[in] delayMilliSec the time in millisecond a message may wait in the buffer
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpCoalescer(UdpCoalescerTransportInterface *transport,unsigned int maxPacketSize,unsigned int delayMilliSec,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the coalescer
+		@remark the messages buffered are dropped.
+		*/
+		virtual ~UdpCoalescer();
+
+		/*!
+		Buffer the message gathered from the buffers, or send it alone if it does not fit in a datagram
+		@param[in] buffers the buffers of the message
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return the byte size of the message buffered or sent
+		@remark return -1 if error occurred
+		*/
+		int Send(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the messages buffered now
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return 0 if nothing is buffered, and -1 if error occurred
+		*/
+		int Flush(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Send the messages buffered longer than the flush delay
+		@remark called from the channel timer every UDP_CHANNEL_TICK_MILLISEC.
+		*/
+		virtual void Update();
+
+		/*!
+		Get the byte size of the length header added to each message
+		@return the byte size of the header
+		*/
+		static unsigned int GetReservedByteSize();
+
+		/*!
+		Slice the coalesced datagram into the messages
+		@param[in] packetData the datagram received
+		@param[in] packetByteSize the byte size of the datagram
+		@param[out] messageList the messages pointing into the datagram
+		@return false if the datagram is malformed, otherwise true
+		@remark the empty messages are skipped, since the zero byte packet closes the session.
+		*/
+		static bool Unpack(const char *packetData,int packetByteSize,vector<WSABUF> &messageList);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the coalescer
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpCoalescer(const UdpCoalescer& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpCoalescer & operator=(const UdpCoalescer&b){return *this;}
+
+		/*!
+		Send the messages buffered
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark called with the lock held.
+		*/
+		int flush(unsigned int waitTimeInMilliSec,SendStatus *sendStatus);
+
+	private:
+		/// transport
+		UdpCoalescerTransportInterface *m_transport;
+		/// maximum byte size of the coalesced datagram
+		unsigned int m_datagramByteSize;
+		/// time in millisecond a message may wait in the buffer
+		unsigned int m_delayMilliSec;
+		/// buffer of the messages
+		char *m_buffer;
+		/// byte size of the messages buffered
+		unsigned int m_bufferByteSize;
+		/// tick count when the first message is buffered
+		DWORD m_firstTick;
+		/// coalescer lock
+		RuntimeLockPolicy m_coalesceLock;
+	};
+}
+
+#endif //__EP_UDP_COALESCER_H__
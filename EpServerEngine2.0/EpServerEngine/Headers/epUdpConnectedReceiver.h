@@ -0,0 +1,174 @@
+/*! 
+@file epUdpConnectedReceiver.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Connected Session Receiver Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the UDP Connected Session Receiver.
+
+Receives the datagrams of the sessions moved to their own connected sockets.
+Each socket has its own port, so the network stack hands it only the datagrams
+of its client. The sockets are waited on by their network events in one thread
+instead of the shared receive loop.
+
+*/
+#ifndef __EP_UDP_CONNECTED_RECEIVER_H__
+#define __EP_UDP_CONNECTED_RECEIVER_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epLockPolicy.h"
+#include <winsock2.h>
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	class BaseUdpServer;
+	class BaseUdpSocket;
+
+	/*! 
+	@class UdpConnectedReceiver epUdpConnectedReceiver.h
+	@brief A class for the thread receiving on the connected sockets of the UDP sessions.
+	*/
+	class EP_SERVER_ENGINE UdpConnectedReceiver:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the receiver
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpConnectedReceiver(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the receiver
+		*/
+		virtual ~UdpConnectedReceiver();
+
+		/*!
+		Start the receiver
+		@param[in] server the UDP server to deliver the datagrams
+		@return true if started, otherwise false
+		*/
+		bool StartReceiver(BaseUdpServer *server);
+
+		/*!
+		Stop the receiver, and close the connected sockets left
+		@param[in] waitTimeInMilliSec wait time for the thread to terminate
+		*/
+		void StopReceiver(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Register the connected socket of the session to receive on
+		@param[in] socket the session socket
+		@param[in] connectedSocket the connected socket, which is closed by this receiver once registered
+		@return true if registered, otherwise false
+		@remark fails when UDP_CONNECTED_SESSION_MAX_COUNT sessions are registered.
+		*/
+		bool Register(BaseUdpSocket *socket,SOCKET connectedSocket);
+
+		/*!
+		Unregister the session, and close its connected socket
+		@param[in] socket the session socket
+		@remark the connected socket is closed by the receiving thread, which might still be receiving on it.
+		*/
+		void Unregister(BaseUdpSocket *socket);
+
+	protected:
+		/*!
+		Receiving Loop Function
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the receiver
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpConnectedReceiver(const UdpConnectedReceiver& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpConnectedReceiver & operator=(const UdpConnectedReceiver&b){return *this;}
+
+		/// session received on its connected socket
+		struct Session{
+			/// session socket
+			BaseUdpSocket *m_socket;
+			/// connected socket
+			SOCKET m_connectedSocket;
+			/// network event of the connected socket
+			WSAEVENT m_event;
+		};
+
+		/*!
+		Receive the datagrams queued on the connected socket of the session
+		@param[in] session the session to receive
+		@param[in] packetData the buffer to receive
+		@param[in] length the byte size of the buffer
+		@remark called without the lock, as the delivery may close the session.
+		@remark the first datagram confirms that the client moved, and the empty ones are not delivered.
+		*/
+		void receiveSession(const Session &session,char *packetData,int length);
+
+		/*!
+		Close the connected sockets and the events of the sessions unregistered
+		@remark called with the lock held.
+		*/
+		void closeUnregisteredSessions();
+
+	private:
+		/// UDP server
+		BaseUdpServer *m_server;
+		/// sessions registered
+		vector<Session> m_sessionList;
+		/// sessions unregistered, closed by the receiving thread
+		vector<Session> m_unregisteredSessionList;
+		/// event to wake the receiving thread up as the sessions change
+		WSAEVENT m_wakeEvent;
+		/// flag whether the receiver is stopping
+		bool m_isStopping;
+		/// session list lock
+		RuntimeLockPolicy m_listLock;
+	};
+}
+
+#endif //__EP_UDP_CONNECTED_RECEIVER_H__
@@ -0,0 +1,209 @@
+/*! 
+@file epUdpFragment.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Fragmentation Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for UDP Fragmentation.
+
+Splits the packets larger than the path MTU into the fragments, sent without
+copying the payload, and reassembles them into one copy bounded in memory and
+time. The path MTU is found by probing with the datagrams not fragmented by IP.
+
+*/
+#ifndef __EP_UDP_FRAGMENT_H__
+#define __EP_UDP_FRAGMENT_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epPacket.h"
+#include "epLockPolicy.h"
+#include <winsock2.h>
+#include <vector>
+#include <map>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class UdpFragmentTransportInterface epUdpFragment.h
+	@brief A class for the transport of the UDP fragmenter.
+	*/
+	class EP_SERVER_ENGINE UdpFragmentTransportInterface{
+	public:
+		/*!
+		Send the buffers gathered as one datagram
+		@param[in] buffers the buffers to send
+		@param[in] bufferCount the number of the buffers
+		@param[in] waitTimeInMilliSec wait time for sending the datagram in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size
+		@remark return -1 if error occurred
+		*/
+		virtual int SendBuffers(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)=0;
+	};
+
+	/*! 
+	@class UdpFragmenter epUdpFragment.h
+	@brief A class for the fragmentation, reassembly and path MTU probing of a UDP session.
+	*/
+	class EP_SERVER_ENGINE UdpFragmenter{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the fragmenter
+		@param[in] transport the transport to send the datagrams
+		@param[in] maxPacketSize the maximum datagram byte size of the socket
+		@param[in] reservedByteSize the byte size added to each datagram by the transport
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpFragmenter(UdpFragmentTransportInterface *transport,unsigned int maxPacketSize,unsigned int reservedByteSize=0,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the fragmenter
+		*/
+		virtual ~UdpFragmenter();
+
+		/*!
+		Send the packet in the fragments fit in the path MTU
+		@param[in] packet the packet to send
+		@param[in] waitTimeInMilliSec wait time for sending each fragment in millisecond
+		@param[in] sendStatus the status of the send
+		@return sent byte size of the packet
+		@remark return -1 if error occurred
+		@remark the packet must not be larger than UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE.
+		*/
+		int Send(const Packet &packet,unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE,SendStatus *sendStatus=NULL);
+
+		/*!
+		Process the datagram received
+		@param[in] packetData the datagram received
+		@param[in] packetByteSize the byte size of the datagram
+		@param[out] packetList the packets completed, which must be released by the caller
+		@return false if the datagram is malformed, otherwise true
+		*/
+		bool Receive(const char *packetData,int packetByteSize,vector<Packet*> &packetList);
+
+		/*!
+		Get the datagram byte size confirmed by the path MTU probing
+		@return the datagram byte size including the fragment header
+		*/
+		unsigned int GetDatagramByteSize() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the fragmenter
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpFragmenter(const UdpFragmenter& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpFragmenter & operator=(const UdpFragmenter&b){return *this;}
+
+		/// packet being reassembled
+		struct Assembly{
+			/// reassembled packet
+			Packet *m_packet;
+			/// flags of the fragments received
+			vector<bool> m_receivedList;
+			/// number of the fragments received
+			unsigned int m_receivedCount;
+			/// tick count when the first fragment is received
+			DWORD m_firstTick;
+		};
+
+		/*!
+		Get the probe to send, if any
+		@param[out] retProbeId the probe id
+		@return the probe byte size to send, 0 if none
+		@remark called with the lock held.
+		*/
+		unsigned int nextProbe(unsigned int *retProbeId);
+
+		/*!
+		Send the probe or the acknowledgement of the probe
+		@param[in] type the datagram type
+		@param[in] probeId the probe id
+		@param[in] probeByteSize the probe byte size
+		*/
+		void sendProbe(unsigned char type,unsigned int probeId,unsigned int probeByteSize);
+
+		/*!
+		Remove the packets timed out, and the oldest packets until the new packet fits
+		@param[in] currentTick the current tick count
+		@param[in] newByteSize the byte size of the new packet
+		@remark called with the lock held.
+		*/
+		void purgeAssembly(DWORD currentTick,unsigned int newByteSize);
+
+	private:
+		/// transport
+		UdpFragmentTransportInterface *m_transport;
+		/// maximum datagram byte size of the path
+		unsigned int m_maxDatagramByteSize;
+		/// datagram byte size confirmed
+		unsigned int m_datagramByteSize;
+		/// id of the next packet to send
+		unsigned int m_nextMessageId;
+
+		/// largest datagram byte size not failed the probing
+		unsigned int m_probeHighByteSize;
+		/// byte size of the probe outstanding, 0 if none
+		unsigned int m_probeByteSize;
+		/// id of the probe outstanding
+		unsigned int m_probeId;
+		/// tick count when the probe is sent
+		DWORD m_probeTick;
+		/// number of the probes of the current byte size sent
+		unsigned int m_probeSendCount;
+
+		/// packets being reassembled by the packet id
+		map<unsigned int,Assembly> m_assemblyMap;
+		/// byte size of the packets being reassembled
+		size_t m_assemblyByteSize;
+
+		/// fragmenter lock
+		mutable RuntimeLockPolicy m_fragmentLock;
+	};
+}
+
+#endif //__EP_UDP_FRAGMENT_H__
@@ -0,0 +1,165 @@
+/*! 
+@file epUdpOffload.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Segmentation Offload Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for UDP Segmentation Offload.
+
+Sends a train of equally sized datagrams with one call (UDP_SEND_MSG_SIZE)
+and receives the coalesced datagrams (UDP_RECV_MAX_COALESCED_SIZE) where
+the network stack supports it.
+
+*/
+#ifndef __EP_UDP_OFFLOAD_H__
+#define __EP_UDP_OFFLOAD_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mswsock.h>
+
+namespace epse{
+
+	/*! 
+	@class UdpOffload epUdpOffload.h
+	@brief A class for the UDP segmentation and receive coalescing offload of a socket.
+	*/
+	class EP_SERVER_ENGINE UdpOffload{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Offload
+		*/
+		UdpOffload();
+
+		/*!
+		Default Destructor
+
+		Destroy the Offload
+		*/
+		virtual ~UdpOffload();
+
+		/*!
+		Load the message functions of the given socket
+		@param[in] udpSocket the UDP socket
+		@return true if the segmentation offload might be used, otherwise false
+		*/
+		bool Initialize(SOCKET udpSocket);
+
+		/*!
+		Reset to the uninitialized state
+		*/
+		void Reset();
+
+		/*!
+		Enable the receive coalescing of the given socket
+		@param[in] udpSocket the UDP socket
+		@param[in] maxCoalescedByteSize the maximum byte size of the coalesced datagrams
+		@return true if enabled, otherwise false
+		@remark the receive buffer must be at least maxCoalescedByteSize long.
+		*/
+		bool EnableReceiveCoalescing(SOCKET udpSocket,unsigned int maxCoalescedByteSize);
+
+		/*!
+		Check if the segmentation offload is supported
+		@return true if supported, otherwise false
+		@remark becomes false once the network stack rejects the segmented send.
+		*/
+		bool IsSendOffloadSupported() const;
+
+		/*!
+		Check if the receive coalescing is enabled
+		@return true if enabled, otherwise false
+		*/
+		bool IsReceiveCoalescingEnabled() const;
+
+		/*!
+		Send the data as a train of datagrams with one call
+		@param[in] udpSocket the UDP socket
+		@param[in] data the data to send
+		@param[in] length the byte size of the data
+		@param[in] segmentByteSize the byte size of each datagram
+		@param[in] sockAddr the destination address
+		@param[in] sockAddrSize the byte size of the destination address
+		@return sent byte size, otherwise SOCKET_ERROR
+		@remark check IsSendOffloadSupported on failure to fall back to the separate datagrams.
+		*/
+		int SendSegmented(SOCKET udpSocket,const char *data,int length,unsigned int segmentByteSize,const sockaddr *sockAddr,int sockAddrSize);
+
+		/*!
+		Receive the datagram, or the coalesced datagrams
+		@param[in] udpSocket the UDP socket
+		@param[out] data the buffer to receive
+		@param[in] length the byte size of the buffer
+		@param[out] sockAddr the source address
+		@param[in,out] sockAddrSize the byte size of the source address
+		@param[out] segmentByteSize the byte size of each coalesced datagram, 0 if not coalesced
+		@return received byte size, otherwise SOCKET_ERROR
+		*/
+		int ReceiveFrom(SOCKET udpSocket,char *data,int length,sockaddr *sockAddr,int *sockAddrSize,unsigned int *segmentByteSize);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the Offload
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpOffload(const UdpOffload& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpOffload & operator=(const UdpOffload&b){return *this;}
+
+		/// WSASendMsg function type
+		typedef int (PASCAL *SendMsgFunc)(SOCKET,LPWSAMSG,DWORD,LPDWORD,LPWSAOVERLAPPED,LPWSAOVERLAPPED_COMPLETION_ROUTINE);
+		/// WSARecvMsg function type
+		typedef int (PASCAL *RecvMsgFunc)(SOCKET,LPWSAMSG,LPDWORD,LPWSAOVERLAPPED,LPWSAOVERLAPPED_COMPLETION_ROUTINE);
+
+		/// WSASendMsg of the socket
+		SendMsgFunc m_sendMsgFunc;
+		/// WSARecvMsg of the socket
+		RecvMsgFunc m_recvMsgFunc;
+		/// flag whether the segmentation offload is supported
+		volatile LONG m_isSendOffloadSupported;
+		/// flag whether the receive coalescing is enabled
+		bool m_isReceiveCoalescing;
+	};
+}
+#endif //__EP_UDP_OFFLOAD_H__
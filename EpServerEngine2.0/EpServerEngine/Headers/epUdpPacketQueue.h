@@ -0,0 +1,172 @@
+/*! 
+@file epUdpPacketQueue.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Packet Queue Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Per-session UDP Packet Queue.
+
+The server pushes the datagrams without taking a lock, and the session
+is woken only when the queue turns from empty to non-empty. The nodes are
+recycled through a lock-free free list, so a push does not allocate once
+the queue is warmed up.
+
+*/
+#ifndef __EP_UDP_PACKET_QUEUE_H__
+#define __EP_UDP_PACKET_QUEUE_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epPacket.h"
+#include "epLockPolicy.h"
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class UdpPacketQueue epUdpPacketQueue.h
+	@brief A class for the multiple-producer single-consumer packet queue of a UDP session.
+
+	The producers never block each other nor the consumer, and the consumers are serialized by the consumer lock.
+	*/
+	class EP_SERVER_ENGINE UdpPacketQueue{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the queue
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpPacketQueue(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the queue, and release the packets left
+		*/
+		virtual ~UdpPacketQueue();
+
+		/*!
+		Push the packet retained by the caller
+		@param[in] packet the packet to push
+		@return true if the queue was empty, so the consumer must be woken
+		@remark safe to call from the multiple threads without the lock.
+		*/
+		bool Push(Packet *packet);
+
+		/*!
+		Pop the packet, which must be released by the caller
+		@return the packet, NULL if none
+		*/
+		Packet *Pop();
+
+		/*!
+		Pop all the packets queued in one pass, which must be released by the caller
+		@param[out] retPacketList the packets popped, appended in the pushed order
+		@return the number of the packets popped
+		*/
+		size_t PopAll(vector<Packet*> &retPacketList);
+
+		/*!
+		Check whether the queue is empty
+		@return true if nothing is queued nor being pushed, otherwise false
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		Release all the packets queued
+		*/
+		void Clear();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the queue
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpPacketQueue(const UdpPacketQueue& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpPacketQueue & operator=(const UdpPacketQueue&b){return *this;}
+
+		/// queue node
+		struct Node{
+			/// free list entry, which must be the first
+			SLIST_ENTRY m_freeEntry;
+			/// next node
+			Node * volatile m_next;
+			/// packet
+			Packet *m_packet;
+		};
+
+		/*!
+		Pop the node, called with the consumer lock held
+		@return the node, NULL if none or the last push is not linked yet
+		*/
+		Node *popNode();
+
+		/*!
+		Get the node from the free list, or allocate new one
+		@return the node
+		*/
+		Node *allocateNode();
+
+		/*!
+		Return the node to the free list, or delete it when the list is full
+		@param[in] node the node popped
+		*/
+		void freeNode(Node *node);
+
+	private:
+		/// last node pushed, exchanged by the producers
+		Node * volatile m_head;
+		/// first node, owned by the consumer
+		Node *m_tail;
+		/// stub node to keep the queue non-empty
+		Node m_stub;
+		/// number of the packets pushed and not popped, which can be negative while a push is in progress
+		volatile LONG m_count;
+		/// consumer lock
+		mutable RuntimeLightLockPolicy m_consumerLock;
+		/// free nodes, popped by the producers and pushed by the consumer
+		SLIST_HEADER m_freeList;
+	};
+}
+
+#endif //__EP_UDP_PACKET_QUEUE_H__
@@ -0,0 +1,230 @@
+/*! 
+@file epUdpReceiveThread.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Receive Thread Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the UDP Receive Thread.
+
+Every receive thread receives on the listen socket itself, so the datagrams
+are received in parallel. Each datagram is then handled in the shard chosen
+by the seeded hash of the client address, and a shard is handled by one
+thread at a time, so the datagrams of a client are never handled
+concurrently. The thread entering a free shard handles its datagram in
+place; only a datagram arriving while another thread is in its shard is
+copied into the shard queue, which is bounded and charged to the memory
+budget of the server.
+
+*/
+#ifndef __EP_UDP_RECEIVE_THREAD_H__
+#define __EP_UDP_RECEIVE_THREAD_H__
+
+#include "epServerEngine.h"
+#include "epPacket.h"
+#include "epMemoryBudget.h"
+#include "epLightLock.h"
+#include "epLockPolicy.h"
+#include "epUdpSessionTable.h"
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	class BaseUdpServer;
+
+	/*! 
+	@class UdpReceiveShard epUdpReceiveThread.h
+	@brief A class for the datagrams of the clients hashed to one shard, handled by one thread at a time.
+	*/
+	class EP_SERVER_ENGINE UdpReceiveShard{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the shard
+		@param[in] server the UDP server to handle the datagrams
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpReceiveShard(BaseUdpServer *server,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the shard, and releases the datagrams left
+		*/
+		~UdpReceiveShard();
+
+		/*!
+		Handle the datagram received from the client in this shard
+		@param[in] packetData the datagram
+		@param[in] recvLength the result of the receive
+		@param[in] clientAddress the client address
+		@param[in] segmentByteSize the segment byte size of the coalesced datagrams, 0 if not coalesced
+		@remark handled in place if no other thread is in the shard, otherwise queued for that thread.
+		@remark the datagram is dropped if the queue is full or the memory budget is exceeded.
+		*/
+		void Handle(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize);
+
+		/*!
+		Release the datagrams queued
+		*/
+		void Clear();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the shard
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpReceiveShard(const UdpReceiveShard& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpReceiveShard & operator=(const UdpReceiveShard&b){return *this;}
+
+		/// datagram received
+		struct ReceivedDatagram{
+			/// datagram
+			Packet *m_packet;
+			/// result of the receive
+			int m_recvLength;
+			/// client address
+			UdpSessionAddress m_address;
+			/// segment byte size of the coalesced datagrams
+			unsigned int m_segmentByteSize;
+		};
+
+		/*!
+		Copy the datagram into the queue
+		@param[in] packetData the datagram
+		@param[in] recvLength the result of the receive
+		@param[in] clientAddress the client address
+		@param[in] segmentByteSize the segment byte size of the coalesced datagrams, 0 if not coalesced
+		@return true if queued, false if dropped
+		*/
+		bool push(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize);
+
+		/*!
+		Try to enter the shard
+		@return true if entered, false if another thread is in the shard
+		*/
+		bool tryEnter();
+
+		/*!
+		Leave the shard
+		*/
+		void leave();
+
+		/*!
+		Handle the datagrams queued until the queue is empty
+		@remark must be called in the shard.
+		*/
+		void drain();
+
+		/*!
+		Release the datagrams in the list
+		@param[in] datagramList the datagrams to release
+		*/
+		static void releaseDatagrams(vector<ReceivedDatagram> &datagramList);
+
+	private:
+		/// UDP server
+		BaseUdpServer *m_server;
+		/// queue lock
+		RuntimeLightLockPolicy m_queueLock;
+		/// datagrams queued while another thread was in the shard
+		vector<ReceivedDatagram> m_queue;
+		/// datagrams being handled, swapped with the queue so the capacity is reused
+		vector<ReceivedDatagram> m_handleList;
+		/// 1 while a thread is in the shard, otherwise 0
+		volatile LONG m_isEntered;
+	};
+
+	/*! 
+	@class UdpReceiveThread epUdpReceiveThread.h
+	@brief A class for the thread receiving on the UDP listen socket with the server thread.
+	*/
+	class EP_SERVER_ENGINE UdpReceiveThread:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the thread
+		@param[in] server the UDP server to receive for
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpReceiveThread(BaseUdpServer *server,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the thread
+		*/
+		virtual ~UdpReceiveThread();
+
+	protected:
+		/*!
+		Receiving Loop Function
+		@remark returns as the listen socket is closed.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the thread
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpReceiveThread(const UdpReceiveThread& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpReceiveThread & operator=(const UdpReceiveThread&b){return *this;}
+
+	private:
+		/// UDP server
+		BaseUdpServer *m_server;
+	};
+}
+
+#endif //__EP_UDP_RECEIVE_THREAD_H__
@@ -0,0 +1,196 @@
+/*! 
+@file epUdpSessionDispatcher.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Session Dispatcher Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the UDP Session Dispatcher.
+
+Runs the packets of the UDP sessions on a fixed number of threads, so the
+sessions do not hold a thread each. A session is run by one thread at a time,
+so its packets are processed in the received order.
+
+*/
+#ifndef __EP_UDP_SESSION_DISPATCHER_H__
+#define __EP_UDP_SESSION_DISPATCHER_H__
+
+#include "epServerEngine.h"
+#include "epLightLock.h"
+#include <queue>
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	class BaseUdpSocket;
+	class UdpSessionDispatcher;
+
+	/*! 
+	@class UdpDispatchThread epUdpSessionDispatcher.h
+	@brief A class for the thread of the UDP session dispatcher.
+	*/
+	class EP_SERVER_ENGINE UdpDispatchThread:public epl::Thread{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the thread
+		@param[in] dispatcher the dispatcher to run the sessions from
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpDispatchThread(UdpSessionDispatcher *dispatcher,epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the thread
+		*/
+		virtual ~UdpDispatchThread();
+
+	protected:
+		/*!
+		Dispatching Loop Function
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the thread
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpDispatchThread(const UdpDispatchThread& b):Thread(b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpDispatchThread & operator=(const UdpDispatchThread&b){return *this;}
+
+	private:
+		/// dispatcher
+		UdpSessionDispatcher *m_dispatcher;
+	};
+
+	/*! 
+	@class UdpSessionDispatcher epUdpSessionDispatcher.h
+	@brief A class for running the UDP sessions with the packets queued on a fixed thread pool.
+	*/
+	class EP_SERVER_ENGINE UdpSessionDispatcher{
+		friend class UdpDispatchThread;
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the dispatcher
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpSessionDispatcher(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the dispatcher
+		*/
+		virtual ~UdpSessionDispatcher();
+
+		/*!
+		Start the dispatch threads
+		@param[in] threadCount the number of the dispatch threads
+		@return true if started, otherwise false
+		*/
+		bool StartDispatcher(unsigned int threadCount);
+
+		/*!
+		Stop the dispatch threads after the sessions scheduled are run
+		@param[in] waitTimeInMilliSec wait time for each thread to terminate
+		@remark the sessions scheduled after the threads stopped are run on the calling thread.
+		*/
+		void StopDispatcher(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Check whether the dispatch threads are running
+		@return true if running, otherwise false
+		*/
+		bool IsDispatcherStarted() const;
+
+		/*!
+		Schedule the session to run on one of the dispatch threads
+		@param[in] socket the session socket, retained until run
+		@remark the caller must make sure that the session is not scheduled twice at the same time.
+		*/
+		void Schedule(BaseUdpSocket *socket);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the dispatcher
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpSessionDispatcher(const UdpSessionDispatcher& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpSessionDispatcher & operator=(const UdpSessionDispatcher&b){return *this;}
+
+		/*!
+		Wait for the next session scheduled
+		@return the session, NULL if the dispatcher is stopping and nothing is scheduled
+		*/
+		BaseUdpSocket *waitForSession();
+
+	private:
+		/// lock policy
+		epl::LockPolicy m_lockPolicy;
+		/// dispatch threads
+		vector<UdpDispatchThread*> m_threadList;
+		/// sessions scheduled
+		queue<BaseUdpSocket*> m_readyList;
+		/// ready list lock
+		RuntimeLightLockPolicy m_readyLock;
+		/// number of the sessions scheduled and the stop signals
+		LightSemaphore m_readySemaphore;
+		/// start and stop lock
+		mutable RuntimeLockPolicy m_dispatcherLock;
+	};
+}
+
+#endif //__EP_UDP_SESSION_DISPATCHER_H__
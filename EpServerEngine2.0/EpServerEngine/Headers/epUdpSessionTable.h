@@ -0,0 +1,254 @@
+/*! 
+@file epUdpSessionTable.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/epserverengine>
+@date October 19, 2026
+@brief UDP Session Table Interface
+@version 1.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the hashed UDP Session Table.
+
+*/
+#ifndef __EP_UDP_SESSION_TABLE_H__
+#define __EP_UDP_SESSION_TABLE_H__
+
+#include "epServerEngine.h"
+#include "epServerConf.h"
+#include "epLockPolicy.h"
+#include "epBaseServerObject.h"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <vector>
+using namespace std;
+
+namespace epse{
+
+	/*! 
+	@class UdpSessionAddress epUdpSessionTable.h
+	@brief A class for the UDP session key of (family, IP, port).
+
+	Holds up to the IPv6 socket address.
+	*/
+	class EP_SERVER_ENGINE UdpSessionAddress{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty address
+		*/
+		UdpSessionAddress();
+
+		/*!
+		Default Constructor
+
+		Initializes the address
+		@param[in] sockAddr the socket address
+		@param[in] sockAddrSize the byte size of the socket address
+		*/
+		UdpSessionAddress(const sockaddr *sockAddr,int sockAddrSize);
+
+		/*!
+		Set the address
+		@param[in] sockAddr the socket address
+		@param[in] sockAddrSize the byte size of the socket address
+		@return true if the address family is supported, otherwise false
+		*/
+		bool SetSockAddr(const sockaddr *sockAddr,int sockAddrSize);
+
+		/*!
+		Get the socket address
+		@return the socket address
+		*/
+		const sockaddr *GetSockAddr() const;
+
+		/*!
+		Get the byte size of the socket address
+		@return the byte size of the socket address
+		*/
+		int GetSockAddrSize() const;
+
+		/*!
+		Compare the family, IP and port with the given address
+		@param[in] b the address to compare
+		@return true if same session, otherwise false
+		*/
+		bool operator==(const UdpSessionAddress &b) const;
+
+		/*!
+		Get the hash of the family, IP and port with the given seed
+		@param[in] seed the hash seed
+		@return the hash value
+		*/
+		unsigned __int64 GetHash(unsigned __int64 seed) const;
+
+	private:
+		/// socket address
+		SOCKADDR_STORAGE m_sockAddr;
+		/// byte size of the socket address
+		int m_sockAddrSize;
+		/// address family
+		unsigned short m_family;
+		/// port in network byte order
+		unsigned short m_port;
+		/// byte size of the IP
+		unsigned int m_ipByteSize;
+		/// IP (IPv4 or IPv6)
+		unsigned char m_ip[16];
+	};
+
+	/*! 
+	@class UdpSessionTable epUdpSessionTable.h
+	@brief A class for the hashed table of UDP sessions.
+
+	The table is striped by the hash, so the lookups on the different stripes run concurrently.
+	The hash is seeded randomly per table to resist the collision flooding.
+	*/
+	class EP_SERVER_ENGINE UdpSessionTable{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the table
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdpSessionTable(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the table
+		*/
+		~UdpSessionTable();
+
+		/*!
+		Find the session object with the given address
+		@param[in] address the session address
+		@return the session object retained, otherwise NULL
+		@remark the caller must release the returned object.
+		*/
+		BaseServerObject *Find(const UdpSessionAddress &address);
+
+		/*!
+		Insert the session object with the given address
+		@param[in] address the session address
+		@param[in] obj the session object
+		@return true if inserted, false if the address already exists
+		@remark the table retains the object.
+		*/
+		bool Insert(const UdpSessionAddress &address,BaseServerObject *obj);
+
+		/*!
+		Remove the session object with the given address
+		@param[in] address the session address
+		@param[in] obj the session object
+		@return true if removed, otherwise false
+		@remark removed only if the address is mapped to the given object.
+		*/
+		bool Remove(const UdpSessionAddress &address,const BaseServerObject *obj);
+
+		/*!
+		Remove all the session objects
+		*/
+		void Clear();
+
+		/*!
+		Get the number of the session objects
+		@return the number of the session objects
+		*/
+		size_t Count() const;
+
+		/*!
+		Get the hash seed of the table
+		@return the hash seed
+		*/
+		unsigned __int64 GetSeed() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		Initializes the table
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		UdpSessionTable(const UdpSessionTable& b){}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		UdpSessionTable & operator=(const UdpSessionTable&b){return *this;}
+
+		/// session entry
+		struct SessionEntry{
+			/// session address
+			UdpSessionAddress m_address;
+			/// hash of the address
+			unsigned __int64 m_hash;
+			/// session object
+			BaseServerObject *m_object;
+			/// next entry in the bucket
+			SessionEntry *m_next;
+		};
+
+		/// stripe of the table
+		struct SessionStripe{
+			/// stripe lock
+			RuntimeLockPolicy m_lock;
+			/// buckets
+			vector<SessionEntry*> m_buckets;
+			/// number of the entries
+			size_t m_count;
+		};
+
+		/*!
+		Get the bucket index of the hash
+		@param[in] hash the hash value
+		@param[in] bucketCount the number of the buckets
+		@return the bucket index
+		*/
+		static size_t getBucketIndex(unsigned __int64 hash,size_t bucketCount);
+
+		/*!
+		Double the buckets of the stripe
+		@param[in] stripe the stripe to grow
+		*/
+		static void growStripe(SessionStripe &stripe);
+
+	private:
+		/// hash seed
+		unsigned __int64 m_seed;
+		/// stripes
+		SessionStripe m_stripes[UDP_SESSION_TABLE_STRIPE_COUNT];
+	};
+}
+
+#endif //__EP_UDP_SESSION_TABLE_H__
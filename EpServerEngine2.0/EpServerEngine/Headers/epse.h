@@ -40,11 +40,26 @@ An Interface for EP Server Engine
 // General
 #include "epServerConf.h"
 #include "epPacket.h"
+#include "epMessageArena.h"
+#include "epMemoryBudget.h"
+#include "epBufferPool.h"
+#include "epLockPolicy.h"
+#include "epLightLock.h"
+#include "epUdpSessionTable.h"
+#include "epUdpReceiveThread.h"
+#include "epUdpOffload.h"
+#include "epUdpChannel.h"
+#include "epUdpFragment.h"
+#include "epUdpPacketQueue.h"
+#include "epUdpSessionDispatcher.h"
+#include "epUdpCoalescer.h"
+#include "epUdpConnectedReceiver.h"
 #include "epBaseServerObject.h"
 #include "epPacketContainer.h"
 #include "epBasePacketProcessor.h"
 #include "epServerObjectList.h"
 #include "epServerObjectRemover.h"
+#include "epResolverCache.h"
 
 
 // Client Side
@@ -63,6 +78,7 @@ An Interface for EP Server Engine
 
 #include "epIocpClientJob.h"
 #include "epIocpClientProcessor.h"
+#include "epIocpClientRuntime.h"
 #include "epIocpTcpClient.h"
 #include "epIocpUdpClient.h"
 
@@ -96,10 +112,18 @@ An Interface for EP Server Engine
 #include "epIocpUdpSocket.h"
 
 #include "epProxyServerInterfaces.h"
+#include "epProxyUpstreamGroup.h"
+#include "epProxyForwardWorker.h"
+#include "epProxyForwardQueue.h"
 #include "epBaseProxyHandler.h"
 #include "epBaseProxyServer.h"
+#include "epProxyUpstreamPool.h"
+#include "epProxyTcpRelay.h"
+#include "epProxyMuxPool.h"
+#include "epProxyMuxHandler.h"
 #include "epProxyTcpHandler.h"
 #include "epProxyTcpServer.h"
+#include "epProxyUdpRelay.h"
 #include "epProxyUdpHandler.h"
 #include "epProxyUdpServer.h"
 
@@ -96,6 +96,36 @@ void AsyncTcpClient::SetIsAsynchronousReceive(bool isASynchronousReceive)
 
 void AsyncTcpClient::execute() 
 {
+	if(m_isConnectPending)
+	{
+		ConnectStatus status;
+		bool isConnected=connectToServer(status);
+		if(isConnected && m_isConnectCanceled)
+		{
+			isConnected=false;
+			status=CONNECT_STATUS_FAIL_CANCELED;
+		}
+		if(!isConnected)
+			cleanUpClient();
+		m_callBackObj->OnConnected(reinterpret_cast<ClientInterface*>(this),status);
+		bool isCanceled;
+		{
+			// cleared after the callback, so Disconnect does not return while it is still running,
+			// and under the lock, so the cancel made while reporting the connect is not missed
+			epl::LockObj lock(m_generalLock);
+			m_isConnectPending=false;
+			isCanceled=m_isConnectCanceled;
+		}
+		if(!isConnected)
+			return;
+		// canceled after the connect was reported, so closed here instead of receiving
+		if(isCanceled)
+		{
+			disconnect();
+			return;
+		}
+	}
+
 	int iResult;
 	// Receive until the peer shuts down the connection
 	do {
@@ -130,6 +160,7 @@ void AsyncTcpClient::execute()
 				}
 				else
 				{
+					epl::LockObj lock(m_callBackLock);
 					m_callBackObj->OnReceived(reinterpret_cast<ClientInterface*>(this),recvPacket,RECEIVE_STATUS_SUCCESS);
 					recvPacket->ReleaseObj();
 				}
@@ -191,9 +222,10 @@ bool AsyncTcpClient::Connect(const ClientOps &ops)
 	m_isAsynchronousReceive=ops.isAsynchronousReceive;
 
 
+	m_connectTimeOutMilliSec=ops.connectTimeOutMilliSec;
+
 	WSADATA wsaData;
 	m_connectSocket=INVALID_SOCKET;
-	struct addrinfo hints;
 	int iResult;
 
 	// Initialize Winsock
@@ -203,50 +235,26 @@ bool AsyncTcpClient::Connect(const ClientOps &ops)
 		return false;
 	}
 
-	ZeroMemory( &hints, sizeof(hints) );
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_socktype = SOCK_STREAM;
-	hints.ai_protocol = IPPROTO_TCP;
-
-	// Resolve the server address and port
-	iResult = getaddrinfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
-	if ( iResult != 0 ) {
-		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
-		WSACleanup();
-		return false;
+	m_isConnectCanceled=false;
+	if(ops.isAsynchronousConnect)
+	{
+		// connect on the thread of the client, and report the result to OnConnected
+		m_isConnectPending=true;
 	}
-
-	struct addrinfo *iPtr=0;
-	// Attempt to connect to an address until one succeeds
-	for(iPtr=m_result; iPtr != NULL ;iPtr=iPtr->ai_next) {
-
-		// Create a SOCKET for connecting to server
-		m_connectSocket = socket(iPtr->ai_family, iPtr->ai_socktype, 
-			iPtr->ai_protocol);
-		if (m_connectSocket == INVALID_SOCKET) {
-			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Socket failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+	else
+	{
+		ConnectStatus status;
+		if(!connectToServer(status))
+		{
 			cleanUpClient();
 			return false;
 		}
-
-		// Connect to server.
-		iResult = connect( m_connectSocket, iPtr->ai_addr, static_cast<int>(iPtr->ai_addrlen));
-		if (iResult == SOCKET_ERROR) {
-			closesocket(m_connectSocket);
-			m_connectSocket = INVALID_SOCKET;
-			continue;
-		}
-		break;
-	}
-	if (m_connectSocket == INVALID_SOCKET) {
-		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Unable to connect to server!\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
-		cleanUpClient();
-		return false;
 	}
 	if(Start())
 	{
 		return true;
 	}
+	m_isConnectPending=false;
 	cleanUpClient();
 	return false;
 }
@@ -258,12 +266,15 @@ void AsyncTcpClient::disconnect()
 	{
 		cleanUpClient();
 		m_processorList.Clear();
+		epl::LockObj lock(m_callBackLock);
 		m_callBackObj->OnDisconnect(reinterpret_cast<ClientInterface*>(this));
 	}
 }
 
 void AsyncTcpClient::Disconnect()
 {
+	// waits for OnConnected outside the lock, which the thread takes to clear the pending connect
+	bool wasConnectPending=cancelConnect();
 	epl::LockObj lock(m_generalLock);
 	if(!IsConnectionAlive())
 	{
@@ -278,15 +289,17 @@ void AsyncTcpClient::Disconnect()
 		}
 
 	}
-	else
+	else if(!wasConnectPending)
 	{
 		return;
 	}
+	// the canceled connect is closed by the thread itself without receiving, so it is just returning
 	if(TerminateAfter(m_waitTime)==Thread::TERMINATE_RESULT_GRACEFULLY_TERMINATED)
 		return;
 
 	cleanUpClient();
 	m_processorList.Clear();
+	epl::LockObj callBackLock(m_callBackLock);
 	m_callBackObj->OnDisconnect(reinterpret_cast<ClientInterface*>(this));
 
 }
@@ -137,11 +137,28 @@ void AsyncTcpSocket::execute()
 		if(iResult>0)
 		{
 			unsigned int shouldReceive=(reinterpret_cast<unsigned int*>(const_cast<char*>(m_recvSizePacket.GetPacket())))[0];
+			// throttle until the pending packets of this connection are processed
+			while(!m_memoryBudget->CanAcquire(shouldReceive) && m_memoryBudget->IsInBudget(shouldReceive) && m_processorList.Count()>0)
+			{
+				m_processorList.WaitForListSizeDecrease();
+			}
+			if(!m_memoryBudget->CanAcquire(shouldReceive))
+			{
+				epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded for %d bytes\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,shouldReceive);
+				break;
+			}
+			bool isAsynchronousReceive=m_isAsynchronousReceive;
 			Packet *recvPacket=EP_NEW Packet(NULL,shouldReceive);
+			if(!recvPacket->ChargeMemoryBudget(m_memoryBudget))
+			{
+				epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded for %d bytes\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,shouldReceive);
+				recvPacket->ReleaseObj();
+				break;
+			}
 			iResult = receive(*recvPacket);
 
 			if (iResult == shouldReceive) {
-				if(m_isAsynchronousReceive)
+				if(isAsynchronousReceive)
 				{
 					ServerPacketProcessor::PacketPassUnit passUnit;
 					passUnit.m_packet=recvPacket;
@@ -167,6 +184,8 @@ void AsyncTcpSocket::execute()
 				}
 				else
 				{
+					// for the handler's own allocations only, as the packet on the heap may be retained past OnReceived
+					MessageArenaScope arenaScope(&m_arena);
 					m_callBackObj->OnReceived(this,recvPacket,RECEIVE_STATUS_SUCCESS);
 					recvPacket->ReleaseObj();
 				}
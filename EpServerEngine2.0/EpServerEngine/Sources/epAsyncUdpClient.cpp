@@ -99,41 +99,53 @@ void AsyncUdpClient::SetIsAsynchronousReceive(bool isASynchronousReceive)
 void AsyncUdpClient::execute() 
 {
 	int iResult=0;
+	bool isMoveNotice=false;
 	// Receive until the peer shuts down the connection
 	Packet recvPacket(NULL,m_maxPacketSize);
 	do {
-		iResult = receive(recvPacket);
+		iResult = receive(recvPacket,isMoveNotice);
 
 		if (iResult > 0) {
-			Packet *passPacket=EP_NEW Packet(recvPacket.GetPacket(),iResult);
-			if(m_isAsynchronousReceive)
+			vector<Packet*> packetList;
+			unpackDatagram(recvPacket.GetPacket(),iResult,packetList);
+			for(size_t packetTrav=0;packetTrav<packetList.size();packetTrav++)
 			{
-				ClientPacketProcessor::PacketPassUnit passUnit;
-
-				passUnit.m_packet=passPacket;
-				passUnit.m_owner=this;
-				ClientPacketProcessor *parser=EP_NEW ClientPacketProcessor(m_callBackObj,m_waitTime,m_lockPolicy);
-				parser->setPacketPassUnit(passUnit);
-				m_processorList.Push(parser);
-				parser->Start();
-				parser->ReleaseObj();
-				passPacket->ReleaseObj();
-				unsigned int maximumProcessorCount=GetMaximumProcessorCount();
-				if(maximumProcessorCount!=PROCESSOR_LIMIT_INFINITE)
+				Packet *passPacket=packetList.at(packetTrav);
+				if(m_isAsynchronousReceive)
 				{
-					while(m_processorList.Count()>=maximumProcessorCount)
+					ClientPacketProcessor::PacketPassUnit passUnit;
+
+					passUnit.m_packet=passPacket;
+					passUnit.m_owner=this;
+					ClientPacketProcessor *parser=EP_NEW ClientPacketProcessor(m_callBackObj,m_waitTime,m_lockPolicy);
+					parser->setPacketPassUnit(passUnit);
+					m_processorList.Push(parser);
+					parser->Start();
+					parser->ReleaseObj();
+					passPacket->ReleaseObj();
+					unsigned int maximumProcessorCount=GetMaximumProcessorCount();
+					if(maximumProcessorCount!=PROCESSOR_LIMIT_INFINITE)
 					{
-						m_processorList.WaitForListSizeDecrease();
+						while(m_processorList.Count()>=maximumProcessorCount)
+						{
+							m_processorList.WaitForListSizeDecrease();
+						}
 					}
 				}
-			}
-			else
-			{
-				m_callBackObj->OnReceived(reinterpret_cast<ClientInterface*>(this),passPacket,RECEIVE_STATUS_SUCCESS);
-				passPacket->ReleaseObj();
+				else
+				{
+					epl::LockObj lock(m_callBackLock);
+					m_callBackObj->OnReceived(reinterpret_cast<ClientInterface*>(this),passPacket,RECEIVE_STATUS_SUCCESS);
+					passPacket->ReleaseObj();
+				}
 			}
 
 		}
+		else if (isMoveNotice)
+		{
+			// the session moved to another port of the server
+			continue;
+		}
 		else if (iResult == 0)
 		{
 			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Connection closing...\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
@@ -144,7 +156,7 @@ void AsyncUdpClient::execute()
 			break;
 		}
 
-	} while (iResult > 0);
+	} while (iResult > 0 || isMoveNotice);
 
 	disconnect();
 }
@@ -201,7 +213,7 @@ bool AsyncUdpClient::Connect(const ClientOps &ops)
 	hints.ai_protocol = IPPROTO_UDP;
 
 	// Resolve the server address and port
-	iResult = getaddrinfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
+	iResult = RESOLVER_CACHE_INSTANCE.GetAddrInfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
 	if ( iResult != 0 ) {
 		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
 		WSACleanup();
@@ -230,7 +242,7 @@ bool AsyncUdpClient::Connect(const ClientOps &ops)
 	int nTmp = sizeof(int);
 	getsockopt(m_connectSocket, SOL_SOCKET,SO_MAX_MSG_SIZE, (char *)&m_maxPacketSize,&nTmp);
 
-	if(Start())
+	if(setUpSession(ops) && Start())
 	{
 		return true;
 	}
@@ -245,6 +257,7 @@ void AsyncUdpClient::disconnect()
 	{
 		cleanUpClient();
 		m_processorList.Clear();
+		epl::LockObj lock(m_callBackLock);
 		m_callBackObj->OnDisconnect(reinterpret_cast<ClientInterface*>(this));
 	}
 }
@@ -270,6 +283,7 @@ void AsyncUdpClient::Disconnect()
 		return;
 	cleanUpClient();
 	m_processorList.Clear();
+	epl::LockObj callBackLock(m_callBackLock);
 	m_callBackObj->OnDisconnect(reinterpret_cast<ClientInterface*>(this));
 
 }
@@ -34,16 +34,18 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epse;
 
-AsyncUdpServer::AsyncUdpServer(epl::LockPolicy lockPolicyType): BaseUdpServer(lockPolicyType)
+AsyncUdpServer::AsyncUdpServer(epl::LockPolicy lockPolicyType): BaseUdpServer(lockPolicyType),m_dispatcher(lockPolicyType)
 {
 	m_isAsynchronousReceive=true;
+	m_udpDispatchThreadCount=0;
 }
 
 
-AsyncUdpServer::AsyncUdpServer(const AsyncUdpServer& b):BaseUdpServer(b)
+AsyncUdpServer::AsyncUdpServer(const AsyncUdpServer& b):BaseUdpServer(b),m_dispatcher(b.m_lockPolicy)
 {
 	LockObj lock(b.m_baseServerLock);
 	m_isAsynchronousReceive=b.m_isAsynchronousReceive;
+	m_udpDispatchThreadCount=b.m_udpDispatchThreadCount;
 }
 AsyncUdpServer::~AsyncUdpServer()
 {
@@ -56,6 +58,7 @@ AsyncUdpServer & AsyncUdpServer::operator=(const AsyncUdpServer&b)
 		BaseUdpServer::operator =(b);
 		LockObj lock(b.m_baseServerLock);
 		m_isAsynchronousReceive=b.m_isAsynchronousReceive;
+		m_udpDispatchThreadCount=b.m_udpDispatchThreadCount;
 	}
 	return *this;
 }
@@ -71,70 +74,72 @@ void AsyncUdpServer::SetIsAsynchronousReceive(bool isASynchronousReceive)
 
 bool AsyncUdpServer::StartServer(const ServerOps &ops)
 {
-	m_isAsynchronousReceive=ops.isAsynchronousReceive;
+	{
+		epl::LockObj lock(m_baseServerLock);
+		if(IsServerStarted())
+			return true;
+		m_isAsynchronousReceive=ops.isAsynchronousReceive;
+		m_udpDispatchThreadCount=ops.udpDispatchThreadCount;
+		if(m_udpDispatchThreadCount && !m_dispatcher.StartDispatcher(m_udpDispatchThreadCount))
+		{
+			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) dispatcher failed to start\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+			return false;
+		}
+	}
 	return BaseUdpServer::StartServer(ops);
 }
 
-void AsyncUdpServer::execute()
+unsigned int AsyncUdpServer::GetUdpDispatchThreadCount() const
 {
-	Packet recvPacket(NULL,m_maxPacketSize);
-	char *packetData=const_cast<char*>(recvPacket.GetPacket());
-	int length=recvPacket.GetPacketByteSize();
-	sockaddr clientSockAddr;
-	int sockAddrSize=sizeof(sockaddr);
-	while(m_listenSocket!=INVALID_SOCKET)
-	{
-		int recvLength=recvfrom(m_listenSocket,packetData,length, 0,&clientSockAddr,&sockAddrSize);
+	return m_udpDispatchThreadCount;
+}
+
+void AsyncUdpServer::cleanUpServer()
+{
+	// the sessions killed are closed on the dispatch threads before they stop
+	m_dispatcher.StopDispatcher(m_waitTime);
+	BaseUdpServer::cleanUpServer();
+}
 
-		AsyncUdpSocket *workerObj=(AsyncUdpSocket*)m_socketList.Find(clientSockAddr,socketCompare);
-		if(workerObj)
+void AsyncUdpServer::handleDatagram(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize)
+{
+	AsyncUdpSocket *workerObj=(AsyncUdpSocket*)m_sessionTable.Find(clientAddress);
+	if(workerObj)
+	{
+		deliverPacket(workerObj,packetData,recvLength,segmentByteSize);
+		workerObj->ReleaseObj();
+	}
+	else
+	{
+		if(recvLength<=0)
+			return;
+		// a client is handled in one shard at a time, so the lock is just for the connection count
+		ScopedLock<RuntimeLockPolicy> acceptLock(m_acceptLock);
+		if(GetMaximumConnectionCount()!=CONNECTION_LIMIT_INFINITE)
 		{
-			if(recvLength<=0)
+			if(m_socketList.Count()>=GetMaximumConnectionCount())
 			{
-				Packet *passPacket=EP_NEW Packet(packetData,0);
-				workerObj->addPacket(passPacket);
-				passPacket->ReleaseObj();
-				continue;
-			}	
-			Packet *passPacket=EP_NEW Packet(packetData,recvLength);
-			workerObj->addPacket(passPacket);
-			passPacket->ReleaseObj();
+				return;
+			}
 		}
-		else
+		if(!m_callBackObj->OnAccept(clientAddress.GetSockAddr(),clientAddress.GetSockAddrSize()))
 		{
-			if(recvLength<=0)
-				continue;
-			if(GetMaximumConnectionCount()!=CONNECTION_LIMIT_INFINITE)
-			{
-				if(m_socketList.Count()>=GetMaximumConnectionCount())
-				{
-					continue;
-				}
-			}
-			if(!m_callBackObj->OnAccept(clientSockAddr))
-			{
-				continue;
-			}
-			/// Create Worker Thread
-			AsyncUdpSocket *accWorker=EP_NEW AsyncUdpSocket(m_callBackObj,m_isAsynchronousReceive,m_waitTime,PROCESSOR_LIMIT_INFINITE,m_lockPolicy);
-			if(!accWorker)
-			{
-				continue;
-			}
-			Packet *passPacket=EP_NEW Packet(packetData,recvLength);
-			accWorker->setSockAddr(clientSockAddr);
-			accWorker->setOwner(this);
-			accWorker->setMaxPacketByteSize(m_maxPacketSize);
-			m_socketList.Push(accWorker);
-			accWorker->Start();
-			accWorker->addPacket(passPacket);
-			accWorker->ReleaseObj();
-			passPacket->ReleaseObj();
-
+			return;
+		}
+		/// Create Worker Thread
+		AsyncUdpSocket *accWorker=EP_NEW AsyncUdpSocket(m_callBackObj,m_isAsynchronousReceive,m_waitTime,PROCESSOR_LIMIT_INFINITE,m_lockPolicy);
+		if(!accWorker)
+		{
+			return;
 		}
+		if(m_udpDispatchThreadCount)
+			accWorker->setDispatcher(&m_dispatcher);
+		addSession(accWorker,clientAddress);
+		if(!m_udpDispatchThreadCount)
+			accWorker->Start();
+		deliverPacket(accWorker,packetData,recvLength,segmentByteSize);
+		accWorker->ReleaseObj();
 
 	}
-
-	stopServer();
-} 
+}
 
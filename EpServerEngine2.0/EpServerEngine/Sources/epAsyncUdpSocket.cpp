@@ -36,14 +36,35 @@ using namespace epse;
 AsyncUdpSocket::AsyncUdpSocket(ServerCallbackInterface *callBackObj,bool isAsynchronousReceive,unsigned int waitTimeMilliSec,unsigned int maximumProcessorCount,epl::LockPolicy lockPolicyType): BaseUdpSocket(callBackObj,waitTimeMilliSec,lockPolicyType)
 {
 	m_processorList=ServerObjectList(waitTimeMilliSec,lockPolicyType);
-	m_threadStopEvent=EventEx(false,false);
+	m_threadStopEvent=LightEvent(false,false);
+	m_packetReceivedEvent=LightEvent(false,false);
 	m_maxProcessorCount=maximumProcessorCount;
 	m_isAsynchronousReceive=isAsynchronousReceive;
+	m_dispatcher=NULL;
+	m_isScheduled=0;
+	m_isNewConnectionNotified=false;
+	m_isConnected=true;
 }
 
 AsyncUdpSocket::~AsyncUdpSocket()
 {
-	KillConnection();
+	// no longer scheduled nor contained, so killed here without the dispatcher
+	if(m_dispatcher)
+		killConnection();
+	else
+		KillConnection();
+}
+
+bool AsyncUdpSocket::IsConnectionAlive() const
+{
+	if(m_dispatcher)
+		return m_isConnected;
+	return BaseUdpSocket::IsConnectionAlive();
+}
+
+void AsyncUdpSocket::setDispatcher(UdpSessionDispatcher *dispatcher)
+{
+	m_dispatcher=dispatcher;
 }
 void AsyncUdpSocket::SetMaximumProcessorCount(unsigned int maxProcessorCount)
 {
@@ -79,24 +100,23 @@ void AsyncUdpSocket::KillConnection()
 	{
 		return;
 	}
+	if(m_dispatcher)
+	{
+		// closed in order by the dispatch thread, as when closed by the channel layer
+		Packet *closePacket=EP_NEW Packet(NULL,0);
+		addPacket(closePacket);
+		closePacket->ReleaseObj();
+		return;
+	}
 	m_threadStopEvent.SetEvent();
-	if(GetStatus()==Thread::THREAD_STATUS_SUSPENDED)
-		Resume();
+	m_packetReceivedEvent.SetEvent();
 	if(TerminateAfter(m_waitTime)==Thread::TERMINATE_RESULT_GRACEFULLY_TERMINATED)
 		return;
 	m_processorList.Clear();
 
-	m_listLock->Lock();
-	Packet *removeElem=NULL;
-	while(!m_packetList.empty())
-	{
-		removeElem=m_packetList.front();
-		if(removeElem)
-			removeElem->ReleaseObj();
-		m_packetList.pop();
-	}
-	m_listLock->Unlock();
+	m_packetQueue.Clear();
 
+	removeSelfFromSessionTable();
 	removeSelfFromContainer();
 	m_callBackObj->OnDisconnect(this);
 }
@@ -105,19 +125,12 @@ void AsyncUdpSocket::killConnection()
 {
 	if(IsConnectionAlive())
 	{
+		m_isConnected=false;
 
 		m_processorList.Clear();
-		m_listLock->Lock();
-		Packet *removeElem=NULL;
-		while(!m_packetList.empty())
-		{
-			removeElem=m_packetList.front();
-			if(removeElem)
-				removeElem->ReleaseObj();
-			m_packetList.pop();
-		}
-		m_listLock->Unlock();
+		m_packetQueue.Clear();
 
+		removeSelfFromSessionTable();
 		removeSelfFromContainer();
 		m_callBackObj->OnDisconnect(this);
 
@@ -126,42 +139,67 @@ void AsyncUdpSocket::killConnection()
 
 void AsyncUdpSocket::addPacket(Packet *packet)
 {
-	if(packet)
-		packet->RetainObj();
-	epl::LockObj lock(m_listLock);
-	m_packetList.push(packet);
-	if(GetStatus()==THREAD_STATUS_SUSPENDED)
-		Resume();
+	// the datagram is dropped when the memory budget is exceeded, as when the receive buffer is full
+	if(packet && packet->GetPacketByteSize()>0 && !packet->ChargeMemoryBudget(m_memoryBudget))
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded, packet dropped\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return;
+	}
+	if(!packet)
+		return;
+	packet->RetainObj();
+	bool isFirst=m_packetQueue.Push(packet);
+	if(m_dispatcher)
+		schedule();
+	// the session thread is woken only when the queue turns non-empty
+	else if(isFirst)
+		m_packetReceivedEvent.SetEvent();
 }
 
-void AsyncUdpSocket::execute()
+void AsyncUdpSocket::schedule()
 {
-	m_callBackObj->OnNewConnection(this);
+	// the plain read keeps the scheduled session from bouncing the flag between the threads
+	if(m_isScheduled)
+		return;
+	if(InterlockedCompareExchange(&m_isScheduled,1,0)==0)
+		m_dispatcher->Schedule(this);
+}
 
-	unsigned int packetSize=0;
-	while(1)
+void AsyncUdpSocket::dispatchPackets()
+{
+	if(!m_isNewConnectionNotified)
 	{
-		if(m_threadStopEvent.WaitForEvent(WAITTIME_IGNORE))
-		{
-			break;
-		}
-		m_listLock->Lock();
-		if(m_packetList.size()==0)
+		m_isNewConnectionNotified=true;
+		m_callBackObj->OnNewConnection(this);
+	}
+
+	vector<Packet*> packetList;
+	m_packetQueue.PopAll(packetList);
+	if(processPackets(packetList))
+	{
+		// left scheduled, so never run again
+		killConnection();
+		return;
+	}
+
+	// the packets pushed meanwhile either see the flag cleared or are seen here
+	InterlockedExchange(&m_isScheduled,0);
+	if(!m_packetQueue.IsEmpty())
+		schedule();
+}
+
+bool AsyncUdpSocket::processPackets(const vector<Packet*> &packetList)
+{
+	bool isClosing=false;
+	for(size_t packetTrav=0;packetTrav<packetList.size();packetTrav++)
+	{
+		Packet *packet=packetList.at(packetTrav);
+		if(isClosing || packet->GetPacketByteSize()==0)
 		{
-			m_listLock->Unlock();
-			Suspend();
+			isClosing=true;
+			packet->ReleaseObj();
 			continue;
 		}
-		Packet *packet= m_packetList.front();
-		packetSize=packet->GetPacketByteSize();
-		if(packetSize==0)
-		{
-			m_listLock->Unlock();
-			break;
-		}
-
-		m_packetList.pop();
-		m_listLock->Unlock();
 
 		if(m_isAsynchronousReceive)
 		{
@@ -189,10 +227,35 @@ void AsyncUdpSocket::execute()
 		}
 		else
 		{
+			MessageArenaScope arenaScope(&m_arena);
 			m_callBackObj->OnReceived(this,packet,RECEIVE_STATUS_SUCCESS);
 			packet->ReleaseObj();
 		}
+	}
+	return isClosing;
+}
+
+void AsyncUdpSocket::execute()
+{
+	m_callBackObj->OnNewConnection(this);
+
+	vector<Packet*> packetList;
+	bool isClosing=false;
+	while(!isClosing)
+	{
+		if(m_threadStopEvent.WaitForEvent(WAITTIME_IGNORE))
+		{
+			break;
+		}
+		// everything queued so far is taken in one pass
+		packetList.clear();
+		if(!m_packetQueue.PopAll(packetList))
+		{
+			m_packetReceivedEvent.WaitForEvent();
+			continue;
+		}
 
+		isClosing=processPackets(packetList);
 	}	
 
 	killConnection();
@@ -42,18 +42,22 @@ BaseClient::BaseClient( epl::LockPolicy lockPolicyType) :BaseServerObject(WAITTI
 	case epl::LOCK_POLICY_CRITICALSECTION:
 		m_sendLock=EP_NEW epl::CriticalSectionEx();
 		m_generalLock=EP_NEW epl::CriticalSectionEx();
+		m_callBackLock=EP_NEW epl::CriticalSectionEx();
 		break;
 	case epl::LOCK_POLICY_MUTEX:
 		m_sendLock=EP_NEW epl::Mutex();
 		m_generalLock=EP_NEW epl::Mutex();
+		m_callBackLock=EP_NEW epl::Mutex();
 		break;
 	case epl::LOCK_POLICY_NONE:
 		m_sendLock=EP_NEW epl::NoLock();
 		m_generalLock=EP_NEW epl::NoLock();
+		m_callBackLock=EP_NEW epl::NoLock();
 		break;
 	default:
 		m_sendLock=NULL;
 		m_generalLock=NULL;
+		m_callBackLock=NULL;
 		break;
 	}
 	m_connectSocket=INVALID_SOCKET;
@@ -74,18 +78,22 @@ BaseClient::BaseClient(const BaseClient& b) :BaseServerObject(b)
 	case epl::LOCK_POLICY_CRITICALSECTION:
 		m_sendLock=EP_NEW epl::CriticalSectionEx();
 		m_generalLock=EP_NEW epl::CriticalSectionEx();
+		m_callBackLock=EP_NEW epl::CriticalSectionEx();
 		break;
 	case epl::LOCK_POLICY_MUTEX:
 		m_sendLock=EP_NEW epl::Mutex();
 		m_generalLock=EP_NEW epl::Mutex();
+		m_callBackLock=EP_NEW epl::Mutex();
 		break;
 	case epl::LOCK_POLICY_NONE:
 		m_sendLock=EP_NEW epl::NoLock();
 		m_generalLock=EP_NEW epl::NoLock();
+		m_callBackLock=EP_NEW epl::NoLock();
 		break;
 	default:
 		m_sendLock=NULL;
 		m_generalLock=NULL;
+		m_callBackLock=NULL;
 		break;
 	}
 	m_connectSocket=INVALID_SOCKET;
@@ -116,18 +124,22 @@ BaseClient & BaseClient::operator=(const BaseClient&b)
 		case epl::LOCK_POLICY_CRITICALSECTION:
 			m_sendLock=EP_NEW epl::CriticalSectionEx();
 			m_generalLock=EP_NEW epl::CriticalSectionEx();
+			m_callBackLock=EP_NEW epl::CriticalSectionEx();
 			break;
 		case epl::LOCK_POLICY_MUTEX:
 			m_sendLock=EP_NEW epl::Mutex();
 			m_generalLock=EP_NEW epl::Mutex();
+			m_callBackLock=EP_NEW epl::Mutex();
 			break;
 		case epl::LOCK_POLICY_NONE:
 			m_sendLock=EP_NEW epl::NoLock();
 			m_generalLock=EP_NEW epl::NoLock();
+			m_callBackLock=EP_NEW epl::NoLock();
 			break;
 		default:
 			m_sendLock=NULL;
 			m_generalLock=NULL;
+			m_callBackLock=NULL;
 			break;
 		}
 		m_connectSocket=INVALID_SOCKET;
@@ -151,6 +163,9 @@ void BaseClient::resetClient()
 	if(m_generalLock)
 		EP_DELETE m_generalLock;
 	m_generalLock=NULL;
+	if(m_callBackLock)
+		EP_DELETE m_callBackLock;
+	m_callBackLock=NULL;
 }
 
 void  BaseClient::SetHostName(const TCHAR * hostName)
@@ -232,6 +247,7 @@ epl::EpTString BaseClient::GetPort() const
 void BaseClient::SetCallbackObject(ClientCallbackInterface *callBackObj)
 {
 	EP_ASSERT(callBackObj);
+	epl::LockObj lock(m_callBackLock);
 	m_callBackObj=callBackObj;
 }
 ClientCallbackInterface *BaseClient::GetCallbackObject()
@@ -264,7 +280,7 @@ void BaseClient::cleanUpClient()
 	}
 	if(m_result)
 	{
-		freeaddrinfo(m_result);
+		ResolverCache::FreeAddrInfo(m_result);
 		m_result=NULL;
 	}
 	WSACleanup();
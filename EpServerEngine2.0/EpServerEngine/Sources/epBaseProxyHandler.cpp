@@ -34,7 +34,7 @@ static char THIS_FILE[] = __FILE__;
 using namespace epse;
 
 
-BaseProxyHandler::BaseProxyHandler(ProxyServerCallbackInterface *callBack, SocketInterface *socket, epl::LockPolicy lockPolicyType)
+BaseProxyHandler::BaseProxyHandler(ProxyServerCallbackInterface *callBack, SocketInterface *socket, epl::LockPolicy lockPolicyType):m_clientToForwardLock(lockPolicyType),m_forwardToClientLock(lockPolicyType)
 {
 	m_lockPolicy=lockPolicyType;
 	switch(lockPolicyType)
@@ -55,55 +55,139 @@ BaseProxyHandler::BaseProxyHandler(ProxyServerCallbackInterface *callBack, Socke
 
 	m_callBack=callBack;
 	m_client=socket;
+	m_forwardClient=NULL;
+	m_upstreamGroup=NULL;
+	m_upstreamGroupIdx=0;
+	m_fromClientQueue=NULL;
+	m_fromForwardServerQueue=NULL;
 	socket->SetCallbackObject(this);
 
 }
 
 BaseProxyHandler::~BaseProxyHandler()
 {	
+	closeForwardQueues();
+	releaseUpstreamGroup();
 	if(m_forwardClient)
 	{
 		m_forwardClient->Disconnect();
 		EP_DELETE m_forwardClient;
 	}
+	// closed again, now that the packet in progress fails on the peers disconnected
+	if(m_fromClientQueue)
+		EP_DELETE m_fromClientQueue;
+	if(m_fromForwardServerQueue)
+		EP_DELETE m_fromForwardServerQueue;
 	if(m_baseProxyHandlerLock)
 		EP_DELETE m_baseProxyHandlerLock;
 }
 
 void BaseProxyHandler::OnReceived(SocketInterface *socket,const Packet*receivedPacket,ReceiveStatus status)
 {
-	epl::LockObj lock(m_baseProxyHandlerLock);
-	m_callBack->OnReceivedFromClient(m_client,m_forwardClient,receivedPacket);
+	if(m_fromClientQueue)
+	{
+		// the forward server did not take the data in time
+		if(receivedPacket && !m_fromClientQueue->Push(receivedPacket))
+			abortClient();
+		return;
+	}
+	forwardFromClient(receivedPacket);
 }
 void BaseProxyHandler::OnDisconnect(SocketInterface *socket)
 {
-	if(m_forwardClient)
-		m_forwardClient->Disconnect();
+	closeForwardQueues();
+	releaseForwardClient();
+	releaseUpstreamGroup();
 	epl::LockObj lock(m_baseProxyHandlerLock);
 	m_callBack->OnDisconnect(socket->GetSockAddr());
 }
 
 void BaseProxyHandler::OnReceived(ClientInterface *client,const Packet*receivedPacket,ReceiveStatus status)
 {
-	epl::LockObj lock(m_baseProxyHandlerLock);
-	m_callBack->OnReceivedFromForwardServer(m_client,client,receivedPacket);
+	if(m_fromForwardServerQueue)
+	{
+		// the client did not take the data in time
+		if(receivedPacket && !m_fromForwardServerQueue->Push(receivedPacket))
+			abortClient();
+		return;
+	}
+	forwardFromForwardServer(client,receivedPacket);
 }
 
 void BaseProxyHandler::OnDisconnect(ClientInterface *client)
 {
+	// the data queued from the forward server is delivered before the client is disconnected,
+	// unless the client does not take it in time
+	if(m_fromForwardServerQueue)
+	{
+		unsigned int waitTime=m_client->GetWaitTime();
+		if(waitTime>PROXY_FORWARD_FLUSH_WAITTIME_MILLISEC)
+			waitTime=PROXY_FORWARD_FLUSH_WAITTIME_MILLISEC;
+		m_fromForwardServerQueue->Flush(waitTime);
+	}
 	m_client->KillConnection();
 }
 
+void BaseProxyHandler::forwardFromClient(const Packet *receivedPacket)
+{
+	// held across the send, so the connection is not taken back to the pool while sending on it
+	ScopedLock<RuntimeLockPolicy> lock(m_clientToForwardLock);
+	ProxyServerCallbackInterface *callBack=m_callBack;
+	BaseClient *forwardClient=m_forwardClient;
+	if(forwardClient)
+		callBack->OnReceivedFromClient(m_client,forwardClient,receivedPacket);
+}
+
+void BaseProxyHandler::forwardFromForwardServer(ClientInterface *client,const Packet *receivedPacket)
+{
+	// only the lock of this direction, so a blocking send to the forward server never holds this back,
+	// and the forward server client is not taken away while forwarding from it
+	ScopedLock<RuntimeLockPolicy> lock(m_forwardToClientLock);
+	BaseClient *forwardClient=m_forwardClient;
+	// released, and might be handed to another client already
+	if(!forwardClient)
+		return;
+	if(!client)
+		client=forwardClient;
+	ProxyServerCallbackInterface *callBack=m_callBack;
+	callBack->OnReceivedFromForwardServer(m_client,client,receivedPacket);
+}
+
+bool BaseProxyHandler::isWritable(bool isFromClient)
+{
+	return true;
+}
+
+void BaseProxyHandler::abortClient()
+{
+	closeForwardQueues();
+	m_client->KillConnection();
+}
+
+void BaseProxyHandler::openForwardQueues(ProxyForwardWorker *forwardWorker,unsigned int highWatermarkByteSize,unsigned int lowWatermarkByteSize)
+{
+	m_fromClientQueue=EP_NEW ProxyForwardQueue(this,true,m_lockPolicy);
+	m_fromForwardServerQueue=EP_NEW ProxyForwardQueue(this,false,m_lockPolicy);
+	m_fromClientQueue->Open(forwardWorker,highWatermarkByteSize,lowWatermarkByteSize);
+	m_fromForwardServerQueue->Open(forwardWorker,highWatermarkByteSize,lowWatermarkByteSize);
+}
+
+void BaseProxyHandler::closeForwardQueues()
+{
+	if(m_fromClientQueue)
+		m_fromClientQueue->Close();
+	if(m_fromForwardServerQueue)
+		m_fromForwardServerQueue->Close();
+}
+
 
 void BaseProxyHandler::SetCallbackObject(ProxyServerCallbackInterface *callBackObj)
 {
-	epl::LockObj lock(m_baseProxyHandlerLock);
-	m_callBack=callBackObj;
+	InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_callBack),callBackObj);
 }
 
 ProxyServerCallbackInterface *BaseProxyHandler::GetCallbackObject()
 {
-	epl::LockObj lock(m_baseProxyHandlerLock);
 	return m_callBack;
 }
 
@@ -124,3 +208,62 @@ sockaddr BaseProxyHandler::GetSockAddr() const
 	}
 	return sockaddr();
 }
+
+SOCKADDR_STORAGE BaseProxyHandler::GetSockAddrStorage() const
+{
+	if(m_client)
+	{
+		return m_client->GetSockAddrStorage();
+	}
+	SOCKADDR_STORAGE sockAddr;
+	epl::System::Memset(&sockAddr,0,sizeof(SOCKADDR_STORAGE));
+	return sockAddr;
+}
+
+int BaseProxyHandler::GetSockAddrSize() const
+{
+	if(m_client)
+	{
+		return m_client->GetSockAddrSize();
+	}
+	return 0;
+}
+
+void BaseProxyHandler::releaseForwardClient()
+{
+	if(m_forwardClient)
+		m_forwardClient->Disconnect();
+}
+
+bool BaseProxyHandler::isForwardConnected() const
+{
+	if(m_forwardClient)
+		return m_forwardClient->IsConnectionAlive();
+	return false;
+}
+
+void BaseProxyHandler::setUpstreamGroup(ProxyUpstreamGroup *upstreamGroup,unsigned int upstreamIdx,unsigned int connectTick)
+{
+	bool isConnected=isForwardConnected();
+	upstreamGroup->ReportConnect(upstreamIdx,GetTickCount()-connectTick,isConnected);
+	{
+		epl::LockObj lock(m_baseProxyHandlerLock);
+		m_upstreamGroup=upstreamGroup;
+		m_upstreamGroupIdx=upstreamIdx;
+	}
+	// the client might have disconnected before the group is set
+	if(!m_client->IsConnectionAlive())
+		releaseUpstreamGroup();
+}
+
+void BaseProxyHandler::releaseUpstreamGroup()
+{
+	ProxyUpstreamGroup *upstreamGroup;
+	{
+		epl::LockObj lock(m_baseProxyHandlerLock);
+		upstreamGroup=m_upstreamGroup;
+		m_upstreamGroup=NULL;
+	}
+	if(upstreamGroup)
+		upstreamGroup->Release(m_upstreamGroupIdx);
+}
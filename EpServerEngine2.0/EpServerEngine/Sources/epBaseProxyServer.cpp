@@ -52,9 +52,11 @@ BaseProxyServer::BaseProxyServer(epl::LockPolicy lockPolicyType)
 		m_baseProxyServerLock=NULL;
 		break;
 	}
+	m_upstreamGroup=NULL;
 }
 BaseProxyServer::BaseProxyServer(const BaseProxyServer& b)
 {
+	m_upstreamGroup=NULL;
 	m_lockPolicy=b.m_lockPolicy;
 	switch(m_lockPolicy)
 	{
@@ -147,6 +149,7 @@ bool BaseProxyServer::StartServer(const ProxyServerOps &ops)
 	m_baseProxyServerLock->Lock();
 	m_callBack=ops.callBackObj;
 	EP_ASSERT(m_callBack);
+	m_upstreamGroup=ops.upstreamGroup;
 	m_baseProxyServerLock->Unlock();
 	ServerOps serverOps;
 	serverOps.callBackObj=this;
@@ -190,10 +193,10 @@ void BaseProxyServer::ShutdownAllClient()
 	}
 	m_proxyHandlerList.clear();
 }
-bool BaseProxyServer::OnAccept(sockaddr sockAddr)
+bool BaseProxyServer::OnAccept(const sockaddr *sockAddr,int sockAddrSize)
 {
 	epl::LockObj lock(m_baseProxyServerLock);
-	return m_callBack->OnAccept(sockAddr);
+	return m_callBack->OnAccept(sockAddr,sockAddrSize);
 }
 
 void BaseProxyServer::SetCallbackObject(ProxyServerCallbackInterface *callBackObj)
@@ -212,4 +215,24 @@ ProxyServerCallbackInterface *BaseProxyServer::GetCallbackObject()
 {
 	epl::LockObj lock(m_baseProxyServerLock);
 	return m_callBack;
+}
+
+void BaseProxyServer::addHandler(BaseProxyHandler *handler,ProxyServerCallbackInterface *callBack)
+{
+	epl::LockObj lock(m_baseProxyServerLock);
+	if(m_callBack!=callBack)
+		handler->SetCallbackObject(m_callBack);
+	m_proxyHandlerList.push_back(handler);
+}
+
+ProxyUpstreamGroup *BaseProxyServer::selectForwardServer(SocketInterface *socket,ForwardServerInfo &retForwardServerInfo,unsigned int &retUpstreamIdx)
+{
+	SOCKADDR_STORAGE sockAddr=socket->GetSockAddrStorage();
+	if(m_upstreamGroup && m_upstreamGroup->Select(reinterpret_cast<const sockaddr*>(&sockAddr),socket->GetSockAddrSize(),retUpstreamIdx))
+	{
+		retForwardServerInfo=m_upstreamGroup->GetForwardServerInfo(retUpstreamIdx);
+		return m_upstreamGroup;
+	}
+	retForwardServerInfo=m_callBack->GetForwardServerInfo(socket->GetSockAddr());
+	return NULL;
 }
\ No newline at end of file
@@ -57,6 +57,8 @@ BaseServer::BaseServer(epl::LockPolicy lockPolicyType):BaseServerObject(WAITTIME
 	m_maxConnectionCount=CONNECTION_LIMIT_INFINITE;
 	SetPort(_T(DEFAULT_PORT));
 	m_callBackObj=NULL;
+	m_memoryBudget=EP_NEW MemoryBudget(MEMORY_BUDGET_INFINITE,NULL,lockPolicyType);
+	m_connectionMemoryBudget=MEMORY_BUDGET_INFINITE;
 }
 
 BaseServer::BaseServer(const BaseServer& b):BaseServerObject(b)
@@ -86,6 +88,8 @@ BaseServer::BaseServer(const BaseServer& b):BaseServerObject(b)
 	m_maxConnectionCount=b.m_maxConnectionCount;
 	m_socketList=b.m_socketList;
 	m_callBackObj=b.m_callBackObj;
+	m_memoryBudget=EP_NEW MemoryBudget(b.m_memoryBudget->GetBudgetByteSize(),NULL,m_lockPolicy);
+	m_connectionMemoryBudget=b.m_connectionMemoryBudget;
 }
 BaseServer::~BaseServer()
 {
@@ -125,6 +129,8 @@ BaseServer & BaseServer::operator=(const BaseServer&b)
 		m_maxConnectionCount=b.m_maxConnectionCount;
 		m_socketList=b.m_socketList;
 		m_callBackObj=b.m_callBackObj;
+		m_memoryBudget=EP_NEW MemoryBudget(b.m_memoryBudget->GetBudgetByteSize(),NULL,m_lockPolicy);
+		m_connectionMemoryBudget=b.m_connectionMemoryBudget;
 	}
 	return *this;
 }
@@ -136,6 +142,11 @@ void BaseServer::resetServer()
 	if(m_baseServerLock)
 		EP_DELETE m_baseServerLock;
 	m_baseServerLock=NULL;
+
+	// sockets and packets still alive keep their own reference
+	if(m_memoryBudget)
+		m_memoryBudget->ReleaseObj();
+	m_memoryBudget=NULL;
 }
 
 void  BaseServer::SetPort(const TCHAR *  port)
@@ -194,6 +205,23 @@ ServerCallbackInterface *BaseServer::GetCallbackObject()
 	return m_callBackObj;
 }
 
+MemoryBudget *BaseServer::GetMemoryBudget()
+{
+	return m_memoryBudget;
+}
+
+void BaseServer::SetConnectionMemoryBudgetByteSize(size_t budgetByteSize)
+{
+	epl::LockObj lock(m_baseServerLock);
+	m_connectionMemoryBudget=budgetByteSize;
+}
+
+size_t BaseServer::GetConnectionMemoryBudgetByteSize() const
+{
+	epl::LockObj lock(m_baseServerLock);
+	return m_connectionMemoryBudget;
+}
+
 void BaseServer::SetWaitTime(unsigned int milliSec)
 {
 	m_waitTime=milliSec;
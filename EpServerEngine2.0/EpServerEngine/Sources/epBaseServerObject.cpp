@@ -39,6 +39,7 @@ BaseServerObject::BaseServerObject(unsigned int waitTimeMilliSec,epl::LockPolicy
 	m_waitTime=waitTimeMilliSec;
 	m_lockPolicy=lockPolicyType;
 	m_container=NULL;
+	m_containerIndex=0;
 	switch(lockPolicyType)
 	{
 	case epl::LOCK_POLICY_CRITICALSECTION:
@@ -60,6 +61,7 @@ BaseServerObject::BaseServerObject(const BaseServerObject& b):SmartObject(b),Thr
 {
 	m_waitTime=b.m_waitTime;
 	m_container=b.m_container;
+	m_containerIndex=b.m_containerIndex;
 	m_lockPolicy=b.m_lockPolicy;
 	switch(m_lockPolicy)
 	{
@@ -97,6 +99,7 @@ BaseServerObject & BaseServerObject::operator=(const BaseServerObject&b)
 		
 		m_waitTime=b.m_waitTime;
 		m_container=b.m_container;
+		m_containerIndex=b.m_containerIndex;
 		m_lockPolicy=b.m_lockPolicy;
 		switch(m_lockPolicy)
 		{
@@ -126,7 +129,7 @@ unsigned int BaseServerObject::GetWaitTime() const
 	return m_waitTime;
 }
 
-void BaseServerObject::setContainer(ServerObjectList *container)
+void BaseServerObject::setContainer(ServerObjectContainer *container)
 {
 	LockObj lock(m_containerLock);
 	m_container=container;
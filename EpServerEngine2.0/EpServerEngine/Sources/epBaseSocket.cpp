@@ -54,6 +54,9 @@ BaseSocket::BaseSocket(ServerCallbackInterface *callBackObj,unsigned int waitTim
 	}
 	m_callBackObj=callBackObj;
 	m_owner=NULL;
+	epl::System::Memset(&m_sockAddr,0,sizeof(SOCKADDR_STORAGE));
+	m_sockAddrSize=0;
+	m_memoryBudget=EP_NEW MemoryBudget(MEMORY_BUDGET_INFINITE,NULL,lockPolicyType);
 }
 
 BaseSocket::~BaseSocket()
@@ -62,6 +65,11 @@ BaseSocket::~BaseSocket()
 		EP_DELETE m_baseSocketLock;
 	m_baseSocketLock=NULL;
 
+	// packets still alive keep their own reference
+	if(m_memoryBudget)
+		m_memoryBudget->ReleaseObj();
+	m_memoryBudget=NULL;
+
 	m_owner=NULL;
 }
 
@@ -81,11 +89,23 @@ void BaseSocket::setOwner(BaseServerObject * owner )
 	epl::LockObj lock(m_baseSocketLock);
 	m_owner=owner;
 }
-void BaseSocket::setSockAddr(sockaddr sockAddr)
+void BaseSocket::setSockAddr(const sockaddr *sockAddr,int sockAddrSize)
+{
+	epl::LockObj lock(m_baseSocketLock);
+	epl::System::Memset(&m_sockAddr,0,sizeof(SOCKADDR_STORAGE));
+	m_sockAddrSize=0;
+	if(!sockAddr || sockAddrSize<=0 || sockAddrSize>static_cast<int>(sizeof(SOCKADDR_STORAGE)))
+		return;
+	epl::System::Memcpy(&m_sockAddr,sockAddr,sockAddrSize);
+	m_sockAddrSize=sockAddrSize;
+}
+void BaseSocket::setMemoryBudget(MemoryBudget *serverBudget,size_t budgetByteSize)
 {
 	epl::LockObj lock(m_baseSocketLock);
-	m_sockAddr=sockAddr;
+	m_memoryBudget->SetParent(serverBudget);
+	m_memoryBudget->SetBudgetByteSize(budgetByteSize);
 }
+
 bool BaseSocket::IsConnectionAlive() const
 {
 	return (GetStatus()!=Thread::THREAD_STATUS_TERMINATED);
@@ -99,19 +119,28 @@ BaseServerObject * BaseSocket::GetOwner()
 
 epl::EpTString BaseSocket::GetIP() const
 {
-	sockaddr socketAddr=m_sockAddr;
-	TCHAR ip[INET6_ADDRSTRLEN] = {0};
-	unsigned long ipSize=INET6_ADDRSTRLEN;
-	WSAAddressToString(&socketAddr,sizeof(sockaddr),NULL,ip,&ipSize);
-	epl::EpTString retString=ip;
-	return retString;
+	SOCKADDR_STORAGE socketAddr=m_sockAddr;
+	return GetIP(reinterpret_cast<const sockaddr*>(&socketAddr),m_sockAddrSize);
 }
 
 sockaddr BaseSocket::GetSockAddr() const
+{
+	// the IPv6 address does not fit in sockaddr, so only the head is returned
+	sockaddr sockAddr;
+	epl::System::Memcpy(&sockAddr,&m_sockAddr,sizeof(sockaddr));
+	return sockAddr;
+}
+
+SOCKADDR_STORAGE BaseSocket::GetSockAddrStorage() const
 {
 	return m_sockAddr;
 }
 
+int BaseSocket::GetSockAddrSize() const
+{
+	return m_sockAddrSize;
+}
+
 epl::EpTString BaseSocket::GetIP(sockaddr socketAddr)
 {
 	TCHAR ip[INET6_ADDRSTRLEN] = {0};
@@ -121,6 +150,16 @@ epl::EpTString BaseSocket::GetIP(sockaddr socketAddr)
 	return retString;
 }
 
+epl::EpTString BaseSocket::GetIP(const sockaddr *socketAddr,int sockAddrSize)
+{
+	TCHAR ip[INET6_ADDRSTRLEN] = {0};
+	unsigned long ipSize=INET6_ADDRSTRLEN;
+	if(socketAddr && sockAddrSize>0)
+		WSAAddressToString(const_cast<sockaddr*>(socketAddr),sockAddrSize,NULL,ip,&ipSize);
+	epl::EpTString retString=ip;
+	return retString;
+}
+
 void BaseSocket::SetCallbackObject(ServerCallbackInterface *callBackObj)
 {
 	EP_ASSERT(callBackObj);
@@ -132,3 +171,13 @@ ServerCallbackInterface *BaseSocket::GetCallbackObject()
 {
 	return m_callBackObj;
 }
+
+MessageArena *BaseSocket::GetArena()
+{
+	return MessageArena::GetCurrentArena();
+}
+
+MemoryBudget *BaseSocket::GetMemoryBudget()
+{
+	return m_memoryBudget;
+}
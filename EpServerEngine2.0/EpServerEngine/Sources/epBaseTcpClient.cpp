@@ -36,13 +36,18 @@ using namespace epse;
 BaseTcpClient::BaseTcpClient(epl::LockPolicy lockPolicyType) :BaseClient(lockPolicyType)
 {
 	m_recvSizePacket=Packet(NULL,4);
+	m_connectTimeOutMilliSec=WAITTIME_INIFINITE;
+	m_isConnectPending=false;
+	m_isConnectCanceled=false;
 }
 
 
 BaseTcpClient::BaseTcpClient(const BaseTcpClient& b) :BaseClient(b)
 {
 	m_recvSizePacket=b.m_recvSizePacket;
-
+	m_connectTimeOutMilliSec=b.m_connectTimeOutMilliSec;
+	m_isConnectPending=false;
+	m_isConnectCanceled=false;
 }
 BaseTcpClient::~BaseTcpClient()
 {
@@ -55,6 +60,7 @@ BaseTcpClient & BaseTcpClient::operator=(const BaseTcpClient&b)
 
 		BaseClient::operator =(b);
 		m_recvSizePacket=b.m_recvSizePacket;
+		m_connectTimeOutMilliSec=b.m_connectTimeOutMilliSec;
 	}
 	return *this;
 }
@@ -152,3 +158,157 @@ int BaseTcpClient::receive(Packet &packet)
 
 
 
+
+bool BaseTcpClient::connectToServer(ConnectStatus &retStatus)
+{
+	struct addrinfo hints;
+	ZeroMemory( &hints, sizeof(hints) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	// Resolve the server address and port
+	int iResult = RESOLVER_CACHE_INSTANCE.GetAddrInfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
+	if ( iResult != 0 ) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		retStatus=CONNECT_STATUS_FAIL_RESOLVE_FAILED;
+		return false;
+	}
+
+	// alternate the address families, starting with the family of the first address
+	std::vector<struct addrinfo*> addressList;
+	std::vector<struct addrinfo*> otherFamilyList;
+	struct addrinfo *iPtr=0;
+	for(iPtr=m_result; iPtr != NULL ;iPtr=iPtr->ai_next) {
+		if(iPtr->ai_family==m_result->ai_family)
+			addressList.push_back(iPtr);
+		else
+			otherFamilyList.push_back(iPtr);
+	}
+	for(size_t otherTrav=0;otherTrav<otherFamilyList.size();otherTrav++)
+	{
+		size_t insertIdx=otherTrav*2+1;
+		if(insertIdx>addressList.size())
+			insertIdx=addressList.size();
+		addressList.insert(addressList.begin()+insertIdx,otherFamilyList[otherTrav]);
+	}
+
+	std::vector<SOCKET> attemptList;
+	size_t addressIdx=0;
+	unsigned int startTick=GetTickCount();
+	unsigned int attemptTick=startTick-TCP_CONNECT_ATTEMPT_DELAY_MILLISEC;
+	m_connectSocket=INVALID_SOCKET;
+	retStatus=CONNECT_STATUS_FAIL_CONNECT_FAILED;
+	while(m_connectSocket==INVALID_SOCKET)
+	{
+		if(m_isConnectCanceled)
+		{
+			retStatus=CONNECT_STATUS_FAIL_CANCELED;
+			break;
+		}
+		unsigned int tick=GetTickCount();
+		if(m_connectTimeOutMilliSec!=WAITTIME_INIFINITE && tick-startTick>=m_connectTimeOutMilliSec)
+		{
+			retStatus=CONNECT_STATUS_FAIL_TIME_OUT;
+			break;
+		}
+
+		// start the next attempt once the previous one had its delay, without waiting for it to fail
+		if(addressIdx<addressList.size() && attemptList.size()<FD_SETSIZE && tick-attemptTick>=TCP_CONNECT_ATTEMPT_DELAY_MILLISEC)
+		{
+			iPtr=addressList[addressIdx++];
+			SOCKET attemptSocket=socket(iPtr->ai_family, iPtr->ai_socktype, iPtr->ai_protocol);
+			if(attemptSocket==INVALID_SOCKET)
+				continue;
+			u_long isNonBlocking=1;
+			ioctlsocket(attemptSocket,FIONBIO,&isNonBlocking);
+			iResult=connect(attemptSocket, iPtr->ai_addr, static_cast<int>(iPtr->ai_addrlen));
+			if(iResult!=SOCKET_ERROR)
+			{
+				m_connectSocket=attemptSocket;
+				break;
+			}
+			if(WSAGetLastError()!=WSAEWOULDBLOCK)
+			{
+				closesocket(attemptSocket);
+				continue;
+			}
+			attemptList.push_back(attemptSocket);
+			attemptTick=tick;
+		}
+		if(!attemptList.size())
+		{
+			if(addressIdx>=addressList.size())
+				break;
+			continue;
+		}
+
+		// wake for the next attempt, the time-out, and to check the cancel
+		unsigned int waitMilliSec=TCP_CONNECT_ATTEMPT_DELAY_MILLISEC;
+		if(addressIdx<addressList.size() && tick-attemptTick<TCP_CONNECT_ATTEMPT_DELAY_MILLISEC)
+			waitMilliSec=TCP_CONNECT_ATTEMPT_DELAY_MILLISEC-(tick-attemptTick);
+		if(m_connectTimeOutMilliSec!=WAITTIME_INIFINITE && m_connectTimeOutMilliSec-(tick-startTick)<waitMilliSec)
+			waitMilliSec=m_connectTimeOutMilliSec-(tick-startTick);
+
+		fd_set writeSet;
+		fd_set exceptSet;
+		FD_ZERO(&writeSet);
+		FD_ZERO(&exceptSet);
+		for(size_t attemptTrav=0;attemptTrav<attemptList.size();attemptTrav++)
+		{
+			FD_SET(attemptList[attemptTrav],&writeSet);
+			FD_SET(attemptList[attemptTrav],&exceptSet);
+		}
+		TIMEVAL timeOutVal;
+		timeOutVal.tv_sec = (long)(waitMilliSec/1000);
+		timeOutVal.tv_usec = (long)(waitMilliSec%1000)*1000;
+		iResult=select(0, NULL, &writeSet, &exceptSet, &timeOutVal);
+		if(iResult==SOCKET_ERROR)
+			break;
+		if(iResult==0)
+			continue;
+
+		// the connected attempt wins, and the failed attempts give way to the next address at once
+		for(size_t attemptTrav=attemptList.size();attemptTrav>0;attemptTrav--)
+		{
+			SOCKET attemptSocket=attemptList[attemptTrav-1];
+			if(FD_ISSET(attemptSocket,&writeSet))
+			{
+				m_connectSocket=attemptSocket;
+				attemptList.erase(attemptList.begin()+(attemptTrav-1));
+				break;
+			}
+			if(FD_ISSET(attemptSocket,&exceptSet))
+			{
+				closesocket(attemptSocket);
+				attemptList.erase(attemptList.begin()+(attemptTrav-1));
+				attemptTick=tick-TCP_CONNECT_ATTEMPT_DELAY_MILLISEC;
+			}
+		}
+	}
+	for(size_t attemptTrav=0;attemptTrav<attemptList.size();attemptTrav++)
+		closesocket(attemptList[attemptTrav]);
+
+	if (m_connectSocket == INVALID_SOCKET) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Unable to connect to server!\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return false;
+	}
+	u_long isNonBlocking=0;
+	ioctlsocket(m_connectSocket,FIONBIO,&isNonBlocking);
+	retStatus=CONNECT_STATUS_SUCCESS;
+	return true;
+}
+
+bool BaseTcpClient::cancelConnect()
+{
+	// OnConnected cannot wait for itself to return
+	if(!m_isConnectPending || GetCurrentThreadId()==GetID())
+		return false;
+	// the thread gives up connecting at its next wake-up
+	m_isConnectCanceled=true;
+	while(m_isConnectPending)
+	{
+		WaitFor(TCP_CONNECT_ATTEMPT_DELAY_MILLISEC);
+	}
+	return true;
+}
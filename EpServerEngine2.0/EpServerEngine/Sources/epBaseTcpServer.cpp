@@ -79,6 +79,8 @@ bool BaseTcpServer::StartServer(const ServerOps &ops)
 
 	SetWaitTime(ops.waitTimeMilliSec);
 	m_maxConnectionCount=ops.maximumConnectionCount;
+	m_memoryBudget->SetBudgetByteSize(ops.memoryBudgetByteSize);
+	m_connectionMemoryBudget=ops.connectionMemoryBudgetByteSize;
 	
 	WSADATA wsaData;
 	int iResult;
@@ -68,6 +68,74 @@ void BaseTcpSocket::setClientSocket(const SOCKET& clientSocket )
 }
 
 
+unsigned int BaseTcpSocket::getFrameByteSize(const Packet &packet)
+{
+	unsigned int length=packet.GetPacketByteSize();
+	if(!length)
+		return 0;
+	return sizeof(int)+length;
+}
+
+int BaseTcpSocket::sendPart(const Packet &packet,unsigned int &offset,unsigned int maxByteSize,SendStatus *sendStatus)
+{
+	epl::LockObj lock(m_sendLock);
+
+	if(m_clientSocket==INVALID_SOCKET)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+		return 0;
+	}
+
+	TIMEVAL	timeOutVal;
+	fd_set	fdSet;
+	FD_ZERO(&fdSet);
+	FD_SET(m_clientSocket, &fdSet);
+	timeOutVal.tv_sec = 0;
+	timeOutVal.tv_usec = 0;
+	int retfdNum = select(0, NULL, &fdSet, NULL, &timeOutVal);
+	if (retfdNum == SOCKET_ERROR)	// select failed
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SOCKET_ERROR;
+		return retfdNum;
+	}
+	else if (retfdNum == 0)		// not writable
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_TIME_OUT;
+		return retfdNum;
+	}
+
+	// the length header first, and then the packet
+	int length=packet.GetPacketByteSize();
+	const char *sendData;
+	unsigned int sendLength;
+	if(offset<sizeof(int))
+	{
+		sendData=reinterpret_cast<const char*>(&length)+offset;
+		sendLength=sizeof(int)-offset;
+	}
+	else
+	{
+		sendData=packet.GetPacket()+(offset-sizeof(int));
+		sendLength=getFrameByteSize(packet)-offset;
+	}
+	if(sendLength>maxByteSize)
+		sendLength=maxByteSize;
+	int sentLength=send(m_clientSocket,sendData,static_cast<int>(sendLength),0);
+	if(sentLength<=0)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return sentLength;
+	}
+	offset+=static_cast<unsigned int>(sentLength);
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return sentLength;
+}
+
 int BaseTcpSocket::Send(const Packet &packet, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
 {	
 	epl::LockObj lock(m_sendLock);
@@ -145,6 +213,12 @@ int BaseTcpSocket::Send(const Packet &packet, unsigned int waitTimeInMilliSec,Se
 }
 
 
+bool BaseTcpSocket::peekPacketByteSize(unsigned int &byteSize)
+{
+	int recvLength=recv(m_clientSocket,reinterpret_cast<char*>(&byteSize),sizeof(unsigned int),MSG_PEEK);
+	return (recvLength==sizeof(unsigned int));
+}
+
 int BaseTcpSocket::receive(Packet &packet)
 {
 	int readLength=0;
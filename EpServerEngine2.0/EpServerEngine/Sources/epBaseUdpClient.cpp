@@ -34,23 +34,43 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epse;
 
-BaseUdpClient::BaseUdpClient(epl::LockPolicy lockPolicyType): BaseClient(lockPolicyType)
+BaseUdpClient::BaseUdpClient(epl::LockPolicy lockPolicyType): BaseClient(lockPolicyType),m_channelTimer(lockPolicyType),m_channelListLock(lockPolicyType)
 {
 
 	m_ptr=0;
 	m_maxPacketSize=0;
+	m_isUdpSessionMovable=false;
+	m_channelSession=NULL;
+	m_fragmenter=NULL;
+	m_coalescer=NULL;
 }
 
-BaseUdpClient::BaseUdpClient(const BaseUdpClient& b):BaseClient(b)
+BaseUdpClient::BaseUdpClient(const BaseUdpClient& b):BaseClient(b),m_channelTimer(b.m_lockPolicy),m_channelListLock(b.m_lockPolicy)
 {
 	m_ptr=0;
 	m_maxPacketSize=b.m_maxPacketSize;
+	m_isUdpSessionMovable=false;
+	m_channelSession=NULL;
+	m_fragmenter=NULL;
+	m_coalescer=NULL;
 
 
 }
 BaseUdpClient::~BaseUdpClient()
 {
-
+	m_channelTimer.StopTimer();
+	if(m_channelSession)
+		EP_DELETE m_channelSession;
+	m_channelSession=NULL;
+	if(m_fragmenter)
+		EP_DELETE m_fragmenter;
+	m_fragmenter=NULL;
+	if(m_coalescer)
+		EP_DELETE m_coalescer;
+	m_coalescer=NULL;
+	Packet *packet;
+	while((packet=popChannelPacket())!=NULL)
+		packet->ReleaseObj();
 }
 
 BaseUdpClient & BaseUdpClient::operator=(const BaseUdpClient&b)
@@ -75,14 +95,94 @@ unsigned int BaseUdpClient::GetMaxPacketByteSize() const
 
 int BaseUdpClient::Send(const Packet &packet, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
 {
-	epl::LockObj lock(m_sendLock);
-	if(!IsConnectionAlive())
+	if(m_channelSession)
+		return SendOnChannel(0,packet,waitTimeInMilliSec,sendStatus);
+	if(m_fragmenter)
+	{
+		if(!IsConnectionAlive())
+		{
+			if(sendStatus)
+				*sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+			return -1;
+		}
+		return m_fragmenter->Send(packet,waitTimeInMilliSec,sendStatus);
+	}
+	if(m_coalescer)
+	{
+		if(!IsConnectionAlive())
+		{
+			if(sendStatus)
+				*sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+			return -1;
+		}
+		WSABUF buffer;
+		buffer.buf=const_cast<char*>(packet.GetPacket());
+		buffer.len=packet.GetPacketByteSize();
+		return m_coalescer->Send(&buffer,1,waitTimeInMilliSec,sendStatus);
+	}
+	return sendTo(packet,waitTimeInMilliSec,sendStatus);
+}
+
+int BaseUdpClient::Flush(unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(m_coalescer)
+		return m_coalescer->Flush(waitTimeInMilliSec,sendStatus);
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return 0;
+}
+
+int BaseUdpClient::SendOnChannel(unsigned int channelId,const Packet &packet, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(!IsConnectionAlive() || !m_channelSession)
 	{
 		if(sendStatus)
 			*sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
-		return 0;
+		return -1;
+	}
+	return m_channelSession->Send(channelId,packet,waitTimeInMilliSec,sendStatus);
+}
+
+unsigned int BaseUdpClient::GetChannelCount() const
+{
+	return static_cast<unsigned int>(m_channelTypeList.size());
+}
+
+unsigned int BaseUdpClient::GetRoundTripTime() const
+{
+	if(m_channelSession)
+		return m_channelSession->GetRoundTripTime();
+	return 0;
+}
+
+int BaseUdpClient::SendDatagram(const Packet &datagram,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(m_fragmenter)
+		return m_fragmenter->Send(datagram,waitTimeInMilliSec,sendStatus);
+	if(m_coalescer)
+	{
+		WSABUF buffer;
+		buffer.buf=const_cast<char*>(datagram.GetPacket());
+		buffer.len=datagram.GetPacketByteSize();
+		return m_coalescer->Send(&buffer,1,waitTimeInMilliSec,sendStatus);
 	}
+	return sendTo(datagram,waitTimeInMilliSec,sendStatus);
+}
+
+int BaseUdpClient::SendBuffers(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(m_coalescer)
+		return m_coalescer->Send(buffers,bufferCount,waitTimeInMilliSec,sendStatus);
+	return sendBuffers(buffers,bufferCount,waitTimeInMilliSec,sendStatus);
+}
 
+int BaseUdpClient::SendCoalesced(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	return sendBuffers(buffers,bufferCount,waitTimeInMilliSec,sendStatus);
+}
+
+int BaseUdpClient::waitForWritable(unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
 	// select routine
 	TIMEVAL	timeOutVal;
 	fd_set	fdSet;
@@ -107,14 +207,28 @@ int BaseUdpClient::Send(const Packet &packet, unsigned int waitTimeInMilliSec,Se
 	{
 		if(sendStatus)
 			*sendStatus=SEND_STATUS_FAIL_SOCKET_ERROR;
-		return retfdNum;
 	}
 	else if (retfdNum == 0)		    // select time-out
 	{
 		if(sendStatus)
 			*sendStatus=SEND_STATUS_FAIL_TIME_OUT;
-		return retfdNum;
 	}
+	return retfdNum;
+}
+
+int BaseUdpClient::sendTo(const Packet &packet, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	epl::LockObj lock(m_sendLock);
+	if(!IsConnectionAlive())
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+		return 0;
+	}
+
+	int retfdNum=waitForWritable(waitTimeInMilliSec,sendStatus);
+	if(retfdNum<=0)
+		return retfdNum;
 
 	// send routine
 	int sentLength=0;
@@ -125,7 +239,7 @@ int BaseUdpClient::Send(const Packet &packet, unsigned int waitTimeInMilliSec,Se
 	int sockAddrSize=sizeof(sockaddr);
 	while(length>0)
 	{
-		sentLength=sendto(m_connectSocket,packetData,length,0,m_ptr->ai_addr,sizeof(sockaddr));
+		sentLength=sendto(m_connectSocket,packetData,length,0,m_sendAddress.GetSockAddr(),m_sendAddress.GetSockAddrSize());
 		writeLength+=sentLength;
 		if(sentLength<=0)
 		{
@@ -141,22 +255,198 @@ int BaseUdpClient::Send(const Packet &packet, unsigned int waitTimeInMilliSec,Se
 	return sentLength;
 }
 
+int BaseUdpClient::sendBuffers(const WSABUF *buffers,unsigned int bufferCount, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	epl::LockObj lock(m_sendLock);
+	if(!IsConnectionAlive())
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+		return 0;
+	}
+
+	int retfdNum=waitForWritable(waitTimeInMilliSec,sendStatus);
+	if(retfdNum<=0)
+		return retfdNum;
+
+	// gathered by the network stack, so the payload is not copied into one buffer
+	DWORD sentLength=0;
+	if(WSASendTo(m_connectSocket,const_cast<WSABUF*>(buffers),bufferCount,&sentLength,0,m_sendAddress.GetSockAddr(),m_sendAddress.GetSockAddrSize(),NULL,NULL)==SOCKET_ERROR)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return -1;
+	}
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return static_cast<int>(sentLength);
+}
+
 
 
-int BaseUdpClient::receive(Packet &packet)
+int BaseUdpClient::receive(Packet &packet,bool &isMoveNotice)
 {
 	int length=packet.GetPacketByteSize();
 	char *packetData=const_cast<char*>(packet.GetPacket());
-	sockaddr tmpInfo;
-	int tmpInfoSize=sizeof(sockaddr);
-	int recvLength = recvfrom(m_connectSocket,packetData,length,0,&tmpInfo,&tmpInfoSize);
+	SOCKADDR_STORAGE tmpInfo;
+	int tmpInfoSize=sizeof(SOCKADDR_STORAGE);
+	int recvLength = recvfrom(m_connectSocket,packetData,length,0,reinterpret_cast<sockaddr*>(&tmpInfo),&tmpInfoSize);
+	isMoveNotice=(recvLength==0 && m_isUdpSessionMovable && answerMoveNotice(reinterpret_cast<sockaddr*>(&tmpInfo),tmpInfoSize));
 	return recvLength;
 }
 
+bool BaseUdpClient::answerMoveNotice(const sockaddr *sourceSockAddr,int sourceSockAddrSize)
+{
+	UdpSessionAddress sourceAddress(sourceSockAddr,sourceSockAddrSize);
+	// the empty datagram from the server port itself closes the session as before
+	if(sourceAddress==m_serverAddress)
+		return false;
+	SOCKADDR_STORAGE hostSockAddrStorage;
+	sockaddr *hostSockAddr=reinterpret_cast<sockaddr*>(&hostSockAddrStorage);
+	epl::System::Memcpy(hostSockAddr,sourceSockAddr,sourceSockAddrSize);
+	if(hostSockAddr->sa_family==AF_INET)
+		reinterpret_cast<sockaddr_in*>(hostSockAddr)->sin_port=reinterpret_cast<const sockaddr_in*>(m_serverAddress.GetSockAddr())->sin_port;
+	else if(hostSockAddr->sa_family==AF_INET6)
+		reinterpret_cast<sockaddr_in6*>(hostSockAddr)->sin6_port=reinterpret_cast<const sockaddr_in6*>(m_serverAddress.GetSockAddr())->sin6_port;
+	else
+		return false;
+	if(!(UdpSessionAddress(hostSockAddr,sourceSockAddrSize)==m_serverAddress))
+		return false;
+
+	epl::LockObj lock(m_sendLock);
+	// answered each time, as the answer may be lost and the notice sent again
+	m_sendAddress=sourceAddress;
+	char answerData=0;
+	sendto(m_connectSocket,&answerData,0,0,m_sendAddress.GetSockAddr(),m_sendAddress.GetSockAddrSize());
+	return true;
+}
+
+
+bool BaseUdpClient::setUpSession(const ClientOps &ops)
+{
+	m_serverAddress.SetSockAddr(m_ptr->ai_addr,static_cast<int>(m_ptr->ai_addrlen));
+	m_sendAddress=m_serverAddress;
+	m_isUdpSessionMovable=ops.isUdpSessionMovable;
+
+	unsigned int channelPacketSize=m_maxPacketSize;
+	unsigned int reservedByteSize=0;
+	if(ops.udpCoalesceDelayMilliSec)
+	{
+		m_coalescer=EP_NEW UdpCoalescer(this,m_maxPacketSize,ops.udpCoalesceDelayMilliSec,m_lockPolicy);
+		m_channelTimer.Register(m_coalescer);
+		// each message is framed by the length header below
+		reservedByteSize=UdpCoalescer::GetReservedByteSize();
+		channelPacketSize-=reservedByteSize;
+	}
+	if(ops.isUdpFragmentation)
+	{
+		// the fragments must be dropped rather than fragmented by IP, so the path MTU probes are meaningful
+		int dontFragment=1;
+		if(m_ptr->ai_family==AF_INET)
+			setsockopt(m_connectSocket,IPPROTO_IP,IP_DONTFRAGMENT,reinterpret_cast<char*>(&dontFragment),sizeof(int));
+#ifdef IPV6_DONTFRAG
+		else if(m_ptr->ai_family==AF_INET6)
+			setsockopt(m_connectSocket,IPPROTO_IPV6,IPV6_DONTFRAG,reinterpret_cast<char*>(&dontFragment),sizeof(int));
+#endif //IPV6_DONTFRAG
+		m_fragmenter=EP_NEW UdpFragmenter(this,m_maxPacketSize,reservedByteSize,m_lockPolicy);
+		// the channel messages are fragmented below
+		channelPacketSize=UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE;
+	}
+
+	m_channelTypeList.clear();
+	if(ops.udpChannelTypes && ops.udpChannelCount)
+	{
+		EP_ASSERT(ops.udpChannelCount<=UDP_CHANNEL_MAX_COUNT);
+		m_channelTypeList.assign(ops.udpChannelTypes,ops.udpChannelTypes+ops.udpChannelCount);
+		m_channelSession=EP_NEW UdpChannelSession(this,&m_channelTypeList.at(0),ops.udpChannelCount,channelPacketSize,m_lockPolicy);
+		m_channelTimer.Register(m_channelSession);
+	}
+	if(!m_channelSession && !m_coalescer)
+		return true;
+
+	if(!m_channelTimer.StartTimer())
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) channel timer failed to start\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return false;
+	}
+	return true;
+}
+
+void BaseUdpClient::unpackDatagram(const char *packetData,int recvLength,vector<Packet*> &packetList)
+{
+	if(!m_coalescer)
+	{
+		unpackMessage(packetData,recvLength,packetList);
+		return;
+	}
+
+	// the messages before the malformed part are still delivered
+	vector<WSABUF> messageList;
+	UdpCoalescer::Unpack(packetData,recvLength,messageList);
+	vector<WSABUF>::iterator iter;
+	for(iter=messageList.begin();iter!=messageList.end();iter++)
+		unpackMessage(iter->buf,static_cast<int>(iter->len),packetList);
+}
+
+void BaseUdpClient::unpackMessage(const char *messageData,int messageLength,vector<Packet*> &packetList)
+{
+	if(!m_fragmenter)
+	{
+		if(m_channelSession)
+			m_channelSession->Receive(messageData,messageLength,packetList);
+		else
+			packetList.push_back(EP_NEW Packet(messageData,messageLength));
+		return;
+	}
+
+	vector<Packet*> fragmentList;
+	m_fragmenter->Receive(messageData,messageLength,fragmentList);
+	vector<Packet*>::iterator iter;
+	for(iter=fragmentList.begin();iter!=fragmentList.end();iter++)
+	{
+		if(m_channelSession)
+		{
+			m_channelSession->Receive((*iter)->GetPacket(),(*iter)->GetPacketByteSize(),packetList);
+			(*iter)->ReleaseObj();
+		}
+		else
+			packetList.push_back(*iter);
+	}
+}
+
+void BaseUdpClient::pushChannelPackets(const vector<Packet*> &packetList,size_t startIndex)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_channelListLock);
+	for(size_t packetTrav=startIndex;packetTrav<packetList.size();packetTrav++)
+		m_channelPacketList.push(packetList.at(packetTrav));
+}
+
+Packet *BaseUdpClient::popChannelPacket()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_channelListLock);
+	if(m_channelPacketList.empty())
+		return NULL;
+	Packet *packet=m_channelPacketList.front();
+	m_channelPacketList.pop();
+	return packet;
+}
 
 void BaseUdpClient::cleanUpClient()
 {
 	BaseClient::cleanUpClient();
+	m_channelTimer.StopTimer(m_waitTime);
+	if(m_channelSession)
+		EP_DELETE m_channelSession;
+	m_channelSession=NULL;
+	if(m_fragmenter)
+		EP_DELETE m_fragmenter;
+	m_fragmenter=NULL;
+	if(m_coalescer)
+		EP_DELETE m_coalescer;
+	m_coalescer=NULL;
+	Packet *packet;
+	while((packet=popChannelPacket())!=NULL)
+		packet->ReleaseObj();
 	m_maxPacketSize=0;
 }
 
@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epBaseUdpServer.h"
+#include "epBaseUdpSocket.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -33,7 +34,7 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epse;
 
-BaseUdpServer::BaseUdpServer(epl::LockPolicy lockPolicyType): BaseServer(lockPolicyType)
+BaseUdpServer::BaseUdpServer(epl::LockPolicy lockPolicyType): BaseServer(lockPolicyType),m_sessionTable(lockPolicyType),m_acceptLock(lockPolicyType),m_sendQueueLock(lockPolicyType),m_channelTimer(lockPolicyType),m_connectedReceiver(lockPolicyType)
 {
 	switch(lockPolicyType)
 	{
@@ -51,9 +52,15 @@ BaseUdpServer::BaseUdpServer(epl::LockPolicy lockPolicyType): BaseServer(lockPol
 		break;
 	}
 	m_maxPacketSize=0;
+	m_udpSendQueueCount=UDP_SEND_QUEUE_COUNT_DISABLED;
+	m_udpReceiveThreadCount=1;
+	m_udpOffloadFlags=UDP_OFFLOAD_FLAG_NONE;
+	m_isUdpFragmentation=false;
+	m_udpCoalesceDelayMilliSec=0;
+	m_udpConnectPacketRate=0;
 }
 
-BaseUdpServer::BaseUdpServer(const BaseUdpServer& b):BaseServer(b)
+BaseUdpServer::BaseUdpServer(const BaseUdpServer& b):BaseServer(b),m_sessionTable(b.m_lockPolicy),m_acceptLock(b.m_lockPolicy),m_sendQueueLock(b.m_lockPolicy),m_channelTimer(b.m_lockPolicy),m_connectedReceiver(b.m_lockPolicy)
 {
 	switch(m_lockPolicy)
 	{
@@ -73,9 +80,17 @@ BaseUdpServer::BaseUdpServer(const BaseUdpServer& b):BaseServer(b)
 
 	LockObj lock(b.m_baseServerLock);
 	m_maxPacketSize=b.m_maxPacketSize;
+	m_udpSendQueueCount=b.m_udpSendQueueCount;
+	m_udpReceiveThreadCount=b.m_udpReceiveThreadCount;
+	m_udpOffloadFlags=b.m_udpOffloadFlags;
+	m_channelTypeList=b.m_channelTypeList;
+	m_isUdpFragmentation=b.m_isUdpFragmentation;
+	m_udpCoalesceDelayMilliSec=b.m_udpCoalesceDelayMilliSec;
+	m_udpConnectPacketRate=b.m_udpConnectPacketRate;
 }
 BaseUdpServer::~BaseUdpServer()
 {
+	clearSendQueue();
 }
 BaseUdpServer & BaseUdpServer::operator=(const BaseUdpServer&b)
 {
@@ -100,8 +115,17 @@ BaseUdpServer & BaseUdpServer::operator=(const BaseUdpServer&b)
 			break;
 		}
 
+		clearSendQueue();
+		m_sendQueueLock.SetLockPolicy(m_lockPolicy);
 		LockObj lock(b.m_baseServerLock);
 		m_maxPacketSize=b.m_maxPacketSize;
+		m_udpSendQueueCount=b.m_udpSendQueueCount;
+		m_udpReceiveThreadCount=b.m_udpReceiveThreadCount;
+		m_udpOffloadFlags=b.m_udpOffloadFlags;
+		m_channelTypeList=b.m_channelTypeList;
+		m_isUdpFragmentation=b.m_isUdpFragmentation;
+		m_udpCoalesceDelayMilliSec=b.m_udpCoalesceDelayMilliSec;
+		m_udpConnectPacketRate=b.m_udpConnectPacketRate;
 	}
 	return *this;
 }
@@ -123,16 +147,123 @@ unsigned int BaseUdpServer::GetMaxPacketByteSize() const
 
 int BaseUdpServer::send(const Packet &packet,const sockaddr &clientSockAddr, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
 {
+	return send(packet,&clientSockAddr,sizeof(sockaddr),waitTimeInMilliSec,sendStatus);
+}
 
-	epl::LockObj lock(m_sendLock);
+int BaseUdpServer::send(const Packet &packet,const sockaddr *clientSockAddr,int sockAddrSize, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	QueuedDatagram datagram;
+	datagram.m_packet=const_cast<Packet*>(&packet);
+	datagram.m_address.SetSockAddr(clientSockAddr,sockAddrSize);
+	return sendDatagrams(&datagram,1,waitTimeInMilliSec,sendStatus);
+}
+
+int BaseUdpServer::sendBatch(const Packet *const *packets,unsigned int packetCount,const UdpSessionAddress &clientAddress, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(!packetCount)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_SUCCESS;
+		return 0;
+	}
+	vector<QueuedDatagram> datagramList(packetCount);
+	int queuedLength=0;
+	for(unsigned int packetTrav=0;packetTrav<packetCount;packetTrav++)
+	{
+		EP_ASSERT(packets[packetTrav]);
+		datagramList[packetTrav].m_packet=const_cast<Packet*>(packets[packetTrav]);
+		datagramList[packetTrav].m_address=clientAddress;
+		queuedLength+=packets[packetTrav]->GetPacketByteSize();
+	}
+
+	if(m_udpSendQueueCount<=1)
+		return sendDatagrams(&datagramList.at(0),datagramList.size(),waitTimeInMilliSec,sendStatus);
+
+	// send queue: queue until the queue is full or flushed
+	m_sendQueueLock.Lock();
+	for(unsigned int packetTrav=0;packetTrav<packetCount;packetTrav++)
+	{
+		datagramList[packetTrav].m_packet->RetainObj();
+		m_sendQueue.push_back(datagramList[packetTrav]);
+	}
+	bool shouldFlush=(m_sendQueue.size()>=m_udpSendQueueCount);
+	m_sendQueueLock.Unlock();
+
+	// the queue is shared by the sessions, so only a flush with nothing sent fails this call
+	if(shouldFlush && FlushSendQueue(waitTimeInMilliSec,sendStatus)<0)
+		return -1;
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return queuedLength;
+}
+
+int BaseUdpServer::FlushSendQueue(unsigned int waitTimeInMilliSec,SendStatus *sendStatus,unsigned int *retFailedCount)
+{
+	vector<QueuedDatagram> datagramList;
+	m_sendQueueLock.Lock();
+	datagramList.swap(m_sendQueue);
+	m_sendQueueLock.Unlock();
+	if(datagramList.empty())
+	{
+		if(retFailedCount)
+			*retFailedCount=0;
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_SUCCESS;
+		return 0;
+	}
 
+	int writeLength=sendDatagrams(&datagramList.at(0),datagramList.size(),waitTimeInMilliSec,sendStatus,retFailedCount);
+	vector<QueuedDatagram>::iterator iter;
+	for(iter=datagramList.begin();iter!=datagramList.end();iter++)
+		iter->m_packet->ReleaseObj();
+	return writeLength;
+}
+
+unsigned int BaseUdpServer::GetUdpSendQueueCount() const
+{
+	return m_udpSendQueueCount;
+}
+
+unsigned int BaseUdpServer::GetUdpOffloadFlags() const
+{
+	return m_udpOffloadFlags;
+}
+
+bool BaseUdpServer::GetIsUdpFragmentation() const
+{
+	return m_isUdpFragmentation;
+}
+
+unsigned int BaseUdpServer::GetUdpCoalesceDelayMilliSec() const
+{
+	return m_udpCoalesceDelayMilliSec;
+}
+
+unsigned int BaseUdpServer::GetUdpConnectPacketRate() const
+{
+	return m_udpConnectPacketRate;
+}
+
+void BaseUdpServer::clearSendQueue()
+{
+	vector<QueuedDatagram> datagramList;
+	m_sendQueueLock.Lock();
+	datagramList.swap(m_sendQueue);
+	m_sendQueueLock.Unlock();
+	vector<QueuedDatagram>::iterator iter;
+	for(iter=datagramList.begin();iter!=datagramList.end();iter++)
+		iter->m_packet->ReleaseObj();
+}
+
+int BaseUdpServer::waitForWritable(SOCKET sendSocket,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
 	// select routine
 	TIMEVAL	timeOutVal;
 	fd_set	fdSet;
 	int		retfdNum = 0;
 
 	FD_ZERO(&fdSet);
-	FD_SET(m_listenSocket, &fdSet);
+	FD_SET(sendSocket, &fdSet);
 	if(waitTimeInMilliSec!=WAITTIME_INIFINITE)
 	{
 		// socket select time out setting
@@ -150,40 +281,304 @@ int BaseUdpServer::send(const Packet &packet,const sockaddr &clientSockAddr, uns
 	{
 		if(sendStatus)
 			*sendStatus=SEND_STATUS_FAIL_SOCKET_ERROR;
-		return retfdNum;
 	}
 	else if (retfdNum == 0)		    // select time-out
 	{
 		if(sendStatus)
 			*sendStatus=SEND_STATUS_FAIL_TIME_OUT;
+	}
+	return retfdNum;
+}
+
+int BaseUdpServer::sendDatagrams(const QueuedDatagram *datagrams,size_t datagramCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus,unsigned int *retFailedCount)
+{
+	if(retFailedCount)
+		*retFailedCount=0;
+	epl::LockObj lock(m_sendLock);
+
+	// one select for the whole queue
+	int retfdNum=waitForWritable(m_listenSocket,waitTimeInMilliSec,sendStatus);
+	if(retfdNum<=0)
+	{
+		if(retFailedCount)
+			*retFailedCount=static_cast<unsigned int>(datagramCount);
 		return retfdNum;
 	}
 
 	// send routine
-
-	int sentLength=0;
 	int writeLength=0;
+	unsigned int failedCount=0;
+	for(size_t datagramTrav=0;datagramTrav<datagramCount;datagramTrav++)
+	{
+		const Packet *packet=datagrams[datagramTrav].m_packet;
+		const UdpSessionAddress &address=datagrams[datagramTrav].m_address;
+		int length=packet->GetPacketByteSize();
+		EP_ASSERT(length<=m_maxPacketSize);
+
+		// the datagram is sent whole or not at all, and a failure is only for its own client
+		int sentLength=sendto(m_listenSocket,packet->GetPacket(),length,0,address.GetSockAddr(),address.GetSockAddrSize());
+		if(sentLength!=length)
+		{
+			failedCount++;
+			continue;
+		}
+		writeLength+=sentLength;
+	}
+	if(retFailedCount)
+		*retFailedCount=failedCount;
+	if(sendStatus)
+		*sendStatus=(failedCount?SEND_STATUS_FAIL_SEND_FAILED:SEND_STATUS_SUCCESS);
+	if(failedCount==datagramCount)
+		return -1;
+	return writeLength;
+}
+
+int BaseUdpServer::sendSegmented(const Packet &packet,unsigned int segmentByteSize,const UdpSessionAddress &clientAddress,bool isOffload, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	EP_ASSERT(segmentByteSize>0 && segmentByteSize<=m_maxPacketSize);
+	epl::LockObj lock(m_sendLock);
+
+	int retfdNum=waitForWritable(m_listenSocket,waitTimeInMilliSec,sendStatus);
+	if(retfdNum<=0)
+		return retfdNum;
+
 	const char *packetData=packet.GetPacket();
 	int length=packet.GetPacketByteSize();
-	EP_ASSERT(length<=m_maxPacketSize);
+	int writeLength=0;
+	if(isOffload && length>static_cast<int>(segmentByteSize))
+	{
+		// whole segments per train, so only the last datagram of the packet is short
+		int trainByteSize=(UDP_SEGMENT_TRAIN_MAX_BYTE_SIZE/segmentByteSize)*segmentByteSize;
+		while(length>0 && m_offload.IsSendOffloadSupported())
+		{
+			int sendLength=length<trainByteSize?length:trainByteSize;
+			int sentLength=m_offload.SendSegmented(m_listenSocket,packetData,sendLength,segmentByteSize,clientAddress.GetSockAddr(),clientAddress.GetSockAddrSize());
+			if(sentLength<=0)
+			{
+				// rejected by the network stack, so send the rest separately
+				if(!m_offload.IsSendOffloadSupported())
+					break;
+				if(sendStatus)
+					*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+				return sentLength;
+			}
+			writeLength+=sentLength;
+			length-=sentLength;
+			packetData+=sentLength;
+		}
+	}
 
-	int sockAddrSize=sizeof(sockaddr);
 	while(length>0)
 	{
-		sentLength=sendto(m_listenSocket,packetData,length,0,&clientSockAddr,sizeof(sockaddr));
-		writeLength+=sentLength;
+		int sendLength=length<static_cast<int>(segmentByteSize)?length:static_cast<int>(segmentByteSize);
+		int sentLength=sendto(m_listenSocket,packetData,sendLength,0,clientAddress.GetSockAddr(),clientAddress.GetSockAddrSize());
 		if(sentLength<=0)
 		{
 			if(sendStatus)
 				*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
 			return sentLength;
 		}
+		writeLength+=sentLength;
 		length-=sentLength;
 		packetData+=sentLength;
 	}
 	if(sendStatus)
 		*sendStatus=SEND_STATUS_SUCCESS;
-	return sentLength;
+	return writeLength;
+}
+
+int BaseUdpServer::sendBuffers(const WSABUF *buffers,unsigned int bufferCount,const UdpSessionAddress &clientAddress, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	epl::LockObj lock(m_sendLock);
+
+	int retfdNum=waitForWritable(m_listenSocket,waitTimeInMilliSec,sendStatus);
+	if(retfdNum<=0)
+		return retfdNum;
+
+	// gathered by the network stack, so the payload is not copied into one buffer
+	DWORD sentLength=0;
+	if(WSASendTo(m_listenSocket,const_cast<WSABUF*>(buffers),bufferCount,&sentLength,0,clientAddress.GetSockAddr(),clientAddress.GetSockAddrSize(),NULL,NULL)==SOCKET_ERROR)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return -1;
+	}
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return static_cast<int>(sentLength);
+}
+
+int BaseUdpServer::sendConnected(const WSABUF *buffers,unsigned int bufferCount,SOCKET connectedSocket, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	int retfdNum=waitForWritable(connectedSocket,waitTimeInMilliSec,sendStatus);
+	if(retfdNum<=0)
+		return retfdNum;
+
+	// the address and the route are kept by the connected socket
+	DWORD sentLength=0;
+	if(WSASend(connectedSocket,const_cast<WSABUF*>(buffers),bufferCount,&sentLength,0,NULL,NULL)==SOCKET_ERROR)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return -1;
+	}
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return static_cast<int>(sentLength);
+}
+
+int BaseUdpServer::receiveFrom(char *packetData,int length,sockaddr *clientSockAddr,int *sockAddrSize,unsigned int *segmentByteSize)
+{
+	return m_offload.ReceiveFrom(m_listenSocket,packetData,length,clientSockAddr,sockAddrSize,segmentByteSize);
+}
+
+void BaseUdpServer::deliverPacket(BaseUdpSocket *socket,const char *packetData,int recvLength,unsigned int segmentByteSize)
+{
+	if(m_udpConnectPacketRate && recvLength>0)
+		socket->updateReceiveRate(m_udpConnectPacketRate);
+	if(recvLength<=0)
+	{
+		Packet *passPacket=EP_NEW Packet(packetData,0);
+		socket->addPacket(passPacket);
+		passPacket->ReleaseObj();
+		return;
+	}
+	if(!segmentByteSize || recvLength<=static_cast<int>(segmentByteSize))
+	{
+		deliverDatagram(socket,packetData,recvLength);
+		return;
+	}
+
+	// split the coalesced datagrams, where only the last one can be short
+	while(recvLength>0)
+	{
+		int datagramLength=recvLength<static_cast<int>(segmentByteSize)?recvLength:static_cast<int>(segmentByteSize);
+		deliverDatagram(socket,packetData,datagramLength);
+		packetData+=datagramLength;
+		recvLength-=datagramLength;
+	}
+}
+
+void BaseUdpServer::deliverDatagram(BaseUdpSocket *socket,const char *packetData,int datagramLength)
+{
+	if(!socket->m_coalescer)
+	{
+		deliverMessage(socket,packetData,datagramLength);
+		return;
+	}
+
+	// the messages before the malformed part are still delivered
+	vector<WSABUF> messageList;
+	UdpCoalescer::Unpack(packetData,datagramLength,messageList);
+	vector<WSABUF>::iterator iter;
+	for(iter=messageList.begin();iter!=messageList.end();iter++)
+		deliverMessage(socket,iter->buf,static_cast<int>(iter->len));
+}
+
+void BaseUdpServer::deliverMessage(BaseUdpSocket *socket,const char *messageData,int messageLength)
+{
+	if(!socket->m_fragmenter && !socket->m_channelSession)
+	{
+		Packet *passPacket=EP_NEW Packet(messageData,messageLength);
+		socket->addPacket(passPacket);
+		passPacket->ReleaseObj();
+		return;
+	}
+
+	vector<Packet*> fragmentList;
+	if(socket->m_fragmenter)
+		socket->m_fragmenter->Receive(messageData,messageLength,fragmentList);
+	else
+		fragmentList.push_back(EP_NEW Packet(messageData,messageLength));
+
+	vector<Packet*> packetList;
+	vector<Packet*>::iterator iter;
+	for(iter=fragmentList.begin();iter!=fragmentList.end();iter++)
+	{
+		if(socket->m_channelSession)
+		{
+			socket->m_channelSession->Receive((*iter)->GetPacket(),(*iter)->GetPacketByteSize(),packetList);
+			(*iter)->ReleaseObj();
+		}
+		else
+			packetList.push_back(*iter);
+	}
+	for(iter=packetList.begin();iter!=packetList.end();iter++)
+	{
+		socket->addPacket(*iter);
+		(*iter)->ReleaseObj();
+	}
+}
+
+void BaseUdpServer::addSession(BaseUdpSocket *socket,const UdpSessionAddress &clientAddress)
+{
+	socket->setSessionAddress(clientAddress);
+	socket->setOwner(this);
+	socket->setMemoryBudget(m_memoryBudget,GetConnectionMemoryBudgetByteSize());
+	socket->setMaxPacketByteSize(m_maxPacketSize);
+	socket->SetSegmentOffload((m_udpOffloadFlags&UDP_OFFLOAD_FLAG_SEND)!=0);
+	unsigned int channelPacketSize=m_maxPacketSize;
+	unsigned int reservedByteSize=0;
+	if(m_udpCoalesceDelayMilliSec)
+	{
+		UdpCoalescer *coalescer=EP_NEW UdpCoalescer(socket,m_maxPacketSize,m_udpCoalesceDelayMilliSec,m_lockPolicy);
+		socket->setCoalescer(coalescer);
+		m_channelTimer.Register(coalescer);
+		// each message is framed by the length header below
+		reservedByteSize=UdpCoalescer::GetReservedByteSize();
+		channelPacketSize-=reservedByteSize;
+	}
+	if(m_isUdpFragmentation)
+	{
+		socket->setFragmenter(EP_NEW UdpFragmenter(socket,m_maxPacketSize,reservedByteSize,m_lockPolicy));
+		// the channel messages are fragmented below
+		channelPacketSize=UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE;
+	}
+	if(!m_channelTypeList.empty())
+	{
+		UdpChannelSession *channelSession=EP_NEW UdpChannelSession(socket,&m_channelTypeList.at(0),static_cast<unsigned int>(m_channelTypeList.size()),channelPacketSize,m_lockPolicy);
+		socket->setChannelSession(channelSession);
+		m_channelTimer.Register(channelSession);
+	}
+	m_socketList.Push(socket);
+	m_sessionTable.Insert(clientAddress,socket);
+}
+
+SOCKET BaseUdpServer::createConnectedSocket(const BaseUdpSocket *socket)
+{
+	SOCKADDR_STORAGE localSockAddrStorage;
+	sockaddr *localSockAddr=reinterpret_cast<sockaddr*>(&localSockAddrStorage);
+	int localSockAddrSize=sizeof(SOCKADDR_STORAGE);
+	if(getsockname(m_listenSocket,localSockAddr,&localSockAddrSize)==SOCKET_ERROR)
+		return INVALID_SOCKET;
+	// a port of its own, as the sockets sharing the listen port get the datagrams in no defined order
+	if(localSockAddr->sa_family==AF_INET)
+		reinterpret_cast<sockaddr_in*>(localSockAddr)->sin_port=0;
+	else if(localSockAddr->sa_family==AF_INET6)
+		reinterpret_cast<sockaddr_in6*>(localSockAddr)->sin6_port=0;
+	else
+		return INVALID_SOCKET;
+
+	SOCKET connectedSocket=::socket(localSockAddr->sa_family,SOCK_DGRAM,IPPROTO_UDP);
+	if(connectedSocket==INVALID_SOCKET)
+		return INVALID_SOCKET;
+	if(bind(connectedSocket,localSockAddr,localSockAddrSize)==SOCKET_ERROR || connect(connectedSocket,socket->m_sessionAddress.GetSockAddr(),socket->m_sessionAddress.GetSockAddrSize())==SOCKET_ERROR)
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) connected socket failed to set up\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		closesocket(connectedSocket);
+		return INVALID_SOCKET;
+	}
+	if(m_isUdpFragmentation)
+	{
+		int dontFragment=1;
+		if(localSockAddr->sa_family==AF_INET)
+			setsockopt(connectedSocket,IPPROTO_IP,IP_DONTFRAGMENT,reinterpret_cast<char*>(&dontFragment),sizeof(int));
+#ifdef IPV6_DONTFRAG
+		else if(localSockAddr->sa_family==AF_INET6)
+			setsockopt(connectedSocket,IPPROTO_IPV6,IPV6_DONTFRAG,reinterpret_cast<char*>(&dontFragment),sizeof(int));
+#endif //IPV6_DONTFRAG
+	}
+	return connectedSocket;
 }
 
 bool BaseUdpServer::socketCompare(sockaddr const & clientSocket, const BaseServerObject*obj )
@@ -221,6 +616,20 @@ bool BaseUdpServer::StartServer(const ServerOps &ops)
 
 	SetWaitTime(ops.waitTimeMilliSec);
 	m_maxConnectionCount=ops.maximumConnectionCount;
+	m_memoryBudget->SetBudgetByteSize(ops.memoryBudgetByteSize);
+	m_connectionMemoryBudget=ops.connectionMemoryBudgetByteSize;
+	m_udpSendQueueCount=ops.udpSendQueueCount;
+	m_udpReceiveThreadCount=ops.udpReceiveThreadCount;
+	m_udpOffloadFlags=ops.udpOffloadFlags;
+	m_channelTypeList.clear();
+	if(ops.udpChannelTypes && ops.udpChannelCount)
+	{
+		EP_ASSERT(ops.udpChannelCount<=UDP_CHANNEL_MAX_COUNT);
+		m_channelTypeList.assign(ops.udpChannelTypes,ops.udpChannelTypes+ops.udpChannelCount);
+	}
+	m_isUdpFragmentation=ops.isUdpFragmentation;
+	m_udpCoalesceDelayMilliSec=ops.udpCoalesceDelayMilliSec;
+	m_udpConnectPacketRate=ops.udpConnectPacketRate;
 
 	WSADATA wsaData;
 	int iResult;
@@ -279,6 +688,37 @@ bool BaseUdpServer::StartServer(const ServerOps &ops)
 	int nTmp = sizeof(int);
 	getsockopt(m_listenSocket, SOL_SOCKET,SO_MAX_MSG_SIZE, (char *)&m_maxPacketSize,&nTmp);
 
+	if(m_isUdpFragmentation)
+	{
+		// the fragments must be dropped rather than fragmented by IP, so the path MTU probes are meaningful
+		int dontFragment=1;
+		if(m_result->ai_family==AF_INET)
+			setsockopt(m_listenSocket,IPPROTO_IP,IP_DONTFRAGMENT,reinterpret_cast<char*>(&dontFragment),sizeof(int));
+#ifdef IPV6_DONTFRAG
+		else if(m_result->ai_family==AF_INET6)
+			setsockopt(m_listenSocket,IPPROTO_IPV6,IPV6_DONTFRAG,reinterpret_cast<char*>(&dontFragment),sizeof(int));
+#endif //IPV6_DONTFRAG
+	}
+
+	// the offload falls back to the separate datagrams where not supported
+	m_offload.Initialize(m_listenSocket);
+	if(m_udpOffloadFlags&UDP_OFFLOAD_FLAG_RECEIVE)
+		m_offload.EnableReceiveCoalescing(m_listenSocket,m_maxPacketSize);
+
+	if((!m_channelTypeList.empty() || m_udpCoalesceDelayMilliSec) && !m_channelTimer.StartTimer())
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) channel timer failed to start\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		cleanUpServer();
+		return false;
+	}
+
+	if(m_udpConnectPacketRate && !m_connectedReceiver.StartReceiver(this))
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) connected session receiver failed to start\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		cleanUpServer();
+		return false;
+	}
+
 	// Create thread 1.
 	if(Start())
 	{
@@ -313,9 +753,79 @@ void BaseUdpServer::StopServer()
 }
 
 
+void BaseUdpServer::execute()
+{
+	if(m_udpReceiveThreadCount>1)
+	{
+		// the shards are set before any thread receives, and not changed until all stopped
+		for(unsigned int shardTrav=0;shardTrav<m_udpReceiveThreadCount;shardTrav++)
+			m_receiveShardList.push_back(EP_NEW UdpReceiveShard(this,m_lockPolicy));
+		// the server thread is one of the receive threads
+		for(unsigned int threadTrav=1;threadTrav<m_udpReceiveThreadCount;threadTrav++)
+		{
+			UdpReceiveThread *receiveThread=EP_NEW UdpReceiveThread(this,m_lockPolicy);
+			if(receiveThread->Start())
+				m_receiveThreadList.push_back(receiveThread);
+			else
+				EP_DELETE receiveThread;
+		}
+	}
+
+	receiveLoop();
+
+	// every loop exits as the listen socket is closed
+	vector<UdpReceiveThread*>::iterator iter;
+	for(iter=m_receiveThreadList.begin();iter!=m_receiveThreadList.end();iter++)
+	{
+		(*iter)->TerminateAfter(m_waitTime);
+		EP_DELETE *iter;
+	}
+	m_receiveThreadList.clear();
+	vector<UdpReceiveShard*>::iterator shardIter;
+	for(shardIter=m_receiveShardList.begin();shardIter!=m_receiveShardList.end();shardIter++)
+		EP_DELETE *shardIter;
+	m_receiveShardList.clear();
+
+	stopServer();
+}
+
+void BaseUdpServer::receiveLoop()
+{
+	Packet recvPacket(NULL,m_maxPacketSize);
+	char *packetData=const_cast<char*>(recvPacket.GetPacket());
+	int length=recvPacket.GetPacketByteSize();
+	SOCKADDR_STORAGE clientSockAddrStorage;
+	sockaddr *clientSockAddr=reinterpret_cast<sockaddr*>(&clientSockAddrStorage);
+	size_t shardCount=m_receiveShardList.size();
+	// seeded as the session table, so a client cannot choose to crowd one shard
+	unsigned __int64 seed=m_sessionTable.GetSeed();
+	while(m_listenSocket!=INVALID_SOCKET)
+	{
+		int sockAddrSize=sizeof(SOCKADDR_STORAGE);
+		unsigned int segmentByteSize=0;
+		int recvLength=receiveFrom(packetData,length,clientSockAddr,&sockAddrSize,&segmentByteSize);
+		UdpSessionAddress clientAddress(clientSockAddr,sockAddrSize);
+		if(!shardCount)
+		{
+			handleDatagram(packetData,recvLength,clientAddress,segmentByteSize);
+			continue;
+		}
+
+		// one client always goes to the same shard, so its datagrams are never handled concurrently
+		size_t shardIdx=static_cast<size_t>(clientAddress.GetHash(seed)%shardCount);
+		m_receiveShardList[shardIdx]->Handle(packetData,recvLength,clientAddress,segmentByteSize);
+	}
+}
+
 void BaseUdpServer::cleanUpServer()
 {
+	// the connected sockets are closed before Winsock is cleaned up
+	m_connectedReceiver.StopReceiver(m_waitTime);
 	BaseServer::cleanUpServer();
+	m_sessionTable.Clear();
+	clearSendQueue();
+	m_channelTimer.StopTimer(m_waitTime);
+	m_offload.Reset();
 	m_maxPacketSize=0;
 }
 
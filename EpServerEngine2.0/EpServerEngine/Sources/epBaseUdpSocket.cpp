@@ -33,61 +33,281 @@ static char THIS_FILE[] = __FILE__;
 #endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 
 using namespace epse;
-BaseUdpSocket::BaseUdpSocket(ServerCallbackInterface *callBackObj,unsigned int waitTimeMilliSec,epl::LockPolicy lockPolicyType): BaseSocket(callBackObj,waitTimeMilliSec,lockPolicyType)
+BaseUdpSocket::BaseUdpSocket(ServerCallbackInterface *callBackObj,unsigned int waitTimeMilliSec,epl::LockPolicy lockPolicyType): BaseSocket(callBackObj,waitTimeMilliSec,lockPolicyType),m_connectLock(lockPolicyType),m_packetQueue(lockPolicyType)
 {
-	
-	switch(lockPolicyType)
+	m_maxPacketSize=0;
+	m_isSegmentOffload=false;
+	m_channelSession=NULL;
+	m_fragmenter=NULL;
+	m_coalescer=NULL;
+	m_connectedSocket=INVALID_SOCKET;
+	m_connectState=CONNECT_STATE_NONE;
+	m_connectNoticeCount=0;
+	m_receiveCount=0;
+	m_receiveTick=GetTickCount();
+}
+
+BaseUdpSocket::~BaseUdpSocket()
+{
+	m_packetQueue.Clear();
+
+	if(m_channelSession)
+		EP_DELETE m_channelSession;
+	m_channelSession=NULL;
+	if(m_fragmenter)
+		EP_DELETE m_fragmenter;
+	m_fragmenter=NULL;
+	if(m_coalescer)
+		EP_DELETE m_coalescer;
+	m_coalescer=NULL;
+}
+
+void BaseUdpSocket::setMaxPacketByteSize(unsigned int maxPacketSize)
+{
+	m_maxPacketSize=maxPacketSize;
+}
+
+void BaseUdpSocket::setSessionAddress(const UdpSessionAddress &sessionAddress)
+{
+	m_sessionAddress=sessionAddress;
+	setSockAddr(sessionAddress.GetSockAddr(),sessionAddress.GetSockAddrSize());
+}
+
+void BaseUdpSocket::removeSelfFromSessionTable()
+{
+	if(m_owner)
 	{
-	case epl::LOCK_POLICY_CRITICALSECTION:
-		m_listLock=EP_NEW epl::CriticalSectionEx();
-		break;
-	case epl::LOCK_POLICY_MUTEX:
-		m_listLock=EP_NEW epl::Mutex();
-		break;
-	case epl::LOCK_POLICY_NONE:
-		m_listLock=EP_NEW epl::NoLock();
-		break;
-	default:
-		m_listLock=NULL;
-		break;
+		((BaseUdpServer*)m_owner)->m_sessionTable.Remove(m_sessionAddress,this);
+		if(m_channelSession)
+			((BaseUdpServer*)m_owner)->m_channelTimer.Unregister(m_channelSession);
+		if(m_coalescer)
+			((BaseUdpServer*)m_owner)->m_channelTimer.Unregister(m_coalescer);
+		if(((BaseUdpServer*)m_owner)->m_udpConnectPacketRate)
+		{
+			clearConnectedSocket();
+			((BaseUdpServer*)m_owner)->m_connectedReceiver.Unregister(this);
+		}
 	}
-	m_maxPacketSize=0;
+}
 
+void BaseUdpSocket::setChannelSession(UdpChannelSession *channelSession)
+{
+	if(m_channelSession)
+		EP_DELETE m_channelSession;
+	m_channelSession=channelSession;
 }
 
-BaseUdpSocket::~BaseUdpSocket()
+void BaseUdpSocket::setFragmenter(UdpFragmenter *fragmenter)
+{
+	if(m_fragmenter)
+		EP_DELETE m_fragmenter;
+	m_fragmenter=fragmenter;
+}
+
+void BaseUdpSocket::setCoalescer(UdpCoalescer *coalescer)
 {
-	m_listLock->Lock();
+	if(m_coalescer)
+		EP_DELETE m_coalescer;
+	m_coalescer=coalescer;
+}
 
-	Packet *removeElem=NULL;
-	while(!m_packetList.empty())
+void BaseUdpSocket::updateReceiveRate(unsigned int packetRate)
+{
+	// the listen socket hands a client to one thread at a time, so counted without the interlocked calls
+	if(m_connectState==CONNECT_STATE_CONNECTED || m_connectState==CONNECT_STATE_CLOSED)
+		return;
+	m_receiveCount++;
+	DWORD currentTick=GetTickCount();
+	if(currentTick-m_receiveTick>=1000)
 	{
-		removeElem=m_packetList.front();
-		if(removeElem)
-			removeElem->ReleaseObj();
-		m_packetList.pop();
+		m_receiveTick=currentTick;
+		m_receiveCount=0;
+		// the notice or the answer may be lost, while the client still sends to the listen socket
+		if(m_connectState==CONNECT_STATE_PENDING && m_connectNoticeCount<UDP_CONNECT_NOTICE_MAX_COUNT)
+		{
+			ScopedLock<RuntimeLightLockPolicy> lock(m_connectLock);
+			if(m_connectedSocket!=INVALID_SOCKET)
+			{
+				m_connectNoticeCount++;
+				sendConnectNotice();
+			}
+		}
+		return;
 	}
-	m_listLock->Unlock();
+	if(m_connectState!=CONNECT_STATE_NONE || m_receiveCount<packetRate)
+		return;
 
-	if(m_listLock)
-		EP_DELETE m_listLock;
-	m_listLock=NULL;
+	BaseUdpServer *server=(BaseUdpServer*)m_owner;
+	SOCKET connectedSocket=server->createConnectedSocket(this);
+	if(connectedSocket==INVALID_SOCKET)
+	{
+		InterlockedExchange(&m_connectState,CONNECT_STATE_CLOSED);
+		return;
+	}
+	ScopedLock<RuntimeLightLockPolicy> lock(m_connectLock);
+	// closed meanwhile
+	if(m_connectState!=CONNECT_STATE_NONE)
+	{
+		closesocket(connectedSocket);
+		return;
+	}
+	// pending before registered, so the answer received at once is not overwritten
+	m_connectedSocket=connectedSocket;
+	InterlockedExchange(&m_connectState,CONNECT_STATE_PENDING);
+	if(!server->m_connectedReceiver.Register(this,connectedSocket))
+	{
+		m_connectedSocket=INVALID_SOCKET;
+		InterlockedExchange(&m_connectState,CONNECT_STATE_CLOSED);
+		closesocket(connectedSocket);
+		return;
+	}
+	m_connectNoticeCount=1;
+	sendConnectNotice();
 }
 
-void BaseUdpSocket::setMaxPacketByteSize(unsigned int maxPacketSize)
+void BaseUdpSocket::sendConnectNotice()
 {
-	m_maxPacketSize=maxPacketSize;
+	// the empty datagram from the new port tells the client to send there
+	char noticeData=0;
+	send(m_connectedSocket,&noticeData,0,0);
+}
+
+void BaseUdpSocket::setConnected()
+{
+	InterlockedCompareExchange(&m_connectState,CONNECT_STATE_CONNECTED,CONNECT_STATE_PENDING);
+}
+
+void BaseUdpSocket::clearConnectedSocket()
+{
+	ScopedLock<RuntimeLightLockPolicy> lock(m_connectLock);
+	m_connectedSocket=INVALID_SOCKET;
+	InterlockedExchange(&m_connectState,CONNECT_STATE_CLOSED);
+}
+
+int BaseUdpSocket::sendBuffers(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(!m_owner)
+		return 0;
+	if(m_connectState==CONNECT_STATE_CONNECTED)
+	{
+		// under the lock, so the socket is not closed while sending
+		ScopedLock<RuntimeLightLockPolicy> lock(m_connectLock);
+		if(m_connectedSocket!=INVALID_SOCKET)
+			return ((BaseUdpServer*)m_owner)->sendConnected(buffers,bufferCount,m_connectedSocket,waitTimeInMilliSec,sendStatus);
+	}
+	return ((BaseUdpServer*)m_owner)->sendBuffers(buffers,bufferCount,m_sessionAddress,waitTimeInMilliSec,sendStatus);
+}
+
+int BaseUdpSocket::SendDatagram(const Packet &datagram,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	// without the socket lock, since called from the channel timer
+	if(m_fragmenter)
+		return m_fragmenter->Send(datagram,waitTimeInMilliSec,sendStatus);
+	WSABUF buffer;
+	buffer.buf=const_cast<char*>(datagram.GetPacket());
+	buffer.len=datagram.GetPacketByteSize();
+	if(m_coalescer)
+		return m_coalescer->Send(&buffer,1,waitTimeInMilliSec,sendStatus);
+	return sendBuffers(&buffer,1,waitTimeInMilliSec,sendStatus);
+}
+
+void BaseUdpSocket::OnChannelFailed()
+{
+	// closes the session as the client does
+	Packet *closePacket=EP_NEW Packet(NULL,0);
+	addPacket(closePacket);
+	closePacket->ReleaseObj();
+}
+
+int BaseUdpSocket::SendBuffers(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(m_coalescer)
+		return m_coalescer->Send(buffers,bufferCount,waitTimeInMilliSec,sendStatus);
+	return SendCoalesced(buffers,bufferCount,waitTimeInMilliSec,sendStatus);
+}
+
+int BaseUdpSocket::SendCoalesced(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	return sendBuffers(buffers,bufferCount,waitTimeInMilliSec,sendStatus);
 }
 
 int BaseUdpSocket::Send(const Packet &packet, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
 {
 	epl::LockObj lock(m_baseSocketLock);
+	if(m_channelSession)
+		return m_channelSession->Send(0,packet,waitTimeInMilliSec,sendStatus);
+	if(m_fragmenter)
+		return m_fragmenter->Send(packet,waitTimeInMilliSec,sendStatus);
+	WSABUF buffer;
+	buffer.buf=const_cast<char*>(packet.GetPacket());
+	buffer.len=packet.GetPacketByteSize();
+	if(m_coalescer)
+		return m_coalescer->Send(&buffer,1,waitTimeInMilliSec,sendStatus);
 	EP_ASSERT(packet.GetPacketByteSize()<=m_maxPacketSize);
+	return sendBuffers(&buffer,1,waitTimeInMilliSec,sendStatus);
+}
+
+int BaseUdpSocket::Flush(unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(m_coalescer)
+		return m_coalescer->Flush(waitTimeInMilliSec,sendStatus);
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return 0;
+}
+
+int BaseUdpSocket::SendBatch(const Packet *const *packets,unsigned int packetCount, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	epl::LockObj lock(m_baseSocketLock);
+	if(m_owner)
+		return ((BaseUdpServer*)m_owner)->sendBatch(packets,packetCount,m_sessionAddress,waitTimeInMilliSec,sendStatus);
+	return 0;
+}
+
+int BaseUdpSocket::SendSegmented(const Packet &packet,unsigned int segmentByteSize, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	epl::LockObj lock(m_baseSocketLock);
 	if(m_owner)
-		return ((BaseUdpServer*)m_owner)->send(packet,m_sockAddr,waitTimeInMilliSec,sendStatus);
+		return ((BaseUdpServer*)m_owner)->sendSegmented(packet,segmentByteSize,m_sessionAddress,m_isSegmentOffload,waitTimeInMilliSec,sendStatus);
 	return 0;
 }
 
+int BaseUdpSocket::SendOnChannel(unsigned int channelId,const Packet &packet, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	epl::LockObj lock(m_baseSocketLock);
+	if(!m_channelSession)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return -1;
+	}
+	return m_channelSession->Send(channelId,packet,waitTimeInMilliSec,sendStatus);
+}
+
+unsigned int BaseUdpSocket::GetChannelCount() const
+{
+	if(m_channelSession)
+		return m_channelSession->GetChannelCount();
+	return 0;
+}
+
+unsigned int BaseUdpSocket::GetRoundTripTime() const
+{
+	if(m_channelSession)
+		return m_channelSession->GetRoundTripTime();
+	return 0;
+}
+
+void BaseUdpSocket::SetSegmentOffload(bool isSegmentOffload)
+{
+	m_isSegmentOffload=isSegmentOffload;
+}
+
+bool BaseUdpSocket::GetSegmentOffload() const
+{
+	return m_isSegmentOffload;
+}
+
 unsigned int BaseUdpSocket::GetMaxPacketByteSize() const
 {
 	return m_maxPacketSize;
@@ -0,0 +1,270 @@
+/*! 
+BufferPool for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epBufferPool.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+// Need to link with Advapi32.lib for SeLockMemoryPrivilege
+#pragma comment (lib, "Advapi32.lib")
+
+using namespace epse;
+
+// NUMA functions are loaded at runtime to keep the older Windows supported
+typedef LPVOID (WINAPI *VirtualAllocExNumaFunc)(HANDLE,LPVOID,SIZE_T,DWORD,DWORD,DWORD);
+typedef DWORD (WINAPI *GetCurrentProcessorNumberFunc)(void);
+typedef BOOL (WINAPI *GetNumaProcessorNodeFunc)(UCHAR,PUCHAR);
+typedef SIZE_T (WINAPI *GetLargePageMinimumFunc)(void);
+
+/*! 
+@struct BufferPoolTlsIndex epBufferPool.cpp
+@brief A class holding the TLS index for the buffer pool of the current thread.
+*/
+struct BufferPoolTlsIndex{
+	/// TLS index
+	DWORD m_index;
+	BufferPoolTlsIndex()
+	{
+		m_index=TlsAlloc();
+	}
+	~BufferPoolTlsIndex()
+	{
+		if(m_index!=TLS_OUT_OF_INDEXES)
+			TlsFree(m_index);
+	}
+};
+static BufferPoolTlsIndex s_bufferPoolTlsIndex;
+
+static FARPROC getKernelProc(const char *procName)
+{
+	HMODULE kernelModule=GetModuleHandle(_T("kernel32.dll"));
+	if(!kernelModule)
+		return NULL;
+	return GetProcAddress(kernelModule,procName);
+}
+
+/// state of the lock memory privilege of the process
+typedef enum _lockMemoryPrivilegeState{
+	/// not tried yet
+	LOCK_MEMORY_PRIVILEGE_STATE_UNKNOWN=0,
+	/// enabled
+	LOCK_MEMORY_PRIVILEGE_STATE_ENABLED,
+	/// not held by the process
+	LOCK_MEMORY_PRIVILEGE_STATE_FAILED,
+}LockMemoryPrivilegeState;
+static volatile LONG s_lockMemoryPrivilegeState=LOCK_MEMORY_PRIVILEGE_STATE_UNKNOWN;
+
+static bool enableLockMemoryPrivilege()
+{
+	// the token is adjusted once for the process, and the result is reused by every slab allocation
+	LONG state=s_lockMemoryPrivilegeState;
+	if(state!=LOCK_MEMORY_PRIVILEGE_STATE_UNKNOWN)
+		return state==LOCK_MEMORY_PRIVILEGE_STATE_ENABLED;
+
+	HANDLE token=NULL;
+	if(!OpenProcessToken(GetCurrentProcess(),TOKEN_ADJUST_PRIVILEGES|TOKEN_QUERY,&token))
+	{
+		InterlockedExchange(&s_lockMemoryPrivilegeState,LOCK_MEMORY_PRIVILEGE_STATE_FAILED);
+		return false;
+	}
+	TOKEN_PRIVILEGES privileges;
+	privileges.PrivilegeCount=1;
+	privileges.Privileges[0].Attributes=SE_PRIVILEGE_ENABLED;
+	bool retVal=false;
+	if(LookupPrivilegeValue(NULL,SE_LOCK_MEMORY_NAME,&privileges.Privileges[0].Luid))
+	{
+		// AdjustTokenPrivileges succeeds even if the privilege is not held
+		if(AdjustTokenPrivileges(token,FALSE,&privileges,0,NULL,NULL) && GetLastError()==ERROR_SUCCESS)
+			retVal=true;
+	}
+	CloseHandle(token);
+	InterlockedExchange(&s_lockMemoryPrivilegeState,retVal?LOCK_MEMORY_PRIVILEGE_STATE_ENABLED:LOCK_MEMORY_PRIVILEGE_STATE_FAILED);
+	return retVal;
+}
+
+BufferPool::BufferPool(unsigned int bufferByteSize,unsigned int poolFlags,epl::LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_poolLock(lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	// each free buffer holds the pointer to the next free buffer
+	if(bufferByteSize<sizeof(void*))
+		bufferByteSize=sizeof(void*);
+	m_bufferByteSize=(bufferByteSize+MEMORY_ALLOCATION_ALIGNMENT-1)&~(MEMORY_ALLOCATION_ALIGNMENT-1);
+	m_poolFlags=poolFlags;
+	m_isLargePage=false;
+	m_numaNode=0;
+	m_freeList=NULL;
+	m_reservedByteSize=0;
+	m_usedBufferCount=0;
+
+	if(m_poolFlags&BUFFER_POOL_FLAG_NUMA_LOCAL)
+	{
+		GetCurrentProcessorNumberFunc getCurrentProcessorNumber=(GetCurrentProcessorNumberFunc)getKernelProc("GetCurrentProcessorNumber");
+		GetNumaProcessorNodeFunc getNumaProcessorNode=(GetNumaProcessorNodeFunc)getKernelProc("GetNumaProcessorNode");
+		UCHAR numaNode=0;
+		if(getCurrentProcessorNumber && getNumaProcessorNode && getNumaProcessorNode((UCHAR)getCurrentProcessorNumber(),&numaNode))
+			m_numaNode=numaNode;
+	}
+}
+
+BufferPool::~BufferPool()
+{
+	EP_ASSERT(m_usedBufferCount==0);
+	vector<void*>::iterator iter;
+	for(iter=m_slabList.begin();iter!=m_slabList.end();iter++)
+	{
+		VirtualFree(*iter,0,MEM_RELEASE);
+	}
+	m_slabList.clear();
+	m_freeList=NULL;
+}
+
+void *BufferPool::allocSlab(size_t byteSize,DWORD allocationType)
+{
+	if(m_poolFlags&BUFFER_POOL_FLAG_NUMA_LOCAL)
+	{
+		VirtualAllocExNumaFunc virtualAllocExNuma=(VirtualAllocExNumaFunc)getKernelProc("VirtualAllocExNuma");
+		if(virtualAllocExNuma)
+			return virtualAllocExNuma(GetCurrentProcess(),NULL,byteSize,allocationType,PAGE_READWRITE,m_numaNode);
+	}
+	return VirtualAlloc(NULL,byteSize,allocationType,PAGE_READWRITE);
+}
+
+bool BufferPool::addSlab()
+{
+	size_t slabByteSize=BUFFER_POOL_SLAB_BYTE_SIZE;
+	if(slabByteSize<m_bufferByteSize)
+		slabByteSize=m_bufferByteSize;
+
+	void *slab=NULL;
+	if(m_poolFlags&BUFFER_POOL_FLAG_LARGE_PAGE)
+	{
+		GetLargePageMinimumFunc getLargePageMinimum=(GetLargePageMinimumFunc)getKernelProc("GetLargePageMinimum");
+		size_t largePageByteSize=getLargePageMinimum?getLargePageMinimum():0;
+		if(largePageByteSize && enableLockMemoryPrivilege())
+		{
+			size_t largeSlabByteSize=((slabByteSize+largePageByteSize-1)/largePageByteSize)*largePageByteSize;
+			slab=allocSlab(largeSlabByteSize,MEM_RESERVE|MEM_COMMIT|MEM_LARGE_PAGES);
+			if(slab)
+			{
+				slabByteSize=largeSlabByteSize;
+				m_isLargePage=true;
+			}
+		}
+		if(!slab)
+			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Large pages not available, falling back to normal pages\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+	}
+	if(!slab)
+		slab=allocSlab(slabByteSize,MEM_RESERVE|MEM_COMMIT);
+	if(!slab)
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Slab allocation failed\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return false;
+	}
+	m_slabList.push_back(slab);
+	m_reservedByteSize+=slabByteSize;
+
+	size_t bufferCount=slabByteSize/m_bufferByteSize;
+	char *buffer=reinterpret_cast<char*>(slab);
+	for(size_t trav=0;trav<bufferCount;trav++)
+	{
+		*reinterpret_cast<void**>(buffer)=m_freeList;
+		m_freeList=buffer;
+		buffer+=m_bufferByteSize;
+	}
+	return true;
+}
+
+void *BufferPool::Allocate(unsigned int byteSize)
+{
+	if(byteSize>m_bufferByteSize)
+		return NULL;
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	if(!m_freeList && !addSlab())
+		return NULL;
+	void *retBuffer=m_freeList;
+	m_freeList=*reinterpret_cast<void**>(retBuffer);
+	m_usedBufferCount++;
+	return retBuffer;
+}
+
+void BufferPool::Free(void *buffer)
+{
+	if(!buffer)
+		return;
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	*reinterpret_cast<void**>(buffer)=m_freeList;
+	m_freeList=buffer;
+	m_usedBufferCount--;
+}
+
+unsigned int BufferPool::GetBufferByteSize() const
+{
+	return m_bufferByteSize;
+}
+
+unsigned int BufferPool::GetPoolFlags() const
+{
+	return m_poolFlags;
+}
+
+bool BufferPool::IsLargePage() const
+{
+	return m_isLargePage;
+}
+
+unsigned int BufferPool::GetNumaNode() const
+{
+	return m_numaNode;
+}
+
+unsigned int BufferPool::GetUsedBufferCount() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	return m_usedBufferCount;
+}
+
+size_t BufferPool::GetReservedByteSize() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	return m_reservedByteSize;
+}
+
+BufferPool *BufferPool::GetCurrentPool()
+{
+	if(s_bufferPoolTlsIndex.m_index==TLS_OUT_OF_INDEXES)
+		return NULL;
+	return reinterpret_cast<BufferPool*>(TlsGetValue(s_bufferPoolTlsIndex.m_index));
+}
+
+void BufferPool::SetCurrentPool(BufferPool *bufferPool)
+{
+	if(s_bufferPoolTlsIndex.m_index==TLS_OUT_OF_INDEXES)
+		return;
+	TlsSetValue(s_bufferPoolTlsIndex.m_index,bufferPool);
+}
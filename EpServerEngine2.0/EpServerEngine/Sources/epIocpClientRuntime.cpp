@@ -0,0 +1,131 @@
+/*! 
+IocpClientRuntime for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epIocpClientRuntime.h"
+#include "epIocpClientProcessor.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+IocpClientRuntime::IocpClientRuntime(epl::LockPolicy lockPolicyType):m_workerLock(lockPolicyType)
+{
+}
+
+IocpClientRuntime::~IocpClientRuntime()
+{
+	StopRuntime();
+}
+
+bool IocpClientRuntime::StartRuntime(unsigned int workerThreadCount)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	if(m_workerList.size())
+		return true;
+
+	int workerCount=static_cast<int>(workerThreadCount);
+	if(workerCount==0)
+	{
+		workerCount=System::GetNumberOfCores()*2;
+	}
+	for(int trav=0;trav<workerCount;trav++)
+	{
+		BaseWorkerThread *workerThread=WorkerThreadFactory::GetWorkerThread(BaseWorkerThread::THREAD_LIFE_SUSPEND_AFTER_WORK);
+
+		workerThread->SetCallBackClass(this);
+
+		m_workerList.push_back(workerThread);
+		m_emptyWorkerList.push(workerThread);
+		workerThread->SetJobProcessor(EP_NEW IocpClientProcessor());
+		workerThread->Start();
+	}
+	return true;
+}
+
+void IocpClientRuntime::StopRuntime(unsigned int waitTimeInMilliSec)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	while(!m_emptyWorkerList.empty())
+		m_emptyWorkerList.pop();
+
+	for(size_t trav=0;trav<m_workerList.size();trav++)
+	{
+		m_workerList.at(trav)->TerminateWorker(waitTimeInMilliSec);
+		EP_DELETE m_workerList.at(trav);
+	}
+	m_workerList.clear();
+}
+
+bool IocpClientRuntime::IsRuntimeStarted() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	return m_workerList.size()!=0;
+}
+
+unsigned int IocpClientRuntime::GetWorkerThreadCount() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	return static_cast<unsigned int>(m_workerList.size());
+}
+
+void IocpClientRuntime::CallBackFunc(BaseWorkerThread *p)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	m_emptyWorkerList.push(p);
+}
+
+void IocpClientRuntime::PushJob(BaseJob *job)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	if(m_emptyWorkerList.size())
+	{
+		m_emptyWorkerList.front()->Push(job);
+		m_emptyWorkerList.pop();
+	}
+	else
+	{
+		if(!m_workerList.size())
+		{
+			return;
+		}
+
+		size_t jobCount=m_workerList.at(0)->GetJobCount();
+		int workerIdx=0;
+
+		for(int trav=1;trav<m_workerList.size();trav++)
+		{
+			if(m_workerList.at(trav)->GetJobCount()<jobCount)
+			{
+				jobCount=m_workerList.at(trav)->GetJobCount();
+				workerIdx=trav;
+			}
+		}
+		m_workerList.at(workerIdx)->Push(job);
+	}
+}
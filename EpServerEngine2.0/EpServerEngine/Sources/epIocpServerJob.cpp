@@ -45,10 +45,17 @@ IocpServerJob::IocpServerJob(BaseSocket *socket,IocpServerJobType jobType,Packet
 
 	m_completeEvent=completionEvent;
 	m_callBackObj=callBackObj;
+	m_memoryBudget=NULL;
+	m_chargedByteSize=0;
 }
 
 IocpServerJob::~IocpServerJob()
 {
+	if(m_memoryBudget)
+	{
+		m_memoryBudget->Release(m_chargedByteSize);
+		m_memoryBudget->ReleaseObj();
+	}
 	if(m_packet)
 		m_packet->ReleaseObj();
 	if(m_socket)
@@ -96,4 +103,18 @@ EventEx *IocpServerJob::GetCompletionEvent()
 ServerCallbackInterface *IocpServerJob::GetCallBackObject()
 {
 	return m_callBackObj;
+}
+
+bool IocpServerJob::ChargeMemoryBudget(MemoryBudget *budget)
+{
+	EP_ASSERT(budget && !m_memoryBudget);
+	unsigned int byteSize=0;
+	if(m_packet)
+		byteSize=m_packet->GetPacketByteSize();
+	if(!budget->Acquire(byteSize))
+		return false;
+	budget->RetainObj();
+	m_memoryBudget=budget;
+	m_chargedByteSize=byteSize;
+	return true;
 }
\ No newline at end of file
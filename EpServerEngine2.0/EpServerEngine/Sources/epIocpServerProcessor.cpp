@@ -28,8 +28,28 @@ THE SOFTWARE.
 #include "epPacket.h"
 using namespace epse;
 
+IocpServerProcessor::IocpServerProcessor(unsigned int bufferPoolFlags):BaseJobProcessor()
+{
+	m_bufferPoolFlags=bufferPoolFlags;
+	m_bufferPool=NULL;
+}
+
+IocpServerProcessor::~IocpServerProcessor()
+{
+	// packets still alive keep their own reference
+	if(m_bufferPool)
+		m_bufferPool->ReleaseObj();
+	m_bufferPool=NULL;
+}
+
 void IocpServerProcessor::DoJob(BaseWorkerThread *workerThread,  BaseJob* const data)
 {
+	if(m_bufferPoolFlags!=BUFFER_POOL_FLAG_NONE && !m_bufferPool)
+	{
+		// created on the worker thread, so the pool is placed on the NUMA node of the worker
+		m_bufferPool=EP_NEW BufferPool(BUFFER_POOL_BUFFER_BYTE_SIZE,m_bufferPoolFlags);
+		BufferPool::SetCurrentPool(m_bufferPool);
+	}
 	IocpServerJob * job=reinterpret_cast<IocpServerJob*>(data);
 	Packet *receivedPacket=NULL;
 	SendStatus sendStatus;
@@ -60,12 +80,14 @@ void IocpServerProcessor::DoJob(BaseWorkerThread *workerThread,  BaseJob* const
 	case IocpServerJob::IOCP_SERVER_JOB_TYPE_RECEIVE:
 		receivedPacket=job->GetSocket()->Receive(0,&receiveStatus);
 		
-		if(receiveStatus==RECEIVE_STATUS_FAIL_TIME_OUT)
+		// memory budget exceeded on alive connection means throttled, so retry later
+		if(receiveStatus==RECEIVE_STATUS_FAIL_TIME_OUT || (receiveStatus==RECEIVE_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED && job->GetSocket()->IsConnectionAlive()))
 		{
 			workerThread->Push(data);
 		}
 		else
 		{
+			MessageArenaScope arenaScope(&m_arena);
 			if(job->GetCompletionEvent())
 				job->GetCompletionEvent()->SetEvent();
 			if(job->GetCallBackObject())
@@ -92,6 +114,12 @@ void IocpServerProcessor::DoJob(BaseWorkerThread *workerThread,  BaseJob* const
 			job->GetSocket()->GetCallbackObject()->OnDisconnect(job->GetSocket());
 
 		break;
+	case IocpServerJob::IOCP_SERVER_JOB_TYPE_CONNECT:
+		if(job->GetCallBackObject())
+			job->GetCallBackObject()->OnNewConnection(job->GetSocket());
+		else
+			job->GetSocket()->GetCallbackObject()->OnNewConnection(job->GetSocket());
+		break;
 	}
 }
 
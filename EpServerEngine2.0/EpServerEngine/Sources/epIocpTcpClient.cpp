@@ -25,6 +25,7 @@ THE SOFTWARE.
 */
 #include "epIocpTcpClient.h"
 #include "epIocpClientProcessor.h"
+#include "epIocpClientRuntime.h"
 #include "epIocpClientJob.h"
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -53,6 +54,7 @@ IocpTcpClient::IocpTcpClient(epl::LockPolicy lockPolicyType) :BaseTcpClient(lock
 	}
 
 	m_isConnected=false;
+	m_runtime=NULL;
 }
 
 
@@ -74,6 +76,7 @@ IocpTcpClient::IocpTcpClient(const IocpTcpClient& b) :BaseTcpClient(b)
 		break;
 	}
 	m_isConnected=false;
+	m_runtime=NULL;
 }
 
 IocpTcpClient::~IocpTcpClient()
@@ -106,16 +109,36 @@ IocpTcpClient & IocpTcpClient::operator=(const IocpTcpClient&b)
 		}
 
 		m_isConnected=false;
+		m_runtime=NULL;
 	}
 	return *this;
 }
 
 
 void IocpTcpClient::execute()
-{}
+{
+	if(!m_isConnectPending)
+		return;
+	ConnectStatus status;
+	bool isConnected=connectToServer(status);
+	if(isConnected && m_isConnectCanceled)
+	{
+		isConnected=false;
+		status=CONNECT_STATUS_FAIL_CANCELED;
+	}
+	if(isConnected)
+		m_isConnected=true;
+	else
+		cleanUpClient();
+	m_callBackObj->OnConnected(this,status);
+	// cleared after the callback, so Disconnect does not return while it is still running
+	m_isConnectPending=false;
+}
 
 bool IocpTcpClient::Connect(const ClientOps &ops)
 {
+	if(m_isConnectPending)
+		return true;
 	m_workerLock->Lock();
 	while(!m_emptyWorkerList.empty())
 		m_emptyWorkerList.pop();
@@ -127,21 +150,30 @@ bool IocpTcpClient::Connect(const ClientOps &ops)
 	}
 	m_workerList.clear();
 
-	int workerCount=ops.workerThreadCount;
-	if(workerCount==0)
+	m_runtime=ops.iocpClientRuntime;
+	if(m_runtime)
 	{
-		workerCount=System::GetNumberOfCores()*2;
+		// the jobs run on the shared worker threads, so no thread of its own
+		m_runtime->StartRuntime(ops.workerThreadCount);
 	}
-	for(int trav=0;trav<workerCount;trav++)
+	else
 	{
-		BaseWorkerThread *workerThread=WorkerThreadFactory::GetWorkerThread(BaseWorkerThread::THREAD_LIFE_SUSPEND_AFTER_WORK);
+		int workerCount=ops.workerThreadCount;
+		if(workerCount==0)
+		{
+			workerCount=System::GetNumberOfCores()*2;
+		}
+		for(int trav=0;trav<workerCount;trav++)
+		{
+			BaseWorkerThread *workerThread=WorkerThreadFactory::GetWorkerThread(BaseWorkerThread::THREAD_LIFE_SUSPEND_AFTER_WORK);
 
-		workerThread->SetCallBackClass(this);
+			workerThread->SetCallBackClass(this);
 
-		m_workerList.push_back(workerThread);
-		m_emptyWorkerList.push(workerThread);
-		workerThread->SetJobProcessor(EP_NEW IocpClientProcessor());
-		workerThread->Start();
+			m_workerList.push_back(workerThread);
+			m_emptyWorkerList.push(workerThread);
+			workerThread->SetJobProcessor(EP_NEW IocpClientProcessor());
+			workerThread->Start();
+		}
 	}
 	m_workerLock->Unlock();
 
@@ -174,9 +206,10 @@ bool IocpTcpClient::Connect(const ClientOps &ops)
 	SetWaitTime(ops.waitTimeMilliSec);
 
 
+	m_connectTimeOutMilliSec=ops.connectTimeOutMilliSec;
+
 	WSADATA wsaData;
 	m_connectSocket=INVALID_SOCKET;
-	struct addrinfo hints;
 	int iResult;
 
 	// Initialize Winsock
@@ -186,43 +219,20 @@ bool IocpTcpClient::Connect(const ClientOps &ops)
 		return false;
 	}
 
-	ZeroMemory( &hints, sizeof(hints) );
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_socktype = SOCK_STREAM;
-	hints.ai_protocol = IPPROTO_TCP;
-
-	// Resolve the server address and port
-	iResult = getaddrinfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
-	if ( iResult != 0 ) {
-		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
-		WSACleanup();
+	m_isConnectCanceled=false;
+	if(ops.isAsynchronousConnect)
+	{
+		// connect on the thread of the client, and report the result to OnConnected
+		m_isConnectPending=true;
+		if(Start())
+			return true;
+		m_isConnectPending=false;
+		cleanUpClient();
 		return false;
 	}
-
-	// Attempt to connect to an address until one succeeds
-	struct addrinfo *iPtr=0;
-	for(iPtr=m_result; iPtr != NULL ;iPtr=iPtr->ai_next) {
-
-		// Create a SOCKET for connecting to server
-		m_connectSocket = socket(iPtr->ai_family, iPtr->ai_socktype, 
-			iPtr->ai_protocol);
-		if (m_connectSocket == INVALID_SOCKET) {
-			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Socket failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
-			cleanUpClient();
-			return false;
-		}
-
-		// Connect to server.
-		iResult = connect( m_connectSocket, iPtr->ai_addr, static_cast<int>(iPtr->ai_addrlen));
-		if (iResult == SOCKET_ERROR) {
-			closesocket(m_connectSocket);
-			m_connectSocket = INVALID_SOCKET;
-			continue;
-		}
-		break;
-	}
-	if (m_connectSocket == INVALID_SOCKET) {
-		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Unable to connect to server!\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+	ConnectStatus status;
+	if(!connectToServer(status))
+	{
 		cleanUpClient();
 		return false;
 	}
@@ -239,8 +249,12 @@ bool IocpTcpClient::IsConnectionAlive() const
 
 void IocpTcpClient::Disconnect()
 {
-	
+	// waits for OnConnected outside the lock, since OnConnected may call the getters taking it, such as GetHostName
+	bool wasConnectPending=cancelConnect();
 	epl::LockObj lock(m_generalLock);
+	// the thread only connects, and is just returning
+	if(wasConnectPending)
+		TerminateAfter(m_waitTime);
 	if(!IsConnectionAlive())
 	{
 		return;
@@ -272,6 +286,7 @@ void IocpTcpClient::Disconnect()
 		EP_DELETE m_workerList.at(trav);
 	}
 	m_workerList.clear();
+	m_runtime=NULL;
 	m_workerLock->Unlock();
 
 	m_callBackObj->OnDisconnect(this);
@@ -296,6 +311,7 @@ void IocpTcpClient::disconnect()
 			EP_DELETE m_workerList.at(trav);
 		}
 		m_workerList.clear();
+		m_runtime=NULL;
 		m_workerLock->Unlock();
 
 		m_callBackObj->OnDisconnect(this);
@@ -419,6 +435,11 @@ void IocpTcpClient::CallBackFunc(BaseWorkerThread *p)
 void IocpTcpClient::pushJob(BaseJob * job)
 {
 	epl::LockObj lock(m_workerLock);
+	if(m_runtime)
+	{
+		m_runtime->PushJob(job);
+		return;
+	}
 	if(m_emptyWorkerList.size())
 	{
 		m_emptyWorkerList.front()->Push(job);
@@ -185,7 +185,7 @@ bool IocpTcpServer::StartServer(const ServerOps &ops)
 
 		m_workerList.push_back(workerThread);
 		m_emptyWorkerList.push(workerThread);
-		workerThread->SetJobProcessor(EP_NEW IocpServerProcessor());
+		workerThread->SetJobProcessor(EP_NEW IocpServerProcessor(ops.bufferPoolFlags));
 		workerThread->Start();
 	}
 	m_workerLock->Unlock();
@@ -196,18 +196,20 @@ bool IocpTcpServer::StartServer(const ServerOps &ops)
 void IocpTcpServer::execute()
 {
 	SOCKET clientSocket;
-	sockaddr sockAddr;
-	int sizeOfSockAddr=sizeof(sockaddr);
+	SOCKADDR_STORAGE sockAddrStorage;
+	sockaddr *sockAddr=reinterpret_cast<sockaddr*>(&sockAddrStorage);
+	int sizeOfSockAddr;
 	while(1)
 	{
-		clientSocket=accept(m_listenSocket,&sockAddr,&sizeOfSockAddr);
+		sizeOfSockAddr=sizeof(SOCKADDR_STORAGE);
+		clientSocket=accept(m_listenSocket,sockAddr,&sizeOfSockAddr);
 		if(clientSocket == INVALID_SOCKET || m_listenSocket== INVALID_SOCKET)
 		{
 			break;			
 		}
 		else
 		{
-			if(!m_callBackObj->OnAccept(sockAddr))
+			if(!m_callBackObj->OnAccept(sockAddr,sizeOfSockAddr))
 			{
 				closesocket(clientSocket);
 				continue;
@@ -219,9 +221,10 @@ void IocpTcpServer::execute()
 				continue;
 			}
 			accWorker->setClientSocket(clientSocket);
-			accWorker->setSockAddr(sockAddr);
+			accWorker->setSockAddr(sockAddr,sizeOfSockAddr);
 
 			accWorker->setOwner(this);
+			accWorker->setMemoryBudget(m_memoryBudget,GetConnectionMemoryBudgetByteSize());
 			m_socketList.Push(accWorker);	
 			accWorker->Start();
 			accWorker->ReleaseObj();
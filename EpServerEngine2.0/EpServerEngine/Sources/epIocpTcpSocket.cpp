@@ -97,6 +97,18 @@ void IocpTcpSocket::killConnectionNoCallBack()
 void IocpTcpSocket::Send(Packet &packet,EventEx *completionEvent,ServerCallbackInterface *callBackObj,Priority priority)
 {
 	IocpServerJob *newJob= EP_NEW IocpServerJob(this,IocpServerJob::IOCP_SERVER_JOB_TYPE_SEND,&packet,completionEvent,callBackObj,priority,m_lockPolicy);
+	// outbound queue is charged to the memory budget until the packet is sent
+	if(!newJob->ChargeMemoryBudget(m_memoryBudget))
+	{
+		newJob->ReleaseObj();
+		if(completionEvent)
+			completionEvent->SetEvent();
+		if(callBackObj)
+			callBackObj->OnSent(this,SEND_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED);
+		else
+			m_callBackObj->OnSent(this,SEND_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED);
+		return;
+	}
 	((IocpTcpServer*)m_owner)->pushJob(newJob);
 	newJob->ReleaseObj();
 }
@@ -157,12 +169,48 @@ Packet *IocpTcpSocket::Receive(unsigned int waitTimeInMilliSec,ReceiveStatus *re
 		return NULL;
 	}
 
+	// memory budget routine
+	unsigned int nextPacketByteSize=0;
+	if(peekPacketByteSize(nextPacketByteSize) && !m_memoryBudget->CanAcquire(nextPacketByteSize))
+	{
+		if(!m_memoryBudget->IsInBudget(nextPacketByteSize))
+		{
+			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded for %d bytes\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,nextPacketByteSize);
+			killConnection();
+		}
+		// otherwise the packet is left in the socket buffer, so the peer is throttled by TCP flow control
+		if(retStatus)
+			*retStatus=RECEIVE_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED;
+		return NULL;
+	}
+
 	// receive routine
 	int iResult =receive(m_recvSizePacket);
 	if(iResult>0)
 	{
 		unsigned int shouldReceive=(reinterpret_cast<unsigned int*>(const_cast<char*>(m_recvSizePacket.GetPacket())))[0];
-		Packet *recvPacket=EP_NEW Packet(NULL,shouldReceive);
+		Packet *recvPacket=NULL;
+		if(m_memoryBudget->CanAcquire(shouldReceive))
+		{
+			// the buffer pool of the worker thread is used if bound
+			BufferPool *bufferPool=BufferPool::GetCurrentPool();
+			recvPacket=EP_NEW Packet(NULL,0);
+			if(!bufferPool || !recvPacket->AllocateFromPool(bufferPool,shouldReceive))
+				recvPacket->SetPacket(NULL,shouldReceive);
+			if(!recvPacket->ChargeMemoryBudget(m_memoryBudget))
+			{
+				recvPacket->ReleaseObj();
+				recvPacket=NULL;
+			}
+		}
+		if(!recvPacket)
+		{
+			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded for %d bytes\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,shouldReceive);
+			killConnection();
+			if(retStatus)
+				*retStatus=RECEIVE_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED;
+			return NULL;
+		}
 		iResult = receive(*recvPacket);
 
 		if (iResult == shouldReceive) {
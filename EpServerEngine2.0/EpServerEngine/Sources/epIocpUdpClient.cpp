@@ -25,6 +25,7 @@ THE SOFTWARE.
 */
 #include "epIocpUdpClient.h"
 #include "epIocpClientProcessor.h"
+#include "epIocpClientRuntime.h"
 #include "epIocpClientJob.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
@@ -55,6 +56,7 @@ IocpUdpClient::IocpUdpClient(epl::LockPolicy lockPolicyType): BaseUdpClient(lock
 	}
 
 	m_isConnected=false;
+	m_runtime=NULL;
 
 }
 
@@ -78,6 +80,7 @@ IocpUdpClient::IocpUdpClient(const IocpUdpClient& b):BaseUdpClient(b)
 	}
 
 	m_isConnected=false;
+	m_runtime=NULL;
 }
 IocpUdpClient::~IocpUdpClient()
 {
@@ -108,6 +111,7 @@ IocpUdpClient & IocpUdpClient::operator=(const IocpUdpClient&b)
 		}
 
 		m_isConnected=false;
+		m_runtime=NULL;
 	}
 	return *this;
 }
@@ -128,21 +132,30 @@ bool IocpUdpClient::Connect(const ClientOps &ops)
 	}
 	m_workerList.clear();
 
-	int workerCount=ops.workerThreadCount;
-	if(workerCount==0)
+	m_runtime=ops.iocpClientRuntime;
+	if(m_runtime)
 	{
-		workerCount=System::GetNumberOfCores()*2;
+		// the jobs run on the shared worker threads, so no thread of its own
+		m_runtime->StartRuntime(ops.workerThreadCount);
 	}
-	for(int trav=0;trav<workerCount;trav++)
+	else
 	{
-		BaseWorkerThread *workerThread=WorkerThreadFactory::GetWorkerThread(BaseWorkerThread::THREAD_LIFE_SUSPEND_AFTER_WORK);
+		int workerCount=ops.workerThreadCount;
+		if(workerCount==0)
+		{
+			workerCount=System::GetNumberOfCores()*2;
+		}
+		for(int trav=0;trav<workerCount;trav++)
+		{
+			BaseWorkerThread *workerThread=WorkerThreadFactory::GetWorkerThread(BaseWorkerThread::THREAD_LIFE_SUSPEND_AFTER_WORK);
 
-		workerThread->SetCallBackClass(this);
+			workerThread->SetCallBackClass(this);
 
-		m_workerList.push_back(workerThread);
-		m_emptyWorkerList.push(workerThread);
-		workerThread->SetJobProcessor(EP_NEW IocpClientProcessor());
-		workerThread->Start();
+			m_workerList.push_back(workerThread);
+			m_emptyWorkerList.push(workerThread);
+			workerThread->SetJobProcessor(EP_NEW IocpClientProcessor());
+			workerThread->Start();
+		}
 	}
 	m_workerLock->Unlock();
 
@@ -192,7 +205,7 @@ bool IocpUdpClient::Connect(const ClientOps &ops)
 	hints.ai_protocol = IPPROTO_UDP;
 
 	// Resolve the server address and port
-	iResult = getaddrinfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
+	iResult = RESOLVER_CACHE_INSTANCE.GetAddrInfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
 	if ( iResult != 0 ) {
 		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
 		WSACleanup();
@@ -220,6 +233,11 @@ bool IocpUdpClient::Connect(const ClientOps &ops)
 
 	int nTmp = sizeof(int);
 	getsockopt(m_connectSocket, SOL_SOCKET,SO_MAX_MSG_SIZE, (char *)&m_maxPacketSize,&nTmp);
+	if(!setUpSession(ops))
+	{
+		cleanUpClient();
+		return false;
+	}
 	m_isConnected=true;
 	return true;
 }
@@ -262,6 +280,7 @@ void IocpUdpClient::Disconnect()
 		EP_DELETE m_workerList.at(trav);
 	}
 	m_workerList.clear();
+	m_runtime=NULL;
 	m_workerLock->Unlock();
 
 
@@ -290,6 +309,7 @@ void IocpUdpClient::disconnect()
 			EP_DELETE m_workerList.at(trav);
 		}
 		m_workerList.clear();
+		m_runtime=NULL;
 		m_workerLock->Unlock();
 
 		m_callBackObj->OnDisconnect(this);		
@@ -328,6 +348,15 @@ Packet *IocpUdpClient::Receive(unsigned int waitTimeInMilliSec,ReceiveStatus *re
 		return NULL;
 	}
 
+	// packets delivered together by the channel layer
+	Packet *channelPacket=popChannelPacket();
+	if(channelPacket)
+	{
+		if(retStatus)
+			*retStatus=RECEIVE_STATUS_SUCCESS;
+		return channelPacket;
+	}
+
 	// select routine
 	TIMEVAL	timeOutVal;
 	fd_set	fdSet;
@@ -363,14 +392,31 @@ Packet *IocpUdpClient::Receive(unsigned int waitTimeInMilliSec,ReceiveStatus *re
 	}
 
 	int iResult=0;
+	bool isMoveNotice=false;
 	Packet recvPacket(NULL,m_maxPacketSize);
-	iResult = receive(recvPacket);
+	iResult = receive(recvPacket,isMoveNotice);
 
 	if (iResult > 0) {
-		Packet *passPacket=EP_NEW Packet(recvPacket.GetPacket(),iResult);
+		vector<Packet*> packetList;
+		unpackDatagram(recvPacket.GetPacket(),iResult,packetList);
+		if(packetList.empty())
+		{
+			// acknowledgement only, or not deliverable yet
+			if(retStatus)
+				*retStatus=RECEIVE_STATUS_FAIL_TIME_OUT;
+			return NULL;
+		}
+		pushChannelPackets(packetList,1);
 		if(retStatus)
 			*retStatus=RECEIVE_STATUS_SUCCESS;
-		return passPacket;
+		return packetList.at(0);
+	}
+	else if (isMoveNotice)
+	{
+		// the session moved to another port of the server
+		if(retStatus)
+			*retStatus=RECEIVE_STATUS_FAIL_TIME_OUT;
+		return NULL;
 	}
 	else if (iResult == 0)
 	{
@@ -399,6 +445,11 @@ void IocpUdpClient::CallBackFunc(BaseWorkerThread *p)
 void IocpUdpClient::pushJob(BaseJob * job)
 {
 	epl::LockObj lock(m_workerLock);
+	if(m_runtime)
+	{
+		m_runtime->PushJob(job);
+		return;
+	}
 	if(m_emptyWorkerList.size())
 	{
 		m_emptyWorkerList.front()->Push(job);
@@ -185,7 +185,7 @@ bool IocpUdpServer::StartServer(const ServerOps &ops)
 
 		m_workerList.push_back(workerThread);
 		m_emptyWorkerList.push(workerThread);
-		workerThread->SetJobProcessor(EP_NEW IocpServerProcessor());
+		workerThread->SetJobProcessor(EP_NEW IocpServerProcessor(ops.bufferPoolFlags));
 		workerThread->Start();
 	}
 	m_workerLock->Unlock();
@@ -193,66 +193,45 @@ bool IocpUdpServer::StartServer(const ServerOps &ops)
 	return BaseUdpServer::StartServer(ops);
 }
 
-void IocpUdpServer::execute()
+void IocpUdpServer::handleDatagram(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize)
 {
-	Packet recvPacket(NULL,m_maxPacketSize);
-	char *packetData=const_cast<char*>(recvPacket.GetPacket());
-	int length=recvPacket.GetPacketByteSize();
-	sockaddr clientSockAddr;
-	int sockAddrSize=sizeof(sockaddr);
-	while(m_listenSocket!=INVALID_SOCKET)
+	IocpUdpSocket *workerObj=(IocpUdpSocket*)m_sessionTable.Find(clientAddress);
+	if(workerObj)
 	{
-		int recvLength=recvfrom(m_listenSocket,packetData,length, 0,&clientSockAddr,&sockAddrSize);
-
-		IocpUdpSocket *workerObj=(IocpUdpSocket*)m_socketList.Find(clientSockAddr,socketCompare);
-		if(workerObj)
+		deliverPacket(workerObj,packetData,recvLength,segmentByteSize);
+		workerObj->ReleaseObj();
+	}
+	else
+	{
+		if(recvLength<=0)
+			return;
+		// a client is handled in one shard at a time, so the lock is just for the connection count
+		ScopedLock<RuntimeLockPolicy> acceptLock(m_acceptLock);
+		if(GetMaximumConnectionCount()!=CONNECTION_LIMIT_INFINITE)
 		{
-			if(recvLength<=0)
+			if(m_socketList.Count()>=GetMaximumConnectionCount())
 			{
-				Packet *passPacket=EP_NEW Packet(packetData,0);
-				workerObj->addPacket(passPacket);
-				passPacket->ReleaseObj();
-				continue;
-			}	
-			Packet *passPacket=EP_NEW Packet(packetData,recvLength);
-			workerObj->addPacket(passPacket);
-			passPacket->ReleaseObj();
+				return;
+			}
 		}
-		else
+		if(!m_callBackObj->OnAccept(clientAddress.GetSockAddr(),clientAddress.GetSockAddrSize()))
 		{
-			if(recvLength<=0)
-				continue;
-			if(GetMaximumConnectionCount()!=CONNECTION_LIMIT_INFINITE)
-			{
-				if(m_socketList.Count()>=GetMaximumConnectionCount())
-				{
-					continue;
-				}
-			}
-			if(!m_callBackObj->OnAccept(clientSockAddr))
-			{
-				continue;
-			}
-			/// Create Worker Thread
-			IocpUdpSocket *accWorker=EP_NEW IocpUdpSocket(m_callBackObj,m_waitTime,m_lockPolicy);
-			if(!accWorker)
-			{
-				continue;
-			}
-			Packet *passPacket=EP_NEW Packet(packetData,recvLength);
-			accWorker->setSockAddr(clientSockAddr);
-			accWorker->setOwner(this);
-			accWorker->setMaxPacketByteSize(m_maxPacketSize);
-			m_socketList.Push(accWorker);
-			accWorker->Start();
-			accWorker->addPacket(passPacket);
-			accWorker->ReleaseObj();
-			passPacket->ReleaseObj();
-
+			return;
 		}
+		/// Create Worker Thread
+		IocpUdpSocket *accWorker=EP_NEW IocpUdpSocket(m_callBackObj,m_waitTime,m_lockPolicy);
+		if(!accWorker)
+		{
+			return;
+		}
+		addSession(accWorker,clientAddress);
+		// notified on the worker pool, so the session holds no thread
+		IocpServerJob *connectJob=EP_NEW IocpServerJob(accWorker,IocpServerJob::IOCP_SERVER_JOB_TYPE_CONNECT,NULL,NULL,NULL,PRIORITY_NORMAL,m_lockPolicy);
+		pushJob(connectJob);
+		connectJob->ReleaseObj();
+		deliverPacket(accWorker,packetData,recvLength,segmentByteSize);
+		accWorker->ReleaseObj();
 
 	}
-
-	stopServer();
-} 
+}
 
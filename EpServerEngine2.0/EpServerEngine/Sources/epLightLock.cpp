@@ -0,0 +1,420 @@
+/*! 
+LightLock for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epLightLock.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+// WaitOnAddress functions are loaded at runtime to keep the older Windows supported
+typedef BOOL (WINAPI *WaitOnAddressFunc)(volatile VOID*,PVOID,SIZE_T,DWORD);
+typedef VOID (WINAPI *WakeByAddressFunc)(PVOID);
+
+/*! 
+@struct AddressWaitFunctions epLightLock.cpp
+@brief A class holding the WaitOnAddress functions if available.
+*/
+struct AddressWaitFunctions{
+	/// WaitOnAddress
+	WaitOnAddressFunc m_waitOnAddress;
+	/// WakeByAddressSingle
+	WakeByAddressFunc m_wakeByAddressSingle;
+	/// WakeByAddressAll
+	WakeByAddressFunc m_wakeByAddressAll;
+	AddressWaitFunctions()
+	{
+		m_waitOnAddress=NULL;
+		m_wakeByAddressSingle=NULL;
+		m_wakeByAddressAll=NULL;
+		HMODULE synchModule=LoadLibrary(_T("api-ms-win-core-synch-l1-2-0.dll"));
+		if(!synchModule)
+			return;
+		m_waitOnAddress=reinterpret_cast<WaitOnAddressFunc>(GetProcAddress(synchModule,"WaitOnAddress"));
+		m_wakeByAddressSingle=reinterpret_cast<WakeByAddressFunc>(GetProcAddress(synchModule,"WakeByAddressSingle"));
+		m_wakeByAddressAll=reinterpret_cast<WakeByAddressFunc>(GetProcAddress(synchModule,"WakeByAddressAll"));
+		if(!m_waitOnAddress || !m_wakeByAddressSingle || !m_wakeByAddressAll)
+		{
+			m_waitOnAddress=NULL;
+			m_wakeByAddressSingle=NULL;
+			m_wakeByAddressAll=NULL;
+		}
+	}
+	bool IsAvailable() const
+	{
+		return (m_waitOnAddress!=NULL);
+	}
+};
+static AddressWaitFunctions s_addressWaitFunctions;
+
+static unsigned int getRemainingTime(DWORD startTick,unsigned int waitTimeMilliSec)
+{
+	if(waitTimeMilliSec==WAITTIME_INIFINITE)
+		return WAITTIME_INIFINITE;
+	DWORD elapsed=GetTickCount()-startTick;
+	if(elapsed>=waitTimeMilliSec)
+		return 0;
+	return waitTimeMilliSec-elapsed;
+}
+
+LightParker::LightParker()
+{
+	m_waiterCount=0;
+	m_semaphore=NULL;
+	if(!s_addressWaitFunctions.IsAvailable())
+		m_semaphore=CreateSemaphore(NULL,0,LONG_MAX,NULL);
+}
+
+LightParker::~LightParker()
+{
+	if(m_semaphore)
+		CloseHandle(m_semaphore);
+	m_semaphore=NULL;
+}
+
+bool LightParker::Park(volatile LONG *address,LONG compareValue,unsigned int waitTimeMilliSec)
+{
+	// the waiter count must be visible before re-checking the value
+	InterlockedIncrement(&m_waiterCount);
+	if(*address!=compareValue)
+	{
+		InterlockedDecrement(&m_waiterCount);
+		return true;
+	}
+	bool retVal=true;
+	if(s_addressWaitFunctions.IsAvailable())
+	{
+		if(!s_addressWaitFunctions.m_waitOnAddress(address,&compareValue,sizeof(LONG),waitTimeMilliSec))
+			retVal=(GetLastError()!=ERROR_TIMEOUT);
+	}
+	else
+	{
+		retVal=(WaitForSingleObject(m_semaphore,waitTimeMilliSec)==WAIT_OBJECT_0);
+	}
+	InterlockedDecrement(&m_waiterCount);
+	return retVal;
+}
+
+void LightParker::Unpark(volatile LONG *address,bool shouldWakeAll)
+{
+	LONG waiterCount=m_waiterCount;
+	if(!waiterCount)
+		return;
+	if(s_addressWaitFunctions.IsAvailable())
+	{
+		if(shouldWakeAll)
+			s_addressWaitFunctions.m_wakeByAddressAll(const_cast<LONG*>(address));
+		else
+			s_addressWaitFunctions.m_wakeByAddressSingle(const_cast<LONG*>(address));
+	}
+	else
+	{
+		// surplus releases only cause spurious returns from Park
+		ReleaseSemaphore(m_semaphore,shouldWakeAll?waiterCount:1,NULL);
+	}
+}
+
+LightMutex::LightMutex():BaseLock()
+{
+	m_state=0;
+	m_ownerThreadID=0;
+	m_recursionCount=0;
+}
+
+LightMutex::LightMutex(const LightMutex& b):BaseLock()
+{
+	m_state=0;
+	m_ownerThreadID=0;
+	m_recursionCount=0;
+}
+
+LightMutex::~LightMutex()
+{
+}
+
+bool LightMutex::Lock()
+{
+	return (TryLockFor(WAITTIME_INIFINITE)!=0);
+}
+
+long LightMutex::TryLock()
+{
+	return TryLockFor(WAITTIME_IGNORE);
+}
+
+long LightMutex::TryLockFor(const unsigned int dwMilliSecond)
+{
+	DWORD threadID=GetCurrentThreadId();
+	if(m_ownerThreadID==threadID)
+	{
+		m_recursionCount++;
+		return true;
+	}
+
+	bool isLocked=(InterlockedCompareExchange(&m_state,1,0)==0);
+	for(unsigned int spinTrav=0;!isLocked && spinTrav<LIGHT_LOCK_SPIN_COUNT;spinTrav++)
+	{
+		YieldProcessor();
+		if(m_state==0)
+			isLocked=(InterlockedCompareExchange(&m_state,1,0)==0);
+	}
+
+	if(!isLocked)
+	{
+		if(dwMilliSecond==WAITTIME_IGNORE)
+			return false;
+		DWORD startTick=GetTickCount();
+		// mark as contended, so the owner unparks on Unlock
+		while(InterlockedExchange(&m_state,2)!=0)
+		{
+			unsigned int remainingTime=getRemainingTime(startTick,dwMilliSecond);
+			if(remainingTime==0)
+				return false;
+			m_parker.Park(&m_state,2,remainingTime);
+		}
+	}
+	m_ownerThreadID=threadID;
+	m_recursionCount=1;
+	return true;
+}
+
+void LightMutex::Unlock()
+{
+	EP_ASSERT(m_ownerThreadID==GetCurrentThreadId());
+	if(--m_recursionCount>0)
+		return;
+	m_ownerThreadID=0;
+	if(InterlockedExchange(&m_state,0)==2)
+		m_parker.Unpark(&m_state,false);
+}
+
+LightEvent::LightEvent(bool isInitialRaised,bool isManualReset):BaseLock()
+{
+	m_state=isInitialRaised?1:0;
+	m_isManualReset=isManualReset;
+}
+
+LightEvent::LightEvent(const LightEvent& b):BaseLock()
+{
+	m_state=b.m_state;
+	m_isManualReset=b.m_isManualReset;
+}
+
+LightEvent::~LightEvent()
+{
+}
+
+LightEvent & LightEvent::operator=(const LightEvent&b)
+{
+	if(this!=&b)
+	{
+		m_isManualReset=b.m_isManualReset;
+		if(b.m_state)
+			SetEvent();
+		else
+			ResetEvent();
+	}
+	return *this;
+}
+
+bool LightEvent::Lock()
+{
+	return WaitForEvent(WAITTIME_INIFINITE);
+}
+
+long LightEvent::TryLock()
+{
+	return WaitForEvent(WAITTIME_IGNORE);
+}
+
+long LightEvent::TryLockFor(const unsigned int dwMilliSecond)
+{
+	return WaitForEvent(dwMilliSecond);
+}
+
+void LightEvent::Unlock()
+{
+	SetEvent();
+}
+
+bool LightEvent::ResetEvent()
+{
+	InterlockedExchange(&m_state,0);
+	return true;
+}
+
+bool LightEvent::SetEvent()
+{
+	if(InterlockedExchange(&m_state,1)==0)
+		m_parker.Unpark(&m_state,m_isManualReset);
+	return true;
+}
+
+bool LightEvent::IsManualReset() const
+{
+	return m_isManualReset;
+}
+
+bool LightEvent::tryConsume()
+{
+	if(m_isManualReset)
+		return (m_state==1);
+	return (InterlockedCompareExchange(&m_state,0,1)==1);
+}
+
+bool LightEvent::WaitForEvent(const unsigned int dwMilliSecond)
+{
+	if(tryConsume())
+		return true;
+	for(unsigned int spinTrav=0;spinTrav<LIGHT_LOCK_SPIN_COUNT;spinTrav++)
+	{
+		YieldProcessor();
+		if(m_state==1 && tryConsume())
+			return true;
+	}
+	if(dwMilliSecond==WAITTIME_IGNORE)
+		return false;
+
+	DWORD startTick=GetTickCount();
+	while(!tryConsume())
+	{
+		unsigned int remainingTime=getRemainingTime(startTick,dwMilliSecond);
+		if(remainingTime==0)
+			return false;
+		m_parker.Park(&m_state,0,remainingTime);
+	}
+	return true;
+}
+
+LightSemaphore::LightSemaphore(long count):BaseLock()
+{
+	EP_ASSERT(count>0);
+	m_count=count;
+	m_maxCount=count;
+}
+
+LightSemaphore::LightSemaphore(long count,long initialCount):BaseLock()
+{
+	EP_ASSERT(count>0 && initialCount>=0 && initialCount<=count);
+	m_count=initialCount;
+	m_maxCount=count;
+}
+
+LightSemaphore::LightSemaphore(const LightSemaphore& b):BaseLock()
+{
+	m_count=b.m_count;
+	m_maxCount=b.m_maxCount;
+}
+
+LightSemaphore::~LightSemaphore()
+{
+}
+
+LightSemaphore & LightSemaphore::operator=(const LightSemaphore&b)
+{
+	if(this!=&b)
+	{
+		m_maxCount=b.m_maxCount;
+		LONG prevCount=InterlockedExchange(&m_count,b.m_count);
+		if(prevCount==0 && b.m_count>0)
+			m_parker.Unpark(&m_count,true);
+	}
+	return *this;
+}
+
+bool LightSemaphore::Lock()
+{
+	return (TryLockFor(WAITTIME_INIFINITE)!=0);
+}
+
+long LightSemaphore::TryLock()
+{
+	return TryLockFor(WAITTIME_IGNORE);
+}
+
+bool LightSemaphore::tryAcquire()
+{
+	LONG count=m_count;
+	while(count>0)
+	{
+		LONG prevCount=InterlockedCompareExchange(&m_count,count-1,count);
+		if(prevCount==count)
+			return true;
+		count=prevCount;
+	}
+	return false;
+}
+
+long LightSemaphore::TryLockFor(const unsigned int dwMilliSecond)
+{
+	if(tryAcquire())
+		return true;
+	for(unsigned int spinTrav=0;spinTrav<LIGHT_LOCK_SPIN_COUNT;spinTrav++)
+	{
+		YieldProcessor();
+		if(m_count>0 && tryAcquire())
+			return true;
+	}
+	if(dwMilliSecond==WAITTIME_IGNORE)
+		return false;
+
+	DWORD startTick=GetTickCount();
+	while(!tryAcquire())
+	{
+		unsigned int remainingTime=getRemainingTime(startTick,dwMilliSecond);
+		if(remainingTime==0)
+			return false;
+		m_parker.Park(&m_count,0,remainingTime);
+	}
+	return true;
+}
+
+void LightSemaphore::Unlock()
+{
+	Release(1);
+}
+
+long LightSemaphore::Release(long releaseCount, long * retPreviousCount)
+{
+	EP_ASSERT(releaseCount>0);
+	LONG count=m_count;
+	while(1)
+	{
+		if(count+releaseCount>m_maxCount)
+			return 0;
+		LONG prevCount=InterlockedCompareExchange(&m_count,count+releaseCount,count);
+		if(prevCount==count)
+			break;
+		count=prevCount;
+	}
+	if(retPreviousCount)
+		*retPreviousCount=count;
+	m_parker.Unpark(&m_count,releaseCount>1);
+	return 1;
+}
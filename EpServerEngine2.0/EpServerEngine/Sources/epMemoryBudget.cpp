@@ -0,0 +1,149 @@
+/*! 
+MemoryBudget for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epMemoryBudget.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+MemoryBudget::MemoryBudget(size_t budgetByteSize,MemoryBudget *parent,epl::LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_budgetLock(lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	m_budgetByteSize=budgetByteSize;
+	m_usedByteSize=0;
+	m_peakByteSize=0;
+	m_rejectedCount=0;
+	m_parent=parent;
+	if(m_parent)
+		m_parent->RetainObj();
+}
+
+MemoryBudget::~MemoryBudget()
+{
+	EP_ASSERT(m_usedByteSize==0);
+	if(m_parent)
+		m_parent->ReleaseObj();
+	m_parent=NULL;
+}
+
+bool MemoryBudget::Acquire(size_t byteSize)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	if(m_budgetByteSize!=MEMORY_BUDGET_INFINITE && (byteSize>m_budgetByteSize || m_usedByteSize>m_budgetByteSize-byteSize))
+	{
+		m_rejectedCount++;
+		return false;
+	}
+	// lock order is always child to parent
+	if(m_parent && !m_parent->Acquire(byteSize))
+	{
+		m_rejectedCount++;
+		return false;
+	}
+	m_usedByteSize+=byteSize;
+	if(m_usedByteSize>m_peakByteSize)
+		m_peakByteSize=m_usedByteSize;
+	return true;
+}
+
+void MemoryBudget::Release(size_t byteSize)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	EP_ASSERT(m_usedByteSize>=byteSize);
+	m_usedByteSize-=byteSize;
+	if(m_parent)
+		m_parent->Release(byteSize);
+}
+
+bool MemoryBudget::CanAcquire(size_t byteSize) const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	if(m_budgetByteSize!=MEMORY_BUDGET_INFINITE && (byteSize>m_budgetByteSize || m_usedByteSize>m_budgetByteSize-byteSize))
+		return false;
+	if(m_parent)
+		return m_parent->CanAcquire(byteSize);
+	return true;
+}
+
+bool MemoryBudget::IsInBudget(size_t byteSize) const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	if(m_budgetByteSize!=MEMORY_BUDGET_INFINITE && byteSize>m_budgetByteSize)
+		return false;
+	if(m_parent)
+		return m_parent->IsInBudget(byteSize);
+	return true;
+}
+
+void MemoryBudget::SetBudgetByteSize(size_t budgetByteSize)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	m_budgetByteSize=budgetByteSize;
+}
+
+size_t MemoryBudget::GetBudgetByteSize() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	return m_budgetByteSize;
+}
+
+size_t MemoryBudget::GetUsedByteSize() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	return m_usedByteSize;
+}
+
+size_t MemoryBudget::GetPeakByteSize() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	return m_peakByteSize;
+}
+
+unsigned int MemoryBudget::GetRejectedCount() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	return m_rejectedCount;
+}
+
+void MemoryBudget::SetParent(MemoryBudget *parent)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_budgetLock);
+	EP_ASSERT(m_usedByteSize==0);
+	if(parent)
+		parent->RetainObj();
+	if(m_parent)
+		m_parent->ReleaseObj();
+	m_parent=parent;
+}
+
+MemoryBudget *MemoryBudget::GetParent() const
+{
+	return m_parent;
+}
@@ -0,0 +1,188 @@
+/*! 
+MessageArena for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epMessageArena.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+/*! 
+@struct ArenaTlsIndex epMessageArena.cpp
+@brief A class holding the TLS index for the arena of the current dispatch.
+*/
+struct ArenaTlsIndex{
+	/// TLS index
+	DWORD m_index;
+	ArenaTlsIndex()
+	{
+		m_index=TlsAlloc();
+	}
+	~ArenaTlsIndex()
+	{
+		if(m_index!=TLS_OUT_OF_INDEXES)
+			TlsFree(m_index);
+	}
+};
+static ArenaTlsIndex s_arenaTlsIndex;
+
+MessageArena::MessageArena(unsigned int blockByteSize)
+{
+	m_firstBlock=NULL;
+	m_currentBlock=NULL;
+	m_cursor=NULL;
+	m_end=NULL;
+	m_blockByteSize=blockByteSize;
+	m_usedByteSize=0;
+}
+
+MessageArena::~MessageArena()
+{
+	ArenaBlock *block=m_firstBlock;
+	while(block)
+	{
+		ArenaBlock *nextBlock=block->m_next;
+		EP_Free(block);
+		block=nextBlock;
+	}
+	m_firstBlock=NULL;
+	m_currentBlock=NULL;
+}
+
+bool MessageArena::addBlock(unsigned int byteSize)
+{
+	if(byteSize<m_blockByteSize)
+		byteSize=m_blockByteSize;
+	ArenaBlock *newBlock=reinterpret_cast<ArenaBlock*>(EP_Malloc(sizeof(ArenaBlock)+byteSize));
+	if(!newBlock)
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Allocation failed for %d bytes\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,byteSize);
+		return false;
+	}
+	newBlock->m_next=NULL;
+	newBlock->m_byteSize=byteSize;
+	if(m_currentBlock)
+		m_currentBlock->m_next=newBlock;
+	else
+		m_firstBlock=newBlock;
+	m_currentBlock=newBlock;
+	m_cursor=reinterpret_cast<char*>(newBlock+1);
+	m_end=m_cursor+byteSize;
+	return true;
+}
+
+void *MessageArena::Allocate(unsigned int byteSize,unsigned int alignment)
+{
+	EP_ASSERT(alignment && (alignment&(alignment-1))==0);
+	if(m_cursor)
+	{
+		char *alignedCursor=reinterpret_cast<char*>((reinterpret_cast<size_t>(m_cursor)+alignment-1)&~(static_cast<size_t>(alignment)-1));
+		if(alignedCursor<=m_end && static_cast<size_t>(m_end-alignedCursor)>=byteSize)
+		{
+			m_cursor=alignedCursor+byteSize;
+			m_usedByteSize+=byteSize;
+			return alignedCursor;
+		}
+	}
+	if(byteSize>UINT_MAX-alignment-sizeof(ArenaBlock))
+		return NULL;
+	// the block is padded by the alignment, so the retry always fits
+	if(!addBlock(byteSize+alignment))
+		return NULL;
+	return Allocate(byteSize,alignment);
+}
+
+void MessageArena::Reset()
+{
+	if(!m_firstBlock)
+		return;
+	// keep only the first block of the normal size, so the steady state does not touch the heap
+	ArenaBlock *block=m_firstBlock->m_next;
+	while(block)
+	{
+		ArenaBlock *nextBlock=block->m_next;
+		EP_Free(block);
+		block=nextBlock;
+	}
+	m_usedByteSize=0;
+	if(m_firstBlock->m_byteSize>m_blockByteSize)
+	{
+		EP_Free(m_firstBlock);
+		m_firstBlock=NULL;
+		m_currentBlock=NULL;
+		m_cursor=NULL;
+		m_end=NULL;
+		return;
+	}
+	m_firstBlock->m_next=NULL;
+	m_currentBlock=m_firstBlock;
+	m_cursor=reinterpret_cast<char*>(m_firstBlock+1);
+	m_end=m_cursor+m_firstBlock->m_byteSize;
+}
+
+unsigned int MessageArena::GetUsedByteSize() const
+{
+	return m_usedByteSize;
+}
+
+unsigned int MessageArena::GetBlockByteSize() const
+{
+	return m_blockByteSize;
+}
+
+MessageArena *MessageArena::GetCurrentArena()
+{
+	if(s_arenaTlsIndex.m_index==TLS_OUT_OF_INDEXES)
+		return NULL;
+	return reinterpret_cast<MessageArena*>(TlsGetValue(s_arenaTlsIndex.m_index));
+}
+
+void MessageArena::setCurrentArena(MessageArena *arena)
+{
+	if(s_arenaTlsIndex.m_index==TLS_OUT_OF_INDEXES)
+		return;
+	TlsSetValue(s_arenaTlsIndex.m_index,arena);
+}
+
+MessageArenaScope::MessageArenaScope(MessageArena *arena)
+{
+	m_arena=arena;
+	m_prevArena=MessageArena::GetCurrentArena();
+	if(m_arena)
+		MessageArena::setCurrentArena(m_arena);
+}
+
+MessageArenaScope::~MessageArenaScope()
+{
+	if(m_arena)
+	{
+		m_arena->Reset();
+		MessageArena::setCurrentArena(m_prevArena);
+	}
+}
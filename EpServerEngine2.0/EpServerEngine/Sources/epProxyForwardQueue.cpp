@@ -0,0 +1,189 @@
+/*! 
+ProxyForwardQueue for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyForwardQueue.h"
+#include "epBaseProxyHandler.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+ProxyForwardQueue::ProxyForwardQueue(BaseProxyHandler *handler,bool isFromClient,epl::LockPolicy lockPolicyType):m_queueLock(lockPolicyType)
+{
+	m_handler=handler;
+	m_isFromClient=isFromClient;
+	m_worker=NULL;
+	m_queuedByteSize=0;
+	m_highWatermarkByteSize=PROXY_FORWARD_HIGH_WATERMARK_BYTE_SIZE;
+	m_lowWatermarkByteSize=PROXY_FORWARD_LOW_WATERMARK_BYTE_SIZE;
+	m_isOpened=false;
+	m_drainEvent=LightEvent(true,true);
+	m_emptyEvent=LightEvent(true,true);
+	m_isScheduled=false;
+	m_isForwarding=false;
+	m_isUnscheduled=false;
+	m_idleEvent=LightEvent(true,true);
+}
+
+ProxyForwardQueue::~ProxyForwardQueue()
+{
+	Close();
+}
+
+bool ProxyForwardQueue::Open(ProxyForwardWorker *worker,unsigned int highWatermarkByteSize,unsigned int lowWatermarkByteSize)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+	if(m_isOpened)
+		return true;
+	if(m_worker)
+		return false;
+	m_worker=worker;
+	m_highWatermarkByteSize=highWatermarkByteSize;
+	m_lowWatermarkByteSize=lowWatermarkByteSize;
+	if(m_lowWatermarkByteSize>m_highWatermarkByteSize)
+		m_lowWatermarkByteSize=m_highWatermarkByteSize;
+	m_isOpened=true;
+	m_drainEvent.SetEvent();
+	m_emptyEvent.SetEvent();
+	return true;
+}
+
+bool ProxyForwardQueue::Close(unsigned int waitTimeInMilliSec)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+		if(!m_worker)
+			return true;
+		m_isOpened=false;
+	}
+	m_drainEvent.SetEvent();
+	m_emptyEvent.SetEvent();
+	clear();
+
+	if(m_worker->unschedule(this))
+		return true;
+	bool isIdle=m_idleEvent.WaitForEvent(waitTimeInMilliSec);
+	// the worker raises the event under its lock, and does not touch the queue after releasing it
+	ScopedLock<RuntimeLockPolicy> lock(m_worker->m_workerLock);
+	return isIdle;
+}
+
+bool ProxyForwardQueue::Push(const Packet *packet,unsigned int waitTimeInMilliSec)
+{
+	unsigned int packetByteSize=packet->GetPacketByteSize();
+	Packet *queuedPacket=const_cast<Packet*>(packet);
+	queuedPacket->RetainObj();
+	bool isFirst;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+		if(!m_isOpened)
+		{
+			queuedPacket->ReleaseObj();
+			return false;
+		}
+		m_queue.push_back(queuedPacket);
+		m_queuedByteSize+=packetByteSize;
+		m_emptyEvent.ResetEvent();
+		if(m_queuedByteSize>=m_highWatermarkByteSize)
+			m_drainEvent.ResetEvent();
+		// otherwise the worker is forwarding the queue already, or has it listed
+		isFirst=(m_queue.size()==1);
+	}
+	if(isFirst)
+		m_worker->schedule(this);
+
+	// over the high watermark, this thread stops receiving from its peer until drained to the low watermark
+	if(!m_drainEvent.WaitForEvent(waitTimeInMilliSec))
+		return false;
+	ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+	return m_isOpened;
+}
+
+bool ProxyForwardQueue::Flush(unsigned int waitTimeInMilliSec)
+{
+	return m_emptyEvent.WaitForEvent(waitTimeInMilliSec);
+}
+
+unsigned int ProxyForwardQueue::GetQueuedByteSize() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+	return m_queuedByteSize;
+}
+
+ProxyForwardQueue::ForwardStatus ProxyForwardQueue::forward()
+{
+	for(unsigned int packetTrav=0;packetTrav<PROXY_FORWARD_BATCH_COUNT;packetTrav++)
+	{
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+			if(!m_isOpened || !m_queue.size())
+				return FORWARD_STATUS_EMPTY;
+		}
+		// the peer not taking the data is checked again later, instead of blocking the worker on it
+		if(!m_handler->isWritable(m_isFromClient))
+			return FORWARD_STATUS_BLOCKED;
+
+		Packet *packet;
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+			if(!m_isOpened || !m_queue.size())
+				return FORWARD_STATUS_EMPTY;
+			packet=m_queue.front();
+			m_queue.pop_front();
+		}
+
+		if(m_isFromClient)
+			m_handler->forwardFromClient(packet);
+		else
+			m_handler->forwardFromForwardServer(NULL,packet);
+
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+			m_queuedByteSize-=packet->GetPacketByteSize();
+			if(m_queuedByteSize<=m_lowWatermarkByteSize)
+				m_drainEvent.SetEvent();
+			if(!m_queuedByteSize)
+				m_emptyEvent.SetEvent();
+		}
+		packet->ReleaseObj();
+	}
+	return FORWARD_STATUS_MORE;
+}
+
+void ProxyForwardQueue::clear()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_queueLock);
+	// the packet being forwarded is taken off by the worker
+	while(m_queue.size())
+	{
+		m_queuedByteSize-=m_queue.front()->GetPacketByteSize();
+		m_queue.front()->ReleaseObj();
+		m_queue.pop_front();
+	}
+}
@@ -0,0 +1,193 @@
+/*! 
+ProxyForwardWorker for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyForwardWorker.h"
+#include "epProxyForwardQueue.h"
+#include <algorithm>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+ProxyForwardWorker::ProxyForwardWorker(epl::LockPolicy lockPolicyType):m_workerLock(lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	m_retryTick=0;
+	m_isStarted=false;
+	m_wakeEvent=LightEvent(false,false);
+}
+
+ProxyForwardWorker::~ProxyForwardWorker()
+{
+	StopWorker();
+}
+
+bool ProxyForwardWorker::StartWorker(unsigned int workerCount)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	if(m_isStarted)
+		return true;
+	if(workerCount==0)
+		workerCount=epl::System::GetNumberOfCores();
+	m_isStarted=true;
+	for(unsigned int workerTrav=0;workerTrav<workerCount;workerTrav++)
+	{
+		ForwardThread *thread=EP_NEW ForwardThread(this,m_lockPolicy);
+		m_threadList.push_back(thread);
+		thread->Start();
+	}
+	return true;
+}
+
+void ProxyForwardWorker::StopWorker(unsigned int waitTimeInMilliSec)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+		if(!m_isStarted)
+			return;
+		m_isStarted=false;
+	}
+	// each thread stopping wakes the next one
+	m_wakeEvent.SetEvent();
+	for(size_t threadTrav=0;threadTrav<m_threadList.size();threadTrav++)
+	{
+		m_threadList[threadTrav]->TerminateAfter(waitTimeInMilliSec);
+		EP_DELETE m_threadList[threadTrav];
+	}
+	m_threadList.clear();
+
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	for(size_t queueTrav=0;queueTrav<m_readyList.size();queueTrav++)
+		m_readyList[queueTrav]->m_isScheduled=false;
+	for(size_t queueTrav=0;queueTrav<m_blockedList.size();queueTrav++)
+		m_blockedList[queueTrav]->m_isScheduled=false;
+	m_readyList.clear();
+	m_blockedList.clear();
+}
+
+bool ProxyForwardWorker::IsWorkerStarted() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	return m_isStarted;
+}
+
+void ProxyForwardWorker::forwardQueues()
+{
+	while(true)
+	{
+		ProxyForwardQueue *queue=NULL;
+		bool isBlocked;
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+			if(!m_isStarted)
+			{
+				m_wakeEvent.SetEvent();
+				break;
+			}
+			if(m_blockedList.size() && GetTickCount()-m_retryTick>=PROXY_FORWARD_RETRY_MILLISEC)
+			{
+				m_readyList.insert(m_readyList.end(),m_blockedList.begin(),m_blockedList.end());
+				m_blockedList.clear();
+			}
+			if(m_readyList.size())
+			{
+				queue=m_readyList.front();
+				m_readyList.pop_front();
+				queue->m_isScheduled=false;
+				queue->m_isForwarding=true;
+				// another thread takes the next queue meanwhile
+				if(m_readyList.size())
+					m_wakeEvent.SetEvent();
+			}
+			isBlocked=(m_blockedList.size()>0);
+		}
+		if(!queue)
+		{
+			if(isBlocked)
+				m_wakeEvent.WaitForEvent(PROXY_FORWARD_RETRY_MILLISEC);
+			else
+				m_wakeEvent.WaitForEvent();
+			continue;
+		}
+
+		ProxyForwardQueue::ForwardStatus status=queue->forward();
+
+		ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+		queue->m_isForwarding=false;
+		if(queue->m_isUnscheduled)
+		{
+			// the queue might be deleted once the lock is released
+			queue->m_idleEvent.SetEvent();
+			continue;
+		}
+		if(status==ProxyForwardQueue::FORWARD_STATUS_BLOCKED)
+		{
+			if(!m_blockedList.size())
+				m_retryTick=GetTickCount();
+			m_blockedList.push_back(queue);
+			queue->m_isScheduled=true;
+		}
+		else if(status==ProxyForwardQueue::FORWARD_STATUS_MORE || queue->m_isScheduled)
+		{
+			// behind the other queues ready, so a busy session does not starve them
+			m_readyList.push_back(queue);
+			queue->m_isScheduled=true;
+			m_wakeEvent.SetEvent();
+		}
+	}
+}
+
+void ProxyForwardWorker::schedule(ProxyForwardQueue *queue)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	if(queue->m_isScheduled || queue->m_isUnscheduled)
+		return;
+	queue->m_isScheduled=true;
+	// listed by the thread forwarding it, once done
+	if(queue->m_isForwarding)
+		return;
+	m_readyList.push_back(queue);
+	m_wakeEvent.SetEvent();
+}
+
+bool ProxyForwardWorker::unschedule(ProxyForwardQueue *queue)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_workerLock);
+	queue->m_isUnscheduled=true;
+	if(queue->m_isScheduled && !queue->m_isForwarding)
+	{
+		m_readyList.erase(remove(m_readyList.begin(),m_readyList.end(),queue),m_readyList.end());
+		m_blockedList.erase(remove(m_blockedList.begin(),m_blockedList.end(),queue),m_blockedList.end());
+	}
+	queue->m_isScheduled=false;
+	if(!queue->m_isForwarding)
+		return true;
+	queue->m_idleEvent.ResetEvent();
+	return false;
+}
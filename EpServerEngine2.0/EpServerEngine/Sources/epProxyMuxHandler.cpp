@@ -0,0 +1,264 @@
+/*! 
+ProxyMuxHandler for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyMuxHandler.h"
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+
+ProxyMuxHandler::ProxyMuxHandler(ProxyServerCallbackInterface *callBack,const ForwardServerInfo& forwardServerInfo, SocketInterface *socket, ProxyMuxPool *muxPool, epl::LockPolicy lockPolicyType):BaseProxyHandler(callBack,socket,lockPolicyType),m_muxLock(lockPolicyType)
+{
+	m_muxPool=muxPool;
+	m_muxConnection=NULL;
+	m_sessionId=0;
+	m_sendCredit=PROXY_MUX_SESSION_WINDOW_BYTE_SIZE;
+	m_creditEvent=LightEvent(false,false);
+	m_queuedByteSize=0;
+	m_deliverOffset=0;
+	m_grantByteSize=0;
+	m_isClosed=false;
+	m_isClosedByForwardServer=false;
+	m_isReady=false;
+	ProxyMuxConnection *muxConnection=m_muxPool->Attach(forwardServerInfo,this);
+
+	ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+	if(!m_isClosed)
+		m_muxConnection=muxConnection;
+}
+
+ProxyMuxHandler::~ProxyMuxHandler()
+{
+	releaseForwardClient();
+}
+
+void ProxyMuxHandler::OnReceived(SocketInterface *socket,const Packet *receivedPacket,ReceiveStatus status)
+{
+	if(!receivedPacket)
+		return;
+	unsigned int packetByteSize=receivedPacket->GetPacketByteSize();
+	ProxyMuxConnection *muxConnection;
+	// only this client waits for the credit, and its own receive window pushes back on it
+	while(true)
+	{
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+			if(m_isClosed || !m_muxConnection)
+				return;
+			if(m_sendCredit>=static_cast<int>(packetByteSize) || m_sendCredit==PROXY_MUX_SESSION_WINDOW_BYTE_SIZE)
+			{
+				m_sendCredit-=static_cast<int>(packetByteSize);
+				muxConnection=m_muxConnection;
+				break;
+			}
+		}
+		m_creditEvent.WaitForEvent();
+	}
+	while(true)
+	{
+		SendStatus sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+		if(muxConnection->SendFrame(m_sessionId,PROXY_MUX_FRAME_TYPE_DATA,receivedPacket->GetPacket(),packetByteSize,PROXY_MUX_FRAME_SEND_WAITTIME_MILLISEC,&sendStatus))
+			return;
+		if(sendStatus!=SEND_STATUS_FAIL_TIME_OUT)
+			return;
+		// retried out of the send lock, so the window frames of the delivering thread go in between
+		ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+		if(m_isClosed)
+			return;
+	}
+}
+
+void ProxyMuxHandler::releaseForwardClient()
+{
+	ProxyMuxConnection *muxConnection;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+		muxConnection=m_muxConnection;
+		m_muxConnection=NULL;
+		m_isClosed=true;
+	}
+	m_creditEvent.SetEvent();
+	m_muxPool->Detach(muxConnection,this);
+	clearQueue();
+}
+
+bool ProxyMuxHandler::isForwardConnected() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+	return m_muxConnection!=NULL;
+}
+
+bool ProxyMuxHandler::queueFromForwardServer(const char *data,unsigned int dataByteSize)
+{
+	bool isReset=false;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+		if(m_isClosed)
+			return true;
+		// the packet over the whole window is taken only when nothing is queued, as the sending side does
+		if(m_queuedByteSize+dataByteSize<=PROXY_MUX_SESSION_WINDOW_BYTE_SIZE || !m_deliverQueue.size())
+		{
+			m_deliverQueue.push_back(EP_NEW Packet(data,dataByteSize));
+			m_queuedByteSize+=dataByteSize;
+		}
+		else
+		{
+			// reset instead of queueing without a bound, and the client is disconnected by the delivering thread
+			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Session %d sent over the window\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,m_sessionId);
+			m_isClosed=true;
+			m_isClosedByForwardServer=true;
+			m_muxConnection=NULL;
+			isReset=true;
+		}
+	}
+	if(isReset)
+	{
+		m_creditEvent.SetEvent();
+		clearQueue();
+	}
+	m_muxPool->MarkReady(this);
+	return !isReset;
+}
+
+void ProxyMuxHandler::addSendCredit(unsigned int credit)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+		m_sendCredit+=static_cast<int>(credit);
+	}
+	m_creditEvent.SetEvent();
+}
+
+void ProxyMuxHandler::closeByForwardServer()
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+		if(m_isClosed)
+			return;
+		m_isClosed=true;
+		m_isClosedByForwardServer=true;
+		m_muxConnection=NULL;
+	}
+	m_creditEvent.SetEvent();
+	// the client is disconnected on the delivering thread, after the data queued
+	m_muxPool->MarkReady(this);
+}
+
+bool ProxyMuxHandler::deliver()
+{
+	unsigned int deliveredByteSize=0;
+	bool isPending=false;
+	BaseTcpSocket *client=static_cast<BaseTcpSocket*>(m_client);
+	while(true)
+	{
+		Packet *packet;
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+			if(!m_deliverQueue.size())
+				break;
+			packet=m_deliverQueue.front();
+			packet->RetainObj();
+		}
+		// written in the parts the send buffer takes now, so a slow client never blocks this thread
+		unsigned int frameByteSize=BaseTcpSocket::getFrameByteSize(*packet);
+		SendStatus sendStatus=SEND_STATUS_SUCCESS;
+		while(m_deliverOffset<frameByteSize)
+		{
+			client->sendPart(*packet,m_deliverOffset,PROXY_MUX_DELIVER_WRITE_BYTE_SIZE,&sendStatus);
+			if(sendStatus!=SEND_STATUS_SUCCESS)
+				break;
+		}
+		if(sendStatus==SEND_STATUS_FAIL_TIME_OUT)
+		{
+			packet->ReleaseObj();
+			isPending=true;
+			break;
+		}
+		// delivered, or dropped as the client failed
+		m_deliverOffset=0;
+		bool isFront;
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+			isFront=(m_deliverQueue.size() && m_deliverQueue.front()==packet);
+			if(isFront)
+			{
+				m_deliverQueue.pop_front();
+				m_queuedByteSize-=packet->GetPacketByteSize();
+			}
+		}
+		if(!isFront)
+		{
+			packet->ReleaseObj();
+			break;
+		}
+		deliveredByteSize+=packet->GetPacketByteSize();
+		// once for the queue, and once for this delivery
+		packet->ReleaseObj();
+		packet->ReleaseObj();
+	}
+
+	ProxyMuxConnection *muxConnection;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+		muxConnection=m_muxConnection;
+	}
+	m_grantByteSize+=deliveredByteSize;
+	if(m_grantByteSize && muxConnection)
+	{
+		// tried without waiting, so the forward server not reading never blocks the delivery to the others
+		SendStatus sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+		if(muxConnection->SendFrame(m_sessionId,PROXY_MUX_FRAME_TYPE_WINDOW,&m_grantByteSize,sizeof(m_grantByteSize),0,&sendStatus))
+			m_grantByteSize=0;
+		else if(sendStatus==SEND_STATUS_FAIL_TIME_OUT)
+			isPending=true;
+	}
+	return isPending;
+}
+
+bool ProxyMuxHandler::isClosing() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+	return m_isClosedByForwardServer;
+}
+
+void ProxyMuxHandler::killClient()
+{
+	m_client->KillConnection();
+}
+
+void ProxyMuxHandler::clearQueue()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_muxLock);
+	while(m_deliverQueue.size())
+	{
+		m_deliverQueue.front()->ReleaseObj();
+		m_deliverQueue.pop_front();
+	}
+	m_queuedByteSize=0;
+}
@@ -0,0 +1,422 @@
+/*! 
+ProxyMuxPool for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyMuxPool.h"
+#include "epProxyMuxHandler.h"
+#include "epAsyncTcpClient.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+Packet *ProxyMuxFrame::MakeFrame(unsigned int sessionId,ProxyMuxFrameType frameType,const void *data,unsigned int dataByteSize)
+{
+	Packet *packet=EP_NEW Packet(NULL,sizeof(ProxyMuxFrameHeader)+dataByteSize);
+	char *frame=const_cast<char*>(packet->GetPacket());
+	ProxyMuxFrameHeader header;
+	header.sessionId=sessionId;
+	header.frameType=static_cast<unsigned int>(frameType);
+	epl::System::Memcpy(frame,&header,sizeof(header));
+	if(dataByteSize)
+		epl::System::Memcpy(frame+sizeof(header),data,dataByteSize);
+	return packet;
+}
+
+bool ProxyMuxFrame::ParseFrame(const Packet &packet,ProxyMuxFrameHeader &retHeader,const char *&retData,unsigned int &retDataByteSize)
+{
+	if(packet.GetPacketByteSize()<sizeof(ProxyMuxFrameHeader))
+		return false;
+	epl::System::Memcpy(&retHeader,packet.GetPacket(),sizeof(retHeader));
+	retData=packet.GetPacket()+sizeof(ProxyMuxFrameHeader);
+	retDataByteSize=packet.GetPacketByteSize()-sizeof(ProxyMuxFrameHeader);
+	return true;
+}
+
+ProxyMuxConnection::ProxyMuxConnection(epl::LockPolicy lockPolicyType):m_sessionLock(lockPolicyType)
+{
+	m_client=EP_NEW AsyncTcpClient(lockPolicyType);
+}
+
+ProxyMuxConnection::~ProxyMuxConnection()
+{
+	Disconnect();
+	EP_DELETE m_client;
+}
+
+bool ProxyMuxConnection::Connect(const TCHAR *hostName,const TCHAR *port)
+{
+	ClientOps ops;
+	ops.callBackObj=this;
+	ops.hostName=hostName;
+	ops.port=port;
+	ops.isAsynchronousReceive=false;
+	return m_client->Connect(ops);
+}
+
+void ProxyMuxConnection::Disconnect()
+{
+	m_client->Disconnect();
+}
+
+bool ProxyMuxConnection::IsConnected() const
+{
+	return m_client->IsConnectionAlive();
+}
+
+unsigned int ProxyMuxConnection::GetSessionCount() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+	return static_cast<unsigned int>(m_sessionMap.size());
+}
+
+bool ProxyMuxConnection::Attach(ProxyMuxHandler *handler)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+		m_sessionMap[handler->m_sessionId]=handler;
+	}
+	SOCKADDR_STORAGE sockAddr=handler->GetSockAddrStorage();
+	if(SendFrame(handler->m_sessionId,PROXY_MUX_FRAME_TYPE_OPEN,&sockAddr,handler->GetSockAddrSize()))
+		return true;
+	ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+	m_sessionMap.erase(handler->m_sessionId);
+	return false;
+}
+
+void ProxyMuxConnection::Detach(ProxyMuxHandler *handler)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+		map<unsigned int,ProxyMuxHandler*>::iterator iter=m_sessionMap.find(handler->m_sessionId);
+		// closed by the forward server already
+		if(iter==m_sessionMap.end() || iter->second!=handler)
+			return;
+		m_sessionMap.erase(iter);
+	}
+	SendFrame(handler->m_sessionId,PROXY_MUX_FRAME_TYPE_CLOSE);
+}
+
+bool ProxyMuxConnection::SendFrame(unsigned int sessionId,ProxyMuxFrameType frameType,const void *data,unsigned int dataByteSize,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	Packet *frame=ProxyMuxFrame::MakeFrame(sessionId,frameType,data,dataByteSize);
+	SendStatus frameSendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+	m_client->Send(*frame,waitTimeInMilliSec,&frameSendStatus);
+	frame->ReleaseObj();
+	if(sendStatus)
+		*sendStatus=frameSendStatus;
+	return frameSendStatus==SEND_STATUS_SUCCESS;
+}
+
+void ProxyMuxConnection::OnReceived(ClientInterface *client,const Packet*receivedPacket,ReceiveStatus status)
+{
+	ProxyMuxFrameHeader header;
+	const char *data;
+	unsigned int dataByteSize;
+	if(!receivedPacket || !ProxyMuxFrame::ParseFrame(*receivedPacket,header,data,dataByteSize))
+		return;
+
+	ProxyMuxHandler *handler;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+		map<unsigned int,ProxyMuxHandler*>::iterator iter=m_sessionMap.find(header.sessionId);
+		if(iter==m_sessionMap.end())
+			return;
+		handler=iter->second;
+		if(header.frameType==PROXY_MUX_FRAME_TYPE_CLOSE)
+			m_sessionMap.erase(iter);
+	}
+	// the handlers live until the proxy server stops, and ignore the frames once closed,
+	// so they are called outside the lock which the pool takes after its own
+	switch(header.frameType)
+	{
+	case PROXY_MUX_FRAME_TYPE_DATA:
+		if(!handler->queueFromForwardServer(data,dataByteSize))
+		{
+			{
+				ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+				map<unsigned int,ProxyMuxHandler*>::iterator iter=m_sessionMap.find(header.sessionId);
+				if(iter!=m_sessionMap.end() && iter->second==handler)
+					m_sessionMap.erase(iter);
+			}
+			// bounded, as this is the receiving thread of the connection, and the frames of a closed session are ignored anyway
+			SendFrame(header.sessionId,PROXY_MUX_FRAME_TYPE_CLOSE,NULL,0,PROXY_MUX_FRAME_SEND_WAITTIME_MILLISEC);
+		}
+		break;
+	case PROXY_MUX_FRAME_TYPE_WINDOW:
+		if(dataByteSize>=sizeof(unsigned int))
+			handler->addSendCredit(*reinterpret_cast<const unsigned int*>(data));
+		break;
+	case PROXY_MUX_FRAME_TYPE_CLOSE:
+		handler->closeByForwardServer();
+		break;
+	default:
+		break;
+	}
+}
+
+void ProxyMuxConnection::OnDisconnect(ClientInterface *client)
+{
+	map<unsigned int,ProxyMuxHandler*> sessionMap;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+		sessionMap.swap(m_sessionMap);
+	}
+	map<unsigned int,ProxyMuxHandler*>::iterator iter;
+	for(iter=sessionMap.begin();iter!=sessionMap.end();iter++)
+	{
+		iter->second->closeByForwardServer();
+	}
+}
+
+ProxyMuxPool::ProxyMuxPool(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_poolLock(lockPolicyType),m_deliverLock(lockPolicyType)
+{
+	m_connectionCount=0;
+	m_nextSessionId=1;
+	m_isStarted=false;
+	m_wakeEvent=LightEvent(false,false);
+	m_lockPolicy=lockPolicyType;
+}
+
+ProxyMuxPool::~ProxyMuxPool()
+{
+	StopPool();
+	vector<Upstream*>::iterator iter;
+	for(iter=m_upstreamList.begin();iter!=m_upstreamList.end();iter++)
+	{
+		for(size_t connectionTrav=0;connectionTrav<(*iter)->m_connectionList.size();connectionTrav++)
+		{
+			EP_DELETE (*iter)->m_connectionList[connectionTrav];
+		}
+		EP_DELETE (*iter);
+	}
+	m_upstreamList.clear();
+}
+
+bool ProxyMuxPool::StartPool(unsigned int connectionCount)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		if(m_isStarted)
+			return true;
+		// the connections made before are kept, so the count only grows
+		if(connectionCount>m_connectionCount)
+			m_connectionCount=connectionCount;
+		m_isStarted=true;
+	}
+	m_wakeEvent.ResetEvent();
+	if(Start())
+		return true;
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	m_isStarted=false;
+	return false;
+}
+
+void ProxyMuxPool::StopPool(unsigned int waitTimeInMilliSec)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		m_isStarted=false;
+	}
+	m_wakeEvent.SetEvent();
+	TerminateAfter(waitTimeInMilliSec);
+
+	vector<ProxyMuxConnection*> connectionList;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		for(size_t upstreamTrav=0;upstreamTrav<m_upstreamList.size();upstreamTrav++)
+		{
+			vector<ProxyMuxConnection*> &upstreamConnectionList=m_upstreamList[upstreamTrav]->m_connectionList;
+			connectionList.insert(connectionList.end(),upstreamConnectionList.begin(),upstreamConnectionList.end());
+		}
+	}
+	// disconnecting closes the sessions, which mark themselves ready
+	for(size_t connectionTrav=0;connectionTrav<connectionList.size();connectionTrav++)
+	{
+		connectionList[connectionTrav]->Disconnect();
+	}
+
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	for(size_t readyTrav=0;readyTrav<m_readyList.size();readyTrav++)
+	{
+		m_readyList[readyTrav]->m_isReady=false;
+	}
+	m_readyList.clear();
+}
+
+bool ProxyMuxPool::IsPoolStarted() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	return m_isStarted;
+}
+
+ProxyMuxConnection *ProxyMuxPool::Attach(const ForwardServerInfo &forwardServerInfo,ProxyMuxHandler *handler)
+{
+	ProxyMuxConnection *connection=NULL;
+	const TCHAR *hostName;
+	const TCHAR *port;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		Upstream *upstream=NULL;
+		for(size_t upstreamTrav=0;upstreamTrav<m_upstreamList.size();upstreamTrav++)
+		{
+			if(m_upstreamList[upstreamTrav]->m_hostName.compare(forwardServerInfo.hostname)==0 && m_upstreamList[upstreamTrav]->m_port.compare(forwardServerInfo.port)==0)
+			{
+				upstream=m_upstreamList[upstreamTrav];
+				break;
+			}
+		}
+		if(!upstream)
+		{
+			upstream=EP_NEW Upstream();
+			upstream->m_hostName=forwardServerInfo.hostname;
+			upstream->m_port=forwardServerInfo.port;
+			m_upstreamList.push_back(upstream);
+		}
+		while(upstream->m_connectionList.size()<m_connectionCount)
+		{
+			upstream->m_connectionList.push_back(EP_NEW ProxyMuxConnection(m_lockPolicy));
+		}
+
+		// the least loaded connected one, or the next to connect
+		unsigned int sessionCount=0;
+		for(size_t connectionTrav=0;connectionTrav<upstream->m_connectionList.size();connectionTrav++)
+		{
+			ProxyMuxConnection *candidate=upstream->m_connectionList[connectionTrav];
+			if(!candidate->IsConnected())
+				continue;
+			unsigned int candidateSessionCount=candidate->GetSessionCount();
+			if(!connection || candidateSessionCount<sessionCount)
+			{
+				connection=candidate;
+				sessionCount=candidateSessionCount;
+			}
+		}
+		if(!connection)
+			connection=upstream->m_connectionList[m_nextSessionId%upstream->m_connectionList.size()];
+
+		handler->m_sessionId=m_nextSessionId++;
+		if(!m_nextSessionId)
+			m_nextSessionId=1;
+		hostName=upstream->m_hostName.c_str();
+		port=upstream->m_port.c_str();
+	}
+
+	if(!connection->IsConnected() && !connection->Connect(hostName,port))
+		return NULL;
+	if(!connection->Attach(handler))
+		return NULL;
+	return connection;
+}
+
+void ProxyMuxPool::Detach(ProxyMuxConnection *connection,ProxyMuxHandler *handler)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> deliverLock(m_deliverLock);
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		if(handler->m_isReady)
+		{
+			handler->m_isReady=false;
+			vector<ProxyMuxHandler*>::iterator iter;
+			for(iter=m_readyList.begin();iter!=m_readyList.end();iter++)
+			{
+				if(*iter==handler)
+				{
+					m_readyList.erase(iter);
+					break;
+				}
+			}
+		}
+	}
+	if(connection)
+		connection->Detach(handler);
+}
+
+void ProxyMuxPool::MarkReady(ProxyMuxHandler *handler)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		if(handler->m_isReady || !m_isStarted)
+			return;
+		handler->m_isReady=true;
+		m_readyList.push_back(handler);
+	}
+	m_wakeEvent.SetEvent();
+}
+
+void ProxyMuxPool::execute()
+{
+	vector<ProxyMuxHandler*> deliverList;
+	vector<ProxyMuxHandler*> killList;
+	while(true)
+	{
+		bool isPending=false;
+		{
+			ScopedLock<RuntimeLockPolicy> deliverLock(m_deliverLock);
+			{
+				ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+				if(!m_isStarted)
+					return;
+				deliverList.swap(m_readyList);
+				for(size_t deliverTrav=0;deliverTrav<deliverList.size();deliverTrav++)
+				{
+					deliverList[deliverTrav]->m_isReady=false;
+				}
+			}
+			for(size_t deliverTrav=0;deliverTrav<deliverList.size();deliverTrav++)
+			{
+				ProxyMuxHandler *handler=deliverList[deliverTrav];
+				if(handler->deliver())
+				{
+					// the client is not ready, so retry later without holding the others
+					ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+					if(!handler->m_isReady)
+					{
+						handler->m_isReady=true;
+						m_readyList.push_back(handler);
+					}
+					isPending=true;
+				}
+				else if(handler->isClosing())
+				{
+					killList.push_back(handler);
+				}
+			}
+			deliverList.clear();
+		}
+
+		// outside the lock, since the client disconnecting detaches itself
+		for(size_t killTrav=0;killTrav<killList.size();killTrav++)
+		{
+			killList[killTrav]->killClient();
+		}
+		killList.clear();
+
+		m_wakeEvent.WaitForEvent(isPending?PROXY_MUX_DELIVER_RETRY_MILLISEC:WAITTIME_INIFINITE);
+	}
+}
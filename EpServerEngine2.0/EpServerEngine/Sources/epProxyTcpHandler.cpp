@@ -34,8 +34,26 @@ static char THIS_FILE[] = __FILE__;
 using namespace epse;
 
 
-ProxyTcpHandler::ProxyTcpHandler(ProxyServerCallbackInterface *callBack,const ForwardServerInfo& forwardServerInfo, SocketInterface *socket, epl::LockPolicy lockPolicyType):BaseProxyHandler(callBack,socket,lockPolicyType)
+ProxyTcpHandler::ProxyTcpHandler(ProxyServerCallbackInterface *callBack,const ForwardServerInfo& forwardServerInfo, SocketInterface *socket, ProxyUpstreamPool *upstreamPool, bool isPassthrough, ProxyForwardWorker *forwardWorker, unsigned int highWatermarkByteSize, unsigned int lowWatermarkByteSize, epl::LockPolicy lockPolicyType):BaseProxyHandler(callBack,socket,lockPolicyType)
 {
+	m_upstreamPool=upstreamPool;
+	m_upstreamIdx=0;
+	m_relay=NULL;
+	if(isPassthrough)
+	{
+		m_upstreamPool=NULL;
+		m_relay=EP_NEW ProxyTcpRelay(lockPolicyType);
+		m_relay->Connect(forwardServerInfo,static_cast<BaseTcpSocket*>(socket));
+		return;
+	}
+	// the queues are opened before the forward server can call back
+	if(forwardWorker)
+		openForwardQueues(forwardWorker,highWatermarkByteSize,lowWatermarkByteSize);
+	if(m_upstreamPool)
+	{
+		m_forwardClient=m_upstreamPool->Checkout(forwardServerInfo,this,m_upstreamIdx);
+		return;
+	}
 	m_forwardClient=EP_NEW AsyncTcpClient(lockPolicyType);
 	ClientOps ops;
 	ops.callBackObj=this;
@@ -47,4 +65,87 @@ ProxyTcpHandler::ProxyTcpHandler(ProxyServerCallbackInterface *callBack,const Fo
 
 ProxyTcpHandler::~ProxyTcpHandler()
 {
+	closeForwardQueues();
+	if(m_upstreamPool)
+		releaseForwardClient();
+	if(m_relay)
+		EP_DELETE m_relay;
+}
+
+void ProxyTcpHandler::relayFromClient()
+{
+	if(m_relay)
+		m_relay->RelayFromClient();
+}
+
+bool ProxyTcpHandler::isForwardConnected() const
+{
+	if(m_relay)
+		return m_relay->IsConnected();
+	return BaseProxyHandler::isForwardConnected();
+}
+
+bool ProxyTcpHandler::isWritable(bool isFromClient)
+{
+	if(isFromClient)
+	{
+		// held, so the connection is not taken back to the pool while checking it
+		ScopedLock<RuntimeLockPolicy> lock(m_clientToForwardLock);
+		BaseClient *forwardClient=m_forwardClient;
+		// dropped on forwarding anyway
+		if(!forwardClient)
+			return true;
+		epl::LockObj sendLock(forwardClient->m_sendLock);
+		return isSocketWritable(forwardClient->m_connectSocket);
+	}
+	BaseTcpSocket *clientSocket=static_cast<BaseTcpSocket*>(m_client);
+	epl::LockObj sendLock(clientSocket->m_sendLock);
+	return isSocketWritable(clientSocket->m_clientSocket);
+}
+
+void ProxyTcpHandler::abortClient()
+{
+	// wakes the receiving thread of either side waiting for its queue to drain
+	closeForwardQueues();
+	BaseTcpSocket *clientSocket=static_cast<BaseTcpSocket*>(m_client);
+	epl::LockObj sendLock(clientSocket->m_sendLock);
+	if(clientSocket->m_clientSocket!=INVALID_SOCKET)
+		shutdown(clientSocket->m_clientSocket,SD_BOTH);
+}
+
+bool ProxyTcpHandler::isSocketWritable(SOCKET socket)
+{
+	if(socket==INVALID_SOCKET)
+		return true;
+	TIMEVAL	timeOutVal;
+	fd_set	fdSet;
+	FD_ZERO(&fdSet);
+	FD_SET(socket, &fdSet);
+	timeOutVal.tv_sec = 0;
+	timeOutVal.tv_usec = 0;
+	// in error, the send fails right away instead
+	return select(0, NULL, &fdSet, NULL, &timeOutVal)!=0;
+}
+
+void ProxyTcpHandler::releaseForwardClient()
+{
+	if(m_relay)
+	{
+		m_relay->Close();
+		return;
+	}
+	if(!m_upstreamPool)
+	{
+		BaseProxyHandler::releaseForwardClient();
+		return;
+	}
+	BaseClient *forwardClient;
+	{
+		// waits for the forwarding in progress on both directions
+		ScopedLock<RuntimeLockPolicy> clientToForwardLock(m_clientToForwardLock);
+		ScopedLock<RuntimeLockPolicy> forwardToClientLock(m_forwardToClientLock);
+		forwardClient=reinterpret_cast<BaseClient*>(InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_forwardClient),NULL));
+	}
+	// waits for the callback of the connection still running, as it might not have reached the forwarding yet
+	m_upstreamPool->Release(forwardClient,m_upstreamIdx);
 }
@@ -0,0 +1,144 @@
+/*! 
+ProxyTcpRelay for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyTcpRelay.h"
+#include "epResolverCache.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+ProxyTcpRelay::ProxyTcpRelay(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+{
+	m_clientSocket=INVALID_SOCKET;
+	m_forwardSocket=INVALID_SOCKET;
+}
+
+ProxyTcpRelay::~ProxyTcpRelay()
+{
+	Close();
+}
+
+bool ProxyTcpRelay::Connect(const ForwardServerInfo &forwardServerInfo,BaseTcpSocket *clientSocket)
+{
+	m_clientSocket=clientSocket->m_clientSocket;
+
+	struct addrinfo hints;
+	struct addrinfo *result=NULL;
+	ZeroMemory( &hints, sizeof(hints) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	// Resolve the server address and port
+	int iResult = RESOLVER_CACHE_INSTANCE.GetAddrInfo(forwardServerInfo.hostname, forwardServerInfo.port, &hints, &result);
+	if ( iResult != 0 ) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return false;
+	}
+
+	struct addrinfo *iPtr=0;
+	// Attempt to connect to an address until one succeeds
+	for(iPtr=result; iPtr != NULL ;iPtr=iPtr->ai_next) {
+		m_forwardSocket = socket(iPtr->ai_family, iPtr->ai_socktype, iPtr->ai_protocol);
+		if (m_forwardSocket == INVALID_SOCKET)
+			continue;
+		iResult = connect( m_forwardSocket, iPtr->ai_addr, static_cast<int>(iPtr->ai_addrlen));
+		if (iResult == SOCKET_ERROR) {
+			closesocket(m_forwardSocket);
+			m_forwardSocket = INVALID_SOCKET;
+			continue;
+		}
+		break;
+	}
+	ResolverCache::FreeAddrInfo(result);
+	if (m_forwardSocket == INVALID_SOCKET) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Unable to connect to forward server!\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return false;
+	}
+	if(Start())
+		return true;
+	closesocket(m_forwardSocket);
+	m_forwardSocket=INVALID_SOCKET;
+	return false;
+}
+
+void ProxyTcpRelay::RelayFromClient()
+{
+	if(m_forwardSocket==INVALID_SOCKET)
+		return;
+	relay(m_clientSocket,m_forwardSocket);
+}
+
+bool ProxyTcpRelay::IsConnected() const
+{
+	return m_forwardSocket!=INVALID_SOCKET;
+}
+
+void ProxyTcpRelay::Close(unsigned int waitTimeInMilliSec)
+{
+	if(m_forwardSocket==INVALID_SOCKET)
+		return;
+	// closing fails the receive of the relay thread
+	closesocket(m_forwardSocket);
+	TerminateAfter(waitTimeInMilliSec);
+	m_forwardSocket=INVALID_SOCKET;
+}
+
+void ProxyTcpRelay::execute()
+{
+	relay(m_forwardSocket,m_clientSocket);
+}
+
+void ProxyTcpRelay::relay(SOCKET fromSocket,SOCKET toSocket)
+{
+	char buffer[PROXY_PASSTHROUGH_BUFFER_BYTE_SIZE];
+	while(true)
+	{
+		int recvLength=recv(fromSocket,buffer,PROXY_PASSTHROUGH_BUFFER_BYTE_SIZE,0);
+		if(recvLength<=0)
+			break;
+		int sentLength=0;
+		while(sentLength<recvLength)
+		{
+			int iResult=send(toSocket,buffer+sentLength,recvLength-sentLength,0);
+			if(iResult==SOCKET_ERROR)
+				break;
+			sentLength+=iResult;
+		}
+		if(sentLength<recvLength)
+		{
+			// stop the source as well, so the bytes left are not received by anyone else
+			shutdown(fromSocket,SD_RECEIVE);
+			break;
+		}
+	}
+	// pass the end of stream on, so the other side closes in turn
+	shutdown(toSocket,SD_SEND);
+}
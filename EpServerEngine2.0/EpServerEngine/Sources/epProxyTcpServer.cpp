@@ -25,6 +25,7 @@ THE SOFTWARE.
 */
 #include "epProxyTcpServer.h"
 #include "epProxyTcpHandler.h"
+#include "epProxyMuxHandler.h"
 #include "epAsyncTcpClient.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
@@ -39,29 +40,130 @@ using namespace epse;
 ProxyTcpServer::ProxyTcpServer(epl::LockPolicy lockPolicyType):BaseProxyServer(lockPolicyType)
 {
 	m_proxyServer=EP_NEW AsyncTcpServer(lockPolicyType);
-
+	m_upstreamPool=EP_NEW ProxyUpstreamPool(lockPolicyType);
+	m_muxPool=EP_NEW ProxyMuxPool(lockPolicyType);
+	m_forwardWorker=EP_NEW ProxyForwardWorker(lockPolicyType);
+	m_isPassthrough=false;
+	m_highWatermarkByteSize=0;
+	m_lowWatermarkByteSize=0;
 
 }
 ProxyTcpServer::ProxyTcpServer(const ProxyTcpServer& b):BaseProxyServer(b)
 {
 	m_proxyServer=EP_NEW AsyncTcpServer(*((AsyncTcpServer*)b.m_proxyServer));
+	m_upstreamPool=EP_NEW ProxyUpstreamPool(b.m_lockPolicy);
+	m_muxPool=EP_NEW ProxyMuxPool(b.m_lockPolicy);
+	m_forwardWorker=EP_NEW ProxyForwardWorker(b.m_lockPolicy);
+	m_isPassthrough=b.m_isPassthrough;
+	m_highWatermarkByteSize=b.m_highWatermarkByteSize;
+	m_lowWatermarkByteSize=b.m_lowWatermarkByteSize;
 
 }
 ProxyTcpServer::~ProxyTcpServer()
 {
+	// the handlers release their connections to the pool before it is deleted
+	StopServer();
+	EP_DELETE m_upstreamPool;
+	EP_DELETE m_muxPool;
+	EP_DELETE m_forwardWorker;
 }
 ProxyTcpServer & ProxyTcpServer::operator=(const ProxyTcpServer&b)
 {
 	if(this!=&b)
 	{
 		BaseProxyServer::operator =(b);
+		m_isPassthrough=b.m_isPassthrough;
+		m_highWatermarkByteSize=b.m_highWatermarkByteSize;
+		m_lowWatermarkByteSize=b.m_lowWatermarkByteSize;
 	}
 	return *this;
 }
 
+bool ProxyTcpServer::StartServer(const ProxyServerOps &ops)
+{
+	m_isPassthrough=ops.isPassthrough;
+	// the multiplexed sessions have their own windows, and the relay is backpressured by the sockets
+	m_highWatermarkByteSize=0;
+	m_lowWatermarkByteSize=0;
+	if(ops.isBackpressured && !m_isPassthrough && !ops.muxConnectionCount)
+	{
+		m_highWatermarkByteSize=ops.highWatermarkByteSize;
+		m_lowWatermarkByteSize=ops.lowWatermarkByteSize;
+		if(!m_forwardWorker->StartWorker(ops.forwardWorkerCount))
+			return false;
+	}
+	if(ops.muxConnectionCount && !m_isPassthrough)
+	{
+		if(!m_muxPool->StartPool(ops.muxConnectionCount))
+		{
+			m_forwardWorker->StopWorker();
+			return false;
+		}
+	}
+	else if(ops.isUpstreamPooled && !m_isPassthrough)
+	{
+		if(!m_upstreamPool->StartPool(ops.upstreamPoolMinimumCount,ops.upstreamPoolMaximumCount,ops.upstreamHealthCheckMilliSec,ops.isUpstreamStateless))
+		{
+			m_forwardWorker->StopWorker();
+			return false;
+		}
+	}
+	if(BaseProxyServer::StartServer(ops))
+		return true;
+	m_muxPool->StopPool();
+	m_upstreamPool->StopPool();
+	m_forwardWorker->StopWorker();
+	return false;
+}
+
+void ProxyTcpServer::StopServer()
+{
+	// the multiplexed sessions are closed first, so no connection calls back the handlers deleted
+	m_muxPool->StopPool();
+	// the threads finish the packets in progress to the writable peers, and forward no more for the handlers deleted
+	m_forwardWorker->StopWorker();
+	BaseProxyServer::StopServer();
+	m_upstreamPool->StopPool();
+}
+
+void ProxyTcpServer::WarmUpstream(const ForwardServerInfo &forwardServerInfo)
+{
+	if(m_upstreamPool->IsPoolStarted())
+		m_upstreamPool->AddUpstream(forwardServerInfo);
+}
+
 void ProxyTcpServer::OnNewConnection(SocketInterface *socket)
 {
-	epl::LockObj lock(m_baseProxyServerLock);
-	ProxyTcpHandler *newHandler=EP_NEW ProxyTcpHandler(m_callBack,m_callBack->GetForwardServerInfo(socket->GetSockAddr()),socket);
-	m_proxyHandlerList.push_back(newHandler);
+	ProxyServerCallbackInterface *callBack;
+	ForwardServerInfo forwardServerInfo;
+	unsigned int upstreamIdx=0;
+	ProxyUpstreamGroup *upstreamGroup;
+	{
+		epl::LockObj lock(m_baseProxyServerLock);
+		callBack=m_callBack;
+		upstreamGroup=selectForwardServer(socket,forwardServerInfo,upstreamIdx);
+	}
+	unsigned int connectTick=GetTickCount();
+
+	// built without the lock, since the handler connects to the forward server
+	if(m_muxPool->IsPoolStarted())
+	{
+		ProxyMuxHandler *newMuxHandler=EP_NEW ProxyMuxHandler(callBack,forwardServerInfo,socket,m_muxPool,m_lockPolicy);
+		if(upstreamGroup)
+			newMuxHandler->setUpstreamGroup(upstreamGroup,upstreamIdx,connectTick);
+		addHandler(newMuxHandler,callBack);
+		return;
+	}
+	ProxyUpstreamPool *upstreamPool=NULL;
+	if(m_upstreamPool->IsPoolStarted())
+		upstreamPool=m_upstreamPool;
+	ProxyForwardWorker *forwardWorker=NULL;
+	if(m_highWatermarkByteSize)
+		forwardWorker=m_forwardWorker;
+	ProxyTcpHandler *newHandler=EP_NEW ProxyTcpHandler(callBack,forwardServerInfo,socket,upstreamPool,m_isPassthrough,forwardWorker,m_highWatermarkByteSize,m_lowWatermarkByteSize,m_lockPolicy);
+	if(upstreamGroup)
+		newHandler->setUpstreamGroup(upstreamGroup,upstreamIdx,connectTick);
+	addHandler(newHandler,callBack);
+	// this is the thread of the client socket, which receives only after the relay is done
+	newHandler->relayFromClient();
 }
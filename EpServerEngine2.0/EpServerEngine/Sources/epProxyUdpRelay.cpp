@@ -0,0 +1,629 @@
+/*! 
+ProxyUdpRelay for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyUdpRelay.h"
+#include "epResolverCache.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+// mstcpip.h of the newer SDKs
+#ifndef SIO_UDP_CONNRESET
+#define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR,12)
+#endif
+
+/// OVERLAPPED_ENTRY of the newer SDKs
+struct CompletionEntry{
+	/// completion key
+	ULONG_PTR completionKey;
+	/// overlapped completed, NULL to wake the worker to stop
+	LPOVERLAPPED overlapped;
+	/// status of the completion
+	ULONG_PTR internal;
+	/// byte size transferred
+	DWORD byteTransferred;
+};
+
+/// completion key of the binding posted to the workers to set up, and 0 for the receives
+#define SETUP_COMPLETION_KEY 1
+
+/// GetQueuedCompletionStatusEx function type
+typedef BOOL (WINAPI *GetQueuedCompletionStatusExFunc)(HANDLE,CompletionEntry*,ULONG,PULONG,DWORD,BOOL);
+
+/*!
+Dequeue the completions in a batch where supported, otherwise one by one
+@param[in] completionPort the completion port
+@param[out] entryList the completions dequeued
+@param[in] maxEntryCount the maximum number of the completions to dequeue
+@return the number of the completions dequeued, 0 if the completion port failed
+*/
+static ULONG getCompletions(HANDLE completionPort,CompletionEntry *entryList,ULONG maxEntryCount)
+{
+	static GetQueuedCompletionStatusExFunc getQueuedCompletionStatusEx=reinterpret_cast<GetQueuedCompletionStatusExFunc>(GetProcAddress(GetModuleHandle(_T("kernel32.dll")),"GetQueuedCompletionStatusEx"));
+	ULONG entryCount=0;
+	if(getQueuedCompletionStatusEx)
+	{
+		if(!getQueuedCompletionStatusEx(completionPort,entryList,maxEntryCount,&entryCount,INFINITE,FALSE))
+			return 0;
+		return entryCount;
+	}
+	DWORD byteTransferred=0;
+	ULONG_PTR completionKey=0;
+	LPOVERLAPPED overlapped=NULL;
+	BOOL isSucceeded=GetQueuedCompletionStatus(completionPort,&byteTransferred,&completionKey,&overlapped,INFINITE);
+	if(!isSucceeded && !overlapped)
+		return 0;
+	entryList[0].completionKey=completionKey;
+	entryList[0].overlapped=overlapped;
+	entryList[0].internal=isSucceeded?0:1;
+	entryList[0].byteTransferred=byteTransferred;
+	return 1;
+}
+
+/*!
+Stop the ICMP port unreachable from failing the next receive of the socket
+@param[in] udpSocket the UDP socket
+*/
+static void disableConnectionReset(SOCKET udpSocket)
+{
+	BOOL isConnectionReset=FALSE;
+	DWORD byteReturned=0;
+	WSAIoctl(udpSocket,SIO_UDP_CONNRESET,&isConnectionReset,sizeof(isConnectionReset),NULL,0,&byteReturned,NULL,NULL);
+}
+
+ProxyUdpRelay::ProxyUdpRelay(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_relayLock(lockPolicyType)
+{
+	m_listenSocket=INVALID_SOCKET;
+	m_completionPort=NULL;
+	m_tableCount=0;
+	m_hashSeed=0;
+	m_bindingCount=0;
+	m_idleEvent=LightEvent(true,true);
+	m_isForwardOffloadInitialized=false;
+	m_callBack=NULL;
+	m_upstreamGroup=NULL;
+	m_expiryMilliSec=PROXY_UDP_BINDING_EXPIRY_MILLISEC;
+	m_bindingLimit=PROXY_UDP_RELAY_BINDING_LIMIT;
+	m_isStarted=false;
+	m_lockPolicy=lockPolicyType;
+}
+
+ProxyUdpRelay::~ProxyUdpRelay()
+{
+	StopRelay();
+}
+
+bool ProxyUdpRelay::StartRelay(const TCHAR *port,ProxyServerCallbackInterface *callBackObj,ProxyUpstreamGroup *upstreamGroup,unsigned int workerCount,unsigned int expiryMilliSec,unsigned int bindingLimit)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_relayLock);
+	if(m_isStarted)
+		return true;
+	m_callBack=callBackObj;
+	m_upstreamGroup=upstreamGroup;
+	m_expiryMilliSec=expiryMilliSec;
+	m_bindingLimit=bindingLimit;
+
+	WSADATA wsaData;
+	int iResult = WSAStartup(MAKEWORD(2,2), &wsaData);
+	if (iResult != 0) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) WSAStartup failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return false;
+	}
+
+	struct addrinfo hints;
+	struct addrinfo *result=NULL;
+	ZeroMemory(&hints, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_protocol = IPPROTO_UDP;
+	hints.ai_flags = AI_PASSIVE;
+
+	iResult = getaddrinfo(NULL, port, &hints, &result);
+	if ( iResult != 0 ) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		WSACleanup();
+		return false;
+	}
+	m_listenSocket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+	if (m_listenSocket == INVALID_SOCKET) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) socket failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		freeaddrinfo(result);
+		cleanUpRelay();
+		return false;
+	}
+	int sockoptval = 1;
+	setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char*>(&sockoptval), sizeof(int));
+	iResult = bind( m_listenSocket, result->ai_addr, static_cast<int>(result->ai_addrlen));
+	freeaddrinfo(result);
+	if (iResult == SOCKET_ERROR) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) bind failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		cleanUpRelay();
+		return false;
+	}
+	disableConnectionReset(m_listenSocket);
+	// the relay thread wakes up at least once a sweep period to expire the bindings, and to stop
+	DWORD receiveTimeOut=PROXY_UDP_RELAY_SWEEP_MILLISEC;
+	setsockopt(m_listenSocket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<char*>(&receiveTimeOut), sizeof(DWORD));
+	m_offload.Initialize(m_listenSocket);
+	m_offload.EnableReceiveCoalescing(m_listenSocket,PROXY_UDP_RELAY_RECEIVE_BUFFER_BYTE_SIZE);
+
+	if(workerCount==0)
+		workerCount=epl::System::GetNumberOfCores();
+	m_completionPort=CreateIoCompletionPort(INVALID_HANDLE_VALUE,NULL,0,workerCount);
+	if(!m_completionPort)
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) CreateIoCompletionPort failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		cleanUpRelay();
+		return false;
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	m_hashSeed=static_cast<unsigned __int64>(counter.QuadPart)^reinterpret_cast<UINT_PTR>(this);
+	m_bucketList.assign(PROXY_UDP_RELAY_BUCKET_COUNT,NULL);
+	m_tableCount=0;
+	m_isForwardOffloadInitialized=false;
+
+	for(unsigned int workerTrav=0;workerTrav<workerCount;workerTrav++)
+	{
+		Worker *worker=EP_NEW Worker(this,m_lockPolicy);
+		m_workerList.push_back(worker);
+		worker->Start();
+	}
+	m_isStarted=true;
+	if(Start())
+		return true;
+	m_isStarted=false;
+	cleanUpRelay();
+	return false;
+}
+
+void ProxyUdpRelay::StopRelay(unsigned int waitTimeInMilliSec)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_relayLock);
+		if(!m_isStarted)
+			return;
+		m_isStarted=false;
+	}
+	// the receive of the relay thread times out within the sweep period
+	TerminateAfter(waitTimeInMilliSec);
+
+	ScopedLock<RuntimeLockPolicy> lock(m_relayLock);
+	for(size_t bucketTrav=0;bucketTrav<m_bucketList.size();bucketTrav++)
+	{
+		Binding *binding=m_bucketList[bucketTrav];
+		while(binding)
+		{
+			Binding *nextBinding=binding->m_next;
+			closeBinding(binding);
+			binding=nextBinding;
+		}
+	}
+	m_bucketList.clear();
+	m_tableCount=0;
+	// the workers complete the receives aborted and the set-ups posted, before the completion port is closed
+	m_idleEvent.WaitForEvent(waitTimeInMilliSec);
+	cleanUpRelay();
+}
+
+bool ProxyUdpRelay::IsRelayStarted() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_relayLock);
+	return m_isStarted;
+}
+
+unsigned int ProxyUdpRelay::GetBindingCount() const
+{
+	return static_cast<unsigned int>(m_bindingCount);
+}
+
+void ProxyUdpRelay::execute()
+{
+	unsigned int sweepTick=GetTickCount();
+	while(m_isStarted)
+	{
+		SOCKADDR_STORAGE sockAddr;
+		int sockAddrSize=sizeof(SOCKADDR_STORAGE);
+		unsigned int segmentByteSize=0;
+		int recvLength=m_offload.ReceiveFrom(m_listenSocket,m_receiveBuffer,PROXY_UDP_RELAY_RECEIVE_BUFFER_BYTE_SIZE,reinterpret_cast<sockaddr*>(&sockAddr),&sockAddrSize,&segmentByteSize);
+		if(recvLength==SOCKET_ERROR)
+		{
+			int errorCode=WSAGetLastError();
+			if(errorCode!=WSAETIMEDOUT && errorCode!=WSAEMSGSIZE && errorCode!=WSAECONNRESET)
+				break;
+		}
+		else if(recvLength>0)
+		{
+			UdpSessionAddress clientAddress;
+			if(clientAddress.SetSockAddr(reinterpret_cast<sockaddr*>(&sockAddr),sockAddrSize))
+				relayFromClient(clientAddress,recvLength,segmentByteSize);
+		}
+
+		unsigned int tick=GetTickCount();
+		if(tick-sweepTick>=PROXY_UDP_RELAY_SWEEP_MILLISEC)
+		{
+			expireBindings(tick);
+			sweepTick=tick;
+		}
+	}
+}
+
+void ProxyUdpRelay::relayFromForwardServers()
+{
+	CompletionEntry entryList[PROXY_UDP_RELAY_COMPLETION_BATCH_COUNT];
+	while(true)
+	{
+		ULONG entryCount=getCompletions(m_completionPort,entryList,PROXY_UDP_RELAY_COMPLETION_BATCH_COUNT);
+		if(!entryCount)
+			break;
+		ULONG stopCount=0;
+		for(ULONG entryTrav=0;entryTrav<entryCount;entryTrav++)
+		{
+			if(!entryList[entryTrav].overlapped)
+			{
+				stopCount++;
+				continue;
+			}
+			Binding *binding=CONTAINING_RECORD(entryList[entryTrav].overlapped,Binding,m_overlapped);
+			if(entryList[entryTrav].completionKey==SETUP_COMPLETION_KEY)
+			{
+				setUpBinding(binding);
+				continue;
+			}
+			// the truncated or the failed receive is dropped
+			if(entryList[entryTrav].internal==0 && entryList[entryTrav].byteTransferred>0)
+			{
+				sendto(m_listenSocket,binding->m_buffer,static_cast<int>(entryList[entryTrav].byteTransferred),0,binding->m_clientAddress.GetSockAddr(),binding->m_clientAddress.GetSockAddrSize());
+				binding->m_lastActiveTick=GetTickCount();
+			}
+			bool isPosted=false;
+			{
+				ScopedLock<RuntimeLockPolicy> lock(binding->m_bindingLock);
+				if(!binding->m_isClosed)
+					isPosted=postReceive(binding);
+			}
+			if(!isPosted)
+				releaseBinding(binding);
+		}
+		if(stopCount)
+		{
+			// the wake-ups dequeued for the other workers are handed back
+			for(ULONG stopTrav=1;stopTrav<stopCount;stopTrav++)
+				PostQueuedCompletionStatus(m_completionPort,0,0,NULL);
+			break;
+		}
+	}
+}
+
+void ProxyUdpRelay::relayFromClient(const UdpSessionAddress &clientAddress,int length,unsigned int segmentByteSize)
+{
+	Binding *binding=findBinding(clientAddress);
+	if(!binding)
+	{
+		// bounded, so the sources flooding the relay do not take all the sockets
+		if(m_tableCount>=m_bindingLimit)
+			return;
+		binding=createBinding(clientAddress);
+	}
+	if(!binding->m_isReady && holdDatagrams(binding,length,segmentByteSize))
+		return;
+	binding->m_lastActiveTick=GetTickCount();
+	if(!m_isForwardOffloadInitialized)
+	{
+		m_forwardOffload.Initialize(binding->m_forwardSocket);
+		m_isForwardOffloadInitialized=true;
+	}
+
+	if(segmentByteSize==0 || length<=static_cast<int>(segmentByteSize))
+	{
+		send(binding->m_forwardSocket,m_receiveBuffer,length,0);
+		return;
+	}
+	// the coalesced datagrams are sent on as a train with one call, or one by one where not supported
+	if(m_forwardOffload.SendSegmented(binding->m_forwardSocket,m_receiveBuffer,length,segmentByteSize,NULL,0)!=SOCKET_ERROR)
+		return;
+	for(int offset=0;offset<length;offset+=static_cast<int>(segmentByteSize))
+	{
+		int segmentLength=length-offset;
+		if(segmentLength>static_cast<int>(segmentByteSize))
+			segmentLength=static_cast<int>(segmentByteSize);
+		send(binding->m_forwardSocket,m_receiveBuffer+offset,segmentLength,0);
+	}
+}
+
+ProxyUdpRelay::Binding *ProxyUdpRelay::findBinding(const UdpSessionAddress &clientAddress) const
+{
+	size_t bucketIdx=static_cast<size_t>(clientAddress.GetHash(m_hashSeed))&(m_bucketList.size()-1);
+	Binding *binding=m_bucketList[bucketIdx];
+	while(binding)
+	{
+		if(binding->m_clientAddress==clientAddress)
+			return binding;
+		binding=binding->m_next;
+	}
+	return NULL;
+}
+
+ProxyUdpRelay::Binding *ProxyUdpRelay::createBinding(const UdpSessionAddress &clientAddress)
+{
+	Binding *binding=EP_NEW Binding(m_lockPolicy);
+	binding->m_clientAddress=clientAddress;
+	binding->m_lastActiveTick=GetTickCount();
+	// referenced by the table and by the set-up posted, which is handed to the receive posted
+	binding->m_refCount=2;
+	if(InterlockedIncrement(&m_bindingCount)==1)
+		m_idleEvent.ResetEvent();
+
+	if(m_tableCount>=m_bucketList.size())
+		growTable();
+	size_t bucketIdx=static_cast<size_t>(clientAddress.GetHash(m_hashSeed))&(m_bucketList.size()-1);
+	binding->m_next=m_bucketList[bucketIdx];
+	m_bucketList[bucketIdx]=binding;
+	m_tableCount++;
+
+	// resolving and connecting never hold back the datagrams of the other clients
+	if(!PostQueuedCompletionStatus(m_completionPort,0,SETUP_COMPLETION_KEY,&binding->m_overlapped))
+	{
+		{
+			ScopedLock<RuntimeLockPolicy> lock(binding->m_bindingLock);
+			binding->m_isFailed=true;
+		}
+		releaseBinding(binding);
+	}
+	return binding;
+}
+
+void ProxyUdpRelay::setUpBinding(Binding *binding)
+{
+	ForwardServerInfo forwardServerInfo;
+	ProxyUpstreamGroup *upstreamGroup=NULL;
+	unsigned int upstreamIdx=0;
+	const sockaddr *sockAddr=binding->m_clientAddress.GetSockAddr();
+	if(m_upstreamGroup && m_upstreamGroup->Select(sockAddr,binding->m_clientAddress.GetSockAddrSize(),upstreamIdx))
+	{
+		upstreamGroup=m_upstreamGroup;
+		forwardServerInfo=upstreamGroup->GetForwardServerInfo(upstreamIdx);
+	}
+	else
+		forwardServerInfo=m_callBack->GetForwardServerInfo(*sockAddr);
+
+	unsigned int connectTick=GetTickCount();
+	SOCKET forwardSocket=connectForwardServer(forwardServerInfo);
+	if(upstreamGroup)
+		upstreamGroup->ReportConnect(upstreamIdx,GetTickCount()-connectTick,forwardSocket!=INVALID_SOCKET);
+	if(forwardSocket!=INVALID_SOCKET && !CreateIoCompletionPort(reinterpret_cast<HANDLE>(forwardSocket),m_completionPort,0,0))
+	{
+		closesocket(forwardSocket);
+		forwardSocket=INVALID_SOCKET;
+	}
+
+	bool isPosted=false;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(binding->m_bindingLock);
+		if(!binding->m_isClosed && forwardSocket!=INVALID_SOCKET)
+		{
+			binding->m_forwardSocket=forwardSocket;
+			binding->m_upstreamGroup=upstreamGroup;
+			binding->m_upstreamIdx=upstreamIdx;
+			// the datagrams held go first, and the relay thread sends the next ones under the lock until ready
+			const char *pendingData=binding->m_pendingBuffer.size()?&binding->m_pendingBuffer[0]:NULL;
+			for(size_t pendingTrav=0;pendingTrav<binding->m_pendingLengthList.size();pendingTrav++)
+			{
+				send(forwardSocket,pendingData,binding->m_pendingLengthList[pendingTrav],0);
+				pendingData+=binding->m_pendingLengthList[pendingTrav];
+			}
+			vector<char>().swap(binding->m_pendingBuffer);
+			vector<int>().swap(binding->m_pendingLengthList);
+			binding->m_isReady=true;
+			isPosted=postReceive(binding);
+			// owned by the binding now
+			forwardSocket=INVALID_SOCKET;
+			upstreamGroup=NULL;
+		}
+		else if(!binding->m_isClosed)
+		{
+			// the client is dropped until the binding expires, and then tried again
+			binding->m_isFailed=true;
+			vector<char>().swap(binding->m_pendingBuffer);
+			vector<int>().swap(binding->m_pendingLengthList);
+		}
+	}
+	if(forwardSocket!=INVALID_SOCKET)
+		closesocket(forwardSocket);
+	if(upstreamGroup)
+		upstreamGroup->Release(upstreamIdx);
+	if(!isPosted)
+		releaseBinding(binding);
+}
+
+bool ProxyUdpRelay::holdDatagrams(Binding *binding,int length,unsigned int segmentByteSize)
+{
+	ScopedLock<RuntimeLockPolicy> lock(binding->m_bindingLock);
+	if(binding->m_isReady)
+		return false;
+	// not refreshed, so the failed binding expires
+	if(binding->m_isFailed)
+		return true;
+	binding->m_lastActiveTick=GetTickCount();
+	if(segmentByteSize==0)
+		segmentByteSize=static_cast<unsigned int>(length);
+	for(int offset=0;offset<length;offset+=static_cast<int>(segmentByteSize))
+	{
+		int segmentLength=length-offset;
+		if(segmentLength>static_cast<int>(segmentByteSize))
+			segmentLength=static_cast<int>(segmentByteSize);
+		if(binding->m_pendingBuffer.size()+static_cast<size_t>(segmentLength)>PROXY_UDP_RELAY_PENDING_BYTE_SIZE)
+			break;
+		binding->m_pendingBuffer.insert(binding->m_pendingBuffer.end(),m_receiveBuffer+offset,m_receiveBuffer+offset+segmentLength);
+		binding->m_pendingLengthList.push_back(segmentLength);
+	}
+	return true;
+}
+
+SOCKET ProxyUdpRelay::connectForwardServer(const ForwardServerInfo &forwardServerInfo)
+{
+	struct addrinfo hints;
+	struct addrinfo *result=NULL;
+	ZeroMemory( &hints, sizeof(hints) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_protocol = IPPROTO_UDP;
+
+	int iResult = RESOLVER_CACHE_INSTANCE.GetAddrInfo(forwardServerInfo.hostname, forwardServerInfo.port, &hints, &result);
+	if ( iResult != 0 ) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return INVALID_SOCKET;
+	}
+
+	SOCKET forwardSocket=INVALID_SOCKET;
+	struct addrinfo *iPtr=0;
+	for(iPtr=result; iPtr != NULL ;iPtr=iPtr->ai_next) {
+		forwardSocket = socket(iPtr->ai_family, iPtr->ai_socktype, iPtr->ai_protocol);
+		if (forwardSocket == INVALID_SOCKET)
+			continue;
+		// connected, so the datagrams from the other sources are filtered by the network stack
+		iResult = connect( forwardSocket, iPtr->ai_addr, static_cast<int>(iPtr->ai_addrlen));
+		if (iResult == SOCKET_ERROR) {
+			closesocket(forwardSocket);
+			forwardSocket = INVALID_SOCKET;
+			continue;
+		}
+		break;
+	}
+	ResolverCache::FreeAddrInfo(result);
+	if (forwardSocket == INVALID_SOCKET) {
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Unable to connect to forward server!\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return INVALID_SOCKET;
+	}
+	disableConnectionReset(forwardSocket);
+	return forwardSocket;
+}
+
+bool ProxyUdpRelay::postReceive(Binding *binding)
+{
+	ZeroMemory(&binding->m_overlapped,sizeof(OVERLAPPED));
+	binding->m_wsaBuffer.buf=binding->m_buffer;
+	binding->m_wsaBuffer.len=PROXY_UDP_RELAY_DATAGRAM_BYTE_SIZE;
+	binding->m_flags=0;
+	if(WSARecv(binding->m_forwardSocket,&binding->m_wsaBuffer,1,NULL,&binding->m_flags,&binding->m_overlapped,NULL)==SOCKET_ERROR && WSAGetLastError()!=WSA_IO_PENDING)
+		return false;
+	return true;
+}
+
+void ProxyUdpRelay::closeBinding(Binding *binding)
+{
+	ProxyUpstreamGroup *upstreamGroup;
+	{
+		// the worker never posts on the socket handle closed, which could be reused,
+		// and closes the socket itself if still setting up
+		ScopedLock<RuntimeLockPolicy> lock(binding->m_bindingLock);
+		binding->m_isClosed=true;
+		if(binding->m_forwardSocket!=INVALID_SOCKET)
+			closesocket(binding->m_forwardSocket);
+		upstreamGroup=binding->m_upstreamGroup;
+	}
+	if(upstreamGroup)
+		upstreamGroup->Release(binding->m_upstreamIdx);
+	releaseBinding(binding);
+}
+
+void ProxyUdpRelay::releaseBinding(Binding *binding)
+{
+	if(InterlockedDecrement(&binding->m_refCount)!=0)
+		return;
+	EP_DELETE binding;
+	if(InterlockedDecrement(&m_bindingCount)==0)
+		m_idleEvent.SetEvent();
+}
+
+void ProxyUdpRelay::expireBindings(unsigned int tick)
+{
+	for(size_t bucketTrav=0;bucketTrav<m_bucketList.size();bucketTrav++)
+	{
+		Binding **bindingLink=&m_bucketList[bucketTrav];
+		while(*bindingLink)
+		{
+			Binding *binding=*bindingLink;
+			if(tick-binding->m_lastActiveTick<m_expiryMilliSec)
+			{
+				bindingLink=&binding->m_next;
+				continue;
+			}
+			*bindingLink=binding->m_next;
+			m_tableCount--;
+			closeBinding(binding);
+		}
+	}
+}
+
+void ProxyUdpRelay::growTable()
+{
+	vector<Binding*> bucketList(m_bucketList.size()*2,NULL);
+	for(size_t bucketTrav=0;bucketTrav<m_bucketList.size();bucketTrav++)
+	{
+		Binding *binding=m_bucketList[bucketTrav];
+		while(binding)
+		{
+			Binding *nextBinding=binding->m_next;
+			size_t bucketIdx=static_cast<size_t>(binding->m_clientAddress.GetHash(m_hashSeed))&(bucketList.size()-1);
+			binding->m_next=bucketList[bucketIdx];
+			bucketList[bucketIdx]=binding;
+			binding=nextBinding;
+		}
+	}
+	m_bucketList.swap(bucketList);
+}
+
+void ProxyUdpRelay::cleanUpRelay()
+{
+	// wakes the workers to stop
+	for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+		PostQueuedCompletionStatus(m_completionPort,0,0,NULL);
+	for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+	{
+		m_workerList[workerTrav]->TerminateAfter(WAITTIME_INIFINITE);
+		EP_DELETE m_workerList[workerTrav];
+	}
+	m_workerList.clear();
+	if(m_completionPort)
+	{
+		CloseHandle(m_completionPort);
+		m_completionPort=NULL;
+	}
+	if(m_listenSocket!=INVALID_SOCKET)
+	{
+		closesocket(m_listenSocket);
+		m_listenSocket=INVALID_SOCKET;
+	}
+	m_offload.Reset();
+	m_forwardOffload.Reset();
+	WSACleanup();
+}
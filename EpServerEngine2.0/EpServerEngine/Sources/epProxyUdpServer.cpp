@@ -39,13 +39,17 @@ using namespace epse;
 ProxyUdpServer::ProxyUdpServer(epl::LockPolicy lockPolicyType):BaseProxyServer(lockPolicyType)
 {
 	m_proxyServer=EP_NEW AsyncUdpServer(lockPolicyType);
+	m_relay=EP_NEW ProxyUdpRelay(lockPolicyType);
 }
 ProxyUdpServer::ProxyUdpServer(const ProxyUdpServer& b):BaseProxyServer(b)
 {
 	m_proxyServer=EP_NEW AsyncUdpServer(*((AsyncUdpServer*)b.m_proxyServer));
+	m_relay=EP_NEW ProxyUdpRelay(b.m_lockPolicy);
 }
 ProxyUdpServer::~ProxyUdpServer()
 {
+	m_relay->StopRelay();
+	EP_DELETE m_relay;
 }
 ProxyUdpServer & ProxyUdpServer::operator=(const ProxyUdpServer&b)
 {
@@ -55,9 +59,48 @@ ProxyUdpServer & ProxyUdpServer::operator=(const ProxyUdpServer&b)
 	}
 	return *this;
 }
+
+bool ProxyUdpServer::StartServer(const ProxyServerOps &ops)
+{
+	if(!ops.isPassthrough)
+		return BaseProxyServer::StartServer(ops);
+	{
+		epl::LockObj lock(m_baseProxyServerLock);
+		m_callBack=ops.callBackObj;
+		EP_ASSERT(m_callBack);
+		m_upstreamGroup=ops.upstreamGroup;
+	}
+	return m_relay->StartRelay(ops.port,ops.callBackObj,ops.upstreamGroup,ops.udpRelayWorkerCount,ops.udpBindingExpiryMilliSec,ops.udpBindingLimit);
+}
+
+void ProxyUdpServer::StopServer()
+{
+	m_relay->StopRelay();
+	BaseProxyServer::StopServer();
+}
+
+bool ProxyUdpServer::IsServerStarted() const
+{
+	if(m_relay->IsRelayStarted())
+		return true;
+	return BaseProxyServer::IsServerStarted();
+}
 void ProxyUdpServer::OnNewConnection(SocketInterface *socket)
 {
-	epl::LockObj lock(m_baseProxyServerLock);
-	ProxyUdpHandler *newHandler=EP_NEW ProxyUdpHandler(m_callBack,m_callBack->GetForwardServerInfo(socket->GetSockAddr()),socket);
-	m_proxyHandlerList.push_back(newHandler);
+	ProxyServerCallbackInterface *callBack;
+	ForwardServerInfo forwardServerInfo;
+	unsigned int upstreamIdx=0;
+	ProxyUpstreamGroup *upstreamGroup;
+	{
+		epl::LockObj lock(m_baseProxyServerLock);
+		callBack=m_callBack;
+		upstreamGroup=selectForwardServer(socket,forwardServerInfo,upstreamIdx);
+	}
+	unsigned int connectTick=GetTickCount();
+
+	// built without the lock, since the handler connects to the forward server
+	ProxyUdpHandler *newHandler=EP_NEW ProxyUdpHandler(callBack,forwardServerInfo,socket);
+	if(upstreamGroup)
+		newHandler->setUpstreamGroup(upstreamGroup,upstreamIdx,connectTick);
+	addHandler(newHandler,callBack);
 }
@@ -0,0 +1,403 @@
+/*! 
+ProxyUpstreamGroup for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyUpstreamGroup.h"
+#include "epResolverCache.h"
+#include <algorithm>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+static const unsigned __int64 FNV_OFFSET_BASIS=14695981039346656037ULL;
+static const unsigned __int64 FNV_PRIME=1099511628211ULL;
+
+static unsigned __int64 hashBytes(unsigned __int64 hash,const void *data,size_t byteSize)
+{
+	const unsigned char *bytes=reinterpret_cast<const unsigned char*>(data);
+	for(size_t trav=0;trav<byteSize;trav++)
+	{
+		hash^=bytes[trav];
+		hash*=FNV_PRIME;
+	}
+	return hash;
+}
+
+static unsigned __int64 mixHash(unsigned __int64 hash)
+{
+	hash^=hash>>33;
+	hash*=0xff51afd7ed558ccdULL;
+	hash^=hash>>33;
+	hash*=0xc4ceb9fe1a85ec53ULL;
+	hash^=hash>>33;
+	return hash;
+}
+
+static unsigned __int64 hashClientIP(const sockaddr *sockAddr,int sockAddrSize)
+{
+	// the port is left out, so every connection from the client sticks to the same upstream
+	unsigned __int64 hash=hashBytes(FNV_OFFSET_BASIS,&sockAddr->sa_family,sizeof(sockAddr->sa_family));
+	if(sockAddr->sa_family==AF_INET && sockAddrSize>=static_cast<int>(sizeof(sockaddr_in)))
+	{
+		const sockaddr_in *sockAddrIn=reinterpret_cast<const sockaddr_in*>(sockAddr);
+		hash=hashBytes(hash,&sockAddrIn->sin_addr,sizeof(sockAddrIn->sin_addr));
+	}
+	else if(sockAddr->sa_family==AF_INET6 && sockAddrSize>=static_cast<int>(sizeof(sockaddr_in6)))
+	{
+		const sockaddr_in6 *sockAddrIn6=reinterpret_cast<const sockaddr_in6*>(sockAddr);
+		hash=hashBytes(hash,&sockAddrIn6->sin6_addr,sizeof(sockAddrIn6->sin6_addr));
+	}
+	else if(sockAddrSize>static_cast<int>(sizeof(sockAddr->sa_family)))
+	{
+		hash=hashBytes(hash,sockAddr->sa_data,sockAddrSize-sizeof(sockAddr->sa_family));
+	}
+	return mixHash(hash);
+}
+
+ProxyUpstreamGroup::ProxyUpstreamGroup(UpstreamBalancePolicy policy,epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_groupLock(lockPolicyType)
+{
+	m_policy=policy;
+	m_nextIdx=0;
+	m_randomState=static_cast<unsigned int>(mixHash(GetTickCount()^reinterpret_cast<size_t>(this)))|1;
+	m_healthCheckMilliSec=PROXY_UPSTREAM_HEALTH_CHECK_MILLISEC;
+	m_threadStopEvent=LightEvent(false,true);
+}
+
+ProxyUpstreamGroup::~ProxyUpstreamGroup()
+{
+	StopHealthCheck();
+	vector<Upstream*>::iterator iter;
+	for(iter=m_upstreamList.begin();iter!=m_upstreamList.end();iter++)
+	{
+		EP_DELETE (*iter);
+	}
+	m_upstreamList.clear();
+}
+
+unsigned int ProxyUpstreamGroup::AddUpstream(const ForwardServerInfo &forwardServerInfo)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	Upstream *upstream=EP_NEW Upstream();
+	upstream->m_hostName=forwardServerInfo.hostname;
+	upstream->m_port=forwardServerInfo.port;
+	upstream->m_stats.outstandingCount=0;
+	upstream->m_stats.latencyMilliSec=0;
+	upstream->m_stats.requestCount=0;
+	upstream->m_stats.failureCount=0;
+	upstream->m_stats.isHealthy=true;
+	upstream->m_stats.isEjected=false;
+	upstream->m_failureStreak=0;
+	upstream->m_ejectTick=0;
+	unsigned int upstreamIdx=static_cast<unsigned int>(m_upstreamList.size());
+	m_upstreamList.push_back(upstream);
+
+	unsigned __int64 hash=hashBytes(FNV_OFFSET_BASIS,upstream->m_hostName.c_str(),upstream->m_hostName.length()*sizeof(TCHAR));
+	hash=hashBytes(hash,upstream->m_port.c_str(),upstream->m_port.length()*sizeof(TCHAR));
+	for(unsigned int nodeTrav=0;nodeTrav<PROXY_UPSTREAM_HASH_VIRTUAL_NODE_COUNT;nodeTrav++)
+	{
+		m_hashRing.push_back(pair<unsigned __int64,unsigned int>(mixHash(hashBytes(hash,&nodeTrav,sizeof(nodeTrav))),upstreamIdx));
+	}
+	sort(m_hashRing.begin(),m_hashRing.end());
+	return upstreamIdx;
+}
+
+unsigned int ProxyUpstreamGroup::GetUpstreamCount() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	return static_cast<unsigned int>(m_upstreamList.size());
+}
+
+void ProxyUpstreamGroup::SetBalancePolicy(UpstreamBalancePolicy policy)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	m_policy=policy;
+}
+
+UpstreamBalancePolicy ProxyUpstreamGroup::GetBalancePolicy() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	return m_policy;
+}
+
+bool ProxyUpstreamGroup::StartHealthCheck(unsigned int periodMilliSec)
+{
+	if(GetStatus()!=THREAD_STATUS_TERMINATED)
+		return true;
+	m_healthCheckMilliSec=periodMilliSec;
+	m_threadStopEvent.ResetEvent();
+	return Start();
+}
+
+void ProxyUpstreamGroup::StopHealthCheck(unsigned int waitTimeInMilliSec)
+{
+	m_threadStopEvent.SetEvent();
+	TerminateAfter(waitTimeInMilliSec);
+}
+
+bool ProxyUpstreamGroup::Select(const sockaddr *sockAddr,int sockAddrSize,unsigned int &retUpstreamIdx)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	unsigned int upstreamCount=static_cast<unsigned int>(m_upstreamList.size());
+	if(!upstreamCount)
+		return false;
+	unsigned int tick=GetTickCount();
+	unsigned int upstreamIdx=upstreamCount;
+
+	switch(m_policy)
+	{
+	case UPSTREAM_BALANCE_POLICY_LEAST_OUTSTANDING:
+		{
+			for(unsigned int upstreamTrav=0;upstreamTrav<upstreamCount;upstreamTrav++)
+			{
+				if(!isAvailable(m_upstreamList[upstreamTrav],tick))
+					continue;
+				if(upstreamIdx==upstreamCount || getScore(m_upstreamList[upstreamTrav])<getScore(m_upstreamList[upstreamIdx]))
+					upstreamIdx=upstreamTrav;
+			}
+		}
+		break;
+	case UPSTREAM_BALANCE_POLICY_POWER_OF_TWO_CHOICES:
+		{
+			upstreamIdx=findAvailable(nextRandom()%upstreamCount,tick);
+			unsigned int secondIdx=findAvailable(nextRandom()%upstreamCount,tick);
+			if(upstreamIdx<upstreamCount && getScore(m_upstreamList[secondIdx])<getScore(m_upstreamList[upstreamIdx]))
+				upstreamIdx=secondIdx;
+		}
+		break;
+	case UPSTREAM_BALANCE_POLICY_CONSISTENT_HASH:
+		{
+			size_t ringSize=m_hashRing.size();
+			size_t ringIdx=lower_bound(m_hashRing.begin(),m_hashRing.end(),pair<unsigned __int64,unsigned int>(hashClientIP(sockAddr,sockAddrSize),0))-m_hashRing.begin();
+			// walk the ring on, so only the clients of the unavailable upstream move
+			for(size_t ringTrav=0;ringTrav<ringSize;ringTrav++)
+			{
+				unsigned int pointIdx=m_hashRing[(ringIdx+ringTrav)%ringSize].second;
+				if(isAvailable(m_upstreamList[pointIdx],tick))
+				{
+					upstreamIdx=pointIdx;
+					break;
+				}
+			}
+			if(upstreamIdx==upstreamCount)
+				upstreamIdx=m_hashRing[ringIdx%ringSize].second;
+		}
+		break;
+	default:
+		{
+			upstreamIdx=findAvailable(m_nextIdx,tick);
+			if(upstreamIdx<upstreamCount)
+				m_nextIdx=(upstreamIdx+1)%upstreamCount;
+		}
+		break;
+	}
+
+	// none available, so let them all take the load rather than refuse
+	if(upstreamIdx>=upstreamCount)
+	{
+		upstreamIdx=m_nextIdx;
+		m_nextIdx=(m_nextIdx+1)%upstreamCount;
+	}
+	m_upstreamList[upstreamIdx]->m_stats.outstandingCount++;
+	m_upstreamList[upstreamIdx]->m_stats.requestCount++;
+	retUpstreamIdx=upstreamIdx;
+	return true;
+}
+
+ForwardServerInfo ProxyUpstreamGroup::GetForwardServerInfo(unsigned int upstreamIdx) const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	ForwardServerInfo forwardServerInfo;
+	if(upstreamIdx<m_upstreamList.size())
+	{
+		forwardServerInfo.hostname=m_upstreamList[upstreamIdx]->m_hostName.c_str();
+		forwardServerInfo.port=m_upstreamList[upstreamIdx]->m_port.c_str();
+	}
+	return forwardServerInfo;
+}
+
+void ProxyUpstreamGroup::ReportConnect(unsigned int upstreamIdx,unsigned int latencyMilliSec,bool isSucceeded)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	if(upstreamIdx>=m_upstreamList.size())
+		return;
+	Upstream *upstream=m_upstreamList[upstreamIdx];
+	if(isSucceeded)
+	{
+		addLatency(upstream,latencyMilliSec);
+		upstream->m_failureStreak=0;
+		upstream->m_stats.isEjected=false;
+		return;
+	}
+	upstream->m_stats.failureCount++;
+	upstream->m_failureStreak++;
+	if(upstream->m_failureStreak>=PROXY_UPSTREAM_EJECT_FAILURE_COUNT && !upstream->m_stats.isEjected)
+	{
+		upstream->m_stats.isEjected=true;
+		upstream->m_ejectTick=GetTickCount();
+	}
+}
+
+void ProxyUpstreamGroup::Release(unsigned int upstreamIdx)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	if(upstreamIdx<m_upstreamList.size() && m_upstreamList[upstreamIdx]->m_stats.outstandingCount)
+		m_upstreamList[upstreamIdx]->m_stats.outstandingCount--;
+}
+
+bool ProxyUpstreamGroup::GetUpstreamStats(unsigned int upstreamIdx,ProxyUpstreamStats &retStats) const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+	if(upstreamIdx>=m_upstreamList.size())
+		return false;
+	retStats=m_upstreamList[upstreamIdx]->m_stats;
+	return true;
+}
+
+void ProxyUpstreamGroup::execute()
+{
+	do{
+		unsigned int upstreamCount=GetUpstreamCount();
+		for(unsigned int upstreamTrav=0;upstreamTrav<upstreamCount;upstreamTrav++)
+		{
+			const TCHAR *hostName;
+			const TCHAR *port;
+			{
+				ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+				hostName=m_upstreamList[upstreamTrav]->m_hostName.c_str();
+				port=m_upstreamList[upstreamTrav]->m_port.c_str();
+			}
+			unsigned int latencyMilliSec=0;
+			bool isHealthy=Probe(hostName,port,latencyMilliSec);
+
+			ScopedLock<RuntimeLockPolicy> lock(m_groupLock);
+			Upstream *upstream=m_upstreamList[upstreamTrav];
+			upstream->m_stats.isHealthy=isHealthy;
+			if(isHealthy)
+			{
+				addLatency(upstream,latencyMilliSec);
+				// passing the check lets the ejected upstream back in early
+				upstream->m_failureStreak=0;
+				upstream->m_stats.isEjected=false;
+			}
+		}
+	}while(!m_threadStopEvent.WaitForEvent(m_healthCheckMilliSec));
+}
+
+bool ProxyUpstreamGroup::isAvailable(Upstream *upstream,unsigned int tick)
+{
+	if(!upstream->m_stats.isHealthy)
+		return false;
+	if(upstream->m_stats.isEjected)
+	{
+		if(tick-upstream->m_ejectTick<PROXY_UPSTREAM_EJECT_MILLISEC)
+			return false;
+		upstream->m_stats.isEjected=false;
+		upstream->m_failureStreak=0;
+	}
+	return true;
+}
+
+unsigned __int64 ProxyUpstreamGroup::getScore(const Upstream *upstream)
+{
+	return static_cast<unsigned __int64>(upstream->m_stats.outstandingCount+1)*(upstream->m_stats.latencyMilliSec+1);
+}
+
+unsigned int ProxyUpstreamGroup::findAvailable(unsigned int upstreamIdx,unsigned int tick)
+{
+	unsigned int upstreamCount=static_cast<unsigned int>(m_upstreamList.size());
+	for(unsigned int upstreamTrav=0;upstreamTrav<upstreamCount;upstreamTrav++)
+	{
+		unsigned int candidateIdx=(upstreamIdx+upstreamTrav)%upstreamCount;
+		if(isAvailable(m_upstreamList[candidateIdx],tick))
+			return candidateIdx;
+	}
+	return upstreamCount;
+}
+
+unsigned int ProxyUpstreamGroup::nextRandom()
+{
+	// xorshift32
+	m_randomState^=m_randomState<<13;
+	m_randomState^=m_randomState>>17;
+	m_randomState^=m_randomState<<5;
+	return m_randomState;
+}
+
+void ProxyUpstreamGroup::addLatency(Upstream *upstream,unsigned int latencyMilliSec)
+{
+	if(!upstream->m_stats.latencyMilliSec)
+		upstream->m_stats.latencyMilliSec=latencyMilliSec;
+	else
+		upstream->m_stats.latencyMilliSec=(upstream->m_stats.latencyMilliSec*7+latencyMilliSec)/8;
+}
+
+bool ProxyUpstreamGroup::Probe(const TCHAR *hostName,const TCHAR *port,unsigned int &retLatencyMilliSec)
+{
+	struct addrinfo hints;
+	struct addrinfo *result=NULL;
+	ZeroMemory( &hints, sizeof(hints) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	DWORD startTick=GetTickCount();
+	if(RESOLVER_CACHE_INSTANCE.GetAddrInfo(hostName, port, &hints, &result)!=0)
+		return false;
+
+	bool isConnected=false;
+	for(struct addrinfo *iPtr=result; iPtr != NULL && !isConnected ;iPtr=iPtr->ai_next) {
+		SOCKET probeSocket = socket(iPtr->ai_family, iPtr->ai_socktype, iPtr->ai_protocol);
+		if (probeSocket == INVALID_SOCKET)
+			continue;
+		u_long isNonBlocking=1;
+		ioctlsocket(probeSocket,FIONBIO,&isNonBlocking);
+		if(connect(probeSocket, iPtr->ai_addr, static_cast<int>(iPtr->ai_addrlen))!=SOCKET_ERROR)
+		{
+			isConnected=true;
+		}
+		else if(WSAGetLastError()==WSAEWOULDBLOCK)
+		{
+			fd_set writeSet;
+			fd_set exceptSet;
+			FD_ZERO(&writeSet);
+			FD_ZERO(&exceptSet);
+			FD_SET(probeSocket,&writeSet);
+			FD_SET(probeSocket,&exceptSet);
+			timeval timeOut;
+			timeOut.tv_sec=PROXY_UPSTREAM_PROBE_TIMEOUT_MILLISEC/1000;
+			timeOut.tv_usec=(PROXY_UPSTREAM_PROBE_TIMEOUT_MILLISEC%1000)*1000;
+			if(select(0,NULL,&writeSet,&exceptSet,&timeOut)>0 && FD_ISSET(probeSocket,&writeSet))
+				isConnected=true;
+		}
+		closesocket(probeSocket);
+	}
+	ResolverCache::FreeAddrInfo(result);
+	retLatencyMilliSec=GetTickCount()-startTick;
+	return isConnected;
+}
@@ -0,0 +1,433 @@
+/*! 
+ProxyUpstreamPool for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epProxyUpstreamPool.h"
+#include "epAsyncTcpClient.h"
+#include "epProxyUpstreamGroup.h"
+#include <algorithm>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+ProxyUpstreamPool::ProxyUpstreamPool(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_poolLock(lockPolicyType)
+{
+	m_minimumCount=PROXY_UPSTREAM_POOL_MIN_COUNT;
+	m_maximumCount=CONNECTION_LIMIT_INFINITE;
+	m_healthCheckMilliSec=PROXY_UPSTREAM_HEALTH_CHECK_MILLISEC;
+	m_isStateless=false;
+	m_isStarted=false;
+	m_wakeEvent=LightEvent(false,false);
+	m_lockPolicy=lockPolicyType;
+}
+
+ProxyUpstreamPool::~ProxyUpstreamPool()
+{
+	StopPool();
+	vector<Upstream*>::iterator iter;
+	for(iter=m_upstreamList.begin();iter!=m_upstreamList.end();iter++)
+	{
+		EP_DELETE (*iter);
+	}
+	m_upstreamList.clear();
+}
+
+bool ProxyUpstreamPool::StartPool(unsigned int minimumCount,unsigned int maximumCount,unsigned int healthCheckMilliSec,bool isStateless)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		if(m_isStarted)
+			return true;
+		m_minimumCount=minimumCount;
+		m_maximumCount=maximumCount;
+		if(m_maximumCount!=CONNECTION_LIMIT_INFINITE && m_minimumCount>m_maximumCount)
+			m_minimumCount=m_maximumCount;
+		m_healthCheckMilliSec=healthCheckMilliSec;
+		m_isStateless=isStateless;
+		// swapped with the list of the pool thread, so the capacity is kept by both
+		m_reapList.reserve(PROXY_UPSTREAM_REAP_RESERVE_COUNT);
+		m_isStarted=true;
+	}
+	m_wakeEvent.ResetEvent();
+	if(Start())
+		return true;
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	m_isStarted=false;
+	return false;
+}
+
+void ProxyUpstreamPool::StopPool(unsigned int waitTimeInMilliSec)
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		m_isStarted=false;
+	}
+	m_wakeEvent.SetEvent();
+	TerminateAfter(waitTimeInMilliSec);
+
+	vector<BaseClient*> clientList;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		clientList.swap(m_reapList);
+		for(size_t upstreamTrav=0;upstreamTrav<m_upstreamList.size();upstreamTrav++)
+		{
+			Upstream *upstream=m_upstreamList[upstreamTrav];
+			upstream->m_connectionCount-=static_cast<unsigned int>(upstream->m_idleList.size()+upstream->m_quietList.size());
+			clientList.insert(clientList.end(),upstream->m_idleList.begin(),upstream->m_idleList.end());
+			upstream->m_idleList.clear();
+			vector<QuietClient>::iterator quietIter;
+			for(quietIter=upstream->m_quietList.begin();quietIter!=upstream->m_quietList.end();quietIter++)
+				clientList.push_back(quietIter->m_client);
+			upstream->m_quietList.clear();
+		}
+	}
+	deleteClients(clientList);
+}
+
+bool ProxyUpstreamPool::IsPoolStarted() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+	return m_isStarted;
+}
+
+unsigned int ProxyUpstreamPool::AddUpstream(const ForwardServerInfo &forwardServerInfo)
+{
+	unsigned int upstreamIdx;
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		upstreamIdx=findUpstream(forwardServerInfo);
+		if(upstreamIdx<m_upstreamList.size())
+			return upstreamIdx;
+		Upstream *upstream=EP_NEW Upstream();
+		upstream->m_hostName=forwardServerInfo.hostname;
+		upstream->m_port=forwardServerInfo.port;
+		upstream->m_idleList.reserve(m_minimumCount);
+		upstream->m_connectionCount=0;
+		upstream->m_isHealthy=true;
+		m_upstreamList.push_back(upstream);
+	}
+	m_wakeEvent.SetEvent();
+	return upstreamIdx;
+}
+
+BaseClient *ProxyUpstreamPool::Checkout(const ForwardServerInfo &forwardServerInfo,ClientCallbackInterface *callBackObj,unsigned int &retUpstreamIdx)
+{
+	retUpstreamIdx=AddUpstream(forwardServerInfo);
+	BaseClient *client=NULL;
+	const TCHAR *hostName;
+	const TCHAR *port;
+	while(true)
+	{
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+			Upstream *upstream=m_upstreamList[retUpstreamIdx];
+			while(upstream->m_idleList.size())
+			{
+				client=upstream->m_idleList.back();
+				upstream->m_idleList.pop_back();
+				if(client->IsConnectionAlive() && !isTainted(client))
+					break;
+				reapClient(upstream,client);
+				client=NULL;
+			}
+			if(!client)
+				upstream->m_connectionCount++;
+			hostName=upstream->m_hostName.c_str();
+			port=upstream->m_port.c_str();
+		}
+		// the pool thread refills behind the checkout
+		m_wakeEvent.SetEvent();
+		if(!client)
+			break;
+
+		// waits for the callback of the pool in progress, so anything received while handed over is seen below
+		client->SetCallbackObject(callBackObj);
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+			if(!isTainted(client))
+				return client;
+		}
+		client->SetCallbackObject(this);
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		reapClient(m_upstreamList[retUpstreamIdx],client);
+		client=NULL;
+	}
+
+	client=connect(hostName,port,callBackObj);
+	if(!client)
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		m_upstreamList[retUpstreamIdx]->m_connectionCount--;
+	}
+	return client;
+}
+
+void ProxyUpstreamPool::Release(BaseClient *client,unsigned int upstreamIdx)
+{
+	if(!client)
+		return;
+	// the handler releasing might be deleted before the connection, so its callback in progress is waited for
+	client->SetCallbackObject(this);
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		Upstream *upstream=m_upstreamList[upstreamIdx];
+		if(m_isStarted)
+		{
+			if(m_isStateless && client->IsConnectionAlive() && !isTainted(client) && (m_maximumCount==CONNECTION_LIMIT_INFINITE || upstream->m_connectionCount<=m_maximumCount))
+			{
+				// not reused until quiet, so a late reply to this client is not handed to the next
+				QuietClient quietClient;
+				quietClient.m_client=client;
+				quietClient.m_releaseTick=GetTickCount();
+				upstream->m_quietList.push_back(quietClient);
+				return;
+			}
+			// deleted by the pool thread, since this might be called back from the connection's own thread
+			reapClient(upstream,client);
+			client=NULL;
+		}
+		else
+		{
+			upstream->m_connectionCount--;
+		}
+	}
+	if(client)
+	{
+		vector<BaseClient*> clientList;
+		clientList.push_back(client);
+		deleteClients(clientList);
+		return;
+	}
+	m_wakeEvent.SetEvent();
+}
+
+void ProxyUpstreamPool::OnReceived(ClientInterface *client,const Packet*receivedPacket,ReceiveStatus status)
+{
+	BaseClient *pooledClient=reinterpret_cast<BaseClient*>(client);
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		for(size_t upstreamTrav=0;upstreamTrav<m_upstreamList.size();upstreamTrav++)
+		{
+			Upstream *upstream=m_upstreamList[upstreamTrav];
+			vector<BaseClient*>::iterator idleIter=find(upstream->m_idleList.begin(),upstream->m_idleList.end(),pooledClient);
+			if(idleIter!=upstream->m_idleList.end())
+			{
+				upstream->m_idleList.erase(idleIter);
+				reapClient(upstream,pooledClient);
+				pooledClient=NULL;
+				break;
+			}
+			vector<QuietClient>::iterator quietIter;
+			for(quietIter=upstream->m_quietList.begin();quietIter!=upstream->m_quietList.end();quietIter++)
+			{
+				if(quietIter->m_client==pooledClient)
+					break;
+			}
+			if(quietIter!=upstream->m_quietList.end())
+			{
+				upstream->m_quietList.erase(quietIter);
+				reapClient(upstream,pooledClient);
+				pooledClient=NULL;
+				break;
+			}
+		}
+		// being handed over, so reaped by the checkout or the release
+		if(pooledClient && !isTainted(pooledClient))
+			m_taintedList.push_back(pooledClient);
+	}
+	m_wakeEvent.SetEvent();
+}
+
+void ProxyUpstreamPool::execute()
+{
+	vector<BaseClient*> reapList;
+	reapList.reserve(PROXY_UPSTREAM_REAP_RESERVE_COUNT);
+	while(true)
+	{
+		// the active health check, outside the lock as it connects
+		unsigned int upstreamIdx;
+		for(upstreamIdx=0;;upstreamIdx++)
+		{
+			Upstream *upstream;
+			{
+				ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+				if(!m_isStarted)
+					return;
+				if(upstreamIdx>=m_upstreamList.size())
+					break;
+				upstream=m_upstreamList[upstreamIdx];
+			}
+			unsigned int latencyMilliSec=0;
+			bool isHealthy=ProxyUpstreamGroup::Probe(upstream->m_hostName.c_str(),upstream->m_port.c_str(),latencyMilliSec);
+			ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+			upstream->m_isHealthy=isHealthy;
+		}
+
+		{
+			ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+			if(!m_isStarted)
+				return;
+			unsigned int tick=GetTickCount();
+			for(size_t upstreamTrav=0;upstreamTrav<m_upstreamList.size();upstreamTrav++)
+				checkClients(m_upstreamList[upstreamTrav],tick);
+			reapList.swap(m_reapList);
+		}
+		deleteClients(reapList);
+
+		upstreamIdx=0;
+		while(true)
+		{
+			Upstream *upstream;
+			{
+				ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+				if(!m_isStarted)
+					return;
+				if(upstreamIdx>=m_upstreamList.size())
+					break;
+				upstream=m_upstreamList[upstreamIdx];
+				// not refilled until the forward server passes the health check
+				if(!upstream->m_isHealthy || upstream->m_idleList.size()>=m_minimumCount || (m_maximumCount!=CONNECTION_LIMIT_INFINITE && upstream->m_connectionCount>=m_maximumCount))
+				{
+					upstreamIdx++;
+					continue;
+				}
+				upstream->m_connectionCount++;
+			}
+
+			BaseClient *client=connect(upstream->m_hostName.c_str(),upstream->m_port.c_str(),this);
+
+			ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+			if(client)
+			{
+				upstream->m_idleList.push_back(client);
+			}
+			else
+			{
+				// retried on the next health check
+				upstream->m_connectionCount--;
+				upstreamIdx++;
+			}
+		}
+		m_wakeEvent.WaitForEvent(m_healthCheckMilliSec);
+	}
+}
+
+unsigned int ProxyUpstreamPool::findUpstream(const ForwardServerInfo &forwardServerInfo) const
+{
+	unsigned int upstreamIdx;
+	for(upstreamIdx=0;upstreamIdx<m_upstreamList.size();upstreamIdx++)
+	{
+		if(m_upstreamList[upstreamIdx]->m_hostName.compare(forwardServerInfo.hostname)==0 && m_upstreamList[upstreamIdx]->m_port.compare(forwardServerInfo.port)==0)
+			break;
+	}
+	return upstreamIdx;
+}
+
+BaseClient *ProxyUpstreamPool::connect(const TCHAR *hostName,const TCHAR *port,ClientCallbackInterface *callBackObj)
+{
+	BaseClient *client=EP_NEW AsyncTcpClient(m_lockPolicy);
+	ClientOps ops;
+	ops.callBackObj=callBackObj;
+	ops.hostName=hostName;
+	ops.port=port;
+	ops.isAsynchronousReceive=false;
+	if(client->Connect(ops))
+		return client;
+	EP_DELETE client;
+	return NULL;
+}
+
+void ProxyUpstreamPool::deleteClients(vector<BaseClient*> &clientList)
+{
+	vector<BaseClient*>::iterator iter;
+	for(iter=clientList.begin();iter!=clientList.end();iter++)
+		(*iter)->Disconnect();
+	{
+		// no callback is left once disconnected, so forgotten before the address can be reused
+		ScopedLock<RuntimeLockPolicy> lock(m_poolLock);
+		for(iter=clientList.begin();iter!=clientList.end();iter++)
+		{
+			vector<BaseClient*>::iterator taintedIter=find(m_taintedList.begin(),m_taintedList.end(),*iter);
+			if(taintedIter!=m_taintedList.end())
+				m_taintedList.erase(taintedIter);
+		}
+	}
+	for(iter=clientList.begin();iter!=clientList.end();iter++)
+		EP_DELETE (*iter);
+	clientList.clear();
+}
+
+void ProxyUpstreamPool::reapClient(Upstream *upstream,BaseClient *client)
+{
+	upstream->m_connectionCount--;
+	m_reapList.push_back(client);
+}
+
+bool ProxyUpstreamPool::isTainted(const BaseClient *client) const
+{
+	return find(m_taintedList.begin(),m_taintedList.end(),client)!=m_taintedList.end();
+}
+
+void ProxyUpstreamPool::checkClients(Upstream *upstream,unsigned int tick)
+{
+	vector<BaseClient*> &idleList=upstream->m_idleList;
+	for(size_t idleTrav=0;idleTrav<idleList.size();)
+	{
+		BaseClient *client=idleList[idleTrav];
+		if(upstream->m_isHealthy && client->IsConnectionAlive() && !isTainted(client))
+		{
+			idleTrav++;
+			continue;
+		}
+		idleList[idleTrav]=idleList.back();
+		idleList.pop_back();
+		reapClient(upstream,client);
+	}
+
+	vector<QuietClient> &quietList=upstream->m_quietList;
+	for(size_t quietTrav=0;quietTrav<quietList.size();)
+	{
+		BaseClient *client=quietList[quietTrav].m_client;
+		if(upstream->m_isHealthy && client->IsConnectionAlive() && !isTainted(client))
+		{
+			if(tick-quietList[quietTrav].m_releaseTick<PROXY_UPSTREAM_QUIET_MILLISEC)
+			{
+				quietTrav++;
+				continue;
+			}
+			idleList.push_back(client);
+		}
+		else
+		{
+			reapClient(upstream,client);
+		}
+		quietList[quietTrav]=quietList.back();
+		quietList.pop_back();
+	}
+}
@@ -0,0 +1,386 @@
+/*! 
+ResolverCache for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epResolverCache.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+/// round up to keep each part of the copied addresses aligned
+#define RESOLVER_CACHE_ALIGN(byteSize) (((byteSize)+7)&~static_cast<size_t>(7))
+
+ResolverCache::ResolverCache(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_cacheLock(lockPolicyType)
+{
+	m_refreshEvent=LightEvent(false,false);
+	m_isStopping=false;
+	m_timeToLiveMilliSec=RESOLVER_CACHE_TIME_TO_LIVE_MILLISEC;
+	m_negativeTimeToLiveMilliSec=RESOLVER_CACHE_NEGATIVE_TIME_TO_LIVE_MILLISEC;
+	m_hitCount=0;
+	m_missCount=0;
+}
+
+ResolverCache::~ResolverCache()
+{
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+		m_isStopping=true;
+	}
+	m_refreshEvent.SetEvent();
+	TerminateAfter(WAITTIME_INIFINITE);
+	Invalidate();
+}
+
+int ResolverCache::GetAddrInfo(const char *hostName,const char *port,const struct addrinfo *hints,struct addrinfo **retResult)
+{
+	*retResult=NULL;
+
+	Entry entry;
+	if(hostName)
+		entry.m_hostName=hostName;
+	if(port)
+		entry.m_port=port;
+	ZeroMemory(&entry.m_hints,sizeof(entry.m_hints));
+	if(hints)
+	{
+		entry.m_hints.ai_flags=hints->ai_flags;
+		entry.m_hints.ai_family=hints->ai_family;
+		entry.m_hints.ai_socktype=hints->ai_socktype;
+		entry.m_hints.ai_protocol=hints->ai_protocol;
+	}
+	entry.m_result=NULL;
+	entry.m_error=0;
+	entry.m_resolvedTick=0;
+	entry.m_isRefreshing=false;
+	string key=makeKey(hostName,port,entry.m_hints);
+
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+		map<string,Entry>::iterator iter=m_cache.find(key);
+		if(iter!=m_cache.end())
+		{
+			Entry &cachedEntry=iter->second;
+			unsigned int age=GetTickCount()-cachedEntry.m_resolvedTick;
+			unsigned int timeToLive=getTimeToLive(cachedEntry);
+			if(age<timeToLive)
+			{
+				m_hitCount++;
+				if(!cachedEntry.m_result)
+					return cachedEntry.m_error;
+
+				// served as is, while resolved again before it expires
+				if(!cachedEntry.m_isRefreshing && !m_isStopping && age>=timeToLive/100*RESOLVER_CACHE_REFRESH_PERCENTAGE)
+				{
+					cachedEntry.m_isRefreshing=true;
+					m_refreshQueue.push_back(key);
+					if(GetStatus()!=Thread::THREAD_STATUS_STARTED)
+						Start();
+					m_refreshEvent.SetEvent();
+				}
+				*retResult=copyAddrInfo(cachedEntry.m_result);
+				return 0;
+			}
+		}
+		m_missCount++;
+	}
+
+	struct addrinfo *result=NULL;
+	int error=resolve(entry,&result);
+	if(error==0)
+		*retResult=copyAddrInfo(result);
+
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	store(key,entry,result,error);
+	return error;
+}
+
+void ResolverCache::FreeAddrInfo(struct addrinfo *result)
+{
+	if(result)
+		EP_DELETE[] reinterpret_cast<char*>(result);
+}
+
+void ResolverCache::Invalidate(const char *hostName,const char *port)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	map<string,Entry>::iterator iter=m_cache.begin();
+	while(iter!=m_cache.end())
+	{
+		if(hostName && (iter->second.m_hostName!=hostName || (port && iter->second.m_port!=port)))
+		{
+			iter++;
+			continue;
+		}
+		if(iter->second.m_result)
+			freeaddrinfo(iter->second.m_result);
+		m_cache.erase(iter++);
+	}
+	if(!hostName)
+		m_refreshQueue.clear();
+}
+
+void ResolverCache::SetTimeToLive(unsigned int timeToLiveMilliSec,unsigned int negativeTimeToLiveMilliSec)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	m_timeToLiveMilliSec=timeToLiveMilliSec;
+	m_negativeTimeToLiveMilliSec=negativeTimeToLiveMilliSec;
+}
+
+unsigned int ResolverCache::GetTimeToLive() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	return m_timeToLiveMilliSec;
+}
+
+unsigned int ResolverCache::GetNegativeTimeToLive() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	return m_negativeTimeToLiveMilliSec;
+}
+
+unsigned int ResolverCache::GetHitCount() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	return m_hitCount;
+}
+
+unsigned int ResolverCache::GetMissCount() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	return m_missCount;
+}
+
+void ResolverCache::ResetStatistics()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+	m_hitCount=0;
+	m_missCount=0;
+}
+
+void ResolverCache::execute()
+{
+	while(true)
+	{
+		m_refreshEvent.WaitForEvent();
+		while(true)
+		{
+			string key;
+			Entry entry;
+			{
+				ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+				if(m_isStopping)
+					return;
+				if(!m_refreshQueue.size())
+					break;
+				key=m_refreshQueue.front();
+				m_refreshQueue.pop_front();
+				map<string,Entry>::iterator iter=m_cache.find(key);
+				if(iter==m_cache.end() || !iter->second.m_isRefreshing)
+					continue;
+				entry=iter->second;
+				entry.m_result=NULL;
+			}
+
+			struct addrinfo *result=NULL;
+			int error=resolve(entry,&result);
+
+			ScopedLock<RuntimeLockPolicy> lock(m_cacheLock);
+			map<string,Entry>::iterator iter=m_cache.find(key);
+			if(iter==m_cache.end() || !iter->second.m_isRefreshing)
+			{
+				// invalidated while resolving
+				if(result)
+					freeaddrinfo(result);
+				continue;
+			}
+			if(error!=0)
+			{
+				// the addresses resolved before are served until they expire
+				continue;
+			}
+			store(key,entry,result,error);
+		}
+	}
+}
+
+string ResolverCache::makeKey(const char *hostName,const char *port,const struct addrinfo &hints)
+{
+	string key;
+	if(hostName)
+		key.append(hostName);
+	key.push_back('\0');
+	if(port)
+		key.append(port);
+	key.push_back('\0');
+	key.append(reinterpret_cast<const char*>(&hints.ai_flags),sizeof(hints.ai_flags));
+	key.append(reinterpret_cast<const char*>(&hints.ai_family),sizeof(hints.ai_family));
+	key.append(reinterpret_cast<const char*>(&hints.ai_socktype),sizeof(hints.ai_socktype));
+	key.append(reinterpret_cast<const char*>(&hints.ai_protocol),sizeof(hints.ai_protocol));
+	return key;
+}
+
+struct addrinfo *ResolverCache::copyAddrInfo(const struct addrinfo *result)
+{
+	if(!result)
+		return NULL;
+
+	// one block, so the caller frees it at once
+	size_t byteSize=0;
+	const struct addrinfo *iPtr=NULL;
+	for(iPtr=result;iPtr!=NULL;iPtr=iPtr->ai_next)
+	{
+		byteSize+=RESOLVER_CACHE_ALIGN(sizeof(struct addrinfo));
+		byteSize+=RESOLVER_CACHE_ALIGN(iPtr->ai_addrlen);
+		if(iPtr->ai_canonname)
+			byteSize+=RESOLVER_CACHE_ALIGN(strlen(iPtr->ai_canonname)+1);
+	}
+
+	char *block=EP_NEW char[byteSize];
+	char *blockPtr=block;
+	struct addrinfo *prevCopy=NULL;
+	for(iPtr=result;iPtr!=NULL;iPtr=iPtr->ai_next)
+	{
+		struct addrinfo *copy=reinterpret_cast<struct addrinfo*>(blockPtr);
+		blockPtr+=RESOLVER_CACHE_ALIGN(sizeof(struct addrinfo));
+		*copy=*iPtr;
+		copy->ai_next=NULL;
+		copy->ai_addr=NULL;
+		copy->ai_canonname=NULL;
+		if(iPtr->ai_addr)
+		{
+			copy->ai_addr=reinterpret_cast<struct sockaddr*>(blockPtr);
+			epl::System::Memcpy(copy->ai_addr,iPtr->ai_addr,iPtr->ai_addrlen);
+		}
+		blockPtr+=RESOLVER_CACHE_ALIGN(iPtr->ai_addrlen);
+		if(iPtr->ai_canonname)
+		{
+			size_t nameByteSize=strlen(iPtr->ai_canonname)+1;
+			copy->ai_canonname=blockPtr;
+			epl::System::Memcpy(copy->ai_canonname,iPtr->ai_canonname,nameByteSize);
+			blockPtr+=RESOLVER_CACHE_ALIGN(nameByteSize);
+		}
+		if(prevCopy)
+			prevCopy->ai_next=copy;
+		prevCopy=copy;
+	}
+	return reinterpret_cast<struct addrinfo*>(block);
+}
+
+int ResolverCache::resolve(const Entry &entry,struct addrinfo **retResult)
+{
+	const char *hostName=NULL;
+	if(entry.m_hostName.length())
+		hostName=entry.m_hostName.c_str();
+	const char *port=NULL;
+	if(entry.m_port.length())
+		port=entry.m_port.c_str();
+	int iResult=getaddrinfo(hostName,port,&entry.m_hints,retResult);
+	if(iResult!=0)
+	{
+		*retResult=NULL;
+		epl::System::OutputDebugString(_T("%s::%s(%d) getaddrinfo failed with error: %d\r\n"),__TFILE__,__TFUNCTION__,__LINE__,iResult);
+	}
+	return iResult;
+}
+
+void ResolverCache::store(const string &key,const Entry &entry,struct addrinfo *result,int error)
+{
+	map<string,Entry>::iterator iter=m_cache.find(key);
+	unsigned int timeToLive=m_timeToLiveMilliSec;
+	if(error!=0)
+		timeToLive=m_negativeTimeToLiveMilliSec;
+	if(!timeToLive || m_isStopping)
+	{
+		// not cached
+		if(result)
+			freeaddrinfo(result);
+		if(iter!=m_cache.end())
+		{
+			if(iter->second.m_result)
+				freeaddrinfo(iter->second.m_result);
+			m_cache.erase(iter);
+		}
+		return;
+	}
+
+	if(iter==m_cache.end())
+	{
+		if(m_cache.size()>=RESOLVER_CACHE_ENTRY_LIMIT)
+			evict();
+		iter=m_cache.insert(pair<string,Entry>(key,entry)).first;
+	}
+	else if(iter->second.m_result)
+	{
+		freeaddrinfo(iter->second.m_result);
+	}
+	iter->second.m_result=result;
+	iter->second.m_error=error;
+	iter->second.m_resolvedTick=GetTickCount();
+	iter->second.m_isRefreshing=false;
+}
+
+void ResolverCache::evict()
+{
+	unsigned int tick=GetTickCount();
+	map<string,Entry>::iterator oldestIter=m_cache.end();
+	unsigned int oldestAge=0;
+	map<string,Entry>::iterator iter=m_cache.begin();
+	while(iter!=m_cache.end())
+	{
+		unsigned int age=tick-iter->second.m_resolvedTick;
+		if(age>=getTimeToLive(iter->second))
+		{
+			if(iter->second.m_result)
+				freeaddrinfo(iter->second.m_result);
+			m_cache.erase(iter++);
+			continue;
+		}
+		if(oldestIter==m_cache.end() || age>oldestAge)
+		{
+			oldestIter=iter;
+			oldestAge=age;
+		}
+		iter++;
+	}
+
+	// none expired, so the oldest gives way
+	if(m_cache.size()>=RESOLVER_CACHE_ENTRY_LIMIT && oldestIter!=m_cache.end())
+	{
+		if(oldestIter->second.m_result)
+			freeaddrinfo(oldestIter->second.m_result);
+		m_cache.erase(oldestIter);
+	}
+}
+
+unsigned int ResolverCache::getTimeToLive(const Entry &entry) const
+{
+	if(entry.m_result)
+		return m_timeToLiveMilliSec;
+	return m_negativeTimeToLiveMilliSec;
+}
@@ -36,7 +36,7 @@ using namespace epse;
 ServerObjectRemover::ServerObjectRemover(unsigned int waitTimeMilliSec,epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),SmartObject(lockPolicyType)
 {
 	m_waitTime=waitTimeMilliSec;
-	m_threadStopEvent=EventEx(false,false);
+	m_threadStopEvent=LightEvent(false,false);
 	m_lockPolicy=lockPolicyType;
 	switch(lockPolicyType)
 	{
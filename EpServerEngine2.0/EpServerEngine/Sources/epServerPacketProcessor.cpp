@@ -50,6 +50,7 @@ void ServerPacketProcessor::execute()
 {
 	if(m_packetReceived)
 	{
+		MessageArenaScope arenaScope(&m_arena);
 		m_callBackObj->OnReceived((SocketInterface*)m_owner,m_packetReceived,RECEIVE_STATUS_SUCCESS);
 		removeSelfFromContainer();
 	}
@@ -95,9 +95,10 @@ bool SyncTcpClient::Connect(const ClientOps &ops)
 	SetWaitTime(ops.waitTimeMilliSec);
 
 
+	m_connectTimeOutMilliSec=ops.connectTimeOutMilliSec;
+
 	WSADATA wsaData;
 	m_connectSocket=INVALID_SOCKET;
-	struct addrinfo hints;
 	int iResult;
 
 	// Initialize Winsock
@@ -107,43 +108,10 @@ bool SyncTcpClient::Connect(const ClientOps &ops)
 		return false;
 	}
 
-	ZeroMemory( &hints, sizeof(hints) );
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_socktype = SOCK_STREAM;
-	hints.ai_protocol = IPPROTO_TCP;
-
-	// Resolve the server address and port
-	iResult = getaddrinfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
-	if ( iResult != 0 ) {
-		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
-		WSACleanup();
-		return false;
-	}
-
-	// Attempt to connect to an address until one succeeds
-	struct addrinfo *iPtr=0;
-	for(iPtr=m_result; iPtr != NULL ;iPtr=iPtr->ai_next) {
-
-		// Create a SOCKET for connecting to server
-		m_connectSocket = socket(iPtr->ai_family, iPtr->ai_socktype, 
-			iPtr->ai_protocol);
-		if (m_connectSocket == INVALID_SOCKET) {
-			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Socket failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
-			cleanUpClient();
-			return false;
-		}
-
-		// Connect to server.
-		iResult = connect( m_connectSocket, iPtr->ai_addr, static_cast<int>(iPtr->ai_addrlen));
-		if (iResult == SOCKET_ERROR) {
-			closesocket(m_connectSocket);
-			m_connectSocket = INVALID_SOCKET;
-			continue;
-		}
-		break;
-	}
-	if (m_connectSocket == INVALID_SOCKET) {
-		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Unable to connect to server!\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+	m_isConnectCanceled=false;
+	ConnectStatus status;
+	if(!connectToServer(status))
+	{
 		cleanUpClient();
 		return false;
 	}
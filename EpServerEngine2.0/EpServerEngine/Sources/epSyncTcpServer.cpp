@@ -57,18 +57,20 @@ SyncTcpServer & SyncTcpServer::operator=(const SyncTcpServer&b)
 void SyncTcpServer::execute()
 {
 	SOCKET clientSocket;
-	sockaddr sockAddr;
-	int sizeOfSockAddr=sizeof(sockaddr);
+	SOCKADDR_STORAGE sockAddrStorage;
+	sockaddr *sockAddr=reinterpret_cast<sockaddr*>(&sockAddrStorage);
+	int sizeOfSockAddr;
 	while(1)
 	{
-		clientSocket=accept(m_listenSocket,&sockAddr,&sizeOfSockAddr);
+		sizeOfSockAddr=sizeof(SOCKADDR_STORAGE);
+		clientSocket=accept(m_listenSocket,sockAddr,&sizeOfSockAddr);
 		if(clientSocket == INVALID_SOCKET || m_listenSocket== INVALID_SOCKET)
 		{
 			break;			
 		}
 		else
 		{
-			if(!m_callBackObj->OnAccept(sockAddr))
+			if(!m_callBackObj->OnAccept(sockAddr,sizeOfSockAddr))
 			{
 				closesocket(clientSocket);
 				continue;
@@ -81,7 +83,8 @@ void SyncTcpServer::execute()
 			}
 			accWorker->setClientSocket(clientSocket);
 			accWorker->setOwner(this);
-			accWorker->setSockAddr(sockAddr);
+			accWorker->setMemoryBudget(m_memoryBudget,GetConnectionMemoryBudgetByteSize());
+			accWorker->setSockAddr(sockAddr,sizeOfSockAddr);
 			m_socketList.Push(accWorker);	
 			accWorker->Start();
 			accWorker->ReleaseObj();
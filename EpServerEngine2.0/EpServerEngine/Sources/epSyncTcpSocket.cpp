@@ -144,12 +144,44 @@ Packet *SyncTcpSocket::Receive(unsigned int waitTimeInMilliSec,ReceiveStatus *re
 		return NULL;
 	}
 
+	// memory budget routine
+	unsigned int nextPacketByteSize=0;
+	if(peekPacketByteSize(nextPacketByteSize) && !m_memoryBudget->CanAcquire(nextPacketByteSize))
+	{
+		if(!m_memoryBudget->IsInBudget(nextPacketByteSize))
+		{
+			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded for %d bytes\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,nextPacketByteSize);
+			killConnection();
+		}
+		// otherwise the packet is left in the socket buffer, so the peer is throttled by TCP flow control
+		if(retStatus)
+			*retStatus=RECEIVE_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED;
+		return NULL;
+	}
+
 	// receive routine
 	int iResult =receive(m_recvSizePacket);
 	if(iResult>0)
 	{
 		unsigned int shouldReceive=(reinterpret_cast<unsigned int*>(const_cast<char*>(m_recvSizePacket.GetPacket())))[0];
-		Packet *recvPacket=EP_NEW Packet(NULL,shouldReceive);
+		Packet *recvPacket=NULL;
+		if(m_memoryBudget->CanAcquire(shouldReceive))
+		{
+			recvPacket=EP_NEW Packet(NULL,shouldReceive);
+			if(!recvPacket->ChargeMemoryBudget(m_memoryBudget))
+			{
+				recvPacket->ReleaseObj();
+				recvPacket=NULL;
+			}
+		}
+		if(!recvPacket)
+		{
+			epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded for %d bytes\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this,shouldReceive);
+			killConnection();
+			if(retStatus)
+				*retStatus=RECEIVE_STATUS_FAIL_MEMORY_BUDGET_EXCEEDED;
+			return NULL;
+		}
 		iResult = receive(*recvPacket);
 
 		if (iResult == shouldReceive) {
@@ -110,7 +110,7 @@ bool SyncUdpClient::Connect(const ClientOps &ops)
 	hints.ai_protocol = IPPROTO_UDP;
 
 	// Resolve the server address and port
-	iResult = getaddrinfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
+	iResult = RESOLVER_CACHE_INSTANCE.GetAddrInfo(m_hostName.c_str(), m_port.c_str(), &hints, &m_result);
 	if ( iResult != 0 ) {
 		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) getaddrinfo failed with error\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
 		WSACleanup();
@@ -138,6 +138,11 @@ bool SyncUdpClient::Connect(const ClientOps &ops)
 
 	int nTmp = sizeof(int);
 	getsockopt(m_connectSocket, SOL_SOCKET,SO_MAX_MSG_SIZE, (char *)&m_maxPacketSize,&nTmp);
+	if(!setUpSession(ops))
+	{
+		cleanUpClient();
+		return false;
+	}
 	m_isConnected=true;
 	return true;
 }
@@ -208,6 +213,15 @@ Packet *SyncUdpClient::Receive(unsigned int waitTimeInMilliSec,ReceiveStatus *re
 		return NULL;
 	}
 
+	// packets delivered together by the channel layer
+	Packet *channelPacket=popChannelPacket();
+	if(channelPacket)
+	{
+		if(retStatus)
+			*retStatus=RECEIVE_STATUS_SUCCESS;
+		return channelPacket;
+	}
+
 	// select routine
 	TIMEVAL	timeOutVal;
 	fd_set	fdSet;
@@ -243,14 +257,31 @@ Packet *SyncUdpClient::Receive(unsigned int waitTimeInMilliSec,ReceiveStatus *re
 	}
 
 	int iResult=0;
+	bool isMoveNotice=false;
 	Packet recvPacket(NULL,m_maxPacketSize);
-	iResult = receive(recvPacket);
+	iResult = receive(recvPacket,isMoveNotice);
 
 	if (iResult > 0) {
-		Packet *passPacket=EP_NEW Packet(recvPacket.GetPacket(),iResult);
+		vector<Packet*> packetList;
+		unpackDatagram(recvPacket.GetPacket(),iResult,packetList);
+		if(packetList.empty())
+		{
+			// acknowledgement only, or not deliverable yet
+			if(retStatus)
+				*retStatus=RECEIVE_STATUS_FAIL_TIME_OUT;
+			return NULL;
+		}
+		pushChannelPackets(packetList,1);
 		if(retStatus)
 			*retStatus=RECEIVE_STATUS_SUCCESS;
-		return passPacket;
+		return packetList.at(0);
+	}
+	else if (isMoveNotice)
+	{
+		// the session moved to another port of the server
+		if(retStatus)
+			*retStatus=RECEIVE_STATUS_FAIL_TIME_OUT;
+		return NULL;
 	}
 	else if (iResult == 0)
 	{
@@ -54,65 +54,41 @@ SyncUdpServer & SyncUdpServer::operator=(const SyncUdpServer&b)
 	return *this;
 }
 
-void SyncUdpServer::execute()
+void SyncUdpServer::handleDatagram(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize)
 {
-	Packet recvPacket(NULL,m_maxPacketSize);
-	char *packetData=const_cast<char*>(recvPacket.GetPacket());
-	int length=recvPacket.GetPacketByteSize();
-	sockaddr clientSockAddr;
-	int sockAddrSize=sizeof(sockaddr);
-	while(m_listenSocket!=INVALID_SOCKET)
+	SyncUdpSocket *workerObj=(SyncUdpSocket*)m_sessionTable.Find(clientAddress);
+	if(workerObj)
 	{
-		int recvLength=recvfrom(m_listenSocket,packetData,length, 0,&clientSockAddr,&sockAddrSize);
-
-		SyncUdpSocket *workerObj=(SyncUdpSocket*)m_socketList.Find(clientSockAddr,socketCompare);
-		if(workerObj)
+		deliverPacket(workerObj,packetData,recvLength,segmentByteSize);
+		workerObj->ReleaseObj();
+	}
+	else
+	{
+		if(recvLength<=0)
+			return;
+		// a client is handled in one shard at a time, so the lock is just for the connection count
+		ScopedLock<RuntimeLockPolicy> acceptLock(m_acceptLock);
+		if(GetMaximumConnectionCount()!=CONNECTION_LIMIT_INFINITE)
 		{
-			if(recvLength<=0)
+			if(m_socketList.Count()>=GetMaximumConnectionCount())
 			{
-				Packet *passPacket=EP_NEW Packet(packetData,0);
-				workerObj->addPacket(passPacket);
-				passPacket->ReleaseObj();
-				continue;
-			}	
-			Packet *passPacket=EP_NEW Packet(packetData,recvLength);
-			workerObj->addPacket(passPacket);
-			passPacket->ReleaseObj();
+				return;
+			}
 		}
-		else
+		if(!m_callBackObj->OnAccept(clientAddress.GetSockAddr(),clientAddress.GetSockAddrSize()))
 		{
-			if(recvLength<=0)
-				continue;
-			if(GetMaximumConnectionCount()!=CONNECTION_LIMIT_INFINITE)
-			{
-				if(m_socketList.Count()>=GetMaximumConnectionCount())
-				{
-					continue;
-				}
-			}
-			if(!m_callBackObj->OnAccept(clientSockAddr))
-			{
-				continue;
-			}
-			/// Create Worker Thread
-			SyncUdpSocket *accWorker=EP_NEW SyncUdpSocket(m_callBackObj,m_waitTime,m_lockPolicy);
-			if(!accWorker)
-			{
-				continue;
-			}
-			Packet *passPacket=EP_NEW Packet(packetData,recvLength);
-			accWorker->setSockAddr(clientSockAddr);
-			accWorker->setOwner(this);
-			accWorker->setMaxPacketByteSize(m_maxPacketSize);
-			m_socketList.Push(accWorker);
-			accWorker->Start();
-			accWorker->addPacket(passPacket);
-			accWorker->ReleaseObj();
-			passPacket->ReleaseObj();
-
+			return;
 		}
+		/// Create Worker Thread
+		SyncUdpSocket *accWorker=EP_NEW SyncUdpSocket(m_callBackObj,m_waitTime,m_lockPolicy);
+		if(!accWorker)
+		{
+			return;
+		}
+		addSession(accWorker,clientAddress);
+		accWorker->Start();
+		deliverPacket(accWorker,packetData,recvLength,segmentByteSize);
+		accWorker->ReleaseObj();
 
 	}
-
-	stopServer();
-} 
+}
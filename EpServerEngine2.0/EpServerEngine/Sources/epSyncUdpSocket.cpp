@@ -35,7 +35,7 @@ static char THIS_FILE[] = __FILE__;
 using namespace epse;
 SyncUdpSocket::SyncUdpSocket(ServerCallbackInterface *callBackObj,unsigned int waitTimeMilliSec,epl::LockPolicy lockPolicyType): BaseUdpSocket(callBackObj,waitTimeMilliSec,lockPolicyType)
 {
-	m_packetReceivedEvent=EventEx(false,false);
+	m_packetReceivedEvent=LightEvent(false,false);
 	m_isConnected=true;
 }
 
@@ -58,17 +58,9 @@ void SyncUdpSocket::KillConnection()
 	}
 	m_isConnected=false;
 
-	m_listLock->Lock();
-	Packet *removeElem=NULL;
-	while(!m_packetList.empty())
-	{
-		removeElem=m_packetList.front();
-		if(removeElem)
-			removeElem->ReleaseObj();
-		m_packetList.pop();
-	}
-	m_listLock->Unlock();
+	m_packetQueue.Clear();
 
+	removeSelfFromSessionTable();
 	removeSelfFromContainer();
 	m_callBackObj->OnDisconnect(this);
 }
@@ -80,18 +72,10 @@ void SyncUdpSocket::killConnection()
 	{
 		m_isConnected=false;
 
-		m_listLock->Lock();
-		Packet *removeElem=NULL;
-		while(!m_packetList.empty())
-		{
-			removeElem=m_packetList.front();
-			if(removeElem)
-				removeElem->ReleaseObj();
-			m_packetList.pop();
-		}
-		m_listLock->Unlock();
+		m_packetQueue.Clear();
 
 
+		removeSelfFromSessionTable();
 		removeSelfFromContainer();
 		m_callBackObj->OnDisconnect(this);
 
@@ -100,11 +84,18 @@ void SyncUdpSocket::killConnection()
 
 void SyncUdpSocket::addPacket(Packet *packet)
 {
-	if(packet)
-		packet->RetainObj();
-	epl::LockObj lock(m_listLock);
-	m_packetList.push(packet);
-	m_packetReceivedEvent.SetEvent();
+	// the datagram is dropped when the memory budget is exceeded, as when the receive buffer is full
+	if(packet && packet->GetPacketByteSize()>0 && !packet->ChargeMemoryBudget(m_memoryBudget))
+	{
+		epl::System::OutputDebugString(_T("%s::%s(%d)(%x) Memory budget exceeded, packet dropped\r\n"),__TFILE__,__TFUNCTION__,__LINE__,this);
+		return;
+	}
+	if(!packet)
+		return;
+	packet->RetainObj();
+	// the waiting Receive is woken only when the queue turns non-empty
+	if(m_packetQueue.Push(packet))
+		m_packetReceivedEvent.SetEvent();
 }
 
 int SyncUdpSocket::Send(const Packet &packet, unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
@@ -124,32 +115,37 @@ Packet *SyncUdpSocket::Receive(unsigned int waitTimeInMilliSec,ReceiveStatus *re
 	}
 
 	// receive routine
-	unsigned int packetSize=0;
-
-	m_listLock->Lock();
-	if(m_packetList.size()==0)
+	Packet *packet=m_packetQueue.Pop();
+	unsigned int startTick=GetTickCount();
+	// the event may still be set for a packet already popped, so wait again until the time out passes
+	while(!packet)
 	{
-		m_listLock->Unlock();
-		if(!m_packetReceivedEvent.WaitForEvent(waitTimeInMilliSec))
+		unsigned int remainingTime=waitTimeInMilliSec;
+		if(waitTimeInMilliSec!=WAITTIME_INIFINITE)
 		{
-			if(retStatus)
-				*retStatus=RECEIVE_STATUS_FAIL_TIME_OUT;
-			return NULL;
+			unsigned int elapsedTime=GetTickCount()-startTick;
+			if(elapsedTime>=waitTimeInMilliSec)
+				break;
+			remainingTime=waitTimeInMilliSec-elapsedTime;
 		}
-
+		if(!m_packetReceivedEvent.WaitForEvent(remainingTime))
+			break;
+		packet=m_packetQueue.Pop();
+	}
+	if(!packet)
+	{
+		if(retStatus)
+			*retStatus=RECEIVE_STATUS_FAIL_TIME_OUT;
+		return NULL;
 	}
-	Packet *packet= m_packetList.front();
-	packetSize=packet->GetPacketByteSize();
-	if(packetSize==0)
+	if(packet->GetPacketByteSize()==0)
 	{
-		m_listLock->Unlock();
+		packet->ReleaseObj();
 		killConnection();
 		if(retStatus)
 			*retStatus=RECEIVE_STATUS_FAIL_CONNECTION_CLOSING;
 		return NULL;
 	}
-	m_packetList.pop();
-	m_listLock->Unlock();
 	if(retStatus)
 		*retStatus=RECEIVE_STATUS_SUCCESS;
 	return packet;
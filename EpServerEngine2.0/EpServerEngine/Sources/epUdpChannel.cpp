@@ -0,0 +1,570 @@
+/*! 
+UdpChannel for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpChannel.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+// header layout: packet sequence(2), ack(2), ack bits(4), channel id(1), flags(1), message sequence(2)
+static const unsigned char s_ackOnlyChannelId=0xFF;
+static const unsigned char s_hasAckFlag=0x01;
+
+static void writeShort(unsigned char *data,unsigned short value)
+{
+	data[0]=static_cast<unsigned char>(value>>8);
+	data[1]=static_cast<unsigned char>(value);
+}
+
+static void writeLong(unsigned char *data,unsigned int value)
+{
+	data[0]=static_cast<unsigned char>(value>>24);
+	data[1]=static_cast<unsigned char>(value>>16);
+	data[2]=static_cast<unsigned char>(value>>8);
+	data[3]=static_cast<unsigned char>(value);
+}
+
+static unsigned short readShort(const unsigned char *data)
+{
+	return static_cast<unsigned short>((data[0]<<8)|data[1]);
+}
+
+static unsigned int readLong(const unsigned char *data)
+{
+	return (static_cast<unsigned int>(data[0])<<24)|(static_cast<unsigned int>(data[1])<<16)|(static_cast<unsigned int>(data[2])<<8)|static_cast<unsigned int>(data[3]);
+}
+
+UdpChannelSession::UdpChannelSession(UdpChannelTransportInterface *transport,const UdpChannelType *channelTypes,unsigned int channelCount,unsigned int maxPacketSize,epl::LockPolicy lockPolicyType):m_sessionLock(lockPolicyType)
+{
+	EP_ASSERT(transport);
+	EP_ASSERT(channelTypes && channelCount>0 && channelCount<=UDP_CHANNEL_MAX_COUNT);
+	m_transport=transport;
+	m_maxPacketSize=maxPacketSize;
+	m_channelList.resize(channelCount);
+	for(unsigned int channelTrav=0;channelTrav<channelCount;channelTrav++)
+	{
+		m_channelList[channelTrav].m_type=channelTypes[channelTrav];
+		m_channelList[channelTrav].m_sendSequence=0;
+		m_channelList[channelTrav].m_receiveSequence=0;
+		m_channelList[channelTrav].m_hasReceived=false;
+	}
+
+	m_localSequence=0;
+	m_remoteSequence=0;
+	m_remoteAckBits=0;
+	m_hasRemoteSequence=false;
+	m_isAckPending=false;
+	m_ackPendingTick=0;
+
+	m_smoothedRtt=0;
+	m_rttVariance=0;
+	m_retransmitTimeout=UDP_CHANNEL_INITIAL_RETRANSMIT_MILLISEC;
+	m_hasRttSample=false;
+
+	m_congestionWindow=UDP_CHANNEL_INITIAL_WINDOW;
+	m_slowStartThreshold=UDP_CHANNEL_RECEIVE_WINDOW;
+	m_reductionTick=GetTickCount();
+
+	m_isFailed=false;
+}
+
+UdpChannelSession::~UdpChannelSession()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+	list<ReliableMessage>::iterator inFlightIter;
+	for(inFlightIter=m_inFlightList.begin();inFlightIter!=m_inFlightList.end();inFlightIter++)
+		inFlightIter->m_packet->ReleaseObj();
+	m_inFlightList.clear();
+
+	deque<ReliableMessage>::iterator pendingIter;
+	for(pendingIter=m_pendingList.begin();pendingIter!=m_pendingList.end();pendingIter++)
+		pendingIter->m_packet->ReleaseObj();
+	m_pendingList.clear();
+
+	for(size_t channelTrav=0;channelTrav<m_channelList.size();channelTrav++)
+	{
+		map<unsigned short,Packet*>::iterator bufferIter;
+		for(bufferIter=m_channelList[channelTrav].m_orderedBuffer.begin();bufferIter!=m_channelList[channelTrav].m_orderedBuffer.end();bufferIter++)
+			bufferIter->second->ReleaseObj();
+		m_channelList[channelTrav].m_orderedBuffer.clear();
+	}
+}
+
+bool UdpChannelSession::isSequenceNewer(unsigned short sequence,unsigned short otherSequence)
+{
+	return ((sequence>otherSequence) && (sequence-otherSequence<=32768)) || ((sequence<otherSequence) && (otherSequence-sequence>32768));
+}
+
+int UdpChannelSession::Send(unsigned int channelId,const Packet &packet,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	unsigned int messageByteSize=packet.GetPacketByteSize();
+	EP_ASSERT(messageByteSize+UDP_CHANNEL_HEADER_BYTE_SIZE<=m_maxPacketSize);
+	if(channelId>=m_channelList.size() || messageByteSize+UDP_CHANNEL_HEADER_BYTE_SIZE>m_maxPacketSize)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return -1;
+	}
+
+	m_sessionLock.Lock();
+	if(m_isFailed)
+	{
+		m_sessionLock.Unlock();
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_NOT_CONNECTED;
+		return -1;
+	}
+
+	ChannelState &channel=m_channelList[channelId];
+	unsigned short messageSequence=channel.m_sendSequence++;
+	if(channel.m_type!=UDP_CHANNEL_TYPE_RELIABLE_ORDERED)
+	{
+		Packet *datagram=buildDatagram(static_cast<unsigned char>(channelId),messageSequence,&packet);
+		m_sessionLock.Unlock();
+		int sentLength=m_transport->SendDatagram(*datagram,waitTimeInMilliSec,sendStatus);
+		datagram->ReleaseObj();
+		if(sentLength<=0)
+			return sentLength;
+		return static_cast<int>(messageByteSize);
+	}
+
+	ReliableMessage message;
+	message.m_packetSequence=0;
+	message.m_channelId=static_cast<unsigned char>(channelId);
+	message.m_messageSequence=messageSequence;
+	message.m_packet=EP_NEW Packet(packet.GetPacket(),messageByteSize);
+	message.m_sentTick=0;
+	message.m_sendCount=0;
+
+	vector<Packet*> datagramList;
+	if(!m_pendingList.empty() || m_inFlightList.size()>=static_cast<size_t>(m_congestionWindow))
+	{
+		m_pendingList.push_back(message);
+	}
+	else
+	{
+		// kept even if the send failed, so the timer retransmits it
+		datagramList.push_back(buildDatagram(message.m_channelId,message.m_messageSequence,message.m_packet,&message.m_packetSequence));
+		message.m_sentTick=GetTickCount();
+		message.m_sendCount=1;
+		m_inFlightList.push_back(message);
+	}
+	m_sessionLock.Unlock();
+	sendDatagrams(datagramList,waitTimeInMilliSec);
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return static_cast<int>(messageByteSize);
+}
+
+Packet *UdpChannelSession::buildDatagram(unsigned char channelId,unsigned short messageSequence,const Packet *packet,unsigned short *retPacketSequence)
+{
+	unsigned int messageByteSize=packet?packet->GetPacketByteSize():0;
+	Packet *datagram=EP_NEW Packet(NULL,UDP_CHANNEL_HEADER_BYTE_SIZE+messageByteSize);
+	unsigned char *data=reinterpret_cast<unsigned char*>(const_cast<char*>(datagram->GetPacket()));
+
+	// the acknowledgement only datagram does not consume the sequence, so it is never acknowledged
+	unsigned short packetSequence=m_localSequence;
+	if(channelId!=s_ackOnlyChannelId)
+		m_localSequence++;
+
+	writeShort(data,packetSequence);
+	writeShort(data+2,m_remoteSequence);
+	writeLong(data+4,m_remoteAckBits);
+	data[8]=channelId;
+	data[9]=m_hasRemoteSequence?s_hasAckFlag:0;
+	writeShort(data+10,messageSequence);
+	if(messageByteSize)
+		epl::System::Memcpy(data+UDP_CHANNEL_HEADER_BYTE_SIZE,packet->GetPacket(),messageByteSize);
+
+	m_isAckPending=false;
+	if(retPacketSequence)
+		*retPacketSequence=packetSequence;
+	return datagram;
+}
+
+void UdpChannelSession::sendDatagrams(vector<Packet*> &datagramList,unsigned int waitTimeInMilliSec)
+{
+	for(size_t datagramTrav=0;datagramTrav<datagramList.size();datagramTrav++)
+	{
+		m_transport->SendDatagram(*(datagramList[datagramTrav]),waitTimeInMilliSec,NULL);
+		datagramList[datagramTrav]->ReleaseObj();
+	}
+	datagramList.clear();
+}
+
+bool UdpChannelSession::Receive(const char *packetData,int packetByteSize,vector<Packet*> &packetList)
+{
+	vector<Packet*> datagramList;
+	m_sessionLock.Lock();
+	bool ret=receive(packetData,packetByteSize,packetList,datagramList);
+	m_sessionLock.Unlock();
+	sendDatagrams(datagramList,WAITTIME_IGNORE);
+	return ret;
+}
+
+bool UdpChannelSession::receive(const char *packetData,int packetByteSize,vector<Packet*> &packetList,vector<Packet*> &datagramList)
+{
+	if(packetByteSize<UDP_CHANNEL_HEADER_BYTE_SIZE)
+		return false;
+
+	const unsigned char *data=reinterpret_cast<const unsigned char*>(packetData);
+	unsigned short packetSequence=readShort(data);
+	unsigned short ack=readShort(data+2);
+	unsigned int ackBits=readLong(data+4);
+	unsigned char channelId=data[8];
+	unsigned char flags=data[9];
+	unsigned short messageSequence=readShort(data+10);
+	const char *message=packetData+UDP_CHANNEL_HEADER_BYTE_SIZE;
+	unsigned int messageByteSize=static_cast<unsigned int>(packetByteSize-UDP_CHANNEL_HEADER_BYTE_SIZE);
+
+	if(flags&s_hasAckFlag)
+		processAck(ack,ackBits,datagramList);
+	if(channelId==s_ackOnlyChannelId)
+		return true;
+	if(channelId>=m_channelList.size())
+		return false;
+
+	ChannelState &channel=m_channelList[channelId];
+	switch(channel.m_type)
+	{
+	case UDP_CHANNEL_TYPE_UNRELIABLE:
+		{
+			Packet *passPacket=EP_NEW Packet(message,messageByteSize);
+			passPacket->SetChannelId(channelId);
+			packetList.push_back(passPacket);
+		}
+		break;
+	case UDP_CHANNEL_TYPE_UNRELIABLE_SEQUENCED:
+		if(!channel.m_hasReceived || isSequenceNewer(messageSequence,channel.m_receiveSequence))
+		{
+			channel.m_hasReceived=true;
+			channel.m_receiveSequence=messageSequence;
+			Packet *passPacket=EP_NEW Packet(message,messageByteSize);
+			passPacket->SetChannelId(channelId);
+			packetList.push_back(passPacket);
+		}
+		break;
+	case UDP_CHANNEL_TYPE_RELIABLE_ORDERED:
+		if(messageSequence==channel.m_receiveSequence)
+		{
+			Packet *passPacket=EP_NEW Packet(message,messageByteSize);
+			passPacket->SetChannelId(channelId);
+			packetList.push_back(passPacket);
+			channel.m_receiveSequence++;
+
+			map<unsigned short,Packet*>::iterator bufferIter;
+			while((bufferIter=channel.m_orderedBuffer.find(channel.m_receiveSequence))!=channel.m_orderedBuffer.end())
+			{
+				packetList.push_back(bufferIter->second);
+				channel.m_orderedBuffer.erase(bufferIter);
+				channel.m_receiveSequence++;
+			}
+		}
+		else if(isSequenceNewer(messageSequence,channel.m_receiveSequence))
+		{
+			// not acknowledged beyond the window, so the peer retransmits it
+			if(static_cast<unsigned short>(messageSequence-channel.m_receiveSequence)>=UDP_CHANNEL_RECEIVE_WINDOW)
+				return true;
+			if(channel.m_orderedBuffer.find(messageSequence)==channel.m_orderedBuffer.end())
+			{
+				Packet *passPacket=EP_NEW Packet(message,messageByteSize);
+				passPacket->SetChannelId(channelId);
+				channel.m_orderedBuffer[messageSequence]=passPacket;
+			}
+		}
+		// otherwise already delivered, and acknowledged again below
+		break;
+	default:
+		return false;
+	}
+
+	recordReceived(packetSequence);
+	if(!m_isAckPending)
+	{
+		m_isAckPending=true;
+		m_ackPendingTick=GetTickCount();
+	}
+	return true;
+}
+
+void UdpChannelSession::recordReceived(unsigned short packetSequence)
+{
+	if(!m_hasRemoteSequence)
+	{
+		m_hasRemoteSequence=true;
+		m_remoteSequence=packetSequence;
+		m_remoteAckBits=0;
+		return;
+	}
+	if(isSequenceNewer(packetSequence,m_remoteSequence))
+	{
+		unsigned short distance=static_cast<unsigned short>(packetSequence-m_remoteSequence);
+		m_remoteAckBits=(distance>=32)?0:(m_remoteAckBits<<distance);
+		if(distance<=32)
+			m_remoteAckBits|=1u<<(distance-1);
+		m_remoteSequence=packetSequence;
+	}
+	else
+	{
+		unsigned short distance=static_cast<unsigned short>(m_remoteSequence-packetSequence);
+		if(distance>=1 && distance<=32)
+			m_remoteAckBits|=1u<<(distance-1);
+	}
+}
+
+void UdpChannelSession::processAck(unsigned short ack,unsigned int ackBits,vector<Packet*> &datagramList)
+{
+	DWORD currentTick=GetTickCount();
+	list<ReliableMessage>::iterator iter=m_inFlightList.begin();
+	while(iter!=m_inFlightList.end())
+	{
+		unsigned short distance=static_cast<unsigned short>(ack-iter->m_packetSequence);
+		if(distance==0 || (distance<=32 && (ackBits&(1u<<(distance-1)))))
+		{
+			// Karn's algorithm: no sample from the retransmitted
+			if(iter->m_sendCount==1)
+				updateRoundTripTime(currentTick-iter->m_sentTick);
+			iter->m_packet->ReleaseObj();
+			iter=m_inFlightList.erase(iter);
+
+			// slow start, then additive increase
+			if(m_congestionWindow<m_slowStartThreshold)
+				m_congestionWindow+=1.0;
+			else
+				m_congestionWindow+=1.0/m_congestionWindow;
+			if(m_congestionWindow>UDP_CHANNEL_RECEIVE_WINDOW)
+				m_congestionWindow=UDP_CHANNEL_RECEIVE_WINDOW;
+		}
+		else
+			iter++;
+	}
+	sendPending(datagramList);
+}
+
+void UdpChannelSession::updateRoundTripTime(unsigned int sampleMilliSec)
+{
+	// RFC 6298
+	if(!m_hasRttSample)
+	{
+		m_smoothedRtt=sampleMilliSec;
+		m_rttVariance=sampleMilliSec/2;
+		m_hasRttSample=true;
+	}
+	else
+	{
+		unsigned int deviation=(m_smoothedRtt>sampleMilliSec)?m_smoothedRtt-sampleMilliSec:sampleMilliSec-m_smoothedRtt;
+		m_rttVariance=(3*m_rttVariance+deviation)/4;
+		m_smoothedRtt=(7*m_smoothedRtt+sampleMilliSec)/8;
+	}
+	unsigned int variance=4*m_rttVariance;
+	if(variance<UDP_CHANNEL_TICK_MILLISEC)
+		variance=UDP_CHANNEL_TICK_MILLISEC;
+	m_retransmitTimeout=m_smoothedRtt+variance;
+	if(m_retransmitTimeout<UDP_CHANNEL_MIN_RETRANSMIT_MILLISEC)
+		m_retransmitTimeout=UDP_CHANNEL_MIN_RETRANSMIT_MILLISEC;
+	else if(m_retransmitTimeout>UDP_CHANNEL_MAX_RETRANSMIT_MILLISEC)
+		m_retransmitTimeout=UDP_CHANNEL_MAX_RETRANSMIT_MILLISEC;
+}
+
+void UdpChannelSession::sendPending(vector<Packet*> &datagramList)
+{
+	while(!m_pendingList.empty() && m_inFlightList.size()<static_cast<size_t>(m_congestionWindow))
+	{
+		ReliableMessage message=m_pendingList.front();
+		m_pendingList.pop_front();
+		datagramList.push_back(buildDatagram(message.m_channelId,message.m_messageSequence,message.m_packet,&message.m_packetSequence));
+		message.m_sentTick=GetTickCount();
+		message.m_sendCount=1;
+		m_inFlightList.push_back(message);
+	}
+}
+
+void UdpChannelSession::Update()
+{
+	bool isFailedNow=false;
+	vector<Packet*> datagramList;
+	m_sessionLock.Lock();
+	if(m_isFailed)
+	{
+		m_sessionLock.Unlock();
+		return;
+	}
+
+	DWORD currentTick=GetTickCount();
+	list<ReliableMessage>::iterator iter;
+	for(iter=m_inFlightList.begin();iter!=m_inFlightList.end();iter++)
+	{
+		// exponential backoff for each retransmission
+		unsigned int timeout=m_retransmitTimeout;
+		for(unsigned int sendTrav=1;sendTrav<iter->m_sendCount && timeout<UDP_CHANNEL_MAX_RETRANSMIT_MILLISEC;sendTrav++)
+			timeout*=2;
+		if(timeout>UDP_CHANNEL_MAX_RETRANSMIT_MILLISEC)
+			timeout=UDP_CHANNEL_MAX_RETRANSMIT_MILLISEC;
+		if(currentTick-iter->m_sentTick<timeout)
+			continue;
+
+		if(iter->m_sendCount>=UDP_CHANNEL_MAX_SEND_COUNT)
+		{
+			m_isFailed=true;
+			isFailedNow=true;
+			break;
+		}
+
+		// multiplicative decrease once per retransmission time-out
+		if(currentTick-m_reductionTick>=m_retransmitTimeout)
+		{
+			m_slowStartThreshold=m_congestionWindow/2.0;
+			if(m_slowStartThreshold<2.0)
+				m_slowStartThreshold=2.0;
+			m_congestionWindow=m_slowStartThreshold;
+			m_reductionTick=currentTick;
+		}
+
+		datagramList.push_back(buildDatagram(iter->m_channelId,iter->m_messageSequence,iter->m_packet,&iter->m_packetSequence));
+		iter->m_sentTick=currentTick;
+		iter->m_sendCount++;
+	}
+
+	if(!m_isFailed)
+	{
+		sendPending(datagramList);
+		if(m_isAckPending && currentTick-m_ackPendingTick>=UDP_CHANNEL_ACK_DELAY_MILLISEC)
+			datagramList.push_back(buildDatagram(s_ackOnlyChannelId,0,NULL));
+	}
+	m_sessionLock.Unlock();
+	sendDatagrams(datagramList,WAITTIME_IGNORE);
+
+	if(isFailedNow)
+		m_transport->OnChannelFailed();
+}
+
+bool UdpChannelSession::IsFailed() const
+{
+	return m_isFailed;
+}
+
+unsigned int UdpChannelSession::GetChannelCount() const
+{
+	return static_cast<unsigned int>(m_channelList.size());
+}
+
+unsigned int UdpChannelSession::GetRoundTripTime() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+	return m_smoothedRtt;
+}
+
+unsigned int UdpChannelSession::GetCongestionWindow() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_sessionLock);
+	return static_cast<unsigned int>(m_congestionWindow);
+}
+
+UdpChannelTimer::UdpChannelTimer(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_listLock(lockPolicyType),m_updateLock(lockPolicyType)
+{
+	m_threadStopEvent=LightEvent(false,true);
+}
+
+UdpChannelTimer::~UdpChannelTimer()
+{
+	StopTimer();
+}
+
+bool UdpChannelTimer::StartTimer()
+{
+	if(GetStatus()!=THREAD_STATUS_TERMINATED)
+		return true;
+	m_threadStopEvent.ResetEvent();
+	return Start();
+}
+
+void UdpChannelTimer::StopTimer(unsigned int waitTimeInMilliSec)
+{
+	m_threadStopEvent.SetEvent();
+	TerminateAfter(waitTimeInMilliSec);
+	ScopedLock<RuntimeLockPolicy> lock(m_listLock);
+	m_taskList.clear();
+}
+
+void UdpChannelTimer::Register(UdpTimerTaskInterface *task)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_listLock);
+	m_taskList.push_back(task);
+}
+
+void UdpChannelTimer::Unregister(UdpTimerTaskInterface *task)
+{
+	m_listLock.Lock();
+	vector<UdpTimerTaskInterface*>::iterator iter;
+	for(iter=m_taskList.begin();iter!=m_taskList.end();iter++)
+	{
+		if(*iter==task)
+		{
+			*iter=m_taskList.back();
+			m_taskList.pop_back();
+			break;
+		}
+	}
+	m_listLock.Unlock();
+
+	if(GetCurrentThreadId()==GetID())
+	{
+		// unregistered from the update of another task, so skip it in this round
+		for(size_t taskTrav=0;taskTrav<m_updateList.size();taskTrav++)
+		{
+			if(m_updateList[taskTrav]==task)
+				m_updateList[taskTrav]=NULL;
+		}
+	}
+	else
+	{
+		// the round in progress might still update the task
+		ScopedLock<RuntimeLockPolicy> lock(m_updateLock);
+	}
+}
+
+void UdpChannelTimer::execute()
+{
+	while(!m_threadStopEvent.WaitForEvent(UDP_CHANNEL_TICK_MILLISEC))
+	{
+		ScopedLock<RuntimeLockPolicy> updateLock(m_updateLock);
+		m_listLock.Lock();
+		m_updateList.assign(m_taskList.begin(),m_taskList.end());
+		m_listLock.Unlock();
+
+		// updated without the list lock, so the tasks might register and unregister meanwhile
+		for(size_t taskTrav=0;taskTrav<m_updateList.size();taskTrav++)
+		{
+			if(m_updateList[taskTrav])
+				m_updateList[taskTrav]->Update();
+		}
+		m_updateList.clear();
+	}
+}
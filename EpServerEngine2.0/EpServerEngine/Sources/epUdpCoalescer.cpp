@@ -0,0 +1,179 @@
+/*! 
+UdpCoalescer for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpCoalescer.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+// each message is prefixed by its byte size in big endian
+static void writeLength(char *data,unsigned int byteSize)
+{
+	data[0]=static_cast<char>(static_cast<unsigned char>(byteSize>>8));
+	data[1]=static_cast<char>(static_cast<unsigned char>(byteSize));
+}
+
+UdpCoalescer::UdpCoalescer(UdpCoalescerTransportInterface *transport,unsigned int maxPacketSize,unsigned int delayMilliSec,epl::LockPolicy lockPolicyType):m_coalesceLock(lockPolicyType)
+{
+	EP_ASSERT(transport);
+	m_transport=transport;
+	m_datagramByteSize=UDP_COALESCE_DATAGRAM_BYTE_SIZE;
+	if(maxPacketSize && m_datagramByteSize>maxPacketSize)
+		m_datagramByteSize=maxPacketSize;
+	m_delayMilliSec=delayMilliSec;
+	m_buffer=EP_NEW char[m_datagramByteSize];
+	m_bufferByteSize=0;
+	m_firstTick=0;
+}
+
+UdpCoalescer::~UdpCoalescer()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_coalesceLock);
+	EP_DELETE[] m_buffer;
+	m_buffer=NULL;
+	m_bufferByteSize=0;
+}
+
+unsigned int UdpCoalescer::GetReservedByteSize()
+{
+	return UDP_COALESCE_HEADER_BYTE_SIZE;
+}
+
+int UdpCoalescer::Send(const WSABUF *buffers,unsigned int bufferCount,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	unsigned int messageByteSize=0;
+	for(unsigned int bufferTrav=0;bufferTrav<bufferCount;bufferTrav++)
+		messageByteSize+=buffers[bufferTrav].len;
+	if(messageByteSize>0xffff)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return -1;
+	}
+
+	ScopedLock<RuntimeLockPolicy> lock(m_coalesceLock);
+	if(messageByteSize+UDP_COALESCE_HEADER_BYTE_SIZE>m_datagramByteSize)
+	{
+		// too large to share a datagram, so send it alone after the messages buffered to keep the order
+		int sentLength=flush(waitTimeInMilliSec,sendStatus);
+		if(sentLength<0)
+			return sentLength;
+		char header[UDP_COALESCE_HEADER_BYTE_SIZE];
+		writeLength(header,messageByteSize);
+		vector<WSABUF> sendBuffers(bufferCount+1);
+		sendBuffers[0].buf=header;
+		sendBuffers[0].len=UDP_COALESCE_HEADER_BYTE_SIZE;
+		for(unsigned int bufferTrav=0;bufferTrav<bufferCount;bufferTrav++)
+			sendBuffers[bufferTrav+1]=buffers[bufferTrav];
+		sentLength=m_transport->SendCoalesced(&sendBuffers.at(0),bufferCount+1,waitTimeInMilliSec,sendStatus);
+		if(sentLength<=0)
+			return sentLength;
+		return static_cast<int>(messageByteSize);
+	}
+
+	if(m_bufferByteSize+UDP_COALESCE_HEADER_BYTE_SIZE+messageByteSize>m_datagramByteSize)
+	{
+		int sentLength=flush(waitTimeInMilliSec,sendStatus);
+		if(sentLength<0)
+			return sentLength;
+	}
+	if(m_bufferByteSize==0)
+		m_firstTick=GetTickCount();
+	writeLength(m_buffer+m_bufferByteSize,messageByteSize);
+	m_bufferByteSize+=UDP_COALESCE_HEADER_BYTE_SIZE;
+	for(unsigned int bufferTrav=0;bufferTrav<bufferCount;bufferTrav++)
+	{
+		epl::System::Memcpy(m_buffer+m_bufferByteSize,buffers[bufferTrav].buf,buffers[bufferTrav].len);
+		m_bufferByteSize+=buffers[bufferTrav].len;
+	}
+
+	// no other message fits, so do not wait for the deadline
+	if(m_datagramByteSize-m_bufferByteSize<=UDP_COALESCE_HEADER_BYTE_SIZE)
+	{
+		int sentLength=flush(waitTimeInMilliSec,sendStatus);
+		if(sentLength<0)
+			return sentLength;
+	}
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return static_cast<int>(messageByteSize);
+}
+
+int UdpCoalescer::Flush(unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_coalesceLock);
+	return flush(waitTimeInMilliSec,sendStatus);
+}
+
+void UdpCoalescer::Update()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_coalesceLock);
+	if(m_bufferByteSize && GetTickCount()-m_firstTick>=m_delayMilliSec)
+		flush(WAITTIME_IGNORE,NULL);
+}
+
+int UdpCoalescer::flush(unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	if(m_bufferByteSize==0)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_SUCCESS;
+		return 0;
+	}
+	WSABUF buffer;
+	buffer.buf=m_buffer;
+	buffer.len=m_bufferByteSize;
+	// the messages are dropped on failure as any other datagram lost
+	m_bufferByteSize=0;
+	return m_transport->SendCoalesced(&buffer,1,waitTimeInMilliSec,sendStatus);
+}
+
+bool UdpCoalescer::Unpack(const char *packetData,int packetByteSize,vector<WSABUF> &messageList)
+{
+	int offset=0;
+	while(offset<packetByteSize)
+	{
+		if(packetByteSize-offset<UDP_COALESCE_HEADER_BYTE_SIZE)
+			return false;
+		const unsigned char *header=reinterpret_cast<const unsigned char*>(packetData+offset);
+		int messageByteSize=(static_cast<int>(header[0])<<8)|static_cast<int>(header[1]);
+		offset+=UDP_COALESCE_HEADER_BYTE_SIZE;
+		if(packetByteSize-offset<messageByteSize)
+			return false;
+		if(messageByteSize==0)
+			continue;
+		WSABUF message;
+		message.buf=const_cast<char*>(packetData)+offset;
+		message.len=static_cast<ULONG>(messageByteSize);
+		messageList.push_back(message);
+		offset+=messageByteSize;
+	}
+	return true;
+}
@@ -0,0 +1,209 @@
+/*! 
+UdpConnectedReceiver for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpConnectedReceiver.h"
+#include "epBaseUdpServer.h"
+#include "epBaseUdpSocket.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+UdpConnectedReceiver::UdpConnectedReceiver(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_listLock(lockPolicyType)
+{
+	m_server=NULL;
+	// created without Winsock, since the receiver outlives the server start
+	m_wakeEvent=CreateEvent(NULL,TRUE,FALSE,NULL);
+	m_isStopping=true;
+}
+
+UdpConnectedReceiver::~UdpConnectedReceiver()
+{
+	StopReceiver();
+	if(m_wakeEvent)
+		CloseHandle(m_wakeEvent);
+}
+
+bool UdpConnectedReceiver::StartReceiver(BaseUdpServer *server)
+{
+	if(GetStatus()!=THREAD_STATUS_TERMINATED)
+		return true;
+	EP_ASSERT(server);
+	m_server=server;
+	m_isStopping=false;
+	ResetEvent(m_wakeEvent);
+	return Start();
+}
+
+void UdpConnectedReceiver::StopReceiver(unsigned int waitTimeInMilliSec)
+{
+	m_listLock.Lock();
+	m_isStopping=true;
+	SetEvent(m_wakeEvent);
+	m_listLock.Unlock();
+	TerminateAfter(waitTimeInMilliSec);
+
+	vector<Session> sessionList;
+	m_listLock.Lock();
+	sessionList.swap(m_sessionList);
+	closeUnregisteredSessions();
+	m_listLock.Unlock();
+
+	// outside the lock, as the session registers with its connected socket lock held
+	vector<Session>::iterator iter;
+	for(iter=sessionList.begin();iter!=sessionList.end();iter++)
+	{
+		iter->m_socket->clearConnectedSocket();
+		closesocket(iter->m_connectedSocket);
+		WSACloseEvent(iter->m_event);
+		iter->m_socket->ReleaseObj();
+	}
+}
+
+bool UdpConnectedReceiver::Register(BaseUdpSocket *socket,SOCKET connectedSocket)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_listLock);
+	if(m_isStopping || m_sessionList.size()>=UDP_CONNECTED_SESSION_MAX_COUNT)
+		return false;
+	Session session;
+	session.m_event=WSACreateEvent();
+	if(session.m_event==WSA_INVALID_EVENT)
+		return false;
+	if(WSAEventSelect(connectedSocket,session.m_event,FD_READ)==SOCKET_ERROR)
+	{
+		WSACloseEvent(session.m_event);
+		return false;
+	}
+	socket->RetainObj();
+	session.m_socket=socket;
+	session.m_connectedSocket=connectedSocket;
+	m_sessionList.push_back(session);
+	SetEvent(m_wakeEvent);
+	return true;
+}
+
+void UdpConnectedReceiver::Unregister(BaseUdpSocket *socket)
+{
+	m_listLock.Lock();
+	vector<Session>::iterator iter;
+	for(iter=m_sessionList.begin();iter!=m_sessionList.end();iter++)
+	{
+		if(iter->m_socket==socket)
+		{
+			// the receiving thread might be waiting on the socket, so closed there
+			m_unregisteredSessionList.push_back(*iter);
+			*iter=m_sessionList.back();
+			m_sessionList.pop_back();
+			SetEvent(m_wakeEvent);
+			m_listLock.Unlock();
+			socket->ReleaseObj();
+			return;
+		}
+	}
+	m_listLock.Unlock();
+}
+
+void UdpConnectedReceiver::closeUnregisteredSessions()
+{
+	vector<Session>::iterator iter;
+	for(iter=m_unregisteredSessionList.begin();iter!=m_unregisteredSessionList.end();iter++)
+	{
+		closesocket(iter->m_connectedSocket);
+		WSACloseEvent(iter->m_event);
+	}
+	m_unregisteredSessionList.clear();
+}
+
+void UdpConnectedReceiver::receiveSession(const Session &session,char *packetData,int length)
+{
+	// drained, since the read event is signaled again only by a new datagram
+	while(true)
+	{
+		int recvLength=recv(session.m_connectedSocket,packetData,length,0);
+		if(recvLength==SOCKET_ERROR)
+		{
+			int error=WSAGetLastError();
+			if(error==WSAEMSGSIZE)
+				continue;
+			// the peer is unreachable, so the session is closed as on the listen socket
+			if(error==WSAECONNRESET)
+				m_server->deliverPacket(session.m_socket,packetData,0,0);
+			return;
+		}
+		// only the client moved sends to this port, so the replies may now be sent from it
+		session.m_socket->setConnected();
+		// the empty datagram is the answer to the move notice, not a close
+		if(recvLength==0)
+			continue;
+		m_server->deliverPacket(session.m_socket,packetData,recvLength,0);
+	}
+}
+
+void UdpConnectedReceiver::execute()
+{
+	Packet recvPacket(NULL,m_server->GetMaxPacketByteSize());
+	char *packetData=const_cast<char*>(recvPacket.GetPacket());
+	int length=recvPacket.GetPacketByteSize();
+	vector<WSAEVENT> eventList;
+	vector<Session> sessionList;
+	while(true)
+	{
+		m_listLock.Lock();
+		if(m_isStopping)
+		{
+			m_listLock.Unlock();
+			break;
+		}
+		// not waited on any more, as the list is taken again below
+		closeUnregisteredSessions();
+		eventList.clear();
+		eventList.push_back(m_wakeEvent);
+		sessionList=m_sessionList;
+		vector<Session>::iterator iter;
+		for(iter=sessionList.begin();iter!=sessionList.end();iter++)
+		{
+			iter->m_socket->RetainObj();
+			eventList.push_back(iter->m_event);
+		}
+		m_listLock.Unlock();
+
+		WSAWaitForMultipleEvents(static_cast<DWORD>(eventList.size()),&eventList.at(0),FALSE,WSA_INFINITE,FALSE);
+		ResetEvent(m_wakeEvent);
+
+		// the sockets unregistered meanwhile stay open until the next turn
+		for(iter=sessionList.begin();iter!=sessionList.end();iter++)
+		{
+			WSANETWORKEVENTS networkEvents;
+			if(WSAEnumNetworkEvents(iter->m_connectedSocket,iter->m_event,&networkEvents)==0 && (networkEvents.lNetworkEvents&FD_READ))
+				receiveSession(*iter,packetData,length);
+			iter->m_socket->ReleaseObj();
+		}
+		sessionList.clear();
+	}
+}
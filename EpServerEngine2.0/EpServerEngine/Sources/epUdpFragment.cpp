@@ -0,0 +1,314 @@
+/*! 
+UdpFragment for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpFragment.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+// header layout: type(1), reserved(1), fragment index(2), fragment count(2), packet or probe id(4), packet or probe byte size(4)
+static const unsigned char s_fragmentType=0x01;
+static const unsigned char s_probeType=0x02;
+static const unsigned char s_probeAckType=0x03;
+
+static void writeHeader(unsigned char *data,unsigned char type,unsigned short fragmentIndex,unsigned short fragmentCount,unsigned int id,unsigned int byteSize)
+{
+	data[0]=type;
+	data[1]=0;
+	data[2]=static_cast<unsigned char>(fragmentIndex>>8);
+	data[3]=static_cast<unsigned char>(fragmentIndex);
+	data[4]=static_cast<unsigned char>(fragmentCount>>8);
+	data[5]=static_cast<unsigned char>(fragmentCount);
+	data[6]=static_cast<unsigned char>(id>>24);
+	data[7]=static_cast<unsigned char>(id>>16);
+	data[8]=static_cast<unsigned char>(id>>8);
+	data[9]=static_cast<unsigned char>(id);
+	data[10]=static_cast<unsigned char>(byteSize>>24);
+	data[11]=static_cast<unsigned char>(byteSize>>16);
+	data[12]=static_cast<unsigned char>(byteSize>>8);
+	data[13]=static_cast<unsigned char>(byteSize);
+}
+
+static unsigned int readLong(const unsigned char *data)
+{
+	return (static_cast<unsigned int>(data[0])<<24)|(static_cast<unsigned int>(data[1])<<16)|(static_cast<unsigned int>(data[2])<<8)|static_cast<unsigned int>(data[3]);
+}
+
+UdpFragmenter::UdpFragmenter(UdpFragmentTransportInterface *transport,unsigned int maxPacketSize,unsigned int reservedByteSize,epl::LockPolicy lockPolicyType):m_fragmentLock(lockPolicyType)
+{
+	EP_ASSERT(transport);
+	m_transport=transport;
+	m_maxDatagramByteSize=UDP_FRAGMENT_MAX_DATAGRAM_BYTE_SIZE;
+	if(maxPacketSize && m_maxDatagramByteSize>maxPacketSize)
+		m_maxDatagramByteSize=maxPacketSize;
+	m_maxDatagramByteSize-=reservedByteSize;
+	m_datagramByteSize=UDP_FRAGMENT_BASE_DATAGRAM_BYTE_SIZE-reservedByteSize;
+	if(m_datagramByteSize>m_maxDatagramByteSize)
+		m_datagramByteSize=m_maxDatagramByteSize;
+	m_nextMessageId=0;
+
+	m_probeHighByteSize=m_maxDatagramByteSize;
+	m_probeByteSize=0;
+	m_probeId=0;
+	m_probeTick=0;
+	m_probeSendCount=0;
+
+	m_assemblyByteSize=0;
+}
+
+UdpFragmenter::~UdpFragmenter()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_fragmentLock);
+	map<unsigned int,Assembly>::iterator iter;
+	for(iter=m_assemblyMap.begin();iter!=m_assemblyMap.end();iter++)
+		iter->second.m_packet->ReleaseObj();
+	m_assemblyMap.clear();
+	m_assemblyByteSize=0;
+}
+
+unsigned int UdpFragmenter::GetDatagramByteSize() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_fragmentLock);
+	return m_datagramByteSize;
+}
+
+int UdpFragmenter::Send(const Packet &packet,unsigned int waitTimeInMilliSec,SendStatus *sendStatus)
+{
+	unsigned int packetByteSize=packet.GetPacketByteSize();
+	EP_ASSERT(packetByteSize<=UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE);
+	if(packetByteSize>UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE)
+	{
+		if(sendStatus)
+			*sendStatus=SEND_STATUS_FAIL_SEND_FAILED;
+		return -1;
+	}
+
+	m_fragmentLock.Lock();
+	unsigned int messageId=m_nextMessageId++;
+	unsigned int fragmentPayloadByteSize=m_datagramByteSize-UDP_FRAGMENT_HEADER_BYTE_SIZE;
+	unsigned int probeId=0;
+	unsigned int probeByteSize=nextProbe(&probeId);
+	m_fragmentLock.Unlock();
+
+	if(probeByteSize)
+		sendProbe(s_probeType,probeId,probeByteSize);
+
+	// split evenly, so the receiver places each fragment from the byte size and the count only
+	unsigned int fragmentCount=(packetByteSize+fragmentPayloadByteSize-1)/fragmentPayloadByteSize;
+	if(fragmentCount==0)
+		fragmentCount=1;
+	unsigned int fragmentByteSize=(packetByteSize+fragmentCount-1)/fragmentCount;
+
+	unsigned char header[UDP_FRAGMENT_HEADER_BYTE_SIZE];
+	WSABUF buffers[2];
+	buffers[0].buf=reinterpret_cast<char*>(header);
+	buffers[0].len=UDP_FRAGMENT_HEADER_BYTE_SIZE;
+
+	const char *packetData=packet.GetPacket();
+	for(unsigned int fragmentTrav=0;fragmentTrav<fragmentCount;fragmentTrav++)
+	{
+		unsigned int offset=fragmentTrav*fragmentByteSize;
+		unsigned int length=(fragmentTrav==fragmentCount-1)?packetByteSize-offset:fragmentByteSize;
+		writeHeader(header,s_fragmentType,static_cast<unsigned short>(fragmentTrav),static_cast<unsigned short>(fragmentCount),messageId,packetByteSize);
+		// the payload is gathered from the packet as it is
+		buffers[1].buf=const_cast<char*>(packetData)+offset;
+		buffers[1].len=length;
+		int sentLength=m_transport->SendBuffers(buffers,length?2:1,waitTimeInMilliSec,sendStatus);
+		if(sentLength<=0)
+			return sentLength;
+	}
+	if(sendStatus)
+		*sendStatus=SEND_STATUS_SUCCESS;
+	return static_cast<int>(packetByteSize);
+}
+
+unsigned int UdpFragmenter::nextProbe(unsigned int *retProbeId)
+{
+	DWORD currentTick=GetTickCount();
+	if(m_probeByteSize)
+	{
+		if(currentTick-m_probeTick<UDP_FRAGMENT_PROBE_TIMEOUT_MILLISEC)
+			return 0;
+		if(m_probeSendCount<UDP_FRAGMENT_PROBE_COUNT)
+		{
+			m_probeSendCount++;
+			m_probeTick=currentTick;
+			*retProbeId=m_probeId;
+			return m_probeByteSize;
+		}
+		// lost every time, so larger than the path MTU
+		m_probeHighByteSize=m_probeByteSize-1;
+		m_probeByteSize=0;
+	}
+
+	// binary search between the confirmed and the largest not failed
+	if(m_probeHighByteSize<m_datagramByteSize+UDP_FRAGMENT_PROBE_PRECISION)
+		return 0;
+	m_probeByteSize=(m_datagramByteSize+m_probeHighByteSize+1)/2;
+	m_probeId++;
+	m_probeSendCount=1;
+	m_probeTick=currentTick;
+	*retProbeId=m_probeId;
+	return m_probeByteSize;
+}
+
+void UdpFragmenter::sendProbe(unsigned char type,unsigned int probeId,unsigned int probeByteSize)
+{
+	unsigned char header[UDP_FRAGMENT_HEADER_BYTE_SIZE];
+	writeHeader(header,type,0,1,probeId,probeByteSize);
+	WSABUF buffers[2];
+	buffers[0].buf=reinterpret_cast<char*>(header);
+	buffers[0].len=UDP_FRAGMENT_HEADER_BYTE_SIZE;
+	if(type!=s_probeType)
+	{
+		m_transport->SendBuffers(buffers,1,WAITTIME_IGNORE,NULL);
+		return;
+	}
+
+	// padded to the probe byte size
+	Packet padding(NULL,probeByteSize-UDP_FRAGMENT_HEADER_BYTE_SIZE);
+	buffers[1].buf=const_cast<char*>(padding.GetPacket());
+	buffers[1].len=padding.GetPacketByteSize();
+	m_transport->SendBuffers(buffers,2,WAITTIME_IGNORE,NULL);
+}
+
+void UdpFragmenter::purgeAssembly(DWORD currentTick,unsigned int newByteSize)
+{
+	map<unsigned int,Assembly>::iterator iter=m_assemblyMap.begin();
+	while(iter!=m_assemblyMap.end())
+	{
+		if(currentTick-iter->second.m_firstTick>=UDP_FRAGMENT_REASSEMBLY_TIMEOUT_MILLISEC)
+		{
+			m_assemblyByteSize-=iter->second.m_packet->GetPacketByteSize();
+			iter->second.m_packet->ReleaseObj();
+			m_assemblyMap.erase(iter++);
+		}
+		else
+			iter++;
+	}
+
+	while(!m_assemblyMap.empty() && (m_assemblyMap.size()>=UDP_FRAGMENT_REASSEMBLY_MESSAGE_COUNT || m_assemblyByteSize+newByteSize>UDP_FRAGMENT_REASSEMBLY_BYTE_SIZE))
+	{
+		map<unsigned int,Assembly>::iterator oldestIter=m_assemblyMap.begin();
+		for(iter=m_assemblyMap.begin();iter!=m_assemblyMap.end();iter++)
+		{
+			if(currentTick-iter->second.m_firstTick>currentTick-oldestIter->second.m_firstTick)
+				oldestIter=iter;
+		}
+		m_assemblyByteSize-=oldestIter->second.m_packet->GetPacketByteSize();
+		oldestIter->second.m_packet->ReleaseObj();
+		m_assemblyMap.erase(oldestIter);
+	}
+}
+
+bool UdpFragmenter::Receive(const char *packetData,int packetByteSize,vector<Packet*> &packetList)
+{
+	if(packetByteSize<UDP_FRAGMENT_HEADER_BYTE_SIZE)
+		return false;
+
+	const unsigned char *data=reinterpret_cast<const unsigned char*>(packetData);
+	unsigned char type=data[0];
+	unsigned int fragmentIndex=(static_cast<unsigned int>(data[2])<<8)|data[3];
+	unsigned int fragmentCount=(static_cast<unsigned int>(data[4])<<8)|data[5];
+	unsigned int id=readLong(data+6);
+	unsigned int byteSize=readLong(data+10);
+	const char *payload=packetData+UDP_FRAGMENT_HEADER_BYTE_SIZE;
+	unsigned int payloadByteSize=static_cast<unsigned int>(packetByteSize-UDP_FRAGMENT_HEADER_BYTE_SIZE);
+
+	if(type==s_probeType)
+	{
+		if(byteSize!=static_cast<unsigned int>(packetByteSize))
+			return false;
+		sendProbe(s_probeAckType,id,byteSize);
+		return true;
+	}
+	if(type==s_probeAckType)
+	{
+		ScopedLock<RuntimeLockPolicy> lock(m_fragmentLock);
+		if(m_probeByteSize && id==m_probeId && byteSize==m_probeByteSize)
+		{
+			m_datagramByteSize=m_probeByteSize;
+			m_probeByteSize=0;
+		}
+		return true;
+	}
+	if(type!=s_fragmentType || fragmentCount==0 || fragmentIndex>=fragmentCount || byteSize>UDP_FRAGMENT_MAX_MESSAGE_BYTE_SIZE)
+		return false;
+	// no empty fragments but the packet of zero byte
+	if(fragmentCount>1 && byteSize<fragmentCount)
+		return false;
+
+	unsigned int fragmentByteSize=(byteSize+fragmentCount-1)/fragmentCount;
+	unsigned int offset=fragmentIndex*fragmentByteSize;
+	if(offset>byteSize)
+		return false;
+	unsigned int expectedByteSize=(fragmentIndex==fragmentCount-1)?byteSize-offset:fragmentByteSize;
+	if(payloadByteSize!=expectedByteSize)
+		return false;
+
+	if(fragmentCount==1)
+	{
+		packetList.push_back(EP_NEW Packet(payload,payloadByteSize));
+		return true;
+	}
+
+	ScopedLock<RuntimeLockPolicy> lock(m_fragmentLock);
+	map<unsigned int,Assembly>::iterator iter=m_assemblyMap.find(id);
+	if(iter==m_assemblyMap.end())
+	{
+		DWORD currentTick=GetTickCount();
+		purgeAssembly(currentTick,byteSize);
+		Assembly assembly;
+		assembly.m_packet=EP_NEW Packet(NULL,byteSize);
+		assembly.m_receivedList.assign(fragmentCount,false);
+		assembly.m_receivedCount=0;
+		assembly.m_firstTick=currentTick;
+		iter=m_assemblyMap.insert(pair<unsigned int,Assembly>(id,assembly)).first;
+		m_assemblyByteSize+=byteSize;
+	}
+
+	Assembly &assembly=iter->second;
+	if(assembly.m_packet->GetPacketByteSize()!=byteSize || assembly.m_receivedList.size()!=fragmentCount)
+		return false;
+	if(assembly.m_receivedList[fragmentIndex])
+		return true;
+
+	// the only copy of the fragment
+	epl::System::Memcpy(const_cast<char*>(assembly.m_packet->GetPacket())+offset,payload,payloadByteSize);
+	assembly.m_receivedList[fragmentIndex]=true;
+	assembly.m_receivedCount++;
+	if(assembly.m_receivedCount==fragmentCount)
+	{
+		packetList.push_back(assembly.m_packet);
+		m_assemblyByteSize-=byteSize;
+		m_assemblyMap.erase(iter);
+	}
+	return true;
+}
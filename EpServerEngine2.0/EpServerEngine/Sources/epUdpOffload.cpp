@@ -0,0 +1,188 @@
+/*! 
+UdpOffload for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpOffload.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+// ws2ipdef.h of the newer SDKs
+#ifndef UDP_SEND_MSG_SIZE
+#define UDP_SEND_MSG_SIZE 2
+#endif
+#ifndef UDP_RECV_MAX_COALESCED_SIZE
+#define UDP_RECV_MAX_COALESCED_SIZE 3
+#endif
+#ifndef UDP_COALESCED_INFO
+#define UDP_COALESCED_INFO 3
+#endif
+
+static GUID s_sendMsgGuid={0xa441e712,0x754f,0x43ca,{0x84,0xa7,0x0d,0xee,0x44,0xcf,0x60,0x6d}};
+static GUID s_recvMsgGuid={0xf689d7c8,0x6f1f,0x436b,{0x8a,0x53,0xe5,0x4f,0xe3,0x51,0xc3,0x22}};
+
+UdpOffload::UdpOffload()
+{
+	m_sendMsgFunc=NULL;
+	m_recvMsgFunc=NULL;
+	m_isSendOffloadSupported=0;
+	m_isReceiveCoalescing=false;
+}
+
+UdpOffload::~UdpOffload()
+{
+}
+
+bool UdpOffload::Initialize(SOCKET udpSocket)
+{
+	Reset();
+	DWORD byteReturned=0;
+	if(WSAIoctl(udpSocket,SIO_GET_EXTENSION_FUNCTION_POINTER,&s_sendMsgGuid,sizeof(GUID),&m_sendMsgFunc,sizeof(m_sendMsgFunc),&byteReturned,NULL,NULL)==SOCKET_ERROR)
+		m_sendMsgFunc=NULL;
+	byteReturned=0;
+	if(WSAIoctl(udpSocket,SIO_GET_EXTENSION_FUNCTION_POINTER,&s_recvMsgGuid,sizeof(GUID),&m_recvMsgFunc,sizeof(m_recvMsgFunc),&byteReturned,NULL,NULL)==SOCKET_ERROR)
+		m_recvMsgFunc=NULL;
+
+	// probe the option, since the control message is rejected the same way
+	DWORD segmentByteSize=0;
+	int optionSize=sizeof(DWORD);
+	if(m_sendMsgFunc && getsockopt(udpSocket,IPPROTO_UDP,UDP_SEND_MSG_SIZE,reinterpret_cast<char*>(&segmentByteSize),&optionSize)!=SOCKET_ERROR)
+		m_isSendOffloadSupported=1;
+	return m_isSendOffloadSupported!=0;
+}
+
+void UdpOffload::Reset()
+{
+	m_sendMsgFunc=NULL;
+	m_recvMsgFunc=NULL;
+	m_isSendOffloadSupported=0;
+	m_isReceiveCoalescing=false;
+}
+
+bool UdpOffload::EnableReceiveCoalescing(SOCKET udpSocket,unsigned int maxCoalescedByteSize)
+{
+	if(!m_recvMsgFunc)
+		return false;
+	DWORD coalescedByteSize=maxCoalescedByteSize;
+	if(setsockopt(udpSocket,IPPROTO_UDP,UDP_RECV_MAX_COALESCED_SIZE,reinterpret_cast<char*>(&coalescedByteSize),sizeof(DWORD))==SOCKET_ERROR)
+		return false;
+	m_isReceiveCoalescing=true;
+	return true;
+}
+
+bool UdpOffload::IsSendOffloadSupported() const
+{
+	return m_isSendOffloadSupported!=0;
+}
+
+bool UdpOffload::IsReceiveCoalescingEnabled() const
+{
+	return m_isReceiveCoalescing;
+}
+
+int UdpOffload::SendSegmented(SOCKET udpSocket,const char *data,int length,unsigned int segmentByteSize,const sockaddr *sockAddr,int sockAddrSize)
+{
+	if(!IsSendOffloadSupported())
+	{
+		WSASetLastError(WSAEOPNOTSUPP);
+		return SOCKET_ERROR;
+	}
+
+	WSABUF dataBuffer;
+	dataBuffer.buf=const_cast<char*>(data);
+	dataBuffer.len=static_cast<ULONG>(length);
+
+	char controlBuffer[WSA_CMSG_SPACE(sizeof(DWORD))];
+	epl::System::Memset(controlBuffer,0,sizeof(controlBuffer));
+
+	WSAMSG msg;
+	epl::System::Memset(&msg,0,sizeof(WSAMSG));
+	msg.name=const_cast<sockaddr*>(sockAddr);
+	msg.namelen=sockAddrSize;
+	msg.lpBuffers=&dataBuffer;
+	msg.dwBufferCount=1;
+	msg.Control.buf=controlBuffer;
+	msg.Control.len=sizeof(controlBuffer);
+
+	WSACMSGHDR *controlHeader=WSA_CMSG_FIRSTHDR(&msg);
+	controlHeader->cmsg_level=IPPROTO_UDP;
+	controlHeader->cmsg_type=UDP_SEND_MSG_SIZE;
+	controlHeader->cmsg_len=WSA_CMSG_LEN(sizeof(DWORD));
+	*reinterpret_cast<DWORD*>(WSA_CMSG_DATA(controlHeader))=segmentByteSize;
+
+	DWORD sentLength=0;
+	if(m_sendMsgFunc(udpSocket,&msg,0,&sentLength,NULL,NULL)==SOCKET_ERROR)
+	{
+		int errorCode=WSAGetLastError();
+		if(errorCode==WSAEINVAL || errorCode==WSAEOPNOTSUPP || errorCode==WSAENOPROTOOPT)
+			InterlockedExchange(&m_isSendOffloadSupported,0);
+		WSASetLastError(errorCode);
+		return SOCKET_ERROR;
+	}
+	return static_cast<int>(sentLength);
+}
+
+int UdpOffload::ReceiveFrom(SOCKET udpSocket,char *data,int length,sockaddr *sockAddr,int *sockAddrSize,unsigned int *segmentByteSize)
+{
+	*segmentByteSize=0;
+	if(!m_isReceiveCoalescing)
+		return recvfrom(udpSocket,data,length,0,sockAddr,sockAddrSize);
+
+	WSABUF dataBuffer;
+	dataBuffer.buf=data;
+	dataBuffer.len=static_cast<ULONG>(length);
+
+	char controlBuffer[WSA_CMSG_SPACE(sizeof(DWORD))*4];
+
+	WSAMSG msg;
+	epl::System::Memset(&msg,0,sizeof(WSAMSG));
+	msg.name=sockAddr;
+	msg.namelen=*sockAddrSize;
+	msg.lpBuffers=&dataBuffer;
+	msg.dwBufferCount=1;
+	msg.Control.buf=controlBuffer;
+	msg.Control.len=sizeof(controlBuffer);
+
+	DWORD recvLength=0;
+	if(m_recvMsgFunc(udpSocket,&msg,&recvLength,NULL,NULL)==SOCKET_ERROR)
+		return SOCKET_ERROR;
+	*sockAddrSize=msg.namelen;
+
+	WSACMSGHDR *controlHeader=WSA_CMSG_FIRSTHDR(&msg);
+	while(controlHeader)
+	{
+		if(controlHeader->cmsg_level==IPPROTO_UDP && controlHeader->cmsg_type==UDP_COALESCED_INFO)
+		{
+			*segmentByteSize=*reinterpret_cast<DWORD*>(WSA_CMSG_DATA(controlHeader));
+			break;
+		}
+		controlHeader=WSA_CMSG_NXTHDR(&msg,controlHeader);
+	}
+	return static_cast<int>(recvLength);
+}
@@ -0,0 +1,159 @@
+/*! 
+UdpPacketQueue for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpPacketQueue.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+UdpPacketQueue::UdpPacketQueue(epl::LockPolicy lockPolicyType):m_consumerLock(lockPolicyType)
+{
+	m_stub.m_next=NULL;
+	m_stub.m_packet=NULL;
+	m_head=&m_stub;
+	m_tail=&m_stub;
+	m_count=0;
+	InitializeSListHead(&m_freeList);
+}
+
+UdpPacketQueue::~UdpPacketQueue()
+{
+	Clear();
+	PSLIST_ENTRY entry;
+	while((entry=InterlockedPopEntrySList(&m_freeList))!=NULL)
+		EP_DELETE reinterpret_cast<Node*>(entry);
+}
+
+UdpPacketQueue::Node *UdpPacketQueue::allocateNode()
+{
+	PSLIST_ENTRY entry=InterlockedPopEntrySList(&m_freeList);
+	if(entry)
+		return reinterpret_cast<Node*>(entry);
+	return EP_NEW Node;
+}
+
+void UdpPacketQueue::freeNode(Node *node)
+{
+	if(QueryDepthSList(&m_freeList)>=UDP_PACKET_QUEUE_FREE_NODE_COUNT)
+	{
+		EP_DELETE node;
+		return;
+	}
+	InterlockedPushEntrySList(&m_freeList,&node->m_freeEntry);
+}
+
+bool UdpPacketQueue::Push(Packet *packet)
+{
+	EP_ASSERT(packet);
+	Node *node=allocateNode();
+	node->m_next=NULL;
+	node->m_packet=packet;
+	// the producers are serialized by the exchange, and the node is visible to the consumer once linked
+	Node *prev=reinterpret_cast<Node*>(InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_head),node));
+	InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&prev->m_next),node);
+	return InterlockedIncrement(&m_count)==1;
+}
+
+UdpPacketQueue::Node *UdpPacketQueue::popNode()
+{
+	Node *tail=m_tail;
+	Node *next=tail->m_next;
+	if(tail==&m_stub)
+	{
+		if(!next)
+			return NULL;
+		m_tail=next;
+		tail=next;
+		next=next->m_next;
+	}
+	if(next)
+	{
+		m_tail=next;
+		return tail;
+	}
+	if(tail!=m_head)
+		return NULL;
+
+	// the last node is handed out, so the stub takes its place
+	m_stub.m_next=NULL;
+	Node *prev=reinterpret_cast<Node*>(InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_head),&m_stub));
+	InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&prev->m_next),&m_stub);
+	next=tail->m_next;
+	if(next)
+	{
+		m_tail=next;
+		return tail;
+	}
+	return NULL;
+}
+
+Packet *UdpPacketQueue::Pop()
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_consumerLock);
+	Node *node=popNode();
+	if(!node)
+		return NULL;
+	Packet *packet=node->m_packet;
+	freeNode(node);
+	InterlockedDecrement(&m_count);
+	return packet;
+}
+
+size_t UdpPacketQueue::PopAll(vector<Packet*> &retPacketList)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_consumerLock);
+	size_t popCount=0;
+	Node *node;
+	while((node=popNode())!=NULL)
+	{
+		retPacketList.push_back(node->m_packet);
+		freeNode(node);
+		popCount++;
+	}
+	if(popCount)
+		InterlockedExchangeAdd(&m_count,-static_cast<LONG>(popCount));
+	return popCount;
+}
+
+bool UdpPacketQueue::IsEmpty() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_consumerLock);
+	// the head is exchanged first by the push, so the push in progress is seen as well
+	return m_tail==&m_stub && m_head==&m_stub;
+}
+
+void UdpPacketQueue::Clear()
+{
+	vector<Packet*> packetList;
+	PopAll(packetList);
+	vector<Packet*>::iterator iter;
+	for(iter=packetList.begin();iter!=packetList.end();iter++)
+		(*iter)->ReleaseObj();
+}
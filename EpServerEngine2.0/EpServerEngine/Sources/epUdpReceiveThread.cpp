@@ -0,0 +1,151 @@
+/*! 
+UdpReceiveThread for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpReceiveThread.h"
+#include "epBaseUdpServer.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+UdpReceiveShard::UdpReceiveShard(BaseUdpServer *server,epl::LockPolicy lockPolicyType):m_queueLock(lockPolicyType)
+{
+	m_server=server;
+	m_isEntered=0;
+}
+
+UdpReceiveShard::~UdpReceiveShard()
+{
+	Clear();
+}
+
+void UdpReceiveShard::Handle(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize)
+{
+	if(tryEnter())
+	{
+		// the datagrams queued before are handled first, so the received order is kept
+		drain();
+		m_server->handleDatagram(packetData,recvLength,clientAddress,segmentByteSize);
+		leave();
+	}
+	else
+		push(packetData,recvLength,clientAddress,segmentByteSize);
+
+	// the datagrams queued while the thread in the shard was leaving are handled here
+	while(true)
+	{
+		m_queueLock.Lock();
+		bool isQueued=!m_queue.empty();
+		m_queueLock.Unlock();
+		if(!isQueued || !tryEnter())
+			break;
+		drain();
+		leave();
+	}
+}
+
+void UdpReceiveShard::Clear()
+{
+	m_queueLock.Lock();
+	releaseDatagrams(m_queue);
+	m_queueLock.Unlock();
+}
+
+bool UdpReceiveShard::push(const char *packetData,int recvLength,const UdpSessionAddress &clientAddress,unsigned int segmentByteSize)
+{
+	Packet *packet=EP_NEW Packet(packetData,recvLength>0?recvLength:0);
+	if(!packet->ChargeMemoryBudget(m_server->GetMemoryBudget()))
+	{
+		packet->ReleaseObj();
+		return false;
+	}
+	ReceivedDatagram datagram;
+	datagram.m_packet=packet;
+	datagram.m_recvLength=recvLength;
+	datagram.m_address=clientAddress;
+	datagram.m_segmentByteSize=segmentByteSize;
+	m_queueLock.Lock();
+	if(m_queue.size()>=UDP_RECEIVE_SHARD_QUEUE_MAX_COUNT)
+	{
+		m_queueLock.Unlock();
+		packet->ReleaseObj();
+		return false;
+	}
+	m_queue.push_back(datagram);
+	m_queueLock.Unlock();
+	return true;
+}
+
+bool UdpReceiveShard::tryEnter()
+{
+	return InterlockedCompareExchange(&m_isEntered,1,0)==0;
+}
+
+void UdpReceiveShard::leave()
+{
+	InterlockedExchange(&m_isEntered,0);
+}
+
+void UdpReceiveShard::drain()
+{
+	while(true)
+	{
+		m_queueLock.Lock();
+		m_handleList.swap(m_queue);
+		m_queueLock.Unlock();
+		if(m_handleList.empty())
+			break;
+		vector<ReceivedDatagram>::iterator iter;
+		for(iter=m_handleList.begin();iter!=m_handleList.end();iter++)
+			m_server->handleDatagram(iter->m_packet->GetPacket(),iter->m_recvLength,iter->m_address,iter->m_segmentByteSize);
+		releaseDatagrams(m_handleList);
+	}
+}
+
+void UdpReceiveShard::releaseDatagrams(vector<ReceivedDatagram> &datagramList)
+{
+	vector<ReceivedDatagram>::iterator iter;
+	for(iter=datagramList.begin();iter!=datagramList.end();iter++)
+		iter->m_packet->ReleaseObj();
+	datagramList.clear();
+}
+
+UdpReceiveThread::UdpReceiveThread(BaseUdpServer *server,epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+{
+	m_server=server;
+}
+
+UdpReceiveThread::~UdpReceiveThread()
+{
+}
+
+void UdpReceiveThread::execute()
+{
+	m_server->receiveLoop();
+}
@@ -0,0 +1,146 @@
+/*! 
+UdpSessionDispatcher for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpSessionDispatcher.h"
+#include "epBaseUdpSocket.h"
+#include <limits.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+UdpDispatchThread::UdpDispatchThread(UdpSessionDispatcher *dispatcher,epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+{
+	m_dispatcher=dispatcher;
+}
+
+UdpDispatchThread::~UdpDispatchThread()
+{
+}
+
+void UdpDispatchThread::execute()
+{
+	BaseUdpSocket *socket;
+	while((socket=m_dispatcher->waitForSession())!=NULL)
+	{
+		socket->dispatchPackets();
+		socket->ReleaseObj();
+	}
+}
+
+UdpSessionDispatcher::UdpSessionDispatcher(epl::LockPolicy lockPolicyType):m_readyLock(lockPolicyType),m_readySemaphore(LONG_MAX,0),m_dispatcherLock(lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+}
+
+UdpSessionDispatcher::~UdpSessionDispatcher()
+{
+	StopDispatcher();
+}
+
+bool UdpSessionDispatcher::StartDispatcher(unsigned int threadCount)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_dispatcherLock);
+	if(!m_threadList.empty())
+		return true;
+	for(unsigned int threadTrav=0;threadTrav<threadCount;threadTrav++)
+	{
+		UdpDispatchThread *dispatchThread=EP_NEW UdpDispatchThread(this,m_lockPolicy);
+		if(!dispatchThread->Start())
+		{
+			EP_DELETE dispatchThread;
+			break;
+		}
+		m_threadList.push_back(dispatchThread);
+	}
+	return !m_threadList.empty();
+}
+
+void UdpSessionDispatcher::StopDispatcher(unsigned int waitTimeInMilliSec)
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_dispatcherLock);
+	if(!m_threadList.empty())
+	{
+		// one stop signal for each thread, taken only when nothing is scheduled
+		m_readySemaphore.Release(static_cast<long>(m_threadList.size()));
+		vector<UdpDispatchThread*>::iterator iter;
+		for(iter=m_threadList.begin();iter!=m_threadList.end();iter++)
+		{
+			(*iter)->TerminateAfter(waitTimeInMilliSec);
+			EP_DELETE *iter;
+		}
+		m_threadList.clear();
+	}
+
+	// rescheduled by the last runs, or scheduled after the threads stopped, so their packets are run here
+	// as the server stops receiving before, the sessions are not scheduled again once their queues are empty
+	while(true)
+	{
+		m_readyLock.Lock();
+		if(m_readyList.empty())
+		{
+			m_readyLock.Unlock();
+			break;
+		}
+		BaseUdpSocket *socket=m_readyList.front();
+		m_readyList.pop();
+		m_readyLock.Unlock();
+		socket->dispatchPackets();
+		socket->ReleaseObj();
+	}
+	while(m_readySemaphore.TryLock())
+	{
+	}
+}
+
+bool UdpSessionDispatcher::IsDispatcherStarted() const
+{
+	ScopedLock<RuntimeLockPolicy> lock(m_dispatcherLock);
+	return !m_threadList.empty();
+}
+
+void UdpSessionDispatcher::Schedule(BaseUdpSocket *socket)
+{
+	socket->RetainObj();
+	m_readyLock.Lock();
+	m_readyList.push(socket);
+	m_readyLock.Unlock();
+	m_readySemaphore.Unlock();
+}
+
+BaseUdpSocket *UdpSessionDispatcher::waitForSession()
+{
+	m_readySemaphore.Lock();
+	ScopedLock<RuntimeLockPolicy> lock(m_readyLock);
+	if(m_readyList.empty())
+		return NULL;
+	BaseUdpSocket *socket=m_readyList.front();
+	m_readyList.pop();
+	return socket;
+}
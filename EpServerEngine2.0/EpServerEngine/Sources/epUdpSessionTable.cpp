@@ -0,0 +1,327 @@
+/*! 
+UdpSessionTable for the EpServerEngine
+
+The MIT License (MIT)
+
+Copyright (c) 2012-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdpSessionTable.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epse;
+
+// RtlGenRandom is exported as SystemFunction036 from advapi32.dll
+typedef BOOLEAN (APIENTRY *RtlGenRandomFunc)(PVOID,ULONG);
+
+static const unsigned __int64 FNV_OFFSET_BASIS=14695981039346656037ULL;
+static const unsigned __int64 FNV_PRIME=1099511628211ULL;
+
+static unsigned __int64 hashBytes(unsigned __int64 hash,const void *data,size_t byteSize)
+{
+	const unsigned char *bytes=reinterpret_cast<const unsigned char*>(data);
+	for(size_t trav=0;trav<byteSize;trav++)
+	{
+		hash^=bytes[trav];
+		hash*=FNV_PRIME;
+	}
+	return hash;
+}
+
+static unsigned __int64 mixHash(unsigned __int64 hash)
+{
+	hash^=hash>>33;
+	hash*=0xff51afd7ed558ccdULL;
+	hash^=hash>>33;
+	hash*=0xc4ceb9fe1a85ec53ULL;
+	hash^=hash>>33;
+	return hash;
+}
+
+static unsigned __int64 generateSeed(const void *salt)
+{
+	unsigned __int64 seed=0;
+	HMODULE advapiModule=LoadLibrary(_T("advapi32.dll"));
+	if(advapiModule)
+	{
+		RtlGenRandomFunc rtlGenRandom=reinterpret_cast<RtlGenRandomFunc>(GetProcAddress(advapiModule,"SystemFunction036"));
+		bool isGenerated=(rtlGenRandom && rtlGenRandom(&seed,sizeof(seed)));
+		FreeLibrary(advapiModule);
+		if(isGenerated)
+			return seed;
+	}
+	// fall back to the less predictable values of the process
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	seed=hashBytes(FNV_OFFSET_BASIS,&counter,sizeof(counter));
+	DWORD processID=GetCurrentProcessId();
+	seed=hashBytes(seed,&processID,sizeof(processID));
+	seed=hashBytes(seed,&salt,sizeof(salt));
+	return mixHash(seed);
+}
+
+UdpSessionAddress::UdpSessionAddress()
+{
+	epl::System::Memset(&m_sockAddr,0,sizeof(SOCKADDR_STORAGE));
+	m_sockAddrSize=0;
+	m_family=AF_UNSPEC;
+	m_port=0;
+	m_ipByteSize=0;
+	epl::System::Memset(m_ip,0,sizeof(m_ip));
+}
+
+UdpSessionAddress::UdpSessionAddress(const sockaddr *sockAddr,int sockAddrSize)
+{
+	m_sockAddrSize=0;
+	SetSockAddr(sockAddr,sockAddrSize);
+}
+
+bool UdpSessionAddress::SetSockAddr(const sockaddr *sockAddr,int sockAddrSize)
+{
+	epl::System::Memset(&m_sockAddr,0,sizeof(SOCKADDR_STORAGE));
+	m_sockAddrSize=0;
+	m_family=AF_UNSPEC;
+	m_port=0;
+	m_ipByteSize=0;
+	epl::System::Memset(m_ip,0,sizeof(m_ip));
+	if(!sockAddr || sockAddrSize<=0 || sockAddrSize>static_cast<int>(sizeof(SOCKADDR_STORAGE)))
+		return false;
+
+	epl::System::Memcpy(&m_sockAddr,sockAddr,sockAddrSize);
+	m_sockAddrSize=sockAddrSize;
+	m_family=sockAddr->sa_family;
+	if(m_family==AF_INET && sockAddrSize>=static_cast<int>(sizeof(sockaddr_in)))
+	{
+		const sockaddr_in *inetAddr=reinterpret_cast<const sockaddr_in*>(sockAddr);
+		m_port=inetAddr->sin_port;
+		m_ipByteSize=sizeof(inetAddr->sin_addr);
+		epl::System::Memcpy(m_ip,&inetAddr->sin_addr,m_ipByteSize);
+		return true;
+	}
+	else if(m_family==AF_INET6 && sockAddrSize>=static_cast<int>(sizeof(sockaddr_in6)))
+	{
+		const sockaddr_in6 *inet6Addr=reinterpret_cast<const sockaddr_in6*>(sockAddr);
+		m_port=inet6Addr->sin6_port;
+		m_ipByteSize=sizeof(inet6Addr->sin6_addr);
+		epl::System::Memcpy(m_ip,&inet6Addr->sin6_addr,m_ipByteSize);
+		return true;
+	}
+
+	// unknown family is keyed by the raw address bytes
+	m_ipByteSize=(sizeof(sockAddr->sa_data)<sizeof(m_ip))?sizeof(sockAddr->sa_data):sizeof(m_ip);
+	if(sockAddrSize<static_cast<int>(sizeof(sockaddr)))
+		m_ipByteSize=0;
+	else
+		epl::System::Memcpy(m_ip,sockAddr->sa_data,m_ipByteSize);
+	return false;
+}
+
+const sockaddr *UdpSessionAddress::GetSockAddr() const
+{
+	return reinterpret_cast<const sockaddr*>(&m_sockAddr);
+}
+
+int UdpSessionAddress::GetSockAddrSize() const
+{
+	return m_sockAddrSize;
+}
+
+bool UdpSessionAddress::operator==(const UdpSessionAddress &b) const
+{
+	if(m_family!=b.m_family || m_port!=b.m_port || m_ipByteSize!=b.m_ipByteSize)
+		return false;
+	return (epl::System::Memcmp(const_cast<unsigned char*>(m_ip),const_cast<unsigned char*>(b.m_ip),m_ipByteSize)==0);
+}
+
+unsigned __int64 UdpSessionAddress::GetHash(unsigned __int64 seed) const
+{
+	unsigned __int64 hash=FNV_OFFSET_BASIS^seed;
+	hash=hashBytes(hash,&m_family,sizeof(m_family));
+	hash=hashBytes(hash,&m_port,sizeof(m_port));
+	hash=hashBytes(hash,m_ip,m_ipByteSize);
+	return mixHash(hash^seed);
+}
+
+UdpSessionTable::UdpSessionTable(epl::LockPolicy lockPolicyType)
+{
+	m_seed=generateSeed(this);
+	for(int stripeTrav=0;stripeTrav<UDP_SESSION_TABLE_STRIPE_COUNT;stripeTrav++)
+	{
+		m_stripes[stripeTrav].m_lock.SetLockPolicy(lockPolicyType);
+		m_stripes[stripeTrav].m_buckets.resize(UDP_SESSION_TABLE_BUCKET_COUNT,NULL);
+		m_stripes[stripeTrav].m_count=0;
+	}
+}
+
+UdpSessionTable::~UdpSessionTable()
+{
+	Clear();
+}
+
+size_t UdpSessionTable::getBucketIndex(unsigned __int64 hash,size_t bucketCount)
+{
+	// lower bits select the stripe
+	return static_cast<size_t>(hash>>8)&(bucketCount-1);
+}
+
+void UdpSessionTable::growStripe(SessionStripe &stripe)
+{
+	vector<SessionEntry*> newBuckets(stripe.m_buckets.size()*2,NULL);
+	for(size_t bucketTrav=0;bucketTrav<stripe.m_buckets.size();bucketTrav++)
+	{
+		SessionEntry *entry=stripe.m_buckets[bucketTrav];
+		while(entry)
+		{
+			SessionEntry *nextEntry=entry->m_next;
+			size_t newIndex=getBucketIndex(entry->m_hash,newBuckets.size());
+			entry->m_next=newBuckets[newIndex];
+			newBuckets[newIndex]=entry;
+			entry=nextEntry;
+		}
+	}
+	stripe.m_buckets.swap(newBuckets);
+}
+
+BaseServerObject *UdpSessionTable::Find(const UdpSessionAddress &address)
+{
+	unsigned __int64 hash=address.GetHash(m_seed);
+	SessionStripe &stripe=m_stripes[hash&(UDP_SESSION_TABLE_STRIPE_COUNT-1)];
+	ScopedLock<RuntimeLockPolicy> lock(stripe.m_lock);
+	SessionEntry *entry=stripe.m_buckets[getBucketIndex(hash,stripe.m_buckets.size())];
+	while(entry)
+	{
+		if(entry->m_hash==hash && entry->m_address==address)
+		{
+			entry->m_object->RetainObj();
+			return entry->m_object;
+		}
+		entry=entry->m_next;
+	}
+	return NULL;
+}
+
+bool UdpSessionTable::Insert(const UdpSessionAddress &address,BaseServerObject *obj)
+{
+	EP_ASSERT(obj);
+	unsigned __int64 hash=address.GetHash(m_seed);
+	SessionStripe &stripe=m_stripes[hash&(UDP_SESSION_TABLE_STRIPE_COUNT-1)];
+	ScopedLock<RuntimeLockPolicy> lock(stripe.m_lock);
+	size_t bucketIndex=getBucketIndex(hash,stripe.m_buckets.size());
+	SessionEntry *entry=stripe.m_buckets[bucketIndex];
+	while(entry)
+	{
+		if(entry->m_hash==hash && entry->m_address==address)
+			return false;
+		entry=entry->m_next;
+	}
+
+	SessionEntry *newEntry=EP_NEW SessionEntry();
+	newEntry->m_address=address;
+	newEntry->m_hash=hash;
+	newEntry->m_object=obj;
+	obj->RetainObj();
+	newEntry->m_next=stripe.m_buckets[bucketIndex];
+	stripe.m_buckets[bucketIndex]=newEntry;
+	stripe.m_count++;
+
+	// keep the load factor at most 1
+	if(stripe.m_count>stripe.m_buckets.size())
+		growStripe(stripe);
+	return true;
+}
+
+bool UdpSessionTable::Remove(const UdpSessionAddress &address,const BaseServerObject *obj)
+{
+	unsigned __int64 hash=address.GetHash(m_seed);
+	SessionStripe &stripe=m_stripes[hash&(UDP_SESSION_TABLE_STRIPE_COUNT-1)];
+	BaseServerObject *removedObj=NULL;
+	stripe.m_lock.Lock();
+	SessionEntry **entryPtr=&stripe.m_buckets[getBucketIndex(hash,stripe.m_buckets.size())];
+	while(*entryPtr)
+	{
+		SessionEntry *entry=*entryPtr;
+		if(entry->m_hash==hash && entry->m_address==address && entry->m_object==obj)
+		{
+			*entryPtr=entry->m_next;
+			removedObj=entry->m_object;
+			EP_DELETE entry;
+			stripe.m_count--;
+			break;
+		}
+		entryPtr=&entry->m_next;
+	}
+	stripe.m_lock.Unlock();
+
+	// released outside the lock since it might be the last reference
+	if(removedObj)
+	{
+		removedObj->ReleaseObj();
+		return true;
+	}
+	return false;
+}
+
+void UdpSessionTable::Clear()
+{
+	vector<BaseServerObject*> removedObjList;
+	for(int stripeTrav=0;stripeTrav<UDP_SESSION_TABLE_STRIPE_COUNT;stripeTrav++)
+	{
+		SessionStripe &stripe=m_stripes[stripeTrav];
+		ScopedLock<RuntimeLockPolicy> lock(stripe.m_lock);
+		for(size_t bucketTrav=0;bucketTrav<stripe.m_buckets.size();bucketTrav++)
+		{
+			SessionEntry *entry=stripe.m_buckets[bucketTrav];
+			while(entry)
+			{
+				SessionEntry *nextEntry=entry->m_next;
+				removedObjList.push_back(entry->m_object);
+				EP_DELETE entry;
+				entry=nextEntry;
+			}
+			stripe.m_buckets[bucketTrav]=NULL;
+		}
+		stripe.m_count=0;
+	}
+
+	vector<BaseServerObject*>::iterator iter;
+	for(iter=removedObjList.begin();iter!=removedObjList.end();iter++)
+		(*iter)->ReleaseObj();
+}
+
+size_t UdpSessionTable::Count() const
+{
+	size_t count=0;
+	for(int stripeTrav=0;stripeTrav<UDP_SESSION_TABLE_STRIPE_COUNT;stripeTrav++)
+	{
+		ScopedLock<RuntimeLockPolicy> lock(const_cast<RuntimeLockPolicy&>(m_stripes[stripeTrav].m_lock));
+		count+=m_stripes[stripeTrav].m_count;
+	}
+	return count;
+}
+
+unsigned __int64 UdpSessionTable::GetSeed() const
+{
+	return m_seed;
+}